@@ -81,10 +81,8 @@ void atmosphere_update( const Delta delta )
 
 void atmosphere_draw( const Delta delta )
 {
-	const Shader shader = Atmosphere::clouds ? Shader::sh_atmosphere_clouds : Shader::sh_atmosphere;
-
 	GfxRenderCommand cmd;
-	cmd.shader( shader );
+	cmd.shader( Shader::sh_atmosphere, Atmosphere::clouds ? ShaderVariant::sh_atmosphere::CLOUDS : 0 );
 	cmd.raster_cull_mode( GfxCullMode_BACK );
 	cmd.depth_function( GfxDepthFunction_NONE );
 	cmd.depth_write_mask( GfxDepthWrite_NONE );
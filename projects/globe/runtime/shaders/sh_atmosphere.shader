@@ -1,5 +1,7 @@
 #include <shader_api.hpp>
 
+#variant CLOUDS
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #define R_EARTH ( 6378137.0 )
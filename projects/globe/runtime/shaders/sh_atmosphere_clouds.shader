@@ -1,8 +0,0 @@
-#include <shader_api.hpp>
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
-#define CLOUDS
-#include "sh_atmosphere.shader"
-
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
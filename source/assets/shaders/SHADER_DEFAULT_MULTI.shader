@@ -0,0 +1,88 @@
+#include <shader_api.hpp>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Multi-texture quad batch: each quad selects one of 8 bound textures with a per-vertex slot index, so sprites,
+// font glyphs, and UI drawn from different textures can share a single draw call (see Gfx::quad_batch_write)
+
+vertex_input BuiltinVertexMulti
+{
+	float3 position packed_as( FLOAT32 );
+	float2 uv packed_as( UNORM16 );
+	float4 color packed_as( UNORM8 );
+	float4 slot packed_as( UNORM8 ); // x: texture slot (0-7)
+};
+
+vertex_output VertexOutput
+{
+	float4 position position_out;
+	float2 uv;
+	float4 color;
+	float slot;
+};
+
+fragment_input FragmentInput
+{
+	float4 position position_in;
+	float2 uv;
+	float4 color;
+	float slot;
+};
+
+fragment_output FragmentOutput
+{
+	float4 color target( 0, COLOR );
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+uniform_buffer( 0 ) UniformsPipeline
+{
+	float4x4 matrixModel;
+	float4x4 matrixView;
+	float4x4 matrixPerspective;
+	float4x4 matrixMVP;
+	float4x4 matrixModelInverse;
+	float4x4 matrixViewInverse;
+	float4x4 matrixPerspectiveInverse;
+	float4x4 matrixMVPInverse;
+};
+
+texture2D( 0, float4 ) textureColor0;
+texture2D( 1, float4 ) textureColor1;
+texture2D( 2, float4 ) textureColor2;
+texture2D( 3, float4 ) textureColor3;
+texture2D( 4, float4 ) textureColor4;
+texture2D( 5, float4 ) textureColor5;
+texture2D( 6, float4 ) textureColor6;
+texture2D( 7, float4 ) textureColor7;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void vertex_main( BuiltinVertexMulti In, VertexOutput Out, UniformsPipeline Pipeline )
+{
+	Out.position = mul( Pipeline.matrixMVP, float4( In.position, 1.0 ) );
+	Out.uv = In.uv;
+	Out.color = In.color;
+	Out.slot = In.slot.x * 255.0;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void fragment_main( FragmentInput In, FragmentOutput Out )
+{
+	float4 colorTexture = float4( 0.0, 0.0, 0.0, 0.0 );
+	if( In.slot < 0.5 ) { colorTexture = texture_sample_2d( textureColor0, In.uv ); }
+	else if( In.slot < 1.5 ) { colorTexture = texture_sample_2d( textureColor1, In.uv ); }
+	else if( In.slot < 2.5 ) { colorTexture = texture_sample_2d( textureColor2, In.uv ); }
+	else if( In.slot < 3.5 ) { colorTexture = texture_sample_2d( textureColor3, In.uv ); }
+	else if( In.slot < 4.5 ) { colorTexture = texture_sample_2d( textureColor4, In.uv ); }
+	else if( In.slot < 5.5 ) { colorTexture = texture_sample_2d( textureColor5, In.uv ); }
+	else if( In.slot < 6.5 ) { colorTexture = texture_sample_2d( textureColor6, In.uv ); }
+	else { colorTexture = texture_sample_2d( textureColor7, In.uv ); }
+
+	if( colorTexture.a <= 0.0 ) { discard; }
+	Out.color = colorTexture * In.color;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
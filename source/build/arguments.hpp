@@ -69,6 +69,7 @@ struct Arguments
 	const char *toolchain;
 	const char *gfx;
 	const char *multilaunch;
+	const char *unity;
 
 	void parse( int argc, char **argv )
 	{
@@ -96,6 +97,9 @@ struct Arguments
 		// Run
 		parse_argument( argc, argv, "-run=", run, ARG_OPTIONAL, "1", "0", "2" );
 
+		// Unity Build
+		parse_argument( argc, argv, "-unity=", unity, ARG_OPTIONAL, "0", "1" );
+
 		// Multi-Launch
 		parse_argument( argc, argv, "-multilaunch=", multilaunch, ARG_OPTIONAL, "1",
 			"1", "2", "3", "4", "5", "6", "7", "8" );
@@ -5,6 +5,8 @@
 #include <core/list.hpp>
 #include <core/json.hpp>
 #include <core/checksum.hpp>
+#include <core/memory.hpp>
+#include <core/math.hpp>
 
 #include <build/build.hpp>
 #include <build/assets.hpp>
@@ -205,4 +207,228 @@ void Meshes::build()
 	}
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Forsyth scoring: vertices used by the last triangle score a flat 0.75 (discouraging strips that re-use them
+// immediately), other cached vertices decay with their LRU position, and a valence boost favors finishing off
+// vertices with few remaining triangles so they can leave the cache for good
+
+#define MESH_FORSYTH_VALENCE_TABLE ( 32 )
+
+static float meshForsythCacheScore[MESH_VERTEX_CACHE_SIZE];
+static float meshForsythValenceScore[MESH_FORSYTH_VALENCE_TABLE];
+
+static void mesh_forsyth_tables()
+{
+	if( meshForsythValenceScore[1] != 0.0f ) { return; }
+
+	for( u32 i = 0; i < MESH_VERTEX_CACHE_SIZE; i++ )
+	{
+		const float scale = 1.0f / ( MESH_VERTEX_CACHE_SIZE - 3 );
+		meshForsythCacheScore[i] = i < 3 ? 0.75f : powf( 1.0f - ( i - 3 ) * scale, 1.5f );
+	}
+
+	meshForsythValenceScore[0] = 0.0f;
+	for( u32 i = 1; i < MESH_FORSYTH_VALENCE_TABLE; i++ )
+	{
+		meshForsythValenceScore[i] = 2.0f * powf( static_cast<float>( i ), -0.5f );
+	}
+}
+
+
+static float mesh_forsyth_score( const i32 cachePosition, const u32 valence )
+{
+	// Vertices without remaining triangles never need to be scored
+	if( valence == 0 ) { return -1.0f; }
+
+	const float scoreCache = cachePosition >= 0 ? meshForsythCacheScore[cachePosition] : 0.0f;
+	const float scoreValence = valence < MESH_FORSYTH_VALENCE_TABLE ? meshForsythValenceScore[valence] :
+		2.0f * powf( static_cast<float>( valence ), -0.5f );
+	return scoreCache + scoreValence;
+}
+
+
+void mesh_optimize_vertex_cache( u32 *indices, const usize indexCount, const u32 vertexCount )
+{
+	const u32 triangleCount = static_cast<u32>( indexCount / 3 );
+	if( triangleCount == 0 || vertexCount == 0 ) { return; }
+	mesh_forsyth_tables();
+
+	// Scratch
+	u32 *valence = reinterpret_cast<u32 *>( memory_alloc( vertexCount * sizeof( u32 ) ) );
+	u32 *adjacencyOffset = reinterpret_cast<u32 *>( memory_alloc( vertexCount * sizeof( u32 ) ) );
+	u32 *adjacency = reinterpret_cast<u32 *>( memory_alloc( triangleCount * 3 * sizeof( u32 ) ) );
+	i32 *cachePosition = reinterpret_cast<i32 *>( memory_alloc( vertexCount * sizeof( i32 ) ) );
+	float *vertexScore = reinterpret_cast<float *>( memory_alloc( vertexCount * sizeof( float ) ) );
+	float *triangleScore = reinterpret_cast<float *>( memory_alloc( triangleCount * sizeof( float ) ) );
+	bool *triangleEmitted = reinterpret_cast<bool *>( memory_alloc( triangleCount * sizeof( bool ) ) );
+	u32 *output = reinterpret_cast<u32 *>( memory_alloc( triangleCount * 3 * sizeof( u32 ) ) );
+
+	// Vertex -> triangle adjacency
+	memory_set( valence, 0, vertexCount * sizeof( u32 ) );
+	for( u32 i = 0; i < triangleCount * 3; i++ )
+	{
+		Assert( indices[i] < vertexCount );
+		valence[indices[i]]++;
+	}
+
+	u32 offset = 0;
+	for( u32 v = 0; v < vertexCount; v++ ) { adjacencyOffset[v] = offset; offset += valence[v]; }
+
+	memory_set( valence, 0, vertexCount * sizeof( u32 ) );
+	for( u32 t = 0; t < triangleCount; t++ )
+	{
+		for( u32 k = 0; k < 3; k++ )
+		{
+			const u32 v = indices[t * 3 + k];
+			adjacency[adjacencyOffset[v] + valence[v]++] = t;
+		}
+	}
+
+	// Initial scores
+	for( u32 v = 0; v < vertexCount; v++ )
+	{
+		cachePosition[v] = -1;
+		vertexScore[v] = mesh_forsyth_score( -1, valence[v] );
+	}
+
+	u32 best = 0;
+	for( u32 t = 0; t < triangleCount; t++ )
+	{
+		const u32 *triangle = &indices[t * 3];
+		triangleScore[t] = vertexScore[triangle[0]] + vertexScore[triangle[1]] + vertexScore[triangle[2]];
+		triangleEmitted[t] = false;
+		if( triangleScore[t] > triangleScore[best] ) { best = t; }
+	}
+
+	// Greedily emit the highest scoring triangle, then rescore the triangles touching the cache
+	u32 cache[MESH_VERTEX_CACHE_SIZE + 3];
+	u32 cacheNext[MESH_VERTEX_CACHE_SIZE + 3];
+	u32 cacheCount = 0;
+	u32 cursor = 0;
+
+	for( u32 emitted = 0; emitted < triangleCount; emitted++ )
+	{
+		// Nothing adjacent to the cache: continue with the next unemitted triangle
+		if( best == U32_MAX )
+		{
+			while( triangleEmitted[cursor] ) { cursor++; }
+			best = cursor;
+		}
+
+		const u32 triangle[3] = { indices[best * 3 + 0], indices[best * 3 + 1], indices[best * 3 + 2] };
+		output[emitted * 3 + 0] = triangle[0];
+		output[emitted * 3 + 1] = triangle[1];
+		output[emitted * 3 + 2] = triangle[2];
+		triangleEmitted[best] = true;
+
+		// Remove the triangle from its vertices' adjacency
+		for( u32 k = 0; k < 3; k++ )
+		{
+			const u32 v = triangle[k];
+			u32 *list = &adjacency[adjacencyOffset[v]];
+			for( u32 i = 0; i < valence[v]; i++ )
+			{
+				if( list[i] != best ) { continue; }
+				list[i] = list[valence[v] - 1];
+				valence[v]--;
+				break;
+			}
+		}
+
+		// LRU: the triangle's vertices move to the front
+		u32 cacheNextCount = 0;
+		for( u32 k = 0; k < 3; k++ )
+		{
+			bool duplicate = false;
+			for( u32 i = 0; i < cacheNextCount; i++ ) { duplicate |= cacheNext[i] == triangle[k]; }
+			if( !duplicate ) { cacheNext[cacheNextCount++] = triangle[k]; }
+		}
+
+		for( u32 i = 0; i < cacheCount; i++ )
+		{
+			const u32 v = cache[i];
+			if( v != triangle[0] && v != triangle[1] && v != triangle[2] ) { cacheNext[cacheNextCount++] = v; }
+		}
+
+		// Rescore cached & evicted vertices
+		for( u32 i = 0; i < cacheNextCount; i++ )
+		{
+			const u32 v = cacheNext[i];
+			cachePosition[v] = i < MESH_VERTEX_CACHE_SIZE ? static_cast<i32>( i ) : -1;
+			vertexScore[v] = mesh_forsyth_score( cachePosition[v], valence[v] );
+		}
+
+		cacheCount = min( cacheNextCount, static_cast<u32>( MESH_VERTEX_CACHE_SIZE ) );
+		memory_copy( cache, cacheNext, cacheCount * sizeof( u32 ) );
+
+		// Rescore their remaining triangles & pick the next one
+		best = U32_MAX;
+		float bestScore = -1.0f;
+		for( u32 i = 0; i < cacheNextCount; i++ )
+		{
+			const u32 v = cacheNext[i];
+			const u32 *list = &adjacency[adjacencyOffset[v]];
+			for( u32 j = 0; j < valence[v]; j++ )
+			{
+				const u32 t = list[j];
+				const u32 *other = &indices[t * 3];
+				triangleScore[t] = vertexScore[other[0]] + vertexScore[other[1]] + vertexScore[other[2]];
+				if( triangleScore[t] > bestScore ) { bestScore = triangleScore[t]; best = t; }
+			}
+		}
+	}
+
+	memory_copy( indices, output, triangleCount * 3 * sizeof( u32 ) );
+
+	memory_free( output );
+	memory_free( triangleEmitted );
+	memory_free( triangleScore );
+	memory_free( vertexScore );
+	memory_free( cachePosition );
+	memory_free( adjacency );
+	memory_free( adjacencyOffset );
+	memory_free( valence );
+}
+
+
+u32 mesh_optimize_vertex_fetch( u32 *indices, const usize indexCount, const u32 vertexCount, u32 *remap )
+{
+	for( u32 v = 0; v < vertexCount; v++ ) { remap[v] = U32_MAX; }
+
+	u32 next = 0;
+	for( usize i = 0; i < indexCount; i++ )
+	{
+		const u32 v = indices[i];
+		Assert( v < vertexCount );
+		if( remap[v] == U32_MAX ) { remap[v] = next++; }
+		indices[i] = remap[v];
+	}
+
+	return next;
+}
+
+
+double mesh_acmr( const u32 *indices, const usize indexCount, const u32 vertexCount, const u32 cacheSize )
+{
+	const usize triangleCount = indexCount / 3;
+	if( triangleCount == 0 ) { return 0.0; }
+
+	// FIFO: a vertex is cached if it was inserted within the last 'cacheSize' misses
+	u32 *stamp = reinterpret_cast<u32 *>( memory_alloc( vertexCount * sizeof( u32 ) ) );
+	memory_set( stamp, 0, vertexCount * sizeof( u32 ) );
+
+	u32 time = cacheSize + 1;
+	usize misses = 0;
+	for( usize i = 0; i < triangleCount * 3; i++ )
+	{
+		const u32 v = indices[i];
+		Assert( v < vertexCount );
+		if( time - stamp[v] > cacheSize ) { stamp[v] = time++; misses++; }
+	}
+
+	memory_free( stamp );
+	return static_cast<double>( misses ) / static_cast<double>( triangleCount );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -40,6 +40,24 @@ using MeshID = u32;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Index buffer optimization (triangle lists)
+
+#define MESH_VERTEX_CACHE_SIZE ( 32 ) // LRU entries modeled by mesh_optimize_vertex_cache()
+#define MESH_VERTEX_CACHE_SIZE_FIFO ( 16 ) // FIFO entries modeled by mesh_acmr()
+
+// Reorders triangles for a post-transform vertex cache (Forsyth, "Linear-Speed Vertex Cache Optimisation")
+extern void mesh_optimize_vertex_cache( u32 *indices, usize indexCount, u32 vertexCount );
+
+// Renumbers vertices in order of first use so vertex fetches walk memory linearly. 'remap' (vertexCount entries)
+// receives the new index of every vertex (U32_MAX if unreferenced). Returns the number of referenced vertices
+extern u32 mesh_optimize_vertex_fetch( u32 *indices, usize indexCount, u32 vertexCount, u32 *remap );
+
+// Average cache miss ratio: transformed vertices per triangle for a FIFO cache (0.5 is ideal, 3.0 is no reuse)
+extern double mesh_acmr( const u32 *indices, usize indexCount, u32 vertexCount,
+	u32 cacheSize = MESH_VERTEX_CACHE_SIZE_FIFO );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 class Meshes
 {
 public:
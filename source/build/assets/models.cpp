@@ -6,6 +6,7 @@
 #include <core/json.hpp>
 #include <core/checksum.hpp>
 #include <core/math.hpp>
+#include <core/memory.hpp>
 
 #include <build/build.hpp>
 #include <build/assets.hpp>
@@ -61,6 +62,52 @@ struct VertexPositionNormalTangentUV
 	u16_v2 uv;
 };
 
+
+// Packed formats: position UNORM16 within the mesh AABB (w: tangent handedness), normal & tangent octahedral
+// SNORM16, uv FLOAT16 (see: shaderlib/vertex_formats.h)
+
+struct VertexPositionPacked
+{
+	u16_v4 position;
+};
+static_assert( sizeof( VertexPositionPacked ) == 8, "VertexPositionPacked size changed!" );
+
+
+struct VertexPositionUVPacked
+{
+	u16_v4 position;
+	u16_v2 uv;
+};
+static_assert( sizeof( VertexPositionUVPacked ) == 12, "VertexPositionUVPacked size changed!" );
+
+
+struct VertexPositionNormalPacked
+{
+	u16_v4 position;
+	i16_v2 normal;
+};
+static_assert( sizeof( VertexPositionNormalPacked ) == 12, "VertexPositionNormalPacked size changed!" );
+
+
+struct VertexPositionNormalUVPacked
+{
+	u16_v4 position;
+	i16_v2 normal;
+	u16_v2 uv;
+};
+static_assert( sizeof( VertexPositionNormalUVPacked ) == 16, "VertexPositionNormalUVPacked size changed!" );
+
+
+struct VertexPositionNormalTangentUVPacked
+{
+	u16_v4 position;
+	i16_v2 normal;
+	i16_v2 tangent;
+	u16_v2 uv;
+};
+static_assert( sizeof( VertexPositionNormalTangentUVPacked ) == 20,
+	"VertexPositionNormalTangentUVPacked size changed!" );
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 struct Tangents
@@ -218,6 +265,9 @@ void Models::build()
 	const u32 count = static_cast<u32>( models.count() );
 
 	Timer timer;
+	double missesBefore = 0.0;
+	double missesAfter = 0.0;
+	usize triangles = 0;
 
 	// Load
 	{
@@ -240,6 +290,15 @@ void Models::build()
 				}
 
 				Assets::log_asset_build( "Model", model.name.cstr() );
+
+				missesBefore += model.acmrBefore * model.triangleCount;
+				missesAfter += model.acmrAfter * model.triangleCount;
+				triangles += model.triangleCount;
+				if( verbose_output() && model.triangleCount > 0 )
+				{
+					PrintLn( PrintColor_White, TAB TAB TAB "%u triangles, %u vertices | ACMR %.3f -> %.3f",
+						model.triangleCount, model.vertexCount, model.acmrBefore, model.acmrAfter );
+				}
 			}
 			else
 			{
@@ -337,220 +396,338 @@ void Models::build()
 	{
 		const usize count = models.count();
 		Print( PrintColor_White, TAB TAB "Wrote %d model%s", count, count == 1 ? "" : "s" );
+		if( triangles > 0 )
+		{
+			Print( PrintColor_White, " (ACMR: %.3f -> %.3f over %llu triangles)",
+				missesBefore / triangles, missesAfter / triangles, triangles );
+		}
 		PrintLn( PrintColor_White, " (%.3f ms)", timer.elapsed_ms() );
 	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// OBJ
+//
+// The file is tokenized in a single pass. Faces are fan-triangulated and their v/vt/vn tuples deduplicated per mesh
+// (meshes are split on 'usemtl') through an open-addressing table sized from the position count. Each mesh is then
+// optimized for the post-transform vertex cache & vertex fetch before its buffers are built
+
+#define OBJ_INDEX_NONE ( U32_MAX )
+
 struct VertexTuple
 {
 	u32 positionIndex;
 	u32 texcoordIndex;
 	u32 normalIndex;
-	u32 tangentIndex;
 };
 
 
-static bool is_number( const char c )
+struct ObjMesh
 {
-	return ( c >= '0' && c <= '9' ) || c == '+' || c == '-' || c == '.';
-}
+	const char *material; // nullptr: faces before the first 'usemtl'
+	u32 materialLength;
+	u32 vertexStart;
+	u32 vertexCount;
+	u32 indexStart;
+	u32 indexCount;
+};
 
 
-static usize seek_to_next_number( const String &file, usize &tell )
+class ObjVertexTable
 {
-	// Early out
-	if( file[tell] == '\n' || file[tell] == '\0' )
+public:
+	void free()
+	{
+		if( slots != nullptr ) { memory_free( slots ); }
+		slots = nullptr;
+		capacity = 0;
+		count = 0;
+	}
+
+	void next_mesh()
 	{
-		return USIZE_MAX;
+		// Slots from previous meshes are left in place and treated as empty
+		stamp++;
+		count = 0;
 	}
 
-	// Seek to beginning of a number
-	usize start = tell;
-	while( !is_number( file[start] ) )
+	void reserve( const u32 vertices )
 	{
-		if( file[start] == '\n' || file[start] == '\0' )
+		// Keep the load factor <= 50%
+		u32 capacityNew = capacity > 0 ? capacity : 1024;
+		while( capacityNew < vertices * 2 ) { capacityNew *= 2; }
+		if( capacityNew == capacity ) { return; }
+
+		Slot *slotsOld = slots;
+		const u32 capacityOld = capacity;
+		slots = reinterpret_cast<Slot *>( memory_alloc( capacityNew * sizeof( Slot ) ) );
+		memory_set( slots, 0, capacityNew * sizeof( Slot ) );
+		capacity = capacityNew;
+		count = 0;
+
+		for( u32 i = 0; i < capacityOld; i++ )
 		{
-			tell = start;
-			return USIZE_MAX;
+			if( slotsOld[i].stamp == stamp ) { find_or_add( slotsOld[i].tuple, slotsOld[i].index ); }
 		}
-
-		start++;
+		if( slotsOld != nullptr ) { memory_free( slotsOld ); }
 	}
 
-	// Seek to end of number
-	usize end = start;
-	while( is_number( file[end] ) ) { end++; }
-	tell = end;
+	u32 find_or_add( const VertexTuple &tuple, const u32 index )
+	{
+		if( ( count + 1 ) * 2 > capacity ) { reserve( count + 1 ); }
 
-	// Return number position
-	return start == end ? USIZE_MAX : start;
-}
+		const u32 mask = capacity - 1;
+		for( u32 i = hash( tuple ) & mask;; i = ( i + 1 ) & mask )
+		{
+			Slot &slot = slots[i];
+			if( slot.stamp != stamp )
+			{
+				slot.tuple = tuple;
+				slot.index = index;
+				slot.stamp = stamp;
+				count++;
+				return index;
+			}
 
+			if( slot.tuple.positionIndex == tuple.positionIndex &&
+				slot.tuple.texcoordIndex == tuple.texcoordIndex &&
+				slot.tuple.normalIndex == tuple.normalIndex )
+			{
+				return slot.index;
+			}
+		}
+	}
 
-static bool next_float( const String &file, usize &tell, float &out )
-{
-	// Seek to beginning of a number
-	usize index = seek_to_next_number( file, tell );
-	if( index == USIZE_MAX) { out = 0.0f; return false; }
+private:
+	struct Slot
+	{
+		VertexTuple tuple;
+		u32 index;
+		u32 stamp; // mesh that owns the slot (0: never used)
+	};
 
-	// Read float
-	out = static_cast<float>( atof( file.get_pointer( index ) ) );
-	return true;
-}
+	static u32 hash( const VertexTuple &tuple )
+	{
+		u32 h = tuple.positionIndex * 0x9E3779B1U;
+		h ^= tuple.texcoordIndex * 0x85EBCA77U;
+		h ^= h >> 15;
+		h ^= tuple.normalIndex * 0xC2B2AE3DU;
+		h ^= h >> 16;
+		h *= 0x7FEB352DU;
+		h ^= h >> 15;
+		return h;
+	}
 
+	Slot *slots = nullptr;
+	u32 capacity = 0;
+	u32 count = 0;
+	u32 stamp = 1;
+};
 
-static bool next_u32( const String &file, usize &tell, u32 &out )
-{
-	// Seek to beginning of a number
-	usize index = seek_to_next_number( file, tell );
-	if( index == USIZE_MAX ) { out = 0; return false; }
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-	// Read float
-	out = static_cast<u32>( atoi( file.get_pointer( index ) ) );
-	return true;
-}
+static const double OBJ_POW10[] =
+{
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22,
+};
 
 
-static bool next_line( const String &file, usize tell, String &out )
+static bool obj_is_space( const char c )
 {
-	const usize newline = file.find( "\n", tell );
-	if( newline <= tell ) { return false; }
-	out = file.substr( tell, newline ).trim();
-	return true;
+	return c == ' ' || c == '\t' || c == '\r';
 }
 
 
-static usize next_key( const String &file, usize &tell, const char *key )
+static void obj_skip_space( const char *&c, const char *end )
 {
-	tell = file.find( key, tell );
-	if( tell == USIZE_MAX ) { return tell; }
-	tell += strlen( key );
-	return tell;
+	while( c < end && obj_is_space( *c ) ) { c++; }
 }
 
 
-static usize try_find_next_key( const String &file, const usize start, const usize end, const char *key )
+static float obj_parse_float( const char *&c, const char *end )
 {
-	usize next = file.find( key, start, end );
-	if( next == USIZE_MAX ) { return USIZE_MAX; }
-	next += strlen( key );
-	return next;
-}
+	// Decimal mantissa (up to 19 significant digits) scaled by a power of 10 in double precision
+	obj_skip_space( c, end );
+	const bool negative = c < end && *c == '-';
+	if( c < end && ( *c == '-' || *c == '+' ) ) { c++; }
+
+	u64 mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
+	for( ; c < end && *c >= '0' && *c <= '9'; c++ )
+	{
+		if( digits < 19 ) { mantissa = mantissa * 10 + static_cast<u64>( *c - '0' ); digits += mantissa != 0; }
+		else { exponent++; }
+	}
 
+	if( c < end && *c == '.' )
+	{
+		for( c++; c < end && *c >= '0' && *c <= '9'; c++ )
+		{
+			if( digits >= 19 ) { continue; }
+			mantissa = mantissa * 10 + static_cast<u64>( *c - '0' );
+			digits += mantissa != 0;
+			exponent--;
+		}
+	}
 
-static bool obj_next_vertex_position( const String &file, usize &tell, List<float_v3> &positions )
-{
-	tell = next_key( file, tell, "v " );
-	if( tell == USIZE_MAX ) { return false; }
+	if( c < end && ( *c == 'e' || *c == 'E' ) )
+	{
+		c++;
+		const bool exponentNegative = c < end && *c == '-';
+		if( c < end && ( *c == '-' || *c == '+' ) ) { c++; }
+		int value = 0;
+		for( ; c < end && *c >= '0' && *c <= '9'; c++ ) { value = min( value * 10 + ( *c - '0' ), 1000 ); }
+		exponent += exponentNegative ? -value : value;
+	}
 
-	float_v3 &vertex = positions.add( float_v3 { } );
-	next_float( file, tell, vertex.x );
-	next_float( file, tell, vertex.y );
-	next_float( file, tell, vertex.z );
-	return true;
-};
+	double result = static_cast<double>( mantissa );
+	for( ; exponent > 22; exponent -= 22 ) { result *= OBJ_POW10[22]; }
+	for( ; exponent < -22; exponent += 22 ) { result /= OBJ_POW10[22]; }
+	result = exponent >= 0 ? result * OBJ_POW10[exponent] : result / OBJ_POW10[-exponent];
+
+	return static_cast<float>( negative ? -result : result );
+}
 
 
-static bool obj_next_vertex_normal( const String &file, usize &tell, List<float_v3> &normals )
+static bool obj_parse_index( const char *&c, const char *end, const u32 count, u32 &index )
 {
-	tell = next_key( file, tell, "vn " );
-	if( tell == USIZE_MAX ) { return false; }
+	// 1-based (negative: relative to the end of the list so far) to 0-based
+	const bool negative = c < end && *c == '-';
+	if( negative ) { c++; }
+	if( c >= end || *c < '0' || *c > '9' ) { return false; }
 
-	float_v3 &normal = normals.add( float_v3 { } );
-	next_float( file, tell, normal.x );
-	next_float( file, tell, normal.y );
-	next_float( file, tell, normal.z );
+	u64 value = 0;
+	for( ; c < end && *c >= '0' && *c <= '9'; c++ ) { value = min( value * 10 + static_cast<u64>( *c - '0' ), U64_MAX / 10 ); }
+
+	if( negative ) { index = value <= count ? static_cast<u32>( count - value ) : OBJ_INDEX_NONE; }
+	else { index = value > 0 && value <= U32_MAX ? static_cast<u32>( value - 1 ) : OBJ_INDEX_NONE; }
 	return true;
-};
+}
 
 
-static bool obj_next_vertex_texcoord( const String &file, usize &tell, List<float_v2> &texcoords )
+static bool obj_keyword( const char *c, const char *end, const char *keyword )
 {
-	tell = next_key( file, tell, "vt " );
-	if( tell == USIZE_MAX ) { return false; }
-
-	float_v2 &uv = texcoords.add( float_v2 { } );
-	next_float( file, tell, uv.x );
-	next_float( file, tell, uv.y );
-	// next_float( file, tell, uv.w ); TODO: Is this ever even used?
-	return true;
-};
+	// 'keyword' followed by whitespace
+	for( ; *keyword != '\0'; c++, keyword++ )
+	{
+		if( c >= end || *c != *keyword ) { return false; }
+	}
+	return c < end && obj_is_space( *c );
+}
 
 
-static bool obj_next_face( const String &file, usize &tell, usize end,
-	const List<float_v3> &positions,
-	const List<float_v2> &textureCoords,
-	const List<float_v3> &normals,
-	List<Tangents> &tangents,
-	HashMap<u64, u32> &faces,
+static void obj_parse( const String &file,
+	List<float_v3> &positions,
+	List<float_v2> &texcoords,
+	List<float_v3> &normals,
 	List<VertexTuple> &vertices,
-	List<u32> &indices )
+	List<u32> &indices,
+	List<ObjMesh> &meshes,
+	ObjVertexTable &table )
 {
-	tell = next_key( file, tell, "f " );
-	if( tell >= end ) { return false; }
+	const char *c = file.cstr();
+	const char *end = c + file.length_bytes();
 
-	// TODO: Support quads as well
-	for( int i = 0; i < 3; i++ )
+	ObjMesh mesh { nullptr, 0, 0, 0, 0, 0 };
+	auto mesh_end = [&]()
 	{
-		VertexTuple tuple;
-		next_u32( file, tell, tuple.positionIndex );
-		next_u32( file, tell, tuple.texcoordIndex );
-		next_u32( file, tell, tuple.normalIndex );
-		const u64 key = Hash::hash64_from( tuple );
+		mesh.vertexCount = static_cast<u32>( vertices.count() ) - mesh.vertexStart;
+		mesh.indexCount = static_cast<u32>( indices.count() ) - mesh.indexStart;
+		if( mesh.indexCount > 0 ) { meshes.add( mesh ); }
+		table.next_mesh();
+	};
 
-		if( faces.contains( key ) )
+	while( c < end )
+	{
+		obj_skip_space( c, end );
+		if( c >= end ) { break; }
+
+		if( obj_keyword( c, end, "v" ) )
 		{
-			const u32 index = faces.get( key );
-			indices.add( index );
+			c += 1;
+			float_v3 &position = positions.add( float_v3 { } );
+			position.x = obj_parse_float( c, end );
+			position.y = obj_parse_float( c, end );
+			position.z = obj_parse_float( c, end );
 		}
-		else
+		else if( obj_keyword( c, end, "vt" ) )
 		{
-			const u32 index = vertices.count();
-			tangents.add( Tangents { } );
-			tuple.tangentIndex = tangents.count();
-			vertices.add( tuple );
-			indices.add( index );
-			faces.add( key, index );
+			c += 2;
+			float_v2 &texcoord = texcoords.add( float_v2 { } );
+			texcoord.x = obj_parse_float( c, end );
+			texcoord.y = obj_parse_float( c, end );
 		}
-	}
-
-	return true;
-}
-
-
-static void obj_parse_vertex_positions( const String &file, List<float_v3> &positions )
-{
-	usize tell = 0LLU;
-	while( obj_next_vertex_position( file, tell, positions ) ) { }
-}
+		else if( obj_keyword( c, end, "vn" ) )
+		{
+			c += 2;
+			float_v3 &normal = normals.add( float_v3 { } );
+			normal.x = obj_parse_float( c, end );
+			normal.y = obj_parse_float( c, end );
+			normal.z = obj_parse_float( c, end );
+		}
+		else if( obj_keyword( c, end, "f" ) )
+		{
+			// Unique vertices usually track the position count (seams add a few)
+			if( vertices.count() == mesh.vertexStart ) { table.reserve( static_cast<u32>( positions.count() ) ); }
+
+			c += 1;
+			u32 first = 0;
+			u32 previous = 0;
+			u32 corners = 0;
+			for( ;; )
+			{
+				obj_skip_space( c, end );
+				VertexTuple tuple { OBJ_INDEX_NONE, OBJ_INDEX_NONE, OBJ_INDEX_NONE };
+				if( !obj_parse_index( c, end, static_cast<u32>( positions.count() ), tuple.positionIndex ) ) { break; }
+				if( c < end && *c == '/' )
+				{
+					c++;
+					obj_parse_index( c, end, static_cast<u32>( texcoords.count() ), tuple.texcoordIndex );
+					if( c < end && *c == '/' )
+					{
+						c++;
+						obj_parse_index( c, end, static_cast<u32>( normals.count() ), tuple.normalIndex );
+					}
+				}
 
+				const u32 vertexIndex = static_cast<u32>( vertices.count() ) - mesh.vertexStart;
+				const u32 index = table.find_or_add( tuple, vertexIndex );
+				if( index == vertexIndex ) { vertices.add( tuple ); }
 
-static void obj_parse_vertex_texcoords( const String &file, List<float_v2> &texcoords )
-{
-	usize tell = 0LLU;
-	while( obj_next_vertex_texcoord( file, tell, texcoords ) ) { }
-}
+				// Triangle fan
+				if( corners == 0 ) { first = index; }
+				if( corners >= 2 ) { indices.add( first ); indices.add( previous ); indices.add( index ); }
+				previous = index;
+				corners++;
+			}
+		}
+		else if( obj_keyword( c, end, "usemtl" ) )
+		{
+			mesh_end();
 
+			c += 6;
+			obj_skip_space( c, end );
+			const char *name = c;
+			while( c < end && *c != '\n' ) { c++; }
+			const char *nameEnd = c;
+			while( nameEnd > name && obj_is_space( nameEnd[-1] ) ) { nameEnd--; }
 
-static void obj_parse_vertex_normals( const String &file, List<float_v3> &normals )
-{
-	usize tell = 0LLU;
-	while( obj_next_vertex_normal( file, tell, normals ) ) { }
-}
+			mesh = ObjMesh { name, static_cast<u32>( nameEnd - name ),
+				static_cast<u32>( vertices.count() ), 0, static_cast<u32>( indices.count() ), 0 };
+		}
 
+		// Next line (comments, groups, smoothing, mtllib, etc. are skipped entirely)
+		while( c < end && *c != '\n' ) { c++; }
+		c++;
+	}
 
-static void obj_parse_mesh_faces( const String &file, usize start, usize end,
-	const List<float_v3> &positions,
-	const List<float_v2> &texcoords,
-	const List<float_v3> &normals,
-	List<Tangents> &tangents,
-	HashMap<u64, u32> &faces, List<VertexTuple> &vertices, List<u32> &indices )
-{
-	while( obj_next_face( file, start, end, positions, texcoords, normals, tangents, faces, vertices, indices ) ) { }
+	mesh_end();
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 static void build_vertex_buffer_position( Buffer &buffer,
 	const List<VertexTuple> &vertices,
@@ -559,7 +736,7 @@ static void build_vertex_buffer_position( Buffer &buffer,
 	for( usize i = 0; i < vertices.count(); i++ )
 	{
 		const VertexTuple &vertex = vertices[i];
-		const float_v3 &position = positions[vertex.positionIndex - 1];
+		const float_v3 &position = positions[vertex.positionIndex];
 		buffer.write( VertexPosition
 			{
 				.position = position
@@ -576,8 +753,8 @@ static void build_vertex_buffer_position_uv( Buffer &buffer,
 	for( usize i = 0; i < vertices.count(); i++ )
 	{
 		const VertexTuple &vertex = vertices[i];
-		const float_v3 &position = positions[vertex.positionIndex - 1];
-		const float_v2 &texcoord = texcoords[vertex.texcoordIndex - 1];
+		const float_v3 &position = positions[vertex.positionIndex];
+		const float_v2 &texcoord = texcoords[vertex.texcoordIndex];
 		buffer.write( VertexPositionUV
 			{
 				.position = position,
@@ -599,8 +776,8 @@ static void build_vertex_buffer_position_normal( Buffer &buffer,
 	for( usize i = 0; i < vertices.count(); i++ )
 	{
 		const VertexTuple &vertex = vertices[i];
-		const float_v3 &position = positions[vertex.positionIndex - 1];
-		const float_v3 &normal = normals[vertex.normalIndex - 1];
+		const float_v3 &position = positions[vertex.positionIndex];
+		const float_v3 &normal = normals[vertex.normalIndex];
 		buffer.write( VertexPositionNormal
 			{
 				.position = position,
@@ -612,24 +789,25 @@ static void build_vertex_buffer_position_normal( Buffer &buffer,
 
 static void calculate_tangents( List<Tangents> &tangents,
 	const List<VertexTuple> &vertices,
-	const List<u32> &indices,
+	const u32 *indices, const usize indexCount,
 	const List<float_v3> &positions,
 	const List<float_v2> &texcoords )
 {
-	Assert( vertices.count() == indices.count() );
+	tangents.clear();
+	for( usize i = 0; i < vertices.count(); i++ ) { tangents.add( Tangents { } ); }
 
-	for( usize i = 0; i < indices.count(); i += 3 )
+	for( usize i = 0; i < indexCount; i += 3 )
 	{
 		const VertexTuple &v0 = vertices[indices[i + 0]];
 		const VertexTuple &v1 = vertices[indices[i + 1]];
 		const VertexTuple &v2 = vertices[indices[i + 2]];
 
-		const float_v3 &p0 = positions[v0.positionIndex - 1];
-		const float_v3 &p1 = positions[v1.positionIndex - 1];
-		const float_v3 &p2 = positions[v2.positionIndex - 1];
-		const float_v2 &w0 = texcoords[v0.texcoordIndex - 1];
-		const float_v2 &w1 = texcoords[v1.texcoordIndex - 1];
-		const float_v2 &w2 = texcoords[v2.texcoordIndex - 1];
+		const float_v3 &p0 = positions[v0.positionIndex];
+		const float_v3 &p1 = positions[v1.positionIndex];
+		const float_v3 &p2 = positions[v2.positionIndex];
+		const float_v2 &w0 = texcoords[v0.texcoordIndex];
+		const float_v2 &w1 = texcoords[v1.texcoordIndex];
+		const float_v2 &w2 = texcoords[v2.texcoordIndex];
 
 		float x1 = p1.x - p0.x;
 		float x2 = p2.x - p0.x;
@@ -659,16 +837,24 @@ static void calculate_tangents( List<Tangents> &tangents,
 			( s1 * z2 - s2 * z1 ) * r,
 		};
 
-		tangents[v0.tangentIndex - 1].sTangent += sdir;
-		tangents[v1.tangentIndex - 1].sTangent += sdir;
-		tangents[v2.tangentIndex - 1].sTangent += sdir;
-		tangents[v0.tangentIndex - 1].tTangent += tdir;
-		tangents[v1.tangentIndex - 1].tTangent += tdir;
-		tangents[v2.tangentIndex - 1].tTangent += tdir;
+		tangents[indices[i + 0]].sTangent += sdir;
+		tangents[indices[i + 1]].sTangent += sdir;
+		tangents[indices[i + 2]].sTangent += sdir;
+		tangents[indices[i + 0]].tTangent += tdir;
+		tangents[indices[i + 1]].tTangent += tdir;
+		tangents[indices[i + 2]].tTangent += tdir;
 	}
 }
 
 
+static float_v3 tangent_orthogonalize( const float_v3 &normal, const Tangents &tangentST, float &handedness )
+{
+	handedness = float_v3_dot( float_v3_cross( normal, tangentST.sTangent ), tangentST.tTangent ) < 0.0f ?
+		-1.0f : 1.0f;
+	return float_v3_normalize( tangentST.sTangent - normal * float_v3_dot( normal, tangentST.sTangent ) );
+}
+
+
 static void build_vertex_buffer_position_normal_uv( Buffer &buffer,
 	const List<VertexTuple> &vertices,
 	const List<float_v3> &positions,
@@ -678,9 +864,9 @@ static void build_vertex_buffer_position_normal_uv( Buffer &buffer,
 	for( usize i = 0; i < vertices.count(); i++ )
 	{
 		const VertexTuple &vertex = vertices[i];
-		const float_v3 &position = positions[vertex.positionIndex - 1];
-		const float_v3 &normal = normals[vertex.normalIndex - 1];
-		const float_v2 &texcoord = texcoords[vertex.texcoordIndex - 1];
+		const float_v3 &position = positions[vertex.positionIndex];
+		const float_v3 &normal = normals[vertex.normalIndex];
+		const float_v2 &texcoord = texcoords[vertex.texcoordIndex];
 		buffer.write( VertexPositionNormalUV
 			{
 				.position = position,
@@ -705,15 +891,11 @@ static void build_vertex_buffer_position_normal_tangent_uv( Buffer &buffer,
 	for( usize i = 0; i < vertices.count(); i++ )
 	{
 		const VertexTuple &vertex = vertices[i];
-		const float_v3 &position = positions[vertex.positionIndex - 1];
-		const float_v3 &normal = normals[vertex.normalIndex - 1];
-		const float_v2 &texcoord = texcoords[vertex.texcoordIndex - 1];
-		const Tangents &tangentST = tangents[vertex.tangentIndex - 1];
-
-		const float_v3 tangent = float_v3_normalize(
-			tangentST.sTangent - normal * float_v3_dot( normal, tangentST.sTangent ) );
-		const float handedness = float_v3_dot( float_v3_cross( normal, tangentST.sTangent ), tangentST.tTangent ) < 0.0f ?
-			-1.0f : 1.0f;
+		const float_v3 &position = positions[vertex.positionIndex];
+		const float_v3 &normal = normals[vertex.normalIndex];
+		const float_v2 &texcoord = texcoords[vertex.texcoordIndex];
+		float handedness;
+		const float_v3 tangent = tangent_orthogonalize( normal, tangents[i], handedness );
 
 		buffer.write( VertexPositionNormalTangentUV
 			{
@@ -730,137 +912,383 @@ static void build_vertex_buffer_position_normal_tangent_uv( Buffer &buffer,
 }
 
 
-bool Model::load_from_obj()
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+struct PackedBounds
 {
-	static char pathDirectory[PATH_SIZE];
-	path_get_directory( pathDirectory, sizeof( pathDirectory ), path );
+	PackedBounds( const float_v3 &boundsMin, const float_v3 &boundsMax ) : offset { boundsMin }
+	{
+		// Degenerate axes (flat meshes) quantize to 0
+		const float_v3 extent = boundsMax - boundsMin;
+		scale.x = extent.x > 0.0f ? U16_MAX / extent.x : 0.0f;
+		scale.y = extent.y > 0.0f ? U16_MAX / extent.y : 0.0f;
+		scale.z = extent.z > 0.0f ? U16_MAX / extent.z : 0.0f;
+	}
+
+	float_v3 offset;
+	float_v3 scale;
+};
+
 
+static u16 pack_unorm16( const float value )
+{
+	return static_cast<u16>( clamp( value, 0.0f, static_cast<float>( U16_MAX ) ) + 0.5f );
+}
+
+
+static i16 pack_snorm16( const float value )
+{
+	const float scaled = clamp( value, -1.0f, 1.0f ) * 32767.0f;
+	return static_cast<i16>( scaled >= 0.0f ? scaled + 0.5f : scaled - 0.5f );
+}
+
+
+static u16_v4 pack_position( const float_v3 &position, const PackedBounds &bounds, const float handedness = 1.0f )
+{
+	return u16_v4
+		{
+			pack_unorm16( ( position.x - bounds.offset.x ) * bounds.scale.x ),
+			pack_unorm16( ( position.y - bounds.offset.y ) * bounds.scale.y ),
+			pack_unorm16( ( position.z - bounds.offset.z ) * bounds.scale.z ),
+			static_cast<u16>( handedness < 0.0f ? 0 : U16_MAX ),
+		};
+}
+
+
+static i16_v2 pack_octahedral( const float_v3 &direction )
+{
+	// Project onto the octahedron |x| + |y| + |z| = 1, then fold the lower hemisphere over the upper one
+	const float length = fabsf( direction.x ) + fabsf( direction.y ) + fabsf( direction.z );
+	if( !( length > 0.0f ) ) { return i16_v2 { 0, 0 }; }
+
+	float x = direction.x / length;
+	float y = direction.y / length;
+	if( direction.z < 0.0f )
+	{
+		const float foldX = ( 1.0f - fabsf( y ) ) * ( x >= 0.0f ? 1.0f : -1.0f );
+		const float foldY = ( 1.0f - fabsf( x ) ) * ( y >= 0.0f ? 1.0f : -1.0f );
+		x = foldX;
+		y = foldY;
+	}
+
+	return i16_v2 { pack_snorm16( x ), pack_snorm16( y ) };
+}
+
+
+static u16_v2 pack_uv( const float_v2 &texcoord )
+{
+	return u16_v2 { float_to_half( texcoord.x ), float_to_half( 1.0f - texcoord.y ) };
+}
+
+
+static void build_vertex_buffer_position_packed( Buffer &buffer,
+	const List<VertexTuple> &vertices,
+	const List<float_v3> &positions,
+	const PackedBounds &bounds )
+{
+	for( usize i = 0; i < vertices.count(); i++ )
+	{
+		const VertexTuple &vertex = vertices[i];
+		buffer.write( VertexPositionPacked
+			{
+				.position = pack_position( positions[vertex.positionIndex], bounds ),
+			} );
+	}
+}
+
+
+static void build_vertex_buffer_position_uv_packed( Buffer &buffer,
+	const List<VertexTuple> &vertices,
+	const List<float_v3> &positions,
+	const List<float_v2> &texcoords,
+	const PackedBounds &bounds )
+{
+	for( usize i = 0; i < vertices.count(); i++ )
+	{
+		const VertexTuple &vertex = vertices[i];
+		buffer.write( VertexPositionUVPacked
+			{
+				.position = pack_position( positions[vertex.positionIndex], bounds ),
+				.uv = pack_uv( texcoords[vertex.texcoordIndex] ),
+			} );
+	}
+}
+
+
+static void build_vertex_buffer_position_normal_packed( Buffer &buffer,
+	const List<VertexTuple> &vertices,
+	const List<float_v3> &positions,
+	const List<float_v3> &normals,
+	const PackedBounds &bounds )
+{
+	for( usize i = 0; i < vertices.count(); i++ )
+	{
+		const VertexTuple &vertex = vertices[i];
+		buffer.write( VertexPositionNormalPacked
+			{
+				.position = pack_position( positions[vertex.positionIndex], bounds ),
+				.normal = pack_octahedral( normals[vertex.normalIndex] ),
+			} );
+	}
+}
+
+
+static void build_vertex_buffer_position_normal_uv_packed( Buffer &buffer,
+	const List<VertexTuple> &vertices,
+	const List<float_v3> &positions,
+	const List<float_v3> &normals,
+	const List<float_v2> &texcoords,
+	const PackedBounds &bounds )
+{
+	for( usize i = 0; i < vertices.count(); i++ )
+	{
+		const VertexTuple &vertex = vertices[i];
+		buffer.write( VertexPositionNormalUVPacked
+			{
+				.position = pack_position( positions[vertex.positionIndex], bounds ),
+				.normal = pack_octahedral( normals[vertex.normalIndex] ),
+				.uv = pack_uv( texcoords[vertex.texcoordIndex] ),
+			} );
+	}
+}
+
+
+static void build_vertex_buffer_position_normal_tangent_uv_packed( Buffer &buffer,
+	const List<VertexTuple> &vertices,
+	const List<float_v3> &positions,
+	const List<float_v3> &normals,
+	const List<Tangents> &tangents,
+	const List<float_v2> &texcoords,
+	const PackedBounds &bounds )
+{
+	for( usize i = 0; i < vertices.count(); i++ )
+	{
+		const VertexTuple &vertex = vertices[i];
+		const float_v3 &normal = normals[vertex.normalIndex];
+
+		float handedness;
+		const float_v3 tangent = tangent_orthogonalize( normal, tangents[i], handedness );
+
+		buffer.write( VertexPositionNormalTangentUVPacked
+			{
+				.position = pack_position( positions[vertex.positionIndex], bounds, handedness ),
+				.normal = pack_octahedral( normal ),
+				.tangent = pack_octahedral( tangent ),
+				.uv = pack_uv( texcoords[vertex.texcoordIndex] ),
+			} );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Model::load_from_obj()
+{
 	// Load Model File
 	String obj;
 	if( !obj.load( path ) ) { return false; }
 
-	// Parse Data
+	// Parse
 	static List<float_v3> positions;
 	static List<float_v2> texcoords;
 	static List<float_v3> normals;
-	static List<Tangents> tangents;
+	static List<VertexTuple> vertices;
+	static List<u32> indices;
+	static List<ObjMesh> objMeshes;
+	static ObjVertexTable table;
 
 	positions.clear();
 	texcoords.clear();
 	normals.clear();
-	tangents.clear();
-	obj_parse_vertex_positions( obj, positions );
-	obj_parse_vertex_texcoords( obj, texcoords );
-	obj_parse_vertex_normals( obj, normals );
-
-	// Parse Faces
-	static HashMap<u64, u32> faces;
-	static List<VertexTuple> vertices;
-	static List<u32> indices;
-
-	usize offsetFirstFace = obj.find( "f ", 0LLU, USIZE_MAX );
-	usize offsetFirstUseMTL = obj.find( "usemtl ", 0LLU, USIZE_MAX );
-	usize offsetCurrent = min( offsetFirstFace, offsetFirstUseMTL );
-	u32 meshIndex = 0;
+	vertices.clear();
+	indices.clear();
+	objMeshes.clear();
+	obj_parse( obj, positions, texcoords, normals, vertices, indices, objMeshes, table );
+
+	// Vertex format attributes
+	const bool needsTexcoords = formatVertex == Assets::MeshFormatTypeVertex_PositionUV ||
+		formatVertex == Assets::MeshFormatTypeVertex_PositionNormalUV ||
+		formatVertex == Assets::MeshFormatTypeVertex_PositionNormalTangentUV ||
+		formatVertex == Assets::MeshFormatTypeVertex_PositionUVPacked ||
+		formatVertex == Assets::MeshFormatTypeVertex_PositionNormalUVPacked ||
+		formatVertex == Assets::MeshFormatTypeVertex_PositionNormalTangentUVPacked;
+	const bool needsNormals = formatVertex == Assets::MeshFormatTypeVertex_PositionNormal ||
+		formatVertex == Assets::MeshFormatTypeVertex_PositionNormalUV ||
+		formatVertex == Assets::MeshFormatTypeVertex_PositionNormalTangentUV ||
+		formatVertex == Assets::MeshFormatTypeVertex_PositionNormalPacked ||
+		formatVertex == Assets::MeshFormatTypeVertex_PositionNormalUVPacked ||
+		formatVertex == Assets::MeshFormatTypeVertex_PositionNormalTangentUVPacked;
 
 	this->x1 = FLOAT_MAX;
 	this->y1 = FLOAT_MAX;
 	this->z1 = FLOAT_MAX;
-	this->x2 = FLOAT_MIN;
-	this->y2 = FLOAT_MIN;
-	this->z2 = FLOAT_MIN;
+	this->x2 = -FLOAT_MAX;
+	this->y2 = -FLOAT_MAX;
+	this->z2 = -FLOAT_MAX;
+	this->triangleCount = 0;
+	this->vertexCount = 0;
+
+	double missesBefore = 0.0;
+	double missesAfter = 0.0;
+	u32 meshIndex = 0;
+
+	static List<VertexTuple> meshVertices;
+	static List<Tangents> tangents;
+	static List<u32> remap;
 
-	for( ;; )
+	for( const ObjMesh &objMesh : objMeshes )
 	{
-		// Nothing left to parse, we're done
-		if( offsetCurrent == USIZE_MAX ) { break; }
+		ErrorIf( meshIndex >= MODEL_MESH_COUNT_MAX, "Model '%s' exceeds %u meshes (one per 'usemtl')",
+			this->name.cstr(), MODEL_MESH_COUNT_MAX );
 
-		// Note: Models are broken up into meshes based on materials
-		const usize offsetNext = obj.find( "usemtl ", offsetCurrent + 1, USIZE_MAX );
-		faces.clear();
-		vertices.clear();
-		indices.clear();
-		obj_parse_mesh_faces( obj, offsetCurrent, offsetNext,
-			positions, texcoords, normals, tangents, faces, vertices, indices );
+		// Validate
+		const VertexTuple *tuples = &vertices[objMesh.vertexStart];
+		for( u32 i = 0; i < objMesh.vertexCount; i++ )
+		{
+			const VertexTuple &tuple = tuples[i];
+			ErrorIf( tuple.positionIndex >= positions.count(), "Model '%s' references invalid vertex position %u",
+				this->name.cstr(), tuple.positionIndex + 1 );
+			ErrorIf( needsTexcoords && tuple.texcoordIndex >= texcoords.count(),
+				"Model '%s' vertex format %s requires texture coordinates ('vt') on every face vertex",
+				this->name.cstr(), Assets::MeshFormatTypeVertexNames[formatVertex] );
+			ErrorIf( needsNormals && tuple.normalIndex >= normals.count(),
+				"Model '%s' vertex format %s requires normals ('vn') on every face vertex",
+				this->name.cstr(), Assets::MeshFormatTypeVertexNames[formatVertex] );
+		}
 
 		// Parse Material (usemtl )
 		u32 skinSlotIndex = U32_MAX;
-		if( skinID != U32_MAX )
+		if( skinID != U32_MAX && objMesh.material != nullptr )
 		{
-			String materialName;
-			usize materialNameOffset = try_find_next_key( obj, offsetCurrent, offsetNext, "usemtl " );
-			if( materialNameOffset != USIZE_MAX && next_line( obj, materialNameOffset, materialName ) )
-			{
-				const u32 materialKey = Hash::hash( materialName );
-				ErrorIf( !Assets::skins[skinID].contains_material( materialKey ),
-					"Model '%s' references undefined material '%s'",
-					this->name.cstr(), materialName.cstr() );
-				skinSlotIndex = Assets::skins[skinID].get_material_slot( materialKey );
-			}
+			const u32 materialKey = Hash::hash( objMesh.material, static_cast<int>( objMesh.materialLength ) );
+			ErrorIf( !Assets::skins[skinID].contains_material( materialKey ),
+				"Model '%s' references undefined material '%.*s'",
+				this->name.cstr(), static_cast<int>( objMesh.materialLength ), objMesh.material );
+			skinSlotIndex = Assets::skins[skinID].get_material_slot( materialKey );
+		}
+
+		// Optimize: vertex cache (triangle order), then vertex fetch (vertex order)
+		u32 *meshIndices = &indices[objMesh.indexStart];
+		const u32 meshTriangles = objMesh.indexCount / 3;
+		missesBefore += mesh_acmr( meshIndices, objMesh.indexCount, objMesh.vertexCount ) * meshTriangles;
+		mesh_optimize_vertex_cache( meshIndices, objMesh.indexCount, objMesh.vertexCount );
+
+		remap.clear();
+		for( u32 i = 0; i < objMesh.vertexCount; i++ ) { remap.add( 0 ); }
+		const u32 meshVertexCount = mesh_optimize_vertex_fetch( meshIndices, objMesh.indexCount,
+			objMesh.vertexCount, remap.data );
+		missesAfter += mesh_acmr( meshIndices, objMesh.indexCount, meshVertexCount ) * meshTriangles;
+
+		meshVertices.clear();
+		for( u32 i = 0; i < meshVertexCount; i++ ) { meshVertices.add( VertexTuple { } ); }
+		for( u32 i = 0; i < objMesh.vertexCount; i++ )
+		{
+			if( remap[i] != U32_MAX ) { meshVertices[remap[i]] = tuples[i]; }
 		}
 
+		this->triangleCount += meshTriangles;
+		this->vertexCount += meshVertexCount;
+
 		// Model AABB Min/Max
 		float meshX1 = FLOAT_MAX;
 		float meshY1 = FLOAT_MAX;
 		float meshZ1 = FLOAT_MAX;
-		float meshX2 = FLOAT_MIN;
-		float meshY2 = FLOAT_MIN;
-		float meshZ2 = FLOAT_MIN;
-		for( usize i = 0; i < vertices.count(); i++ )
+		float meshX2 = -FLOAT_MAX;
+		float meshY2 = -FLOAT_MAX;
+		float meshZ2 = -FLOAT_MAX;
+		for( const VertexTuple &vertex : meshVertices )
 		{
-			const VertexTuple &vertex = vertices[i];
-			const float_v3 &position = positions[vertex.positionIndex - 1];
+			const float_v3 &position = positions[vertex.positionIndex];
 			meshX1 = min( position.x, meshX1 );
-			this->x1 = min( this->x1, meshX1 );
 			meshY1 = min( position.y, meshY1 );
-			this->y1 = min( this->y1, meshY1 );
 			meshZ1 = min( position.z, meshZ1 );
-			this->z1 = min( this->z1, meshZ1 );
 			meshX2 = max( position.x, meshX2 );
-			this->x2 = max( this->x2, meshX2 );
 			meshY2 = max( position.y, meshY2 );
-			this->y2 = max( this->y2, meshY2 );
 			meshZ2 = max( position.z, meshZ2 );
-			this->z2 = max( this->z2, meshZ2 );
 		}
+		this->x1 = min( this->x1, meshX1 );
+		this->y1 = min( this->y1, meshY1 );
+		this->z1 = min( this->z1, meshZ1 );
+		this->x2 = max( this->x2, meshX2 );
+		this->y2 = max( this->y2, meshY2 );
+		this->z2 = max( this->z2, meshZ2 );
 
 		// Build Vertex Buffer
+		const PackedBounds bounds { float_v3 { meshX1, meshY1, meshZ1 }, float_v3 { meshX2, meshY2, meshZ2 } };
 		Buffer vertexBuffer;
 		switch( this->formatVertex )
 		{
 			case Assets::MeshFormatTypeVertex_Position:
-				build_vertex_buffer_position( vertexBuffer, vertices, positions );
+				build_vertex_buffer_position( vertexBuffer, meshVertices, positions );
 			break;
 
 			case Assets::MeshFormatTypeVertex_PositionUV:
-				build_vertex_buffer_position_uv( vertexBuffer, vertices, positions, texcoords );
+				build_vertex_buffer_position_uv( vertexBuffer, meshVertices, positions, texcoords );
 			break;
 
 			case Assets::MeshFormatTypeVertex_PositionNormal:
-				build_vertex_buffer_position_normal( vertexBuffer, vertices, positions, normals );
+				build_vertex_buffer_position_normal( vertexBuffer, meshVertices, positions, normals );
 			break;
 
 			case Assets::MeshFormatTypeVertex_PositionNormalUV:
-				build_vertex_buffer_position_normal_uv( vertexBuffer, vertices, positions, normals, texcoords );
+				build_vertex_buffer_position_normal_uv( vertexBuffer, meshVertices, positions, normals, texcoords );
 			break;
 
 			case Assets::MeshFormatTypeVertex_PositionNormalTangentUV:
-				calculate_tangents( tangents, vertices, indices, positions, texcoords );
-				build_vertex_buffer_position_normal_tangent_uv( vertexBuffer, vertices, positions, normals, tangents, texcoords );
+				calculate_tangents( tangents, meshVertices, meshIndices, objMesh.indexCount, positions, texcoords );
+				build_vertex_buffer_position_normal_tangent_uv( vertexBuffer, meshVertices, positions, normals,
+					tangents, texcoords );
 			break;
+
+			case Assets::MeshFormatTypeVertex_PositionPacked:
+				build_vertex_buffer_position_packed( vertexBuffer, meshVertices, positions, bounds );
+			break;
+
+			case Assets::MeshFormatTypeVertex_PositionUVPacked:
+				build_vertex_buffer_position_uv_packed( vertexBuffer, meshVertices, positions, texcoords, bounds );
+			break;
+
+			case Assets::MeshFormatTypeVertex_PositionNormalPacked:
+				build_vertex_buffer_position_normal_packed( vertexBuffer, meshVertices, positions, normals, bounds );
+			break;
+
+			case Assets::MeshFormatTypeVertex_PositionNormalUVPacked:
+				build_vertex_buffer_position_normal_uv_packed( vertexBuffer, meshVertices, positions, normals,
+					texcoords, bounds );
+			break;
+
+			case Assets::MeshFormatTypeVertex_PositionNormalTangentUVPacked:
+				calculate_tangents( tangents, meshVertices, meshIndices, objMesh.indexCount, positions, texcoords );
+				build_vertex_buffer_position_normal_tangent_uv_packed( vertexBuffer, meshVertices, positions, normals,
+					tangents, texcoords, bounds );
+			break;
+		}
+
+		// Build Index Buffer (16-bit when every index fits)
+		Buffer indexBuffer;
+		const bool indices16 = meshVertexCount <= U16_MAX + 1;
+		if( indices16 )
+		{
+			for( u32 i = 0; i < objMesh.indexCount; i++ ) { indexBuffer.write( static_cast<u16>( meshIndices[i] ) ); }
+		}
+		else
+		{
+			indexBuffer.write( meshIndices, objMesh.indexCount * sizeof( u32 ) );
 		}
 
 		const CacheKey cacheKeyMesh = Hash::hash32_from( this->cacheKey, meshIndex );
 		const MeshID meshID = Assets::meshes.register_new( cacheKeyMesh,
 			this->formatVertex, vertexBuffer.data, vertexBuffer.size(),
-			Assets::MeshFormatTypeIndex_U32, indices.data, indices.count() * sizeof( u32 ),
+			indices16 ? Assets::MeshFormatTypeIndex_U16 : Assets::MeshFormatTypeIndex_U32,
+			indexBuffer.data, indexBuffer.size(),
 			meshX1, meshY1, meshZ1, meshX2, meshY2, meshZ2, skinSlotIndex );
 		this->meshes.add( meshID );
 
-		offsetCurrent = offsetNext;
 		meshIndex++;
 	}
 
+	this->acmrBefore = this->triangleCount > 0 ? missesBefore / this->triangleCount : 0.0;
+	this->acmrAfter = this->triangleCount > 0 ? missesAfter / this->triangleCount : 0.0;
+
 	return true;
 }
 
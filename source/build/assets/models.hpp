@@ -33,6 +33,12 @@ public:
 	SkinID skinID;
 	String name;
 	String path;
+
+	// Build statistics (load_from_obj)
+	u32 triangleCount = 0;
+	u32 vertexCount = 0;
+	double acmrBefore = 0.0;
+	double acmrAfter = 0.0;
 };
 
 using ModelID = u32;
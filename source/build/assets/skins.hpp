@@ -2,7 +2,7 @@
 
 #include <core/types.hpp>
 #include <core/list.hpp>
-#include <core/hashmap.hpp>
+#include <core/flathashmap.hpp>
 #include <core/buffer.hpp>
 #include <core/string.hpp>
 
@@ -22,7 +22,7 @@ public:
 
 public:
 	List<MaterialID> materials;
-	HashMap<u32, u32> materialKeyToSkinSlotIndex;
+	FlatHashMap<u32, u32> materialKeyToSkinSlotIndex;
 
 	String name;
 	String path;
@@ -77,6 +77,12 @@ SpriteID Sprites::register_new_from_definition( String name, const char *path )
 		"Sprite '%s' has an invalid atlas (must not be null)", fileDefinition.name );
 	atlasName.insert( 0, "atlas_" );
 
+	Assets::TextureColorFormat atlasFormat;
+	String compression = fileDefinitionJSON.get_string( "compression", "none" );
+	ErrorIf( !texture_compression_format( compression.cstr(), atlasFormat ),
+		"Sprite '%s' has an invalid compression: '%s' (none, bc1, bc3, bc4, bc5, bc7)",
+		fileDefinition.name, compression.cstr() );
+
 	int imageWidth = 0;
 	int imageHeight = 0;
 	int imageChannels = 0;
@@ -129,6 +135,16 @@ SpriteID Sprites::register_new_from_definition( String name, const char *path )
 	sprite.textureID = Assets::textures.register_new( atlasName );
 	sprite.glyphID = GLYPHID_MAX;
 
+	// Atlas Compression (any sprite in the atlas may request it)
+	if( atlasFormat != Assets::TextureColorFormat_R8G8B8A8 )
+	{
+		Texture &texture = Assets::textures[sprite.textureID];
+		ErrorIf( texture.format != Assets::TextureColorFormat_R8G8B8A8 && texture.format != atlasFormat,
+			"Sprite '%s' requests compression '%s' but atlas '%s' is already compressed with a different format",
+			fileDefinition.name, compression.cstr(), texture.name.cstr() );
+		texture.format = atlasFormat;
+	}
+
 	// Split sprite into individual glyphs
 	for( u16 i = 0; i < sprite.count; i++ )
 	{
@@ -2,10 +2,15 @@
 
 #include <vendor/math.hpp>
 #include <vendor/stb/stb_image.hpp>
+#include <vendor/simd.hpp>
+#include <vendor/string.hpp>
 
 #include <core/list.hpp>
+#include <core/flathashmap.hpp>
+#include <core/math.hpp>
 #include <core/json.hpp>
 #include <core/checksum.hpp>
+#include <core/bcn.hpp>
 
 #include <build/build.hpp>
 #include <build/assets.hpp>
@@ -21,6 +26,9 @@ struct CacheTextureEntry
 };
 
 
+// Bump when the texture binary output changes (invalidates cached textures)
+#define TEXTURE_CACHE_VERSION ( 1 )
+
 struct CacheTextureBinary
 {
 	int width;
@@ -29,13 +37,14 @@ struct CacheTextureBinary
 	int levels;
 	usize offset;
 	usize size;
+	Assets::TextureColorFormat format;
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 static Texture2DBuffer resourceNull;
 static List<Texture2DBuffer> resourceList;
-static HashMap<u32, usize> resourceMap;
+static FlatHashMap<u32, usize> resourceMap;
 
 Texture2DBuffer &texture_load_file( const char *path )
 {
@@ -141,8 +150,312 @@ static usize mip_buffer_size_2d( u16 width, u16 height, u16 levels,
 }
 
 
+// Mip kernels reduce the 2x2 texel blocks of two source rows into one destination row. mip_kernel() resolves the
+// format once per level, and levels with enough texels are split into bands of rows across threads
+
+#define MIP_PARALLEL_TEXELS ( 128 * 128 ) // Destination texels before a level is split across threads
+#define MIP_PARALLEL_BAND_ROWS ( 32 ) // Destination rows per parallel_for() task
+
+using MipKernel = void ( * )( const byte *row0, const byte *row1, byte *out, const u16 mipWidth );
+
+
+template <int CHANNELS> static void mip_kernel_u8( const byte *row0, const byte *row1, byte *out,
+	const u16 mipWidth )
+{
+	for( u32 x = 0; x < mipWidth; x++ )
+	{
+		const u8 *p00 = row0 + ( x * 2 + 0 ) * CHANNELS;
+		const u8 *p10 = row0 + ( x * 2 + 1 ) * CHANNELS;
+		const u8 *p01 = row1 + ( x * 2 + 0 ) * CHANNELS;
+		const u8 *p11 = row1 + ( x * 2 + 1 ) * CHANNELS;
+		for( int c = 0; c < CHANNELS; c++ )
+		{
+			out[x * CHANNELS + c] = static_cast<u8>( ( p00[c] + p10[c] + p01[c] + p11[c] ) / 4 );
+		}
+	}
+}
+
+
+static void mip_kernel_rgba8( const byte *row0, const byte *row1, byte *out, const u16 mipWidth )
+{
+	u32 x = 0;
+
+#if SIMD_SSE2
+	// 8 source texels -> 4 destination texels (16-bit sums, so results match the scalar path exactly)
+	const __m128i zero = _mm_setzero_si128();
+	for( ; x + 4 <= mipWidth; x += 4 )
+	{
+		__m128i result[2];
+		for( int i = 0; i < 2; i++ )
+		{
+			const __m128i a = _mm_loadu_si128( reinterpret_cast<const __m128i *>( row0 + x * 8 + i * 16 ) );
+			const __m128i b = _mm_loadu_si128( reinterpret_cast<const __m128i *>( row1 + x * 8 + i * 16 ) );
+			const __m128i lo = _mm_add_epi16( _mm_unpacklo_epi8( a, zero ), _mm_unpacklo_epi8( b, zero ) );
+			const __m128i hi = _mm_add_epi16( _mm_unpackhi_epi8( a, zero ), _mm_unpackhi_epi8( b, zero ) );
+			const __m128i sum = _mm_add_epi16( _mm_unpacklo_epi64( lo, hi ), _mm_unpackhi_epi64( lo, hi ) );
+			result[i] = _mm_srli_epi16( sum, 2 );
+		}
+		_mm_storeu_si128( reinterpret_cast<__m128i *>( out + x * 4 ), _mm_packus_epi16( result[0], result[1] ) );
+	}
+#elif SIMD_NEON
+	for( ; x + 4 <= mipWidth; x += 4 )
+	{
+		uint8x8_t result[2];
+		for( int i = 0; i < 2; i++ )
+		{
+			const uint8x16_t a = vld1q_u8( row0 + x * 8 + i * 16 );
+			const uint8x16_t b = vld1q_u8( row1 + x * 8 + i * 16 );
+			const uint16x8_t lo = vaddl_u8( vget_low_u8( a ), vget_low_u8( b ) );
+			const uint16x8_t hi = vaddl_u8( vget_high_u8( a ), vget_high_u8( b ) );
+			const uint16x8_t sum = vcombine_u16( vadd_u16( vget_low_u16( lo ), vget_high_u16( lo ) ),
+				vadd_u16( vget_low_u16( hi ), vget_high_u16( hi ) ) );
+			result[i] = vshrn_n_u16( sum, 2 );
+		}
+		vst1q_u8( out + x * 4, vcombine_u8( result[0], result[1] ) );
+	}
+#endif
+
+	mip_kernel_u8<4>( row0 + x * 8, row1 + x * 8, out + x * 4, static_cast<u16>( mipWidth - x ) );
+}
+
+
+// sRGB-encoded color is filtered in linear space: 8-bit sRGB -> linear float, and 12-bit linear -> 8-bit sRGB
+#define MIP_SRGB_LINEAR_STEPS ( 4096 )
+static float mipSRGBToLinear[256];
+static u8 mipLinearToSRGB[MIP_SRGB_LINEAR_STEPS];
+
+static void mip_srgb_tables_init()
+{
+	static bool initialized = false;
+	if( initialized ) { return; }
+
+	for( int i = 0; i < 256; i++ )
+	{
+		mipSRGBToLinear[i] = color_value_srgb_to_linear( i / 255.0f );
+	}
+
+	for( int i = 0; i < MIP_SRGB_LINEAR_STEPS; i++ )
+	{
+		const float srgb = color_value_linear_to_srgb( i / static_cast<float>( MIP_SRGB_LINEAR_STEPS - 1 ) );
+		mipLinearToSRGB[i] = static_cast<u8>( srgb * 255.0f + 0.5f );
+	}
+
+	initialized = true;
+}
+
+
+static void mip_kernel_rgba8_srgb( const byte *row0, const byte *row1, byte *out, const u16 mipWidth )
+{
+	constexpr float scale = 0.25f * ( MIP_SRGB_LINEAR_STEPS - 1 );
+
+	for( u32 x = 0; x < mipWidth; x++ )
+	{
+		const u8 *p00 = row0 + x * 8;
+		const u8 *p10 = row0 + x * 8 + 4;
+		const u8 *p01 = row1 + x * 8;
+		const u8 *p11 = row1 + x * 8 + 4;
+		for( int c = 0; c < 3; c++ )
+		{
+			const float linear = mipSRGBToLinear[p00[c]] + mipSRGBToLinear[p10[c]] +
+				mipSRGBToLinear[p01[c]] + mipSRGBToLinear[p11[c]];
+			out[x * 4 + c] = mipLinearToSRGB[static_cast<u32>( linear * scale + 0.5f )];
+		}
+
+		// Alpha is linear
+		out[x * 4 + 3] = static_cast<u8>( ( p00[3] + p10[3] + p01[3] + p11[3] ) / 4 );
+	}
+}
+
+
+template <int CHANNELS> static void mip_kernel_u16( const byte *row0, const byte *row1, byte *out,
+	const u16 mipWidth )
+{
+	const u16 *s0 = reinterpret_cast<const u16 *>( row0 );
+	const u16 *s1 = reinterpret_cast<const u16 *>( row1 );
+	u16 *o = reinterpret_cast<u16 *>( out );
+
+	for( u32 x = 0; x < mipWidth; x++ )
+	{
+		for( int c = 0; c < CHANNELS; c++ )
+		{
+			const u32 sum = static_cast<u32>( s0[( x * 2 + 0 ) * CHANNELS + c] ) + s0[( x * 2 + 1 ) * CHANNELS + c] +
+				s1[( x * 2 + 0 ) * CHANNELS + c] + s1[( x * 2 + 1 ) * CHANNELS + c];
+			o[x * CHANNELS + c] = static_cast<u16>( sum / 4 );
+		}
+	}
+}
+
+
+// float16 -> float32 for every half (decoding through the table avoids the branches in the filter loop)
+static float mipHalfToFloat[U16_MAX + 1];
+
+static void mip_half_table_init()
+{
+	static bool initialized = false;
+	if( initialized ) { return; }
+
+	for( u32 half = 0; half <= U16_MAX; half++ )
+	{
+		mipHalfToFloat[half] = half_to_float( static_cast<u16>( half ) );
+	}
+
+	initialized = true;
+}
+
+
+template <int CHANNELS> static void mip_kernel_f16( const byte *row0, const byte *row1, byte *out,
+	const u16 mipWidth )
+{
+	const u16 *s0 = reinterpret_cast<const u16 *>( row0 );
+	const u16 *s1 = reinterpret_cast<const u16 *>( row1 );
+	u16 *o = reinterpret_cast<u16 *>( out );
+
+	for( u32 x = 0; x < mipWidth; x++ )
+	{
+		for( int c = 0; c < CHANNELS; c++ )
+		{
+			const float sum = mipHalfToFloat[s0[( x * 2 + 0 ) * CHANNELS + c]] +
+				mipHalfToFloat[s0[( x * 2 + 1 ) * CHANNELS + c]] +
+				mipHalfToFloat[s1[( x * 2 + 0 ) * CHANNELS + c]] +
+				mipHalfToFloat[s1[( x * 2 + 1 ) * CHANNELS + c]];
+			o[x * CHANNELS + c] = float_to_half( sum * 0.25f );
+		}
+	}
+}
+
+
+template <int CHANNELS> static void mip_kernel_f32( const byte *row0, const byte *row1, byte *out,
+	const u16 mipWidth )
+{
+	const float *s0 = reinterpret_cast<const float *>( row0 );
+	const float *s1 = reinterpret_cast<const float *>( row1 );
+	float *o = reinterpret_cast<float *>( out );
+	u32 x = 0;
+
+	if constexpr ( CHANNELS == 4 )
+	{
+	#if SIMD_SSE2
+		const __m128 quarter = _mm_set1_ps( 0.25f );
+		for( ; x < mipWidth; x++ )
+		{
+			const __m128 sum = _mm_add_ps( _mm_add_ps( _mm_add_ps( _mm_loadu_ps( s0 + x * 8 ),
+				_mm_loadu_ps( s0 + x * 8 + 4 ) ), _mm_loadu_ps( s1 + x * 8 ) ), _mm_loadu_ps( s1 + x * 8 + 4 ) );
+			_mm_storeu_ps( o + x * 4, _mm_mul_ps( sum, quarter ) );
+		}
+	#elif SIMD_NEON
+		for( ; x < mipWidth; x++ )
+		{
+			const float32x4_t sum = vaddq_f32( vaddq_f32( vaddq_f32( vld1q_f32( s0 + x * 8 ),
+				vld1q_f32( s0 + x * 8 + 4 ) ), vld1q_f32( s1 + x * 8 ) ), vld1q_f32( s1 + x * 8 + 4 ) );
+			vst1q_f32( o + x * 4, vmulq_n_f32( sum, 0.25f ) );
+		}
+	#endif
+	}
+
+	for( ; x < mipWidth; x++ )
+	{
+		for( int c = 0; c < CHANNELS; c++ )
+		{
+			o[x * CHANNELS + c] = ( s0[( x * 2 + 0 ) * CHANNELS + c] + s0[( x * 2 + 1 ) * CHANNELS + c] +
+				s1[( x * 2 + 0 ) * CHANNELS + c] + s1[( x * 2 + 1 ) * CHANNELS + c] ) * 0.25f;
+		}
+	}
+}
+
+
+static void mip_kernel_rgba32_uint( const byte *row0, const byte *row1, byte *out, const u16 mipWidth )
+{
+	const u32 *s0 = reinterpret_cast<const u32 *>( row0 );
+	const u32 *s1 = reinterpret_cast<const u32 *>( row1 );
+	u32 *o = reinterpret_cast<u32 *>( out );
+
+	for( u32 x = 0; x < mipWidth; x++ )
+	{
+		for( int c = 0; c < 4; c++ )
+		{
+			const u64 sum = static_cast<u64>( s0[x * 8 + c] ) + s0[x * 8 + 4 + c] + s1[x * 8 + c] + s1[x * 8 + 4 + c];
+			o[x * 4 + c] = static_cast<u32>( sum >> 2 );
+		}
+	}
+}
+
+
+static void mip_kernel_rgb10a2( const byte *row0, const byte *row1, byte *out, const u16 mipWidth )
+{
+	const u32 *s0 = reinterpret_cast<const u32 *>( row0 );
+	const u32 *s1 = reinterpret_cast<const u32 *>( row1 );
+	u32 *o = reinterpret_cast<u32 *>( out );
+
+	for( u32 x = 0; x < mipWidth; x++ )
+	{
+		const u32 p00 = s0[x * 2 + 0];
+		const u32 p10 = s0[x * 2 + 1];
+		const u32 p01 = s1[x * 2 + 0];
+		const u32 p11 = s1[x * 2 + 1];
+
+		// Sum the even (R, B) and odd (G, A) fields in separate words so they can't carry into each other
+		constexpr u32 maskEven = 0x3FF | ( 0x3FF << 20 );
+		constexpr u32 maskOdd = ( 0x3FF << 10 ) | ( 0x3U << 30 );
+		const u32 even = ( p00 & maskEven ) + ( p10 & maskEven ) + ( p01 & maskEven ) + ( p11 & maskEven );
+		const u64 odd = static_cast<u64>( p00 & maskOdd ) + ( p10 & maskOdd ) + ( p01 & maskOdd ) + ( p11 & maskOdd );
+		o[x] = ( ( even >> 2 ) & maskEven ) | ( static_cast<u32>( odd >> 2 ) & maskOdd );
+	}
+}
+
+
+static MipKernel mip_kernel( const GfxColorFormat format, const bool srgb )
+{
+	switch( format )
+	{
+		case GfxColorFormat_R8_UINT: return mip_kernel_u8<1>;
+		case GfxColorFormat_R8G8: return mip_kernel_u8<2>;
+		case GfxColorFormat_R8G8B8A8_UINT: return mip_kernel_rgba8;
+		case GfxColorFormat_R8G8B8A8_FLOAT: return srgb ? mip_kernel_rgba8_srgb : mip_kernel_rgba8;
+		case GfxColorFormat_R10G10B10A2_FLOAT: return mip_kernel_rgb10a2;
+		case GfxColorFormat_R16_UINT: return mip_kernel_u16<1>;
+		case GfxColorFormat_R16_FLOAT: return mip_kernel_f16<1>;
+		case GfxColorFormat_R16G16: return mip_kernel_u16<2>;
+		case GfxColorFormat_R16G16F_FLOAT: return mip_kernel_f16<2>;
+		case GfxColorFormat_R16G16B16A16_FLOAT: return mip_kernel_f16<4>;
+		case GfxColorFormat_R16G16B16A16_UINT: return mip_kernel_u16<4>;
+		case GfxColorFormat_R32_FLOAT: return mip_kernel_f32<1>;
+		case GfxColorFormat_R32G32_FLOAT: return mip_kernel_f32<2>;
+		case GfxColorFormat_R32G32B32A32_FLOAT: return mip_kernel_f32<4>;
+		case GfxColorFormat_R32G32B32A32_UINT: return mip_kernel_rgba32_uint;
+		default: return nullptr;
+	}
+}
+
+
+struct MipJob
+{
+	MipKernel kernel;
+	const byte *source;
+	byte *dest;
+	usize sourcePitch; // Bytes per source row
+	usize destPitch; // Bytes per destination row
+	u16 mipWidth;
+	u16 mipHeight;
+};
+
+
+static void mip_generate_rows( usize index, void *context )
+{
+	const MipJob &job = *reinterpret_cast<MipJob *>( context );
+	const usize rowBegin = index * MIP_PARALLEL_BAND_ROWS;
+	const usize rowEnd = min( rowBegin + MIP_PARALLEL_BAND_ROWS, static_cast<usize>( job.mipHeight ) );
+
+	for( usize y = rowBegin; y < rowEnd; y++ )
+	{
+		const byte *row0 = job.source + ( y * 2 + 0 ) * job.sourcePitch;
+		const byte *row1 = job.source + ( y * 2 + 1 ) * job.sourcePitch;
+		job.kernel( row0, row1, job.dest + y * job.destPitch, job.mipWidth );
+	}
+}
+
+
 static bool mip_generate_next_2d( void *data, const u16 width, const u16 height,
-	const GfxColorFormat format, void *dest, const usize size )
+	const GfxColorFormat format, void *dest, const usize size, const bool srgb = false )
 {
 	ErrorReturnIf( format >= GFXCOLORFORMAT_COUNT, false,
 		"%s: invalid GfxColorFormat: %u", __FUNCTION__, format );
@@ -163,180 +476,32 @@ static bool mip_generate_next_2d( void *data, const u16 width, const u16 height,
 		"%s: dest size does not match request mip size (dst: %u bytes, mip: %u bytes %u,%u)",
 		__FUNCTION__, size, mipSizeBytes, width, height );
 
-	for( u16 y = 0; y < mipHeight; y++ )
-	for( u16 x = 0; x < mipWidth; x++ )
-	{
-		u32 srcX = x * 2;
-		u32 srcY = y * 2;
-
-		const u8 *p00 = static_cast<u8 *>( data ) + ( ( srcY + 0 ) * width + ( srcX + 0 ) ) * pixelSizeBytes;
-		const u8 *p10 = static_cast<u8 *>( data ) + ( ( srcY + 0 ) * width + ( srcX + 1 ) ) * pixelSizeBytes;
-		const u8 *p01 = static_cast<u8 *>( data ) + ( ( srcY + 1 ) * width + ( srcX + 0 ) ) * pixelSizeBytes;
-		const u8 *p11 = static_cast<u8 *>( data ) + ( ( srcY + 1 ) * width + ( srcX + 1 ) ) * pixelSizeBytes;
-
-		u8 *out = static_cast<u8 *>( dest ) + ( y * mipWidth + x ) * pixelSizeBytes;
-
-		switch( format )
-		{
-			case GfxColorFormat_R8_UINT:
-			{
-				u32 v = p00[0] + p10[0] + p01[0] + p11[0];
-				out[0] = static_cast<u8>( v / 4 );
-			}
-			break;
-
-			case GfxColorFormat_R8G8:
-			{
-				for( int c = 0; c < 2; c++ )
-				{
-					out[c] = static_cast<u8>( ( p00[c] + p10[c] + p01[c] + p11[c] ) / 4 );
-				}
-			}
-			break;
+	MipJob job;
+	job.kernel = mip_kernel( format, srgb );
+	ErrorReturnIf( job.kernel == nullptr, false, "%s: unsupported format %u", __FUNCTION__, format );
 
-			case GfxColorFormat_R8G8B8A8_UINT:
-			case GfxColorFormat_R8G8B8A8_FLOAT:
-			{
-				for( int c = 0; c < 4; c++ )
-				{
-					out[c] = static_cast<u8>( ( p00[c] + p10[c] + p01[c] + p11[c] ) / 4 );
-				}
-			}
-			break;
-
-			case GfxColorFormat_R16_UINT:
-			case GfxColorFormat_R16_FLOAT:
-			{
-				u16 *o = reinterpret_cast<u16 *>( out );
-				const u16 *s0 = reinterpret_cast<const u16 *>( p00 );
-				const u16 *s1 = reinterpret_cast<const u16 *>( p10 );
-				const u16 *s2 = reinterpret_cast<const u16 *>( p01 );
-				const u16 *s3 = reinterpret_cast<const u16 *>( p11 );
-				o[0] = static_cast<u16>( static_cast<u32>( s0[0] ) + s1[0] + s2[0] + s3[0] ) / 4;
-			}
-			break;
-
-			case GfxColorFormat_R16G16:
-			case GfxColorFormat_R16G16F_FLOAT:
-			{
-				u16 *o = reinterpret_cast<u16 *>( out );
-				const u16* s0 = reinterpret_cast<const u16 *>( p00 );
-				const u16* s1 = reinterpret_cast<const u16 *>( p10 );
-				const u16* s2 = reinterpret_cast<const u16 *>( p01 );
-				const u16* s3 = reinterpret_cast<const u16 *>( p11 );
-				for( int c = 0; c < 2; c++ )
-				{
-					o[c] = static_cast<u16>( static_cast<u32>( s0[c] ) + s1[c] + s2[c] + s3[c] ) / 4;
-				}
-			}
-			break;
-
-			case GfxColorFormat_R16G16B16A16_UINT:
-			case GfxColorFormat_R16G16B16A16_FLOAT:
-			{
-				u16 *o = reinterpret_cast<u16 *>( out );
-				const u16 *s0 = reinterpret_cast<const u16 *>( p00 );
-				const u16 *s1 = reinterpret_cast<const u16 *>( p10 );
-				const u16 *s2 = reinterpret_cast<const u16 *>( p01 );
-				const u16 *s3 = reinterpret_cast<const u16 *>( p11 );
-				for( int c = 0; c < 4; c++ )
-				{
-					o[c] = static_cast<u16>( static_cast<u32>( s0[c] ) + s1[c] + s2[c] + s3[c] ) / 4;
-				}
-			}
-			break;
-
-			case GfxColorFormat_R32_FLOAT:
-			{
-				float *o = reinterpret_cast<float *>( out );
-				const float *s0 = reinterpret_cast<const float *>( p00 );
-				const float *s1 = reinterpret_cast<const float *>( p10 );
-				const float *s2 = reinterpret_cast<const float *>( p01 );
-				const float *s3 = reinterpret_cast<const float *>( p11 );
-				o[0] = ( s0[0] + s1[0] + s2[0] + s3[0] ) * 0.25f;
-			}
-			break;
-
-			case GfxColorFormat_R32G32_FLOAT:
-			{
-				float *o = reinterpret_cast<float *>( out );
-				const float *s0 = reinterpret_cast<const float *>( p00 );
-				const float *s1 = reinterpret_cast<const float *>( p10 );
-				const float *s2 = reinterpret_cast<const float *>( p01 );
-				const float *s3 = reinterpret_cast<const float *>( p11 );
-				for( int c = 0; c < 2; c++ )
-				{
-					o[c] = ( s0[c] + s1[c] + s2[c] + s3[c] ) * 0.25f;
-				}
-			}
-			break;
-
-			case GfxColorFormat_R32G32B32A32_FLOAT:
-			{
-				float *o = reinterpret_cast<float *>( out );
-				const float *s0 = reinterpret_cast<const float *>( p00 );
-				const float *s1 = reinterpret_cast<const float *>( p10 );
-				const float *s2 = reinterpret_cast<const float *>( p01 );
-				const float *s3 = reinterpret_cast<const float *>( p11 );
-				for( int c = 0; c < 4; c++ )
-				{
-					o[c] = ( s0[c] + s1[c] + s2[c] + s3[c] ) * 0.25f;
-				}
-			}
-			break;
-
-			case GfxColorFormat_R32G32B32A32_UINT:
-			{
-				u32 *o = reinterpret_cast<u32 *>( out );
-				const u32 *s0 = reinterpret_cast<const u32 *>( p00 );
-				const u32 *s1 = reinterpret_cast<const u32 *>( p10 );
-				const u32 *s2 = reinterpret_cast<const u32 *>( p01 );
-				const u32 *s3 = reinterpret_cast<const u32 *>( p11 );
-				for( int c = 0; c < 4; c++ )
-				{
-					o[c] = ( s0[c] + s1[c] + s2[c] + s3[c] ) / 4;
-				}
-			}
-			break;
-
-			case GfxColorFormat_R10G10B10A2_FLOAT:
-			{
-				// Packed as 32-bit
-				auto unpack = []( u32 v, int shift, int bits ) -> u32
-				{
-					return ( v >> shift ) & ( ( 1u << bits ) - 1u );
-				};
+	// Lookup tables are built here, before rows are handed to other threads
+	if( job.kernel == mip_kernel_rgba8_srgb ) { mip_srgb_tables_init(); }
+	if( job.kernel == mip_kernel_f16<1> || job.kernel == mip_kernel_f16<2> || job.kernel == mip_kernel_f16<4> )
+	{
+		mip_half_table_init();
+	}
 
-				auto pack = []( u32 r, u32 g, u32 b, u32 a ) -> u32
-				{
-					return ( r & 0x3FF ) | ( ( g & 0x3FF) << 10 ) |
-						( ( b & 0x3FF ) << 20 ) | ( ( a & 0x3 ) << 30 );
-				};
-
-				const u32 *s0 = reinterpret_cast<const u32 *>( p00 );
-				const u32 *s1 = reinterpret_cast<const u32 *>( p10 );
-				const u32 *s2 = reinterpret_cast<const u32 *>( p01 );
-				const u32 *s3 = reinterpret_cast<const u32 *>( p11 );
-
-				u32 r = ( unpack( *s0, 0, 10 ) + unpack( *s1, 0, 10 ) +
-					unpack( *s2, 0, 10 ) + unpack( *s3, 0, 10 ) ) / 4;
-				u32 g = ( unpack( *s0, 10, 10 ) + unpack( *s1, 10, 10 ) +
-					unpack( *s2, 10, 10 ) + unpack( *s3, 10, 10 ) ) / 4;
-				u32 b = ( unpack( *s0, 20, 10 ) + unpack( *s1, 20, 10 ) +
-					unpack( *s2, 20, 10 ) + unpack( *s3, 20, 10 ) ) / 4;
-				u32 a = ( unpack( *s0, 30, 2 ) + unpack( *s1, 30, 2 ) +
-					unpack( *s2, 30, 2 ) + unpack( *s3, 30, 2 ) ) / 4;
-
-				*reinterpret_cast<u32 *>( out ) = pack( r, g, b, a );
-			}
-			break;
+	job.source = reinterpret_cast<const byte *>( data );
+	job.dest = reinterpret_cast<byte *>( dest );
+	job.sourcePitch = static_cast<usize>( width ) * pixelSizeBytes;
+	job.destPitch = static_cast<usize>( mipWidth ) * pixelSizeBytes;
+	job.mipWidth = mipWidth;
+	job.mipHeight = mipHeight;
 
-			default:
-			{
-				ErrorReturnMsg( false, "%s: unsupported format %u", __FUNCTION__, format );
-			}
-			break;
-		}
+	const usize bands = ( mipHeight + MIP_PARALLEL_BAND_ROWS - 1 ) / MIP_PARALLEL_BAND_ROWS;
+	if( static_cast<usize>( mipWidth ) * mipHeight >= MIP_PARALLEL_TEXELS && bands > 1 )
+	{
+		parallel_for( bands, mip_generate_rows, &job );
+	}
+	else
+	{
+		for( usize band = 0; band < bands; band++ ) { mip_generate_rows( band, &job ); }
 	}
 
 	return true;
@@ -344,7 +509,7 @@ static bool mip_generate_next_2d( void *data, const u16 width, const u16 height,
 
 
 bool mip_generate_next_2d_alloc( void *data, const u16 width, const u16 height,
-	const GfxColorFormat format, void *&outData, usize &outSize )
+	const GfxColorFormat format, void *&outData, usize &outSize, const bool srgb = false )
 {
 	ErrorReturnIf( format >= GFXCOLORFORMAT_COUNT, false,
 		"%s: invalid GfxColorFormat: %u", __FUNCTION__, format );
@@ -363,7 +528,7 @@ bool mip_generate_next_2d_alloc( void *data, const u16 width, const u16 height,
 	outData = memory_alloc( outSize );
 
 	// Generate mip
-	if( !mip_generate_next_2d( data, width, height, format, outData, outSize ) )
+	if( !mip_generate_next_2d( data, width, height, format, outData, outSize, srgb ) )
 	{
 		memory_free( outData );
 		outData = nullptr;
@@ -376,7 +541,7 @@ bool mip_generate_next_2d_alloc( void *data, const u16 width, const u16 height,
 
 
 static bool mip_generate_chain_2d( void *data, const u16 width, const u16 height,
-	const GfxColorFormat format, void *dest, const usize size )
+	const GfxColorFormat format, void *dest, const usize size, const bool srgb = false )
 {
 	ErrorReturnIf( format >= GFXCOLORFORMAT_COUNT, false,
 		"%s: invalid GfxColorFormat: %u", __FUNCTION__, format );
@@ -404,7 +569,8 @@ static bool mip_generate_chain_2d( void *data, const u16 width, const u16 height
 	// Generated Mips
 	for( u16 level = 1, w = width, h = height; level < levels; level++ )
 	{
-		if( !mip_generate_next_2d( mipSrc, w, h, format, mipDst, ( pixelSizeBytes * w * h ) / 4 ) ) { return false; }
+		const usize mipSize = pixelSizeBytes * ( w / 2 ) * ( h / 2 );
+		if( !mip_generate_next_2d( mipSrc, w, h, format, mipDst, mipSize, srgb ) ) { return false; }
 		w /= 2;
 		h /= 2;
 		mipSrc = mipDst;
@@ -416,7 +582,7 @@ static bool mip_generate_chain_2d( void *data, const u16 width, const u16 height
 
 
 static bool mip_generate_chain_2d_alloc( void *data, const u16 width, const u16 height,
-	const GfxColorFormat format, void *&outData, usize &outSize )
+	const GfxColorFormat format, void *&outData, usize &outSize, const bool srgb = false )
 {
 	// Generates a mip level half the size of width, height
 	Assert( format < GFXCOLORFORMAT_COUNT );
@@ -435,7 +601,7 @@ static bool mip_generate_chain_2d_alloc( void *data, const u16 width, const u16
 	outData = memory_alloc( outSize );
 
 	// Generate mips
-	if( !mip_generate_chain_2d( data, width, height, format, outData, outSize ) )
+	if( !mip_generate_chain_2d( data, width, height, format, outData, outSize, srgb ) )
 	{
 		memory_free( outData );
 		outData = nullptr;
@@ -448,6 +614,120 @@ static bool mip_generate_chain_2d_alloc( void *data, const u16 width, const u16
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#define TEXTURE_ENCODE_BLOCK_ROWS ( 16 ) // Block rows per parallel_for() task
+
+struct TextureEncodeTask
+{
+	usize sourceOffset; // RGBA8 mip level
+	usize destOffset; // BCn mip level
+	u16 width;
+	u16 height;
+	u32 blockRowBegin;
+	u32 blockRowEnd;
+};
+
+
+struct TextureEncodeJob
+{
+	BCnFormat format;
+	const TextureEncodeTask *tasks;
+	const byte *source;
+	byte *dest;
+};
+
+
+static void texture_encode( usize index, void *context )
+{
+	const TextureEncodeJob &job = *reinterpret_cast<TextureEncodeJob *>( context );
+	const TextureEncodeTask &task = job.tasks[index];
+	bcn_encode( job.format, job.source + task.sourceOffset, task.width, task.height, job.dest + task.destOffset,
+		task.blockRowBegin, task.blockRowEnd );
+}
+
+
+static bool texture_format_compressed( const Assets::TextureColorFormat format )
+{
+	return format >= Assets::TextureColorFormat_BC1 && format <= Assets::TextureColorFormat_BC7;
+}
+
+
+bool texture_compression_format( const char *compression, Assets::TextureColorFormat &format )
+{
+	static_assert( Assets::TextureColorFormat_BC7 - Assets::TextureColorFormat_BC1 == BCnFormat_BC7 - BCnFormat_BC1,
+		"TextureColorFormat BCn formats must match BCnFormat order" );
+
+	static const char *names[BCNFORMAT_COUNT] = { "bc1", "bc3", "bc4", "bc5", "bc7" };
+
+	if( compression[0] == '\0' || strcmp( compression, "none" ) == 0 )
+	{
+		format = Assets::TextureColorFormat_R8G8B8A8;
+		return true;
+	}
+
+	for( u32 i = 0; i < BCNFORMAT_COUNT; i++ )
+	{
+		if( strcmp( compression, names[i] ) == 0 )
+		{
+			format = static_cast<Assets::TextureColorFormat>( Assets::TextureColorFormat_BC1 + i );
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+static usize texture_write_binary( Texture &texture, const void *data, const usize size )
+{
+	// RGBA8 textures are written as is
+	if( !texture_format_compressed( texture.format ) )
+	{
+		texture.offset = Assets::binary.write( data, size );
+		return size;
+	}
+
+	ErrorIf( texture.width % 4 != 0 || texture.height % 4 != 0,
+		"Texture '%s' is block-compressed but its dimensions are not a multiple of 4 (w: %u, h: %u)",
+		texture.name.cstr(), texture.width, texture.height );
+
+	// Split every mip level into bands of block rows
+	const BCnFormat format = static_cast<BCnFormat>( texture.format - Assets::TextureColorFormat_BC1 );
+	List<TextureEncodeTask> tasks;
+	usize sourceOffset = 0;
+	usize destOffset = 0;
+	for( u16 level = 0, width = texture.width, height = texture.height; level < texture.levels; level++ )
+	{
+		const u32 blockRows = bcn_block_count( height );
+		for( u32 row = 0; row < blockRows; row += TEXTURE_ENCODE_BLOCK_ROWS )
+		{
+			TextureEncodeTask task;
+			task.sourceOffset = sourceOffset;
+			task.destOffset = destOffset;
+			task.width = width;
+			task.height = height;
+			task.blockRowBegin = row;
+			task.blockRowEnd = row + TEXTURE_ENCODE_BLOCK_ROWS;
+			tasks.add( task );
+		}
+
+		sourceOffset += static_cast<usize>( width ) * height * sizeof( Color );
+		destOffset += bcn_size_bytes( format, width, height );
+		width >>= 1;
+		height >>= 1;
+	}
+	Assert( sourceOffset == size );
+
+	byte *compressed = reinterpret_cast<byte *>( memory_alloc( destOffset ) );
+	TextureEncodeJob job { format, tasks.data, reinterpret_cast<const byte *>( data ), compressed };
+	parallel_for( tasks.count(), texture_encode, &job );
+
+	texture.offset = Assets::binary.write( compressed, destOffset );
+	memory_free( compressed );
+	return destOffset;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 GlyphID Texture::add_glyph( const Glyph &glyph )
 {
 	glyphCacheKey.add( glyph.cacheKey );
@@ -673,6 +953,13 @@ TextureID Textures::register_new_from_definition( String name, const char *path
 	snprintf( pathImage, sizeof( pathImage ),
 		"%s" SLASH "%s", pathDirectory, pathImageRelative.cstr() );
 	bool generateMips = fileDefinitionJSON.get_bool( "mips" );
+	bool srgb = fileDefinitionJSON.get_bool( "srgb" );
+
+	Assets::TextureColorFormat format;
+	String compression = fileDefinitionJSON.get_string( "compression", "none" );
+	ErrorIf( !texture_compression_format( compression.cstr(), format ),
+		"Texture '%s' has an invalid compression: '%s' (none, bc1, bc3, bc4, bc5, bc7)",
+		fileDefinition.name, compression.cstr() );
 
 	// Register Color Image File
 	AssetFile fileImage;
@@ -713,6 +1000,8 @@ TextureID Textures::register_new_from_definition( String name, const char *path
 	texture.name = name;
 	texture.atlasTexture = false;
 	texture.generateMips = generateMips;
+	texture.srgb = srgb;
+	texture.format = format;
 
 	Glyph glyph;
 	glyph.cacheKey = cacheKey;
@@ -797,6 +1086,8 @@ void Textures::build()
 
 	Timer timer;
 	usize sizeBytes = 0;
+	usize sizeBytesCompressed = 0; // Block-compressed textures (built this run)
+	usize sizeBytesUncompressed = 0; // ... and their RGBA8 size
 
 	// Load & Binary
 	{
@@ -808,7 +1099,7 @@ void Textures::build()
 			// Texture CacheKey
 			const CacheKey cacheKey = static_cast<CacheKey>( checksum_xcrc32(
 				reinterpret_cast<char *>( texture.glyphCacheKey.data ),
-				texture.glyphCacheKey.count() * sizeof( CacheKey ), 0 ) );
+				texture.glyphCacheKey.count() * sizeof( CacheKey ), TEXTURE_CACHE_VERSION ) );
 
 			// Atlas Texture
 			if( numGlyphs >= 1 && texture.atlasTexture )
@@ -822,6 +1113,7 @@ void Textures::build()
 				{
 					// Read & Write Binary (Cached)
 					texture.levels = 1;
+					texture.format = cacheTextureBinary.format;
 					texture.offset = binary.write_from_file( Build::pathOutputRuntimeBinary,
 						Assets::cacheReadOffset + cacheTextureBinary.offset, cacheTextureBinary.size );
 
@@ -857,17 +1149,24 @@ void Textures::build()
 
 					// Write Binary
 					texture.levels = 1;
-					const usize size = texture.width * texture.height * sizeof( Color );
-					texture.offset = binary.write( textureBinary.data, size );
+					const usize sizeUncompressed = texture.width * texture.height * sizeof( Color );
+					const usize size = texture_write_binary( texture, textureBinary.data, sizeUncompressed );
 					Assets::log_asset_build( "Texture", texture.name.cstr() );
 					sizeBytes += size;
 
+					if( texture_format_compressed( texture.format ) )
+					{
+						sizeBytesCompressed += size;
+						sizeBytesUncompressed += sizeUncompressed;
+					}
+
 					// Cache
 					cacheTextureBinary.width = texture.width;
 					cacheTextureBinary.height = texture.height;
 					cacheTextureBinary.levels = texture.levels;
 					cacheTextureBinary.offset = texture.offset;
 					cacheTextureBinary.size = size;
+					cacheTextureBinary.format = texture.format;
 					Assets::cache.store( cacheKey, cacheTextureBinary );
 				}
 			}
@@ -882,6 +1181,7 @@ void Textures::build()
 					texture.width = cacheTextureBinary.width;
 					texture.height = cacheTextureBinary.height;
 					texture.levels = cacheTextureBinary.levels;
+					texture.format = cacheTextureBinary.format;
 					texture.offset = binary.write_from_file( Build::pathOutputRuntimeBinary,
 						Assets::cacheReadOffset + cacheTextureBinary.offset, cacheTextureBinary.size );
 
@@ -902,6 +1202,7 @@ void Textures::build()
 					texture.width = textureBinary.width;
 					texture.height = textureBinary.height;
 					usize size = 0;
+					usize sizeUncompressed = 0;
 
 					// Mipmapping
 					if( texture.generateMips )
@@ -911,9 +1212,10 @@ void Textures::build()
 						void *mip = nullptr;
 
 						if( mip_generate_chain_2d_alloc( textureBinary.data,
-								texture.width, texture.height, GfxColorFormat_R8G8B8A8_FLOAT, mip, size ) )
+								texture.width, texture.height, GfxColorFormat_R8G8B8A8_FLOAT, mip, sizeUncompressed,
+								texture.srgb ) )
 						{
-							texture.offset = binary.write( mip, size );
+							size = texture_write_binary( texture, mip, sizeUncompressed );
 							Assets::log_asset_build( "Texture", texture.name.cstr() );
 							sizeBytes += size;
 							memory_free( mip );
@@ -928,11 +1230,17 @@ void Textures::build()
 					// No mipmaps -- write file directly as is
 					{
 						texture.levels = 1;
-						size = texture.width * texture.height * sizeof( Color );
-						texture.offset = binary.write( textureBinary.data, size );
+						sizeUncompressed = texture.width * texture.height * sizeof( Color );
+						size = texture_write_binary( texture, textureBinary.data, sizeUncompressed );
 						sizeBytes += size;
 					}
 
+					if( texture_format_compressed( texture.format ) )
+					{
+						sizeBytesCompressed += size;
+						sizeBytesUncompressed += sizeUncompressed;
+					}
+
 				#if 0
 					char path[PATH_SIZE];
 					strjoin( path, Build::pathOutput, SLASH "generated" SLASH,
@@ -946,6 +1254,7 @@ void Textures::build()
 					cacheTextureBinary.levels = texture.levels;
 					cacheTextureBinary.offset = texture.offset;
 					cacheTextureBinary.size = size;
+					cacheTextureBinary.format = texture.format;
 					Assets::cache.store( cacheKey, cacheTextureBinary );
 				}
 			}
@@ -1019,7 +1328,13 @@ void Textures::build()
 	if( verbose_output() )
 	{
 		const usize count = textures.count();
-		Print( PrintColor_White, TAB TAB "Wrote %d texture%s", count, count == 1 ? "" : "s", MB( sizeBytes ) );
+		Print( PrintColor_White, TAB TAB "Wrote %d texture%s", count, count == 1 ? "" : "s" );
+		if( sizeBytesUncompressed > 0 )
+		{
+			Print( PrintColor_White, " (BCn: %.2f MB -> %.2f MB, saved %.1f%%)",
+				MB( sizeBytesUncompressed ), MB( sizeBytesCompressed ),
+				100.0 * ( sizeBytesUncompressed - sizeBytesCompressed ) / sizeBytesUncompressed );
+		}
 		PrintLn( PrintColor_White, " (%.3f ms)", timer.elapsed_ms() );
 	}
 }
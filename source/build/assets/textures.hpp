@@ -21,6 +21,7 @@ public:
 public:
 	bool atlasTexture = true;
 	bool generateMips = false;
+	bool srgb = false; // Color is sRGB-encoded (mips are filtered in linear space)
 	usize offset;
 	u16 width = 0;
 	u16 height = 0;
@@ -38,6 +39,9 @@ using TextureID = u16;
 #define TEXTUREID_MAX ( U16_MAX )
 #define TEXTUREID_NULL ( TEXTUREID_MAX )
 
+// Parses a definition file "compression" value ("none", "bc1", "bc3", "bc4", "bc5", "bc7")
+extern bool texture_compression_format( const char *compression, Assets::TextureColorFormat &format );
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 class Textures
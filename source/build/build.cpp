@@ -57,6 +57,7 @@ namespace Build
 	char pathOutputCacheBuild[PATH_SIZE];
 	char pathOutputCacheObjects[PATH_SIZE];
 	char pathOutputCacheGraphics[PATH_SIZE];
+	char pathOutputCacheShaders[PATH_SIZE];
 	char pathOutputCacheAssets[PATH_SIZE];
 
 	// Configuration
@@ -134,11 +135,29 @@ void Build::configuration_load()
 		Build::config.linkerFlags = configsCompile.get_string( "linkerFlags" );
 	}
 
+	// Unity Build
+	JSON configsUnityExclude = json.object( "unity" ).array( "exclude" );
+	for( usize i = 0; i < configsUnityExclude.count(); i++ )
+	{
+		Build::config.unityExclude.add( configsUnityExclude.get_string_at( i ) );
+	}
+
 	// Application
 	JSON configsApplication = json.object( "application" );
 	if( configsApplication.count() > 0 )
 	{
 		Build::config.showTerminal = configsApplication.get_bool( "showTerminal", false );
+		Build::config.headless = configsApplication.get_bool( "headless", false );
+		Build::config.tickRate = configsApplication.get_int( "tickRate", 30 );
+		Build::config.gfxFrontend = configsApplication.get_bool( "gfxFrontend", false );
+		Build::config.benchmarkObjects = configsApplication.get_bool( "benchmarkObjects", false );
+	}
+
+	// Shaders
+	JSON configsShaders = json.object( "shaders" );
+	if( configsShaders.count() > 0 )
+	{
+		Build::config.shaderOptimize = configsShaders.get_bool( "optimize", true );
 	}
 
 	// Steamworks
@@ -165,6 +184,22 @@ void Build::configuration_save()
 	header.append( "// Application\n" );
 	header.append( "#define COMPILE_TERMINAL ( " ).append( Build::config.showTerminal ).append( " )\n\n" );
 
+	if( Build::config.headless )
+	{
+		header.append( "// Headless\n" );
+		header.append( "#define HEADLESS ( 1 )\n" );
+		header.append( "#define HEADLESS_TICK_RATE ( " ).append( Build::config.tickRate ).append( " )\n\n" );
+	}
+
+	if( Build::config.gfxFrontend )
+	{
+		header.append( "// Graphics (gfx/none runs the frontend against its null device)\n" );
+		header.append( "#define GRAPHICS_NONE_FRONTEND ( 1 )\n\n" );
+	}
+
+	header.append( "// Benchmarks (source/benchmark objects)\n" );
+	header.append( "#define COMPILE_BENCHMARK_OBJECTS ( " ).append( Build::config.benchmarkObjects ).append( " )\n\n" );
+
 	header.append( "// Steamworks\n" );
 	header.append( "#define COMPILE_STEAMWORKS ( " ).append( Build::config.steam ).append( " )\n" );
 	header.append( "#define STEAMWORKS_DISTRIBUTE ( " ).append( Build::config.steamDistribute ).append( " )\n" );
@@ -625,6 +660,7 @@ void BuilderCore::build( int argc, char **argv )
 		strjoin( Build::pathOutputCacheBuild, Build::pathOutputRuntime, SLASH "core.cache" );
 		strjoin( Build::pathOutputCacheObjects, Build::pathOutputRuntime, SLASH "objects.cache" );
 		strjoin( Build::pathOutputCacheGraphics, Build::pathOutputRuntime, SLASH "graphics.cache" );
+		strjoin( Build::pathOutputCacheShaders, Build::pathOutputRuntime, SLASH "shaders.cache" );
 		strjoin( Build::pathOutputCacheAssets, Build::pathOutputRuntime, SLASH "assets.cache" );
 
 		// Output Directories
@@ -757,6 +793,7 @@ void BuilderCore::build( int argc, char **argv )
 
 		compile_project();
 		compile_engine();
+		compile_unity();
 		compile_write_ninja();
 		compile_run_ninja();
 
@@ -821,6 +858,11 @@ void BuilderCore::objects_gather()
 	usize numObjects = 0LLU;
 	strjoin( path, Build::pathEngine, SLASH "manta" ); // Engine
 	numObjects += Objects::gather( path, true );
+	if( Build::config.benchmarkObjects )
+	{
+		strjoin( path, Build::pathEngine, SLASH "benchmark" ); // Benchmarks (opt-in, see: Benchmark::replication)
+		numObjects += Objects::gather( path, true );
+	}
 	strjoin( path, Build::pathProject, SLASH "runtime" ); // Project
 	numObjects += Objects::gather( path, true );
 	verbose_log_gather( "object", numObjects );
@@ -909,7 +951,18 @@ void BuilderCore::shaders_build()
 		{
 			if( Gfx::shadersBuilt > 0 )
 			{
-				PrintLn( PrintColor_Red, TAB TAB "%llu shaders built", Gfx::shadersBuilt );
+				Print( PrintColor_Red, TAB TAB "%llu shaders built", Gfx::shadersBuilt );
+				if( Gfx::shaderNodesParsed > 0 )
+				{
+					Print( PrintColor_Red, " (%llu -> %llu AST nodes)",
+						Gfx::shaderNodesParsed, Gfx::shaderNodesOptimized );
+				}
+				Print( "\n" );
+			}
+
+			if( Gfx::shadersCached > 0 )
+			{
+				PrintLn( PrintColor_Magenta, TAB TAB "%llu shaders cached", Gfx::shadersCached );
 			}
 		}
 
@@ -1193,14 +1246,20 @@ void BuilderCore::compile_engine()
 
 		// Backend Sources
 		{
+			// Headless builds run on the 'none' audio, window, & graphics backends
+			const bool headless = Build::config.headless;
+			ErrorIf( headless && !GRAPHICS_NONE, "Headless configurations require '-gfx=none' (got: %s)",
+				BUILD_GRAPHICS );
+
 			// Audio | -r source/manta/backend/audio/*.cpp
-			strjoin( path, Build::pathEngine, SLASH "manta" SLASH "backend" SLASH "audio" SLASH, BACKEND_AUDIO );
+			strjoin( path, Build::pathEngine, SLASH "manta" SLASH "backend" SLASH "audio" SLASH,
+				headless ? "none" : BACKEND_AUDIO );
 			count = Build::compile_add_sources( path, true, ".cpp", Build::tc.linkerExtensionObj );
 			numSources += count;
 			ErrorIf( !count, "No backend found for 'audio' (%s)", path );
-			if( OS_WINDOWS ) { Build::compile_add_library( "Ole32" ); }
-			if( OS_MACOS ) { Build::compile_add_framework( "AudioToolbox" ); }
-			if( OS_LINUX ) { Build::compile_add_library( "asound" ); }
+			if( OS_WINDOWS && !headless ) { Build::compile_add_library( "Ole32" ); }
+			if( OS_MACOS && !headless ) { Build::compile_add_framework( "AudioToolbox" ); }
+			if( OS_LINUX && !headless ) { Build::compile_add_library( "asound" ); }
 
 			// Filesystem | -r source/manta/backend/filesystem/*.cpp
 			strjoin( path, Build::pathEngine, SLASH "manta" SLASH "backend" SLASH "filesystem" SLASH, BACKEND_FILESYSTEM );
@@ -1323,13 +1382,18 @@ void BuilderCore::compile_engine()
 			if( OS_WINDOWS ) { Build::compile_add_library( "winmm" ); }
 
 			// Window | -r source/manta/backend/window/*.cpp
-			strjoin( path, Build::pathEngine, SLASH "manta" SLASH "backend" SLASH "window" SLASH, BACKEND_WINDOW );
-			count = Build::compile_add_sources( path, true, OS_MACOS ? ".mm" : ".cpp", Build::tc.linkerExtensionObj );
+			strjoin( path, Build::pathEngine, SLASH "manta" SLASH "backend" SLASH "window" SLASH,
+				headless ? "none" : BACKEND_WINDOW );
+			count = Build::compile_add_sources( path, true, OS_MACOS && !headless ? ".mm" : ".cpp",
+				Build::tc.linkerExtensionObj );
 			numSources += count;
 			ErrorIf( !count, "No backend found for 'window' (%s)", path );
-			if( OS_WINDOWS ) { Build::compile_add_library( "user32" ); Build::compile_add_library( "Shell32" ); }
-			if( OS_MACOS ) { Build::compile_add_framework( "Cocoa" ); }
-			if( OS_LINUX ) { Build::compile_add_library( "X11" ); Build::compile_add_library( "Xi" ); }
+			if( !headless )
+			{
+				if( OS_WINDOWS ) { Build::compile_add_library( "user32" ); Build::compile_add_library( "Shell32" ); }
+				if( OS_MACOS ) { Build::compile_add_framework( "Cocoa" ); }
+				if( OS_LINUX ) { Build::compile_add_library( "X11" ); Build::compile_add_library( "Xi" ); }
+			}
 
 			// Steam
 			if( Build::config.steam )
@@ -1398,6 +1462,232 @@ void BuilderCore::compile_engine()
 }
 
 
+// Engine sources that can not share a translation unit with others (file-scope name clashes, macro leakage, etc.)
+// Projects list their own with configs.json: "unity": { "exclude": [ "runtime/foo.cpp" ] }
+static const char *UNITY_EXCLUDE[] =
+{
+	"source/vendor/stb/stb_image.cpp", // STB_IMAGE_IMPLEMENTATION
+	"source/vendor/stb/stb_truetype.cpp", // STB_TRUETYPE_IMPLEMENTATION
+};
+
+
+static bool unity_path_matches( const char *path, const char *pattern )
+{
+	// Suffix match, treating '/' and '\' as equal
+	const usize lengthPath = strlen( path );
+	const usize lengthPattern = strlen( pattern );
+	if( lengthPattern == 0 || lengthPattern > lengthPath ) { return false; }
+
+	const char *suffix = path + ( lengthPath - lengthPattern );
+	for( usize i = 0; i < lengthPattern; i++ )
+	{
+		const char a = suffix[i] == '\\' ? '/' : suffix[i];
+		const char b = pattern[i] == '\\' ? '/' : pattern[i];
+		if( a != b ) { return false; }
+	}
+
+	return lengthPattern == lengthPath || suffix[-1] == '/' || suffix[-1] == '\\';
+}
+
+
+static bool unity_excluded( const Source &source )
+{
+	const char *path = source.srcPath.cstr();
+	const usize length = strlen( path );
+	if( length < 4 || strcmp( path + length - 4, ".cpp" ) != 0 ) { return true; } // .mm, etc.
+	for( const char *pattern : UNITY_EXCLUDE ) { if( unity_path_matches( path, pattern ) ) { return true; } }
+	for( String &pattern : Build::config.unityExclude )
+	{
+		if( unity_path_matches( path, pattern.cstr() ) ) { return true; }
+	}
+	return false;
+}
+
+
+static bool unity_assignment_load( const char *path, const List<usize> &unitySources, const usize shardCount,
+	List<usize> &assignment )
+{
+	// "<shard count>" header line, then "<shard> <path>" per line, one line per unity source
+	String contents;
+	if( !contents.load( path ) ) { return false; }
+
+	assignment.clear();
+	for( usize i = 0; i < unitySources.count(); i++ ) { assignment.add( USIZE_MAX ); }
+
+	char *header = nullptr;
+	if( strtoull( contents.cstr(), &header, 10 ) != shardCount || header == contents.cstr() ) { return false; }
+
+	usize assigned = 0LLU;
+	const char *line = header;
+	while( *line == '\n' || *line == '\r' ) { line++; }
+	while( *line != '\0' )
+	{
+		const char *end = line;
+		while( *end != '\0' && *end != '\n' && *end != '\r' ) { end++; }
+
+		char *pathStart = nullptr;
+		const usize shard = strtoull( line, &pathStart, 10 );
+		if( pathStart == line || *pathStart != ' ' || shard >= shardCount ) { return false; }
+		pathStart++;
+
+		const usize pathLength = static_cast<usize>( end - pathStart );
+		bool found = false;
+		for( usize i = 0; i < unitySources.count(); i++ )
+		{
+			const String &srcPath = Build::sources[unitySources[i]].srcPath;
+			if( srcPath.length_bytes() != pathLength ) { continue; }
+			if( strncmp( srcPath.cstr(), pathStart, pathLength ) != 0 ) { continue; }
+			if( assignment[i] != USIZE_MAX ) { return false; }
+			assignment[i] = shard;
+			assigned++;
+			found = true;
+			break;
+		}
+		if( !found ) { return false; } // Source removed
+
+		line = end;
+		while( *line == '\n' || *line == '\r' ) { line++; }
+	}
+
+	return assigned == unitySources.count(); // Otherwise: source added
+}
+
+
+void BuilderCore::compile_unity()
+{
+	if( strcmp( Build::args.unity, "1" ) != 0 ) { return; }
+
+	Timer timer;
+	PrintLn( PrintColor_White, TAB "Group Unity Sources..." );
+
+	char pathUnity[PATH_SIZE];
+	strjoin( pathUnity, Build::pathOutputGenerated, SLASH "unity" );
+	directory_create( pathUnity );
+
+	char pathAssignment[PATH_SIZE];
+	strjoin( pathAssignment, pathUnity, SLASH "unity.shards" );
+
+	List<usize> unitySources;
+	List<Source> sources;
+	for( usize i = 0; i < Build::sources.count(); i++ )
+	{
+		if( unity_excluded( Build::sources[i] ) ) { sources.add( Build::sources[i] ); continue; }
+		unitySources.add( i );
+	}
+
+	// Shard assignment is persisted in unity.shards and reused as long as the set of sources (and the shard count)
+	// is unchanged -- a source never moves between shards because it (or another source) changed length, so editing
+	// a source only rebuilds its own shard
+	const usize shardCount = min( static_cast<usize>( processor_count() ), unitySources.count() );
+	List<usize> assignment;
+	const bool rebalance = !unity_assignment_load( pathAssignment, unitySources, shardCount, assignment );
+
+	if( rebalance )
+	{
+		struct UnitySource
+		{
+			usize source;
+			usize lines;
+		};
+
+		// Measure sources by line count (a decent proxy for compile cost)
+		List<UnitySource> measured;
+		for( usize i = 0; i < unitySources.count(); i++ )
+		{
+			const Source &source = Build::sources[unitySources[i]];
+			String contents;
+			ErrorIf( !contents.load( source.srcPath.cstr() ), "Unity: failed to read '%s'", source.srcPath.cstr() );
+			usize lines = 1LLU;
+			const char *data = contents.cstr();
+			for( usize c = 0; c < contents.length_bytes(); c++ ) { lines += data[c] == '\n'; }
+			measured.add( UnitySource { i, lines } );
+		}
+
+		measured.sort( []( const UnitySource &a, const UnitySource &b )
+			{
+				return a.lines != b.lines ? a.lines > b.lines : a.source < b.source;
+			} );
+
+		// Balance into one shard per core: largest sources first, each into the lightest shard (LPT scheduling)
+		List<usize> shardLines;
+		for( usize i = 0; i < shardCount; i++ ) { shardLines.add( 0LLU ); }
+
+		assignment.clear();
+		for( usize i = 0; i < unitySources.count(); i++ ) { assignment.add( 0LLU ); }
+
+		for( UnitySource &unitySource : measured )
+		{
+			usize lightest = 0LLU;
+			for( usize i = 1; i < shardCount; i++ ) { if( shardLines[i] < shardLines[lightest] ) { lightest = i; } }
+			assignment[unitySource.source] = lightest;
+			shardLines[lightest] += unitySource.lines;
+		}
+
+		String contents;
+		contents.append( static_cast<int>( shardCount ) ).append( "\n" );
+		for( usize i = 0; i < unitySources.count(); i++ )
+		{
+			contents.append( static_cast<int>( assignment[i] ) ).append( " " );
+			contents.append( Build::sources[unitySources[i]].srcPath ).append( "\n" );
+		}
+		ErrorIf( !contents.save( pathAssignment ), "Unity: failed to write '%s'", pathAssignment );
+	}
+
+	// Write unity translation units
+	// Shard members keep their gather order so a shard's contents (and therefore its object) only change when its
+	// sources do. Files are rewritten only when their contents change, so ninja (which tracks the #included .cpp files
+	// through the compiler's depfiles) keeps incremental builds incremental.
+	usize unityCount = 0LLU;
+	for( usize shard = 0; shard < shardCount; shard++ )
+	{
+		List<usize> members;
+		for( usize i = 0; i < unitySources.count(); i++ )
+		{
+			if( assignment[i] == shard ) { members.add( unitySources[i] ); }
+		}
+		if( members.count() == 0 ) { continue; }
+
+		// A lone source compiles as itself
+		if( members.count() == 1 ) { sources.add( Build::sources[members[0]] ); continue; }
+
+		String unity;
+		unity.append( "/*\n * File generated by build.exe (-unity=1)\n * Refer to: source/build/build.cpp\n */\n\n" );
+		for( usize index : members )
+		{
+			// root/projects/<project>/output/generated/unity -> root/
+			unity.append( "#include \"" ".." SLASH ".." SLASH ".." SLASH ".." SLASH ".." SLASH );
+			unity.append( Build::sources[index].srcPath ).append( "\"\n" );
+		}
+
+		char pathSrc[PATH_SIZE];
+		char pathObj[PATH_SIZE];
+		snprintf( pathSrc, sizeof( pathSrc ), "%s" SLASH "unity.%u.cpp", pathUnity, static_cast<u32>( shard ) );
+		snprintf( pathObj, sizeof( pathObj ), "objects" SLASH "unity" SLASH "unity.%u%s",
+			static_cast<u32>( shard ), Build::tc.linkerExtensionObj );
+
+		String existing;
+		if( !existing.load( pathSrc ) || !existing.equals( unity ) )
+		{
+			ErrorIf( !unity.save( pathSrc ), "Unity: failed to write '%s'", pathSrc );
+		}
+
+		sources.add( Source { pathSrc, pathObj } );
+		unityCount++;
+	}
+
+	// Logging
+	if( verbose_output() )
+	{
+		Print( PrintColor_Cyan, TAB TAB "%u sources grouped into %u unity sources, %u compiled alone (%s)",
+			unitySources.count(), unityCount, sources.count() - unityCount,
+			rebalance ? "rebalanced" : "shards reused" );
+		PrintLn( PrintColor_White, " (%.3f ms)", timer.elapsed_ms() );
+	}
+
+	Build::sources = static_cast<List<Source> &&>( sources );
+}
+
+
 void BuilderCore::compile_write_ninja()
 {
 	String output;
@@ -73,6 +73,7 @@ namespace Build
 	extern char pathOutputCacheBuild[PATH_SIZE];
 	extern char pathOutputCacheObjects[PATH_SIZE];
 	extern char pathOutputCacheGraphics[PATH_SIZE];
+	extern char pathOutputCacheShaders[PATH_SIZE];
 	extern char pathOutputCacheAssets[PATH_SIZE];
 
 	// Configuration
@@ -174,6 +175,7 @@ public:
 	// Compile
 	virtual void compile_project();
 	virtual void compile_engine();
+	virtual void compile_unity();
 	virtual void compile_write_ninja();
 	virtual void compile_run_ninja();
 
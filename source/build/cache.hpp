@@ -1,7 +1,7 @@
 #pragma once
 
 #include <core/buffer.hpp>
-#include <core/hashmap.hpp>
+#include <core/flathashmap.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -52,9 +52,30 @@ public:
 		entryTableWriting.set( key, entry );
 	}
 
+	// Variable-length records ('data' points into the read buffer and is valid until the next read())
+	bool fetch( CacheKey key, const void *&data, usize &size )
+	{
+		if( entryTableReading.count() == 0 ) { return false; }
+		Cache::Entry entry = entryTableReading.get( key );
+		if( entry.is_null() ) { return false; }
+		Assert( entry.offset + entry.size <= cacheBufferReading.size() );
+		data = cacheBufferReading.data + entry.offset;
+		size = entry.size;
+		return true;
+	}
+
+	void store( CacheKey key, const void *data, usize size )
+	{
+		ErrorIf( entryTableWriting.contains( key ), "CacheKey conflict: %u", key );
+		Cache::Entry entry;
+		entry.offset = cacheBufferWriting.write( data, size );
+		entry.size = size;
+		entryTableWriting.set( key, entry );
+	}
+
 public:
-	HashMap<CacheKey, Entry> entryTableReading { };
-	HashMap<CacheKey, Entry> entryTableWriting { };
+	FlatHashMap<CacheKey, Entry> entryTableReading { };
+	FlatHashMap<CacheKey, Entry> entryTableWriting { };
 	Buffer cacheBufferReading { };
 	Buffer cacheBufferWriting { };
 	bool dirty = false;
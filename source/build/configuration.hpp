@@ -1,5 +1,6 @@
 #pragma once
 
+#include <core/list.hpp>
 #include <core/string.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -11,8 +12,18 @@ struct Configuration
 	String compilerFlagsWarnings;
 	String linkerFlags;
 
+	// Unity Build (-unity=1)
+	List<String> unityExclude;
+
 	// Applications
 	bool showTerminal = false;
+	bool headless = false;
+	int tickRate = 30;
+	bool gfxFrontend = false;
+	bool benchmarkObjects = false;
+
+	// Shaders
+	bool shaderOptimize = true;
 
 	// Steamworks
 	bool steam = false;
@@ -7,6 +7,7 @@
 
 #include <build/assets.hpp>
 #include <build/shaders/compiler.hpp>
+#include <build/shaders/compiler.preprocessor.hpp>
 #include <build/shaders/bytecode.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -52,11 +53,15 @@ namespace Gfx
 
 	// Cache
 	Cache cache;
+	Cache cacheShaders;
 	usize cacheReadOffset = 0LLU;
 	usize cacheFileCount = 0LLU;
 
 	// Logging
 	usize shadersBuilt = 0LLU;
+	usize shadersCached = 0LLU;
+	usize shaderNodesParsed = 0LLU;
+	usize shaderNodesOptimized = 0LLU;
 
 	// Binary
 	Buffer binary;
@@ -64,6 +69,268 @@ namespace Gfx
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Bump when the shader compiler output changes (invalidates shaders.cache)
+#define SHADER_CACHE_VERSION ( 3 )
+
+struct ShaderBuildJob
+{
+	ShaderCompilation *compilations;
+	double *timings;
+};
+
+
+static CacheKey shader_cache_key( const Shader &shader, const ShaderCompilation &compilation )
+{
+	// Content hash (preprocessed source + ShaderType) -- the name keeps identical shaders from colliding
+	u64 hash = Hash::hash64_from( SHADER_CACHE_VERSION, compilation.hash );
+	Hash::hash64_bytes( hash, shader.name.data, shader.name.length_bytes() );
+	return static_cast<CacheKey>( hash );
+}
+
+
+static void shader_build_frontend( usize index, void *context )
+{
+	ShaderBuildJob &job = *reinterpret_cast<ShaderBuildJob *>( context );
+	Shader &shader = Gfx::shaders[index];
+	ShaderCompilation &compilation = job.compilations[index];
+	Timer timer;
+
+	compile_shader_preprocess( shader, compilation, Gfx::shaderFiles[shader.file].path );
+
+	// Cache candidates skip parsing (if the registry precondition fails, compile_shader_generate() parses)
+	if( !Gfx::cacheShaders.entryTableReading.contains( shader_cache_key( shader, compilation ) ) )
+	{
+		compile_shader_parse( shader, compilation );
+	}
+
+	job.timings[index] = timer.elapsed_ms();
+}
+
+
+static u64 shader_registry_hash()
+{
+	// Generated output depends on the registries built up by the shaders before it (IDs, layouts, names)
+	u64 hash = Hash::hash64_from( Gfx::sharedStructs.size(), Gfx::uniformBuffers.size(),
+		Gfx::vertexFormats.size(), Gfx::instanceFormats.size() );
+
+	for( SharedStruct &entry : Gfx::sharedStructs )
+	{
+		Hash::hash64_combine( hash, entry.id, entry.checksum );
+		Hash::hash64_bytes( hash, entry.name.data, entry.name.length_bytes() );
+	}
+
+	for( UniformBuffer &entry : Gfx::uniformBuffers )
+	{
+		Hash::hash64_combine( hash, entry.id, entry.checksum );
+		Hash::hash64_bytes( hash, entry.name.data, entry.name.length_bytes() );
+	}
+
+	for( VertexFormat &entry : Gfx::vertexFormats )
+	{
+		Hash::hash64_combine( hash, entry.id, entry.checksum );
+		Hash::hash64_bytes( hash, entry.name.data, entry.name.length_bytes() );
+	}
+
+	for( InstanceFormat &entry : Gfx::instanceFormats )
+	{
+		Hash::hash64_combine( hash, entry.id, entry.checksum );
+		Hash::hash64_bytes( hash, entry.name.data, entry.name.length_bytes() );
+	}
+
+	return hash;
+}
+
+
+static void shader_cache_record( Buffer &record, const Shader &shader, u64 precondition, const usize registry[4] )
+{
+	record.write<u64>( precondition );
+
+	// Shader
+	for( ShaderStage stage = 0; stage < SHADERSTAGE_COUNT; stage++ )
+	{
+		String::write( record, shader.outputs[stage] );
+		record.write<usize>( shader.uniformBufferIDs[stage].size() );
+		for( usize i = 0; i < shader.uniformBufferIDs[stage].size(); i++ )
+		{
+			record.write<u32>( shader.uniformBufferIDs[stage][i] );
+			record.write<int>( shader.uniformBufferSlots[stage][i] );
+		}
+	}
+	record.write<u32>( shader.vertexFormatID );
+	record.write<u32>( shader.instanceFormatID );
+	String::write( record, shader.header );
+	String::write( record, shader.source );
+	record.write<u8>( shader.stages );
+
+	// Registry entries added by this shader
+	record.write<usize>( Gfx::sharedStructs.size() - registry[0] );
+	for( usize i = registry[0]; i < Gfx::sharedStructs.size(); i++ )
+	{
+		const SharedStruct &entry = Gfx::sharedStructs[i];
+		String::write( record, entry.name );
+		record.write<u32>( entry.checksum );
+		String::write( record, entry.headerTight );
+		String::write( record, entry.headerAlign );
+		record.write<int>( entry.alignment );
+	}
+
+	record.write<usize>( Gfx::uniformBuffers.size() - registry[1] );
+	for( usize i = registry[1]; i < Gfx::uniformBuffers.size(); i++ )
+	{
+		const UniformBuffer &entry = Gfx::uniformBuffers[i];
+		String::write( record, entry.name );
+		record.write<u32>( entry.checksum );
+		String::write( record, entry.header );
+		String::write( record, entry.source );
+	}
+
+	record.write<usize>( Gfx::vertexFormats.size() - registry[2] );
+	for( usize i = registry[2]; i < Gfx::vertexFormats.size(); i++ )
+	{
+		const VertexFormat &entry = Gfx::vertexFormats[i];
+		String::write( record, entry.name );
+		record.write<u32>( entry.checksum );
+		String::write( record, entry.header );
+		String::write( record, entry.source );
+	}
+
+	record.write<usize>( Gfx::instanceFormats.size() - registry[3] );
+	for( usize i = registry[3]; i < Gfx::instanceFormats.size(); i++ )
+	{
+		const InstanceFormat &entry = Gfx::instanceFormats[i];
+		String::write( record, entry.name );
+		record.write<u32>( entry.checksum );
+		String::write( record, entry.header );
+		String::write( record, entry.source );
+	}
+}
+
+
+template <typename T> static T &shader_cache_register( List<T> &list, HashMap<u32, u32> &cache, Buffer &record )
+{
+	T &entry = list.add( { } );
+	String::read( record, entry.name );
+	record.read<u32>( entry.checksum );
+	entry.id = static_cast<u32>( list.size() - 1 );
+	cache.add( checksum_xcrc32( entry.name.data, entry.name.length_bytes(), 0 ), entry.id );
+	return entry;
+}
+
+
+static bool shader_cache_fetch( Shader &shader, ShaderCompilation &compilation, Buffer &record )
+{
+	const void *data;
+	usize size;
+	if( !Gfx::cacheShaders.fetch( shader_cache_key( shader, compilation ), data, size ) ) { return false; }
+
+	record.write( data, size );
+	record.seek_start();
+
+	// Output is only valid if the registries match the state it was generated against
+	if( record.read<u64>() != shader_registry_hash() ) { record.clear(); return false; }
+
+	// Shader
+	for( ShaderStage stage = 0; stage < SHADERSTAGE_COUNT; stage++ )
+	{
+		String::read( record, shader.outputs[stage] );
+		const usize count = record.read<usize>();
+		for( usize i = 0; i < count; i++ )
+		{
+			shader.uniformBufferIDs[stage].add( record.read<u32>() );
+			shader.uniformBufferSlots[stage].add( record.read<int>() );
+		}
+	}
+	shader.vertexFormatID = record.read<u32>();
+	shader.instanceFormatID = record.read<u32>();
+	String::read( record, shader.header );
+	String::read( record, shader.source );
+	shader.stages = record.read<u8>();
+
+	// Registry entries added by this shader
+	for( usize count = record.read<usize>(); count > 0; count-- )
+	{
+		SharedStruct &entry = shader_cache_register( Gfx::sharedStructs, Gfx::sharedStructCache, record );
+		String::read( record, entry.headerTight );
+		String::read( record, entry.headerAlign );
+		record.read<int>( entry.alignment );
+	}
+
+	for( usize count = record.read<usize>(); count > 0; count-- )
+	{
+		UniformBuffer &entry = shader_cache_register( Gfx::uniformBuffers, Gfx::uniformBufferCache, record );
+		String::read( record, entry.header );
+		String::read( record, entry.source );
+	}
+
+	for( usize count = record.read<usize>(); count > 0; count-- )
+	{
+		VertexFormat &entry = shader_cache_register( Gfx::vertexFormats, Gfx::vertexFormatCache, record );
+		String::read( record, entry.header );
+		String::read( record, entry.source );
+	}
+
+	for( usize count = record.read<usize>(); count > 0; count-- )
+	{
+		InstanceFormat &entry = shader_cache_register( Gfx::instanceFormats, Gfx::instanceFormatCache, record );
+		String::read( record, entry.header );
+		String::read( record, entry.source );
+	}
+
+	return true;
+}
+
+
+template <typename T> static void shader_registry_truncate( List<T> &registry, HashMap<u32, u32> &cache,
+	const usize size )
+{
+	while( registry.size() > size )
+	{
+		const T &entry = registry.back();
+		cache.remove( checksum_xcrc32( entry.name.data, entry.name.length_bytes(), 0 ) );
+		registry.remove( registry.size() - 1 );
+	}
+}
+
+
+static void shader_check_optimizer()
+{
+	// Optimizer regression check: the fixture is compiled like a project shader, and each of its
+	// '// expect: ' lines must appear in the generated code. Registry entries it adds are rolled back, so
+	// nothing from the fixture reaches the project
+	char path[PATH_SIZE];
+	strjoin( path, Build::pathEngine, SLASH "build" SLASH "shaders" SLASH "compiler.optimizer.check" );
+
+	String fixture;
+	ErrorIf( !fixture.load( path ), "Failed to read shader optimizer check: %s", path );
+
+	const usize registry[4] = { Gfx::sharedStructs.size(), Gfx::uniformBuffers.size(),
+		Gfx::vertexFormats.size(), Gfx::instanceFormats.size() };
+
+	Shader shader { "check_optimizer", ShaderType_GLSL };
+	compile_shader( shader, path );
+	const String &output = shader.outputs[ShaderStage_Fragment];
+
+	const char *expect = "// expect: ";
+	const usize expectLength = strlen( expect );
+	for( usize start = fixture.find( expect ); start != USIZE_MAX; start = fixture.find( expect, start + 1 ) )
+	{
+		usize end = fixture.find( "\n", start );
+		if( end == USIZE_MAX ) { end = fixture.length_bytes(); }
+		if( end > start && fixture.data[end - 1] == '\r' ) { end--; }
+
+		const String expected = fixture.substr( start + expectLength, end );
+		ErrorIf( !output.contains( expected.cstr() ),
+			"Shader optimizer check failed (%s): generated code is missing '%s'", path, expected.cstr() );
+	}
+
+	shader_registry_truncate( Gfx::sharedStructs, Gfx::sharedStructCache, registry[0] );
+	shader_registry_truncate( Gfx::uniformBuffers, Gfx::uniformBufferCache, registry[1] );
+	shader_registry_truncate( Gfx::vertexFormats, Gfx::vertexFormatCache, registry[2] );
+	shader_registry_truncate( Gfx::instanceFormats, Gfx::instanceFormatCache, registry[3] );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void Gfx::begin()
 {
 	// Paths
@@ -120,56 +387,102 @@ void Gfx::build()
 		const ShaderType shaderType = ShaderType_NONE;
 	#endif
 
-	// Build Shaders
-	for( FileInfo &fileInfo : shaderFiles )
+	// Register Shaders (one per '#variant' permutation, named <shader>_<KEY>...)
+	for( usize file = 0; file < shaderFiles.size(); file++ )
 	{
-		// Register
+		FileInfo &fileInfo = shaderFiles[file];
 		char shaderName[PATH_SIZE];
 		path_get_filename( shaderName, sizeof( shaderName ), fileInfo.path );
 		path_remove_extension( shaderName, sizeof( shaderName ) );
 
-#if 0
-		// Compile Shader
-		for( ShaderType i = 0; i < 4; i++ )
-		{
-			Shader &shader = Gfx::shaders.add( Shader { shaderName, i } );
+		List<String> variants;
+		ErrorIf( !preprocess_variants( fileInfo.path, variants ), "Failed to read shader variants: %s", fileInfo.path );
+		ErrorIf( variants.size() > SHADER_VARIANT_KEYS_MAX, "Shader '%s' declares too many #variant keys (%llu, max: %d)",
+			shaderName, variants.size(), SHADER_VARIANT_KEYS_MAX );
 
-			Timer timer;
-			if( verbose_output() )
+		const u32 base = static_cast<u32>( Gfx::shaders.size() );
+		for( u32 key = 0; key < ( 1U << variants.size() ); key++ )
+		{
+			Shader &shader = Gfx::shaders.add( Shader { shaderName, shaderType } );
+			for( usize i = 0; i < variants.size(); i++ )
 			{
-				Print( PrintColor_White, TAB TAB "Compile " );
-				Print( PrintColor_Cyan, "%s", fileInfo.name );
+				if( key & ( 1U << i ) ) { shader.name.append( "_" ).append( variants[i] ); }
 			}
 
-			compile_shader( shader, fileInfo.path );
-			Gfx::shadersBuilt++;
-
-			if( verbose_output() )
-			{
-				PrintLn( PrintColor_White, " (%.2f ms)", timer.elapsed_ms() );
-			}
+			shader.variants = variants;
+			shader.file = static_cast<u32>( file );
+			shader.variantBase = base;
+			shader.variantKey = key;
 		}
-#else
-		// Compile Shader
-		Shader &shader = Gfx::shaders.add( Shader { shaderName, shaderType } );
+	}
+	ErrorIf( Gfx::shaders.size() > U16_MAX, "Exceeded maximum shader count (%llu)", Gfx::shaders.size() );
 
+	// Optimizer Check
+	if( Build::config.shaderOptimize ) { shader_check_optimizer(); }
+
+	// Shader Cache
+	if( !Build::cache.dirty ) { Gfx::cacheShaders.read( Build::pathOutputCacheShaders ); }
+
+	// Preprocess & Parse (parallel)
+	List<ShaderCompilation> compilations;
+	List<double> timings;
+	for( usize i = 0; i < shaders.size(); i++ ) { compilations.add( { } ); timings.add( 0.0 ); }
+
+	ShaderBuildJob job { compilations.data, timings.data };
+	parallel_for( shaders.size(), shader_build_frontend, &job );
+
+	// Generate (serial: registry IDs are assigned in shader order)
+	for( usize i = 0; i < shaders.size(); i++ )
+	{
+		Shader &shader = Gfx::shaders[i];
+		ShaderCompilation &compilation = compilations[i];
 		Timer timer;
-		if( verbose_output() )
+
+		Buffer record;
+		const bool cached = shader_cache_fetch( shader, compilation, record );
+		if( cached )
 		{
-			Print( PrintColor_White, TAB TAB "Compile " );
-			Print( PrintColor_Cyan, "%s", fileInfo.name );
+			Gfx::shadersCached++;
+		}
+		else
+		{
+			const u64 precondition = shader_registry_hash();
+			usize registry[4] = { Gfx::sharedStructs.size(), Gfx::uniformBuffers.size(),
+				Gfx::vertexFormats.size(), Gfx::instanceFormats.size() };
+
+			compile_shader_generate( shader, compilation );
+			Gfx::shadersBuilt++;
+			Gfx::shaderNodesParsed += compilation.nodesParsed;
+			Gfx::shaderNodesOptimized += compilation.nodesOptimized;
+
+			shader_cache_record( record, shader, precondition, registry );
 		}
 
-		compile_shader( shader, fileInfo.path );
-		Gfx::shadersBuilt++;
+		Gfx::cacheShaders.store( shader_cache_key( shader, compilation ), record.data, record.size() );
 
 		if( verbose_output() )
 		{
-			PrintLn( PrintColor_White, " (%.2f ms)", timer.elapsed_ms() );
+			Print( PrintColor_White, TAB TAB "Compile " );
+			Print( PrintColor_Cyan, "%s", shader.name.cstr() );
+			if( cached )
+			{
+				PrintLn( PrintColor_Magenta, " (cached)" );
+			}
+			else
+			{
+				Print( PrintColor_White, " (%.2f ms)", timings[i] + timer.elapsed_ms() );
+				if( compilation.nodesParsed > 0 )
+				{
+					Print( PrintColor_White, " (%llu -> %llu AST nodes)",
+						compilation.nodesParsed, compilation.nodesOptimized );
+				}
+				Print( "\n" );
+			}
 		}
-#endif
 	}
 
+	Gfx::cacheShaders.write( Build::pathOutputCacheShaders );
+
 	// Binary
 	for( Shader &shader : shaders )
 	{
@@ -270,6 +583,11 @@ void Gfx::codegen()
 				"u32 instanceFormat;",
 				"const char *name;" );
 
+			assets_struct( header,
+				"ShaderVariantEntry",
+				"u16 base;",
+				"u8 keys;" );
+
 			header.append( "enum_class\n(\n\tShader, u32,\n\n" );
 			for( Shader &shader : shaders )
 			{
@@ -282,6 +600,22 @@ void Gfx::codegen()
 			header.append( "\tconstexpr u32 shaderCount = " );
 			header.append( static_cast<int>( Gfx::shaders.size() ) ).append( ";\n" );
 			header.append( "\textern const ShaderEntry shaderEntries[];\n" );
+			header.append( "\textern const ShaderVariantEntry shaderVariantEntries[];\n" );
+			header.append( "}\n\n" );
+
+			// Variant key bits for GfxRenderCommand::shader( Shader, u32 )
+			header.append( "namespace ShaderVariant\n{\n" );
+			for( Shader &shader : shaders )
+			{
+				if( shader.variantKey != 0 || shader.variants.size() == 0 ) { continue; }
+				header.append( "\tnamespace " ).append( shader.name ).append( "\n\t{\n" );
+				for( usize i = 0; i < shader.variants.size(); i++ )
+				{
+					header.append( "\t\tconstexpr u32 " ).append( shader.variants[i] );
+					header.append( " = ( 1U << " ).append( static_cast<int>( i ) ).append( " );\n" );
+				}
+				header.append( "\t}\n" );
+			}
 			header.append( "}\n\n" );
 		}
 
@@ -476,6 +810,15 @@ void Gfx::codegen()
 
 				source.append( " }, // " ).append( shader.name ).append( "\n" );
 			}
+			source.append( "\t};\n\n" );
+
+			source.append( "\tconst ShaderVariantEntry shaderVariantEntries[shaderCount] =\n\t{\n" );
+			for( Shader &shader : shaders )
+			{
+				snprintf( buffer, sizeof( buffer ), "\t\t{ %u, %u }, // ",
+					shader.variantBase, static_cast<u32>( shader.variants.size() ) );
+				source.append( buffer ).append( shader.name ).append( "\n" );
+			}
 			source.append( "\t};\n" );
 			source.append( "}\n\n" );
 		}
@@ -60,6 +60,13 @@ struct Shader
 	String name;
 	ShaderType type;
 
+	// Permutations ('#variant' keys) -- every combination is a separate Shader, stored contiguously so that
+	// Gfx::shaders[variantBase + variantKey] is the permutation with the matching key bits enabled
+	List<String> variants;
+	u32 file = 0;
+	u32 variantBase = 0;
+	u32 variantKey = 0;
+
 	// C++ Code
 	List<u32> uniformBufferIDs[SHADERSTAGE_COUNT];
 	List<int> uniformBufferSlots[SHADERSTAGE_COUNT];
@@ -70,8 +77,8 @@ struct Shader
 
 	// Shader Code
 	String outputs[SHADERSTAGE_COUNT];
-	usize offset[SHADERSTAGE_COUNT];
-	usize size[SHADERSTAGE_COUNT];
+	usize offset[SHADERSTAGE_COUNT] = { };
+	usize size[SHADERSTAGE_COUNT] = { };
 	u8 stages = 0;
 };
 
@@ -176,6 +183,7 @@ namespace Gfx
 
 	// Cache
 	extern Cache cache;
+	extern Cache cacheShaders;
 	extern usize cacheFileCount;
 	extern usize cacheReadOffset;
 	extern void cache_read( const char *path );
@@ -184,6 +192,9 @@ namespace Gfx
 
 	// Logging
 	extern usize shadersBuilt;
+	extern usize shadersCached;
+	extern usize shaderNodesParsed;
+	extern usize shaderNodesOptimized;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
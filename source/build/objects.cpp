@@ -891,6 +891,15 @@ void ObjectFile::keyword_PRIVATE_PUBLIC_GLOBAL( const String &buffer, Keyword &k
 			// Copy expression
 			String expression = buffer.substr( start, end ).trim();
 
+			// REPLICATED?
+			if( expression.contains_at( "REPLICATED", 0 ) && char_is_keyword_delimiter( expression[10] ) )
+			{
+				ErrorIfLine( !isVariable, line_at( buffer, keyword.start ),
+					"REPLICATED is only valid on variable declarations" );
+				expression.remove( 0, 10 ).trim();
+				keyword_REPLICATED( buffer, keyword, expression );
+			}
+
 			// Format expression
 			expression.replace( "\n", "\n\t" );
 
@@ -1005,6 +1014,32 @@ void ObjectFile::keyword_PRIVATE_PUBLIC_GLOBAL( const String &buffer, Keyword &k
 }
 
 
+void ObjectFile::keyword_REPLICATED( const String &buffer, Keyword &keyword, const String &expression )
+{
+	// Split declaration (e.g. "float x = 0.0f;" -> type: "float", name: "x")
+	const usize line = line_at( buffer, keyword.start );
+	const usize end = min( expression.find( "=" ), min( expression.find( "{" ), expression.find( ";" ) ) );
+	String declaration = expression.substr( 0, end ).trim();
+	ErrorIfLine( !networked, line, "REPLICATED variables require %s( true )", g_KEYWORDS[KeywordID_NETWORKED] );
+	ErrorIfLine( declaration.contains_at( "static ", 0 ) || declaration.contains_at( "const ", 0 ), line,
+		"REPLICATED variables can not be static or const" );
+	ErrorIfLine( declaration.find( "[" ) != USIZE_MAX || declaration.find( "*" ) != USIZE_MAX ||
+		declaration.find( "&" ) != USIZE_MAX || declaration.find( "," ) != USIZE_MAX, line,
+		"REPLICATED variables must be single value declarations (no arrays, pointers, or references)" );
+
+	usize nameStart = declaration.length_bytes();
+	while( nameStart > 0 && !char_is_keyword_delimiter( declaration[nameStart - 1] ) ) { nameStart--; }
+	String name = declaration.substr( nameStart, declaration.length_bytes() );
+	String typeName = declaration.substr( 0, nameStart ).trim();
+	ErrorIfLine( name.length_bytes() == 0 || typeName.length_bytes() == 0, line,
+		"REPLICATED variable has an invalid declaration" );
+
+	// Register variable
+	replicatedNames.add( static_cast<String &&>( name ) );
+	replicatedTypes.add( static_cast<String &&>( typeName ) );
+}
+
+
 void ObjectFile::keyword_FRIEND( const String &buffer, Keyword &keyword )
 {
 	usize start = 0;
@@ -1225,11 +1260,19 @@ void ObjectFile::validate()
 			name.cstr(), g_KEYWORDS[KeywordID_DESERIALIZE], g_KEYWORDS[KeywordID_SERIALIZE] );
 
 		// Networked Requirement
-		ErrorIf( networked && ( serializeSource.length_bytes() == 0 || deserializeSource.length_bytes() == 0 ),
-			"%s marked as %s, but missing required %s & %s functions",
+		ErrorIf( networked && replicated_count() == 0 &&
+			( serializeSource.length_bytes() == 0 || deserializeSource.length_bytes() == 0 ),
+			"%s marked as %s, but missing REPLICATED variables or %s & %s functions",
 			name.cstr(), g_KEYWORDS[KeywordID_NETWORKED], g_KEYWORDS[KeywordID_SERIALIZE],
 			g_KEYWORDS[KeywordID_DESERIALIZE] );
 	}
+
+	// REPLICATED validation
+	{
+		// Field masks are u32 (see: manta/replication.hpp)
+		ErrorIf( replicated_count() > 32, "%s exceeds 32 REPLICATED variables (including inherited)",
+			name.cstr() );
+	}
 }
 
 
@@ -1432,8 +1475,111 @@ void ObjectFile::write_source()
 		output.append( "\tstatic bool deserialize( class Buffer &buffer, OBJECT_ENCODER<Object::" );
 		output.append( name ).append( "> &context ) { return context.object._deserialize( buffer ); }\n" );
 	}
+	if( replicatedNames.size() > 0 )
+	{
+		// REPLICATED snapshot (last sampled values)
+		output.append( "\tstruct Replicated\n\t{\n" );
+		for( usize i = 0; i < replicatedNames.size(); i++ )
+		{
+			output.append( "\t\t" ).append( replicatedTypes[i] ).append( " " );
+			output.append( replicatedNames[i] ).append( ";\n" );
+		}
+		output.append( "\t};\n" );
+
+		// Copy changed variables into the snapshot (returns changed variable mask)
+		output.append( "\tstatic u32 network_sample( void *data, Replicated &state )\n\t{\n" );
+		output.append( "\t\tOBJECT_ENCODER<Object::" ).append( name ).append( "> context { data };\n" );
+		output.append( "\t\tu32 mask = 0U;\n" );
+		for( usize i = 0; i < replicatedNames.size(); i++ )
+		{
+			output.append( "\t\tif( Replication::sample( state." ).append( replicatedNames[i] );
+			output.append( ", context.object." ).append( replicatedNames[i] );
+			output.append( " ) ) { mask |= ( 1U << " ).append( static_cast<u32>( i ) ).append( " ); }\n" );
+		}
+		output.append( "\t\treturn mask;\n\t}\n" );
+
+		// Bit-pack masked variables from the snapshot
+		output.append( "\tstatic void network_write( BitWriter &bits, const Replicated &state, const u32 mask )\n\t{\n" );
+		for( usize i = 0; i < replicatedNames.size(); i++ )
+		{
+			output.append( "\t\tif( mask & ( 1U << " ).append( static_cast<u32>( i ) ).append( " ) ) { " );
+			output.append( "Replication::write( bits, state." ).append( replicatedNames[i] ).append( " ); }\n" );
+		}
+		output.append( "\t}\n" );
+
+		// Unpack masked variables into the object
+		output.append( "\tstatic void network_read( BitReader &bits, void *data, const u32 mask )\n\t{\n" );
+		output.append( "\t\tOBJECT_ENCODER<Object::" ).append( name ).append( "> context { data };\n" );
+		for( usize i = 0; i < replicatedNames.size(); i++ )
+		{
+			output.append( "\t\tif( mask & ( 1U << " ).append( static_cast<u32>( i ) ).append( " ) ) { " );
+			output.append( "Replication::read( bits, context.object." ).append( replicatedNames[i] ).append( " ); }\n" );
+		}
+		output.append( "\t}\n" );
+	}
 	output.append( "};\n\n" );
 
+	// Replication (REPLICATED variables of this object and its parents)
+	if( instantiable() && replicated_count() > 0 )
+	{
+		List<ObjectFile *> slices;
+		for( ObjectFile *par = this; par != nullptr; par = par->parent )
+		{
+			if( par->replicatedNames.size() > 0 ) { slices.insert( 0, par ); }
+		}
+
+		output.append( "template <> struct CoreObjects::OBJECT_REPLICATION<Object::" ).append( name );
+		output.append( ">\n{\n" );
+
+		// State
+		output.append( "\tstruct State\n\t{\n" );
+		for( ObjectFile *slice : slices )
+		{
+			output.append( "\t\tOBJECT_ENCODER<Object::" ).append( slice->name ).append( ">::Replicated " );
+			output.append( slice->name ).append( ";\n" );
+		}
+		output.append( "\t};\n\n" );
+
+		// sample()
+		u32 shift = 0;
+		output.append( "\tstatic u32 sample( void *object, void *state )\n\t{\n" );
+		output.append( "\t\tState &s = *reinterpret_cast<State *>( state );\n" );
+		output.append( "\t\tu32 mask = 0U;\n" );
+		for( ObjectFile *slice : slices )
+		{
+			output.append( "\t\tmask |= OBJECT_ENCODER<Object::" ).append( slice->name );
+			output.append( ">::network_sample( object, s." ).append( slice->name ).append( " ) << " );
+			output.append( shift ).append( ";\n" );
+			shift += static_cast<u32>( slice->replicatedNames.size() );
+		}
+		output.append( "\t\treturn mask;\n\t}\n\n" );
+
+		// write()
+		shift = 0;
+		output.append( "\tstatic void write( BitWriter &bits, const void *state, const u32 mask )\n\t{\n" );
+		output.append( "\t\tconst State &s = *reinterpret_cast<const State *>( state );\n" );
+		for( ObjectFile *slice : slices )
+		{
+			output.append( "\t\tOBJECT_ENCODER<Object::" ).append( slice->name );
+			output.append( ">::network_write( bits, s." ).append( slice->name ).append( ", mask >> " );
+			output.append( shift ).append( " );\n" );
+			shift += static_cast<u32>( slice->replicatedNames.size() );
+		}
+		output.append( "\t}\n\n" );
+
+		// read()
+		shift = 0;
+		output.append( "\tstatic bool read( BitReader &bits, void *object, const u32 mask )\n\t{\n" );
+		for( ObjectFile *slice : slices )
+		{
+			output.append( "\t\tOBJECT_ENCODER<Object::" ).append( slice->name );
+			output.append( ">::network_read( bits, object, mask >> " ).append( shift ).append( " );\n" );
+			shift += static_cast<u32>( slice->replicatedNames.size() );
+		}
+		output.append( "\t\treturn bits.valid();\n\t}\n" );
+		output.append( "};\n\n" );
+	}
+
 	// Constructors
 	for( String &str : constructorSource )
 	{
@@ -2348,6 +2494,7 @@ void Objects::codegen_source_objects( String &output )
 	output.append( "#include <vendor/new.hpp>\n" );
 	output.append( "#include <core/serializer.hpp>\n" );
 	output.append( "#include <manta/objects.hpp>\n" );
+	output.append( "#include <manta/replication.hpp>\n" );
 	output.append( "\n" );
 
 	// SOURCE_INCLUDES
@@ -2378,6 +2525,9 @@ void Objects::codegen_source_objects( String &output )
 	// Object Classes
 	for( ObjectFile *object : objectFilesSorted ) { object->write_source(); }
 
+	// Replication
+	generate_source_objects_replication( output );
+
 	// EOF
 	output.append( COMMENT_BREAK );
 
@@ -2435,6 +2585,27 @@ void Objects::generate_source_objects_events( String &output )
 }
 
 
+void Objects::generate_source_objects_replication( String &output )
+{
+	// TYPE_REPLICATION (emitted after the object classes; requires OBJECT_REPLICATION<...> specializations)
+	output.append( COMMENT_BREAK "\n\n" );
+	output.append( "const CoreObjects::TypeReplication CoreObjects::TYPE_REPLICATION[CoreObjects::TYPE_COUNT] =\n{\n" );
+	for( ObjectFile *object : objectFilesSorted )
+	{
+		const u32 count = object->instantiable() ? object->replicated_count() : 0;
+		if( count == 0 ) { output.append( "\t{ 0, 0, nullptr, nullptr, nullptr },\n" ); continue; }
+
+		String replication;
+		replication.append( "OBJECT_REPLICATION<Object::" ).append( object->name ).append( ">" );
+		output.append( "\t{ " ).append( count ).append( ", sizeof( " ).append( replication ).append( "::State ), " );
+		output.append( replication ).append( "::sample, " );
+		output.append( replication ).append( "::write, " );
+		output.append( replication ).append( "::read },\n" );
+	}
+	output.append( "};\n\n" );
+}
+
+
 String Objects::generate_source_objects_events_category( String &output, u8 eventID, const String &category )
 {
 	String event;
@@ -152,6 +152,7 @@ struct ObjectFile
 	void keyword_FRIEND( const String &buffer, Keyword &keyword );
 	void keyword_CATEGORY( const String &buffer, Keyword &keyword );
 	void keyword_VERSIONS( const String &buffer, Keyword &keyword );
+	void keyword_REPLICATED( const String &buffer, Keyword &keyword, const String &expression );
 
 	bool instantiable()
 	{
@@ -161,6 +162,17 @@ struct ObjectFile
 		return true;
 	}
 
+	u32 replicated_count() const
+	{
+		// REPLICATED variables of this object and its parents
+		u32 count = 0;
+		for( const ObjectFile *par = this; par != nullptr; par = par->parent )
+		{
+			count += static_cast<u32>( par->replicatedNames.size() );
+		}
+		return count;
+	}
+
 	// ObjectFile Info
 	String name;
 	String type;
@@ -215,6 +227,9 @@ struct ObjectFile
 	List<String> inheritedFunctions;
 	List<String> inheritedEvents;
 
+	List<String> replicatedNames;
+	List<String> replicatedTypes;
+
 	String versionsHeader;
 	String writeHeader;
 	String writeSource;
@@ -277,6 +292,7 @@ namespace Objects
 	extern void codegen_source_objects( String &output );
 	extern void generate_source_objects_events( String &output );
 	extern String generate_source_objects_events_category( String &output, const u8 eventID, const String &category );
+	extern void generate_source_objects_replication( String &output );
 
 	// Cache
 	extern Cache cache;
@@ -9,42 +9,40 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void compile_shader( Shader &shader, const char *path )
+static void compile_shader_paths( const Shader &shader, String &pathPreprocessed, String &pathOutput )
 {
-	// Setup
-	char filename[PATH_SIZE];
-	char filenameOutput[PATH_SIZE];
-	char pathInput[PATH_SIZE];
-	char pathPreprocessed[PATH_SIZE];
-	char pathOutput[PATH_SIZE];
+	// Named after the shader (not the file) so that each permutation gets its own output
+	const char *filename = shader.name.cstr();
 
-	// Paths
-	{
-		// Input
-		strjoin( pathInput, path );
+	// Preprocess
+	pathPreprocessed.clear();
+	pathPreprocessed.append( Build::pathOutputGeneratedShaders ).append( SLASH ).append( filename );
+	pathPreprocessed.append( ".preprocessed" );
 
-		// Filename
-		path_get_filename( filename, sizeof( filename ), pathInput );
-		path_change_extension( filename, sizeof( filename ), filename, "" );
+	// Output
+	const char *shaderTypeExtensions[] =
+	{
+		".generated.none",  // ShaderType_NONE
+		".generated.hlsl",  // ShaderType_HLSL
+		".generated.glsl",  // ShaderType_GLSL
+		".generated.metal", // ShaderType_METAL
+	};
+	static_assert( ARRAY_LENGTH( shaderTypeExtensions ) == SHADERTYPE_COUNT, "Missing ShaderType!" );
+
+	pathOutput.clear();
+	pathOutput.append( Build::pathOutputGeneratedShaders ).append( SLASH ).append( filename );
+	pathOutput.append( shaderTypeExtensions[shader.type] );
+}
 
-		// Preprocess
-		strjoin( pathPreprocessed, Build::pathOutputGeneratedShaders, SLASH, filename, ".preprocessed" );
 
-		// Output
-		const char *shaderTypeExtensions[] =
-		{
-			".generated.none",  // ShaderType_NONE
-			".generated.hlsl",  // ShaderType_HLSL
-			".generated.glsl",  // ShaderType_GLSL
-			".generated.metal", // ShaderType_METAL
-		};
-		static_assert( ARRAY_LENGTH( shaderTypeExtensions ) == SHADERTYPE_COUNT, "Missing ShaderType!" );
-
-		strjoin( pathOutput, Build::pathOutputGeneratedShaders, SLASH, filename, shaderTypeExtensions[shader.type] );
-	}
+void compile_shader_preprocess( Shader &shader, ShaderCompilation &compilation, const char *path )
+{
+	// Paths
+	compile_shader_paths( shader, compilation.pathPreprocessed, compilation.pathOutput );
 
 	// Preprocessor
-	static const char *pipelineMacros[1];
+	const char *pipelineMacros[1 + SHADER_VARIANT_KEYS_MAX];
+	int pipelineMacrosCount = 1;
 	switch( shader.type )
 	{
 		case ShaderType_HLSL: pipelineMacros[0] = "SHADER_HLSL"; break;
@@ -52,14 +50,44 @@ void compile_shader( Shader &shader, const char *path )
 		case ShaderType_METAL: pipelineMacros[0] = "SHADER_METAL"; break;
 		default: pipelineMacros[0] = ""; break;
 	}
-	String file;
-	preprocess_shader( pathInput, file, pipelineMacros, 1 );
 
-	// Parse
-	ShaderCompiler::Parser parser { shader, pathPreprocessed };
+	// Variant keys enabled by this permutation are #define'd, the rest stay undefined (so #ifdef branches of
+	// disabled keys never reach the parser)
+	Assert( shader.variants.size() <= SHADER_VARIANT_KEYS_MAX );
+	for( usize i = 0; i < shader.variants.size(); i++ )
 	{
-		parser.parse( reinterpret_cast<char *>( file.data ) );
+		if( shader.variantKey & ( 1U << i ) ) { pipelineMacros[pipelineMacrosCount++] = shader.variants[i].cstr(); }
 	}
+	preprocess_shader( path, compilation.source, pipelineMacros, pipelineMacrosCount );
+
+	// Content Hash
+	compilation.hash = Hash::hash64_from( shader.type, Build::config.shaderOptimize );
+	Hash::hash64_bytes( compilation.hash, compilation.source.data, compilation.source.length_bytes() );
+}
+
+
+void compile_shader_parse( Shader &shader, ShaderCompilation &compilation )
+{
+	Assert( compilation.parser == nullptr );
+	compilation.parser = new ( memory_alloc( sizeof( ShaderCompiler::Parser ) ) )
+		ShaderCompiler::Parser { shader, compilation.pathPreprocessed.cstr() };
+	compilation.parser->parse( reinterpret_cast<char *>( compilation.source.data ) );
+
+	// Optimize (AST passes shared by every stage)
+	if( Build::config.shaderOptimize )
+	{
+		ShaderCompiler::Optimizer optimizer { *compilation.parser };
+		optimizer.optimize_program();
+		compilation.nodesParsed = optimizer.nodesBefore;
+		compilation.nodesOptimized = optimizer.nodesAfter;
+	}
+}
+
+
+void compile_shader_generate( Shader &shader, ShaderCompilation &compilation )
+{
+	if( compilation.parser == nullptr ) { compile_shader_parse( shader, compilation ); }
+	ShaderCompiler::Parser &parser = *compilation.parser;
 
 	// Generate
 	{
@@ -112,7 +140,8 @@ void compile_shader( Shader &shader, const char *path )
 	// Write
 	{
 #if COMPILE_DEBUG
-		String output = "";
+		MemoryScratchScope scratch;
+		String output { scratch };
 		output.append( COMMENT_BREAK );
 		for( ShaderStage stage = 0; stage < SHADERSTAGE_COUNT; stage++ )
 		{
@@ -121,9 +150,23 @@ void compile_shader( Shader &shader, const char *path )
 			output.append( shader.outputs[stage] );
 			output.append( COMMENT_BREAK );
 		}
-		output.save( pathOutput );
+		output.save( compilation.pathOutput.cstr() );
 #endif
 	}
+
+	// Free
+	compilation.parser->~Parser();
+	memory_free( compilation.parser );
+	compilation.parser = nullptr;
+}
+
+
+void compile_shader( Shader &shader, const char *path )
+{
+	ShaderCompilation compilation;
+	compile_shader_preprocess( shader, compilation, path );
+	compile_shader_parse( shader, compilation );
+	compile_shader_generate( shader, compilation );
 }
 
 
@@ -1012,7 +1012,8 @@ bool Generator::generate_structure_gfx_shared_struct( NodeStruct *node )
 	const VariableID last = type.memberFirst + type.memberCount;
 
 	// Layout Identifier
-	String layout;
+	MemoryScratchScope scratch;
+	String layout { scratch };
 	for( VariableID i = first; i < last; i++ )
 	{
 		Type &memberType = parser.types[parser.variables[i].typeID];
@@ -1088,7 +1089,8 @@ bool Generator::generate_structure_gfx_uniform_buffer( NodeStruct *node )
 	int structureByteOffset = 0;
 
 	// Layout Identifier
-	String layout;
+	MemoryScratchScope scratch;
+	String layout { scratch };
 	for( VariableID i = first; i < last; i++ )
 	{
 		Type &memberType = parser.types[parser.variables[i].typeID];
@@ -1171,7 +1173,8 @@ bool Generator::generate_structure_gfx_instance( NodeStruct *node )
 	const VariableID last = type.memberFirst + type.memberCount;
 
 	// Layout identifier
-	String layout;
+	MemoryScratchScope scratch;
+	String layout { scratch };
 	for( VariableID i = first; i < last; i++ )
 	{
 		Type &memberType = parser.types[parser.variables[i].typeID];
@@ -1232,6 +1235,7 @@ bool Generator::generate_structure_gfx_instance( NodeStruct *node )
 			// 2 Bytes
 			case InputFormat_UNORM16:
 			case InputFormat_UINT16:
+			case InputFormat_FLOAT16: // IEEE 754 half bits (see: float_to_half)
 				memberTypeName = "u16";
 			break;
 
@@ -1251,7 +1255,6 @@ bool Generator::generate_structure_gfx_instance( NodeStruct *node )
 				memberTypeName = "int";
 			break;
 
-			case InputFormat_FLOAT16:
 			case InputFormat_FLOAT32:
 				memberTypeName = "float";
 			break;
@@ -1316,7 +1319,8 @@ bool Generator::generate_structure_gfx_vertex( NodeStruct *node )
 	const VariableID last = type.memberFirst + type.memberCount;
 
 	// Layout identifier
-	String layout;
+	MemoryScratchScope scratch;
+	String layout { scratch };
 	for( VariableID i = first; i < last; i++ )
 	{
 		Type &memberType = parser.types[parser.variables[i].typeID];
@@ -1376,6 +1380,7 @@ bool Generator::generate_structure_gfx_vertex( NodeStruct *node )
 			// 2 Bytes
 			case InputFormat_UNORM16:
 			case InputFormat_UINT16:
+			case InputFormat_FLOAT16: // IEEE 754 half bits (see: float_to_half)
 				memberTypeName = "u16";
 			break;
 
@@ -1395,7 +1400,6 @@ bool Generator::generate_structure_gfx_vertex( NodeStruct *node )
 				memberTypeName = "int";
 			break;
 
-			case InputFormat_FLOAT16:
 			case InputFormat_FLOAT32:
 				memberTypeName = "float";
 			break;
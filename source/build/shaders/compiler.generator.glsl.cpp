@@ -986,8 +986,7 @@ void GeneratorGLSL::generate_structure( NodeStruct *node )
 				{
 					if( memberVariable.semantic == SemanticType_POSITION )
 					{
-						String varying = String( "varying_" ).append( memberVariableName );
-						output.append( "#define " ).append( varying ).append( " gl_Position\n" );
+						output.append( "#define varying_" ).append( memberVariableName ).append( " gl_Position\n" );
 						location++;
 						continue;
 					}
@@ -999,8 +998,7 @@ void GeneratorGLSL::generate_structure( NodeStruct *node )
 				{
 					if( memberVariable.semantic == SemanticType_POSITION )
 					{
-						String replace = String( "varying_" ).append( memberVariableName );
-						output.append( "#define " ).append( replace ).append( " gl_FragCoord\n" );
+						output.append( "#define varying_" ).append( memberVariableName ).append( " gl_FragCoord\n" );
 						location++;
 						continue;
 					}
@@ -1012,8 +1010,8 @@ void GeneratorGLSL::generate_structure( NodeStruct *node )
 				{
 					if( memberVariable.semantic == SemanticType_DEPTH )
 					{
-						String varying = String( typeName ).append( "_" ).append( memberVariableName );
-						output.append( "#define " ).append( varying ).append( " gl_FragDepth\n" );
+						output.append( "#define " ).append( typeName ).append( "_" ).append( memberVariableName );
+						output.append( " gl_FragDepth\n" );
 						continue;
 					}
 				}
@@ -1167,7 +1165,8 @@ bool GeneratorGLSL::generate_structure_gfx_vertex( NodeStruct *node )
 	const String &structureName = type_name( structure.typeID );
 
 	int byteOffset = 0;
-	String attributes;
+	MemoryScratchScope scratch;
+	String attributes { scratch };
 
 	const usize count = last - first;
 	if( count > 0 )
@@ -1228,7 +1227,8 @@ bool GeneratorGLSL::generate_structure_gfx_instance( NodeStruct *node )
 	const String &structureName = type_name( structure.typeID );
 
 	int byteOffset = 0;
-	String attributes;
+	MemoryScratchScope scratch;
+	String attributes { scratch };
 
 	const usize count = last - first;
 	if( count > 0 )
@@ -505,7 +505,8 @@ void GeneratorHLSL::generate_stage( ShaderStage stage )
 
 	Generator::generate_stage( stage );
 
-	String header;
+	MemoryScratchScope scratch;
+	String header { scratch };
 	header.append( "struct Global\n{\n" );
 	header.append( globalMembers );
 	header.append( "};\n\n" );
@@ -1322,7 +1323,8 @@ bool GeneratorHLSL::generate_structure_gfx_vertex( NodeStruct *node )
 
 	int semanticIndex[SEMANTICTYPE_COUNT] = { 0 };
 	int byteOffset = 0;
-	String attributes;
+	MemoryScratchScope scratch;
+	String attributes { scratch };
 
 	const usize count = last - first;
 	if( count > 0 )
@@ -1381,7 +1383,8 @@ bool GeneratorHLSL::generate_structure_gfx_instance( NodeStruct *node )
 
 	int semanticIndex[SEMANTICTYPE_COUNT] = { 0 };
 	int byteOffset = 0;
-	String attributes;
+	MemoryScratchScope scratch;
+	String attributes { scratch };
 
 	const usize count = last - first;
 	if( count > 0 )
@@ -387,7 +387,8 @@ void GeneratorMetal::generate_stage( ShaderStage stage )
 
 	Generator::generate_stage( stage );
 
-	String header;
+	MemoryScratchScope scratch;
+	String header { scratch };
 	header.append( "#include <metal_stdlib>\n" );
 	header.append( "using namespace metal;\n\n" );
 	header.append( "struct Global\n{\n" );
@@ -857,7 +858,8 @@ bool GeneratorMetal::generate_structure_gfx_vertex( NodeStruct *node )
 	const VariableID last = first + type.memberCount;
 
 	int byteOffset = 0;
-	String attributes;
+	MemoryScratchScope scratch;
+	String attributes { scratch };
 
 	const usize count = last - first;
 	if( count > 0 )
@@ -912,7 +914,8 @@ bool GeneratorMetal::generate_structure_gfx_instance( NodeStruct *node )
 	const VariableID last = first + type.memberCount;
 
 	int byteOffset = 0;
-	String attributes;
+	MemoryScratchScope scratch;
+	String attributes { scratch };
 
 	const usize count = last - first;
 	if( count > 0 )
@@ -10,6 +10,30 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+namespace ShaderCompiler { class Parser; }
+
+// Maximum '#variant' keys per shader file (a file compiles to 2^keys permutations)
+#define SHADER_VARIANT_KEYS_MAX ( 4 )
+
+// compile_shader() is split into stages so builds can spread shaders across threads:
+//  - preprocess & parse touch no global state and may run concurrently (one ShaderCompilation per shader)
+//  - generate registers structs, buffers & formats with Gfx, whose IDs are baked into the output, so it must
+//    run serially and in the same shader order every build
+struct ShaderCompilation
+{
+	String pathPreprocessed;
+	String pathOutput;
+	String source; // Preprocessed
+	u64 hash = 0LLU; // Preprocessed source + ShaderType + optimizer toggle
+	ShaderCompiler::Parser *parser = nullptr;
+	usize nodesParsed = 0LLU; // AST size before/after the optimizer passes (0 when disabled)
+	usize nodesOptimized = 0LLU;
+};
+
+extern void compile_shader_preprocess( struct Shader &shader, ShaderCompilation &compilation, const char *path );
+extern void compile_shader_parse( struct Shader &shader, ShaderCompilation &compilation );
+extern void compile_shader_generate( struct Shader &shader, ShaderCompilation &compilation );
+
 extern void compile_shader( struct Shader &shader, const char *path );
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -176,6 +200,7 @@ enum_type( TokenType, int )
 	TokenType_Directive_ElseIf,                              // #elif
 	TokenType_Directive_EndIf,                               // #endif
 	TokenType_Directive_Pragma,                              // #pragma
+	TokenType_Directive_Variant,                             // #variant
 	TokenType_Directive_Once,                                // once
 	TokenType_Directive_Defined,                             // defined
 	TokenType_Directive_Undefined,                           // undefined
@@ -497,5 +497,1426 @@ void Optimizer::optimize_texture( NodeTexture *node )
 	texture.seen = true;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// AST Passes
+
+#define NODE_CHILDREN_MAX ( 4 )
+
+// Names for hoisted subexpressions (the generators prefix them like any other variable)
+static const char *HoistedNames[] =
+{
+	"cse0", "cse1", "cse2", "cse3", "cse4", "cse5", "cse6", "cse7",
+	"cse8", "cse9", "cse10", "cse11", "cse12", "cse13", "cse14", "cse15",
+};
+
+
+struct StatementList
+{
+	NodeStatementBlock *head;
+	bool scoped; // false for switch/case bodies (declarations there would cross case labels)
+};
+
+
+struct Occurrence
+{
+	Node **slot;
+	usize statement;
+};
+
+
+struct LocalUsage
+{
+	u32 reads = 0;
+	bool storesImpure = false;
+	bool removed = false;
+};
+
+
+static int node_children( Node *node, Node **children[NODE_CHILDREN_MAX] )
+{
+	int count = 0;
+
+	switch( node->nodeType )
+	{
+		case NodeType_Statement:
+		{
+			switch( reinterpret_cast<NodeStatement *>( node )->statementType )
+			{
+				case StatementType_Block:
+				{
+					NodeStatementBlock *statement = reinterpret_cast<NodeStatementBlock *>( node );
+					children[count++] = &statement->expr;
+					children[count++] = &statement->next;
+				}
+				break;
+
+				case StatementType_Expression:
+				{
+					children[count++] = &reinterpret_cast<NodeStatementExpression *>( node )->expr;
+				}
+				break;
+
+				case StatementType_If:
+				{
+					NodeStatementIf *statement = reinterpret_cast<NodeStatementIf *>( node );
+					children[count++] = &statement->expr;
+					children[count++] = &statement->blockIf;
+					children[count++] = &statement->blockElse;
+				}
+				break;
+
+				case StatementType_Else:
+				{
+					children[count++] = &reinterpret_cast<NodeStatementElse *>( node )->block;
+				}
+				break;
+
+				case StatementType_While:
+				{
+					NodeStatementWhile *statement = reinterpret_cast<NodeStatementWhile *>( node );
+					children[count++] = &statement->expr;
+					children[count++] = &statement->block;
+				}
+				break;
+
+				case StatementType_DoWhile:
+				{
+					NodeStatementDoWhile *statement = reinterpret_cast<NodeStatementDoWhile *>( node );
+					children[count++] = &statement->block;
+					children[count++] = &statement->expr;
+				}
+				break;
+
+				case StatementType_For:
+				{
+					NodeStatementFor *statement = reinterpret_cast<NodeStatementFor *>( node );
+					children[count++] = &statement->expr1;
+					children[count++] = &statement->expr2;
+					children[count++] = &statement->expr3;
+					children[count++] = &statement->block;
+				}
+				break;
+
+				case StatementType_Switch:
+				{
+					NodeStatementSwitch *statement = reinterpret_cast<NodeStatementSwitch *>( node );
+					children[count++] = &statement->expr;
+					children[count++] = &statement->block;
+				}
+				break;
+
+				case StatementType_Case:
+				{
+					NodeStatementCase *statement = reinterpret_cast<NodeStatementCase *>( node );
+					children[count++] = &statement->expr;
+					children[count++] = &statement->block;
+				}
+				break;
+
+				case StatementType_Default:
+				{
+					children[count++] = &reinterpret_cast<NodeStatementDefault *>( node )->block;
+				}
+				break;
+
+				case StatementType_Return:
+				{
+					children[count++] = &reinterpret_cast<NodeStatementReturn *>( node )->expr;
+				}
+				break;
+
+				default: break;
+			}
+		}
+		break;
+
+		case NodeType_ExpressionListNode:
+		{
+			NodeExpressionList *list = reinterpret_cast<NodeExpressionList *>( node );
+			children[count++] = &list->expr;
+			children[count++] = &list->next;
+		}
+		break;
+
+		case NodeType_ExpressionUnary:
+		{
+			children[count++] = &reinterpret_cast<NodeExpressionUnary *>( node )->expr;
+		}
+		break;
+
+		case NodeType_ExpressionBinary:
+		{
+			// NOTE: Member chains nest to the right ('a.b.c' is 'a . ( b . c )'), so a member variable on the
+			// right side of '.' is never a read of a local -- but subscripts within the chain can be
+			NodeExpressionBinary *expression = reinterpret_cast<NodeExpressionBinary *>( node );
+			children[count++] = &expression->expr1;
+			children[count++] = &expression->expr2;
+		}
+		break;
+
+		case NodeType_ExpressionTernary:
+		{
+			NodeExpressionTernary *expression = reinterpret_cast<NodeExpressionTernary *>( node );
+			children[count++] = &expression->expr1;
+			children[count++] = &expression->expr2;
+			children[count++] = &expression->expr3;
+		}
+		break;
+
+		case NodeType_FunctionDeclaration:
+		{
+			children[count++] = &reinterpret_cast<NodeFunctionDeclaration *>( node )->block;
+		}
+		break;
+
+		case NodeType_FunctionCall:
+		{
+			children[count++] = &reinterpret_cast<NodeFunctionCall *>( node )->param;
+		}
+		break;
+
+		case NodeType_Cast:
+		{
+			children[count++] = &reinterpret_cast<NodeCast *>( node )->param;
+		}
+		break;
+
+		case NodeType_VariableDeclaration:
+		{
+			children[count++] = &reinterpret_cast<NodeVariableDeclaration *>( node )->assignment;
+		}
+		break;
+
+		case NodeType_Group:
+		{
+			children[count++] = &reinterpret_cast<NodeGroup *>( node )->expr;
+		}
+		break;
+
+		default: break;
+	}
+
+	Assert( count <= NODE_CHILDREN_MAX );
+	return count;
+}
+
+
+static usize node_count( Node *node )
+{
+	if( node == nullptr ) { return 0LLU; }
+	usize count = 1LLU;
+
+	Node **children[NODE_CHILDREN_MAX];
+	const int childCount = node_children( node, children );
+	for( int i = 0; i < childCount; i++ ) { count += node_count( *children[i] ); }
+	return count;
+}
+
+
+static bool node_equal( Node *a, Node *b )
+{
+	if( a == b ) { return true; }
+	if( a == nullptr || b == nullptr || a->nodeType != b->nodeType ) { return false; }
+
+	switch( a->nodeType )
+	{
+		case NodeType_ExpressionBinary:
+		{
+			NodeExpressionBinary *binaryA = reinterpret_cast<NodeExpressionBinary *>( a );
+			NodeExpressionBinary *binaryB = reinterpret_cast<NodeExpressionBinary *>( b );
+			return binaryA->exprType == binaryB->exprType &&
+				node_equal( binaryA->expr1, binaryB->expr1 ) && node_equal( binaryA->expr2, binaryB->expr2 );
+		}
+
+		case NodeType_ExpressionUnary:
+		{
+			NodeExpressionUnary *unaryA = reinterpret_cast<NodeExpressionUnary *>( a );
+			NodeExpressionUnary *unaryB = reinterpret_cast<NodeExpressionUnary *>( b );
+			return unaryA->exprType == unaryB->exprType && node_equal( unaryA->expr, unaryB->expr );
+		}
+
+		case NodeType_Group:
+		{
+			return node_equal( reinterpret_cast<NodeGroup *>( a )->expr, reinterpret_cast<NodeGroup *>( b )->expr );
+		}
+
+		case NodeType_Variable:
+		{
+			return reinterpret_cast<NodeVariable *>( a )->variableID ==
+				reinterpret_cast<NodeVariable *>( b )->variableID;
+		}
+
+		case NodeType_Swizzle:
+		{
+			return reinterpret_cast<NodeSwizzle *>( a )->swizzleID == reinterpret_cast<NodeSwizzle *>( b )->swizzleID;
+		}
+
+		case NodeType_Integer:
+		{
+			return reinterpret_cast<NodeInteger *>( a )->integer == reinterpret_cast<NodeInteger *>( b )->integer;
+		}
+
+		case NodeType_Number:
+		{
+			return reinterpret_cast<NodeNumber *>( a )->number == reinterpret_cast<NodeNumber *>( b )->number;
+		}
+
+		default: return false;
+	}
+}
+
+
+static Node *node_literal( Node *node )
+{
+	while( node != nullptr && node->nodeType == NodeType_Group ) { node = reinterpret_cast<NodeGroup *>( node )->expr; }
+	if( node == nullptr ) { return nullptr; }
+	return ( node->nodeType == NodeType_Integer || node->nodeType == NodeType_Number ) ? node : nullptr;
+}
+
+
+static double literal_value( Node *literal )
+{
+	return literal->nodeType == NodeType_Integer ?
+		static_cast<double>( reinterpret_cast<NodeInteger *>( literal )->integer ) :
+		reinterpret_cast<NodeNumber *>( literal )->number;
+}
+
+
+static bool node_is_primary( Node *node )
+{
+	switch( node->nodeType )
+	{
+		case NodeType_Variable:
+		case NodeType_Integer:
+		case NodeType_Number:
+		case NodeType_Boolean:
+		case NodeType_FunctionCall:
+		case NodeType_Cast:
+		case NodeType_Group:
+			return true;
+
+		case NodeType_ExpressionBinary:
+		{
+			const ExpressionBinaryType exprType = reinterpret_cast<NodeExpressionBinary *>( node )->exprType;
+			return exprType == ExpressionBinaryType_Dot || exprType == ExpressionBinaryType_Subscript;
+		}
+
+		default: return false;
+	}
+}
+
+
+static bool node_is_member_chain( Node *node )
+{
+	// Right side of '.': a swizzle, a member, or a member followed by more of the chain
+	switch( node->nodeType )
+	{
+		case NodeType_Swizzle: return true;
+		case NodeType_Variable: return true;
+
+		case NodeType_ExpressionBinary:
+		{
+			NodeExpressionBinary *expression = reinterpret_cast<NodeExpressionBinary *>( node );
+			return expression->exprType == ExpressionBinaryType_Dot &&
+				expression->expr1->nodeType == NodeType_Variable && node_is_member_chain( expression->expr2 );
+		}
+
+		default: return false;
+	}
+}
+
+
+static bool node_is_simple( Node *node )
+{
+	// Variables and member/swizzle chains on variables (cheap to evaluate twice)
+	switch( node->nodeType )
+	{
+		case NodeType_Variable: return true;
+		case NodeType_Group: return node_is_simple( reinterpret_cast<NodeGroup *>( node )->expr );
+
+		case NodeType_ExpressionBinary:
+		{
+			NodeExpressionBinary *expression = reinterpret_cast<NodeExpressionBinary *>( node );
+			return expression->exprType == ExpressionBinaryType_Dot &&
+				node_is_simple( expression->expr1 ) && node_is_member_chain( expression->expr2 );
+		}
+
+		default: return false;
+	}
+}
+
+
+static bool node_is_arithmetic( Node *node, bool &variables )
+{
+	switch( node->nodeType )
+	{
+		case NodeType_ExpressionBinary:
+		{
+			NodeExpressionBinary *expression = reinterpret_cast<NodeExpressionBinary *>( node );
+			switch( expression->exprType )
+			{
+				case ExpressionBinaryType_Add:
+				case ExpressionBinaryType_Sub:
+				case ExpressionBinaryType_Mul:
+				case ExpressionBinaryType_Div:
+					return node_is_arithmetic( expression->expr1, variables ) &&
+						node_is_arithmetic( expression->expr2, variables );
+
+				case ExpressionBinaryType_Dot:
+					return node_is_member_chain( expression->expr2 ) && node_is_arithmetic( expression->expr1, variables );
+
+				default: return false;
+			}
+		}
+
+		case NodeType_ExpressionUnary:
+		{
+			NodeExpressionUnary *expression = reinterpret_cast<NodeExpressionUnary *>( node );
+			return ( expression->exprType == ExpressionUnaryType_Plus ||
+			         expression->exprType == ExpressionUnaryType_Minus ) &&
+				node_is_arithmetic( expression->expr, variables );
+		}
+
+		case NodeType_Group: return node_is_arithmetic( reinterpret_cast<NodeGroup *>( node )->expr, variables );
+		case NodeType_Variable: variables = true; return true;
+		case NodeType_Integer: return true;
+		case NodeType_Number: return true;
+		default: return false;
+	}
+}
+
+
+static bool expression_is_assignment( ExpressionBinaryType exprType )
+{
+	switch( exprType )
+	{
+		case ExpressionBinaryType_Assign:
+		case ExpressionBinaryType_AddAssign:
+		case ExpressionBinaryType_SubAssign:
+		case ExpressionBinaryType_MulAssign:
+		case ExpressionBinaryType_DivAssign:
+		case ExpressionBinaryType_ModAssign:
+		case ExpressionBinaryType_BitAndAssign:
+		case ExpressionBinaryType_BitOrAssign:
+		case ExpressionBinaryType_BitXorAssign:
+		case ExpressionBinaryType_BitShiftLeftAssign:
+		case ExpressionBinaryType_BitShiftRightAssign:
+			return true;
+
+		default: return false;
+	}
+}
+
+
+static bool function_has_side_effects( FunctionID functionID )
+{
+	// Custom functions may write 'out' / 'inout' parameters; atomics write their destination
+	return functionID >= INTRINSIC_COUNT ||
+		( functionID >= Intrinsic_AtomicAdd && functionID <= Intrinsic_AtomicXor );
+}
+
+
+static bool node_is_pure( Node *node )
+{
+	if( node == nullptr ) { return true; }
+
+	switch( node->nodeType )
+	{
+		case NodeType_ExpressionUnary:
+		{
+			switch( reinterpret_cast<NodeExpressionUnary *>( node )->exprType )
+			{
+				case ExpressionUnaryType_PreIncrement:
+				case ExpressionUnaryType_PostIncrement:
+				case ExpressionUnaryType_PreDecrement:
+				case ExpressionUnaryType_PostDecrement:
+					return false;
+
+				default: break;
+			}
+		}
+		break;
+
+		case NodeType_ExpressionBinary:
+		{
+			if( expression_is_assignment( reinterpret_cast<NodeExpressionBinary *>( node )->exprType ) ) { return false; }
+		}
+		break;
+
+		case NodeType_FunctionCall:
+		{
+			if( function_has_side_effects( reinterpret_cast<NodeFunctionCall *>( node )->functionID ) ) { return false; }
+		}
+		break;
+
+		default: break;
+	}
+
+	Node **children[NODE_CHILDREN_MAX];
+	const int count = node_children( node, children );
+	for( int i = 0; i < count; i++ ) { if( !node_is_pure( *children[i] ) ) { return false; } }
+	return true;
+}
+
+
+static VariableID node_root( Node *node )
+{
+	// Variable an l-value expression writes to (e.g. 'a' in 'a.b[i].x')
+	while( node != nullptr )
+	{
+		switch( node->nodeType )
+		{
+			case NodeType_Variable: return reinterpret_cast<NodeVariable *>( node )->variableID;
+			case NodeType_Group: node = reinterpret_cast<NodeGroup *>( node )->expr; continue;
+
+			case NodeType_ExpressionBinary:
+			{
+				NodeExpressionBinary *expression = reinterpret_cast<NodeExpressionBinary *>( node );
+				if( expression->exprType != ExpressionBinaryType_Dot &&
+				    expression->exprType != ExpressionBinaryType_Subscript ) { return USIZE_MAX; }
+				node = expression->expr1;
+			}
+			continue;
+
+			default: return USIZE_MAX;
+		}
+	}
+
+	return USIZE_MAX;
+}
+
+
+static void node_writes( Node *node, List<VariableID> &writes )
+{
+	if( node == nullptr ) { return; }
+
+	switch( node->nodeType )
+	{
+		case NodeType_ExpressionUnary:
+		{
+			NodeExpressionUnary *expression = reinterpret_cast<NodeExpressionUnary *>( node );
+			switch( expression->exprType )
+			{
+				case ExpressionUnaryType_PreIncrement:
+				case ExpressionUnaryType_PostIncrement:
+				case ExpressionUnaryType_PreDecrement:
+				case ExpressionUnaryType_PostDecrement:
+					writes.add( node_root( expression->expr ) );
+				break;
+
+				default: break;
+			}
+		}
+		break;
+
+		case NodeType_ExpressionBinary:
+		{
+			NodeExpressionBinary *expression = reinterpret_cast<NodeExpressionBinary *>( node );
+			if( expression_is_assignment( expression->exprType ) ) { writes.add( node_root( expression->expr1 ) ); }
+		}
+		break;
+
+		case NodeType_FunctionCall:
+		{
+			NodeFunctionCall *call = reinterpret_cast<NodeFunctionCall *>( node );
+			if( !function_has_side_effects( call->functionID ) ) { break; }
+			for( Node *param = call->param; param != nullptr; param = reinterpret_cast<NodeExpressionList *>( param )->next )
+			{
+				writes.add( node_root( reinterpret_cast<NodeExpressionList *>( param )->expr ) );
+			}
+		}
+		break;
+
+		case NodeType_VariableDeclaration:
+		{
+			writes.add( reinterpret_cast<NodeVariableDeclaration *>( node )->variableID );
+		}
+		break;
+
+		default: break;
+	}
+
+	Node **children[NODE_CHILDREN_MAX];
+	const int count = node_children( node, children );
+	for( int i = 0; i < count; i++ ) { node_writes( *children[i], writes ); }
+}
+
+
+static void node_variables( Node *node, List<VariableID> &variables )
+{
+	if( node == nullptr ) { return; }
+	if( node->nodeType == NodeType_Variable ) { variables.add( reinterpret_cast<NodeVariable *>( node )->variableID ); }
+
+	Node **children[NODE_CHILDREN_MAX];
+	const int count = node_children( node, children );
+	for( int i = 0; i < count; i++ ) { node_variables( *children[i], variables ); }
+}
+
+
+static bool node_reads( Node *node, VariableID variableID )
+{
+	if( node == nullptr ) { return false; }
+	if( node->nodeType == NodeType_Variable ) { return reinterpret_cast<NodeVariable *>( node )->variableID == variableID; }
+
+	Node **children[NODE_CHILDREN_MAX];
+	const int count = node_children( node, children );
+	for( int i = 0; i < count; i++ ) { if( node_reads( *children[i], variableID ) ) { return true; } }
+	return false;
+}
+
+
+static NodeVariableDeclaration *statement_declaration( NodeStatementBlock *entry )
+{
+	// 'type name = ...;' at statement level
+	Node *statement = entry->expr;
+	if( statement == nullptr || statement->nodeType != NodeType_Statement ) { return nullptr; }
+	if( reinterpret_cast<NodeStatement *>( statement )->statementType != StatementType_Expression ) { return nullptr; }
+
+	Node *expr = reinterpret_cast<NodeStatementExpression *>( statement )->expr;
+	if( expr->nodeType != NodeType_VariableDeclaration ) { return nullptr; }
+	return reinterpret_cast<NodeVariableDeclaration *>( expr );
+}
+
+
+static NodeExpressionBinary *statement_assignment( NodeStatementBlock *entry )
+{
+	// 'name = ...;' at statement level
+	Node *statement = entry->expr;
+	if( statement == nullptr || statement->nodeType != NodeType_Statement ) { return nullptr; }
+	if( reinterpret_cast<NodeStatement *>( statement )->statementType != StatementType_Expression ) { return nullptr; }
+
+	Node *expr = reinterpret_cast<NodeStatementExpression *>( statement )->expr;
+	if( expr->nodeType != NodeType_ExpressionBinary ) { return nullptr; }
+
+	NodeExpressionBinary *expression = reinterpret_cast<NodeExpressionBinary *>( expr );
+	if( expression->exprType != ExpressionBinaryType_Assign ) { return nullptr; }
+	if( expression->expr1->nodeType != NodeType_Variable ) { return nullptr; }
+	return expression;
+}
+
+
+static void collect_statement_lists( Node *node, List<StatementList> &lists, bool scoped )
+{
+	if( node == nullptr ) { return; }
+
+	if( node->nodeType == NodeType_Statement &&
+	    reinterpret_cast<NodeStatement *>( node )->statementType == StatementType_Block )
+	{
+		NodeStatementBlock *head = reinterpret_cast<NodeStatementBlock *>( node );
+		lists.add( StatementList { head, scoped } );
+
+		for( NodeStatementBlock *entry = head; entry != nullptr;
+			entry = reinterpret_cast<NodeStatementBlock *>( entry->next ) )
+		{
+			collect_statement_lists( entry->expr, lists, true );
+		}
+		return;
+	}
+
+	// Statements directly inside switch/case/default share the switch scope
+	bool scopedChildren = true;
+	if( node->nodeType == NodeType_Statement )
+	{
+		switch( reinterpret_cast<NodeStatement *>( node )->statementType )
+		{
+			case StatementType_Switch:
+			case StatementType_Case:
+			case StatementType_Default:
+				scopedChildren = false;
+			break;
+
+			default: break;
+		}
+	}
+
+	Node **children[NODE_CHILDREN_MAX];
+	const int count = node_children( node, children );
+	for( int i = 0; i < count; i++ ) { collect_statement_lists( *children[i], lists, scopedChildren ); }
+}
+
+
+static void collect_declarations( Node *node, List<NodeStatementBlock *> &declarations )
+{
+	if( node == nullptr ) { return; }
+
+	if( node->nodeType == NodeType_Statement &&
+	    reinterpret_cast<NodeStatement *>( node )->statementType == StatementType_Block &&
+	    statement_declaration( reinterpret_cast<NodeStatementBlock *>( node ) ) != nullptr )
+	{
+		declarations.add( reinterpret_cast<NodeStatementBlock *>( node ) );
+	}
+
+	Node **children[NODE_CHILDREN_MAX];
+	const int count = node_children( node, children );
+	for( int i = 0; i < count; i++ ) { collect_declarations( *children[i], declarations ); }
+}
+
+
+static void collect_occurrences( Node **slot, usize statement, List<Occurrence> &occurrences )
+{
+	// Only subexpressions that are evaluated unconditionally whenever the statement runs
+	Node *node = *slot;
+	if( node == nullptr ) { return; }
+
+	switch( node->nodeType )
+	{
+		case NodeType_ExpressionBinary:
+		{
+			NodeExpressionBinary *expression = reinterpret_cast<NodeExpressionBinary *>( node );
+			if( expression->exprType == ExpressionBinaryType_And || expression->exprType == ExpressionBinaryType_Or )
+			{
+				collect_occurrences( &expression->expr1, statement, occurrences );
+				return;
+			}
+
+			if( expression_is_assignment( expression->exprType ) )
+			{
+				collect_occurrences( &expression->expr2, statement, occurrences );
+				return;
+			}
+
+			if( expression->exprType == ExpressionBinaryType_Add || expression->exprType == ExpressionBinaryType_Sub ||
+			    expression->exprType == ExpressionBinaryType_Mul || expression->exprType == ExpressionBinaryType_Div )
+			{
+				occurrences.add( Occurrence { slot, statement } );
+			}
+		}
+		break;
+
+		case NodeType_ExpressionTernary:
+		{
+			collect_occurrences( &reinterpret_cast<NodeExpressionTernary *>( node )->expr1, statement, occurrences );
+		}
+		return;
+
+		case NodeType_ExpressionUnary:
+		{
+			if( !node_is_pure( node ) ) { return; }
+		}
+		break;
+
+		default: break;
+	}
+
+	Node **children[NODE_CHILDREN_MAX];
+	const int count = node_children( node, children );
+	for( int i = 0; i < count; i++ ) { collect_occurrences( children[i], statement, occurrences ); }
+}
+
+
+static bool primitive_vector( TypeID typeID, Primitive &base, u32 &components )
+{
+	if( typeID >= Primitive_Bool && typeID <= Primitive_Bool4 ) { base = Primitive_Bool; } else
+	if( typeID >= Primitive_Int && typeID <= Primitive_Int4 ) { base = Primitive_Int; } else
+	if( typeID >= Primitive_UInt && typeID <= Primitive_UInt4 ) { base = Primitive_UInt; } else
+	if( typeID >= Primitive_Float && typeID <= Primitive_Float4 ) { base = Primitive_Float; } else
+	{
+		return false;
+	}
+
+	components = static_cast<u32>( typeID - base + 1 );
+	return true;
+}
+
+
+static Node *fold_literals( NodeBuffer &ast, ExpressionBinaryType exprType, Node *literal1, Node *literal2 )
+{
+	// Integer arithmetic (integer literals are non-negative; keep results within 'int' range)
+	if( literal1->nodeType == NodeType_Integer && literal2->nodeType == NodeType_Integer )
+	{
+		constexpr u64 limit = 0x7FFFFFFF;
+		const u64 a = reinterpret_cast<NodeInteger *>( literal1 )->integer;
+		const u64 b = reinterpret_cast<NodeInteger *>( literal2 )->integer;
+		if( a > limit || b > limit ) { return nullptr; }
+
+		u64 result;
+		switch( exprType )
+		{
+			case ExpressionBinaryType_Add: result = a + b; break;
+			case ExpressionBinaryType_Sub: if( b > a ) { return nullptr; } result = a - b; break;
+			case ExpressionBinaryType_Mul: result = a * b; break;
+			case ExpressionBinaryType_Div: if( b == 0 ) { return nullptr; } result = a / b; break;
+			default: return nullptr;
+		}
+
+		if( result > limit ) { return nullptr; }
+		return ast.add( NodeInteger( result ) );
+	}
+
+	// Floating point arithmetic (a float literal promotes the other operand)
+	const double a = literal_value( literal1 );
+	const double b = literal_value( literal2 );
+
+	double result;
+	switch( exprType )
+	{
+		case ExpressionBinaryType_Add: result = a + b; break;
+		case ExpressionBinaryType_Sub: result = a - b; break;
+		case ExpressionBinaryType_Mul: result = a * b; break;
+		case ExpressionBinaryType_Div: if( b == 0.0 ) { return nullptr; } result = a / b; break;
+		default: return nullptr;
+	}
+
+	// Numbers are emitted with "%f" and the AST has no negative literals, so only fold non-negative results that
+	// survive printing: whole numbers, or fractions with at most 6 decimal places
+	if( !( result >= 0.0 && result < 1e15 ) ) { return nullptr; }
+	const bool whole = static_cast<double>( static_cast<u64>( result ) ) == result;
+	const double scaled = result * 1000000.0;
+	if( !whole && ( result >= 1e9 || static_cast<double>( static_cast<u64>( scaled + 0.5 ) ) != scaled ) )
+	{
+		return nullptr;
+	}
+
+	return ast.add( NodeNumber( result ) );
+}
+
+
+void Optimizer::optimize_program()
+{
+	for( Node *node : parser.program ) { nodesBefore += node_count( node ); }
+
+	for( Node *node : parser.program )
+	{
+		if( node->nodeType != NodeType_FunctionDeclaration ) { continue; }
+		NodeFunctionDeclaration *declaration = reinterpret_cast<NodeFunctionDeclaration *>( node );
+		if( declaration->block == nullptr ) { continue; }
+
+		// Constant Folding, Propagation & Algebraic Simplification
+		pass_fold( &declaration->block );
+		pass_propagate_constants( declaration->block );
+		pass_fold( &declaration->block );
+
+		// Dead-Store & Unused-Local Elimination (removing one store can orphan another)
+		List<StatementList> lists;
+		collect_statement_lists( declaration->block, lists, true );
+
+		for( bool changed = true; changed; )
+		{
+			List<NodeStatementBlock *> declarations;
+			collect_declarations( declaration->block, declarations );
+
+			List<bool> locals { parser.variables.size() };
+			for( usize i = 0; i < parser.variables.size(); i++ ) { locals.add( false ); }
+			for( NodeStatementBlock *entry : declarations ) { locals[statement_declaration( entry )->variableID] = true; }
+
+			changed = false;
+			for( StatementList &list : lists ) { changed |= pass_eliminate_dead_stores( list.head, locals ); }
+			changed |= pass_eliminate_unused_locals( declaration->block );
+		}
+
+		// Common Subexpression Hoisting
+		for( StatementList &list : lists )
+		{
+			if( list.scoped ) { pass_hoist_subexpressions( list.head ); }
+		}
+	}
+
+	for( Node *node : parser.program ) { nodesAfter += node_count( node ); }
+}
+
+
+void Optimizer::pass_fold( Node **slot )
+{
+	Node *node = *slot;
+	if( node == nullptr ) { return; }
+
+	// Bottom-up: operands are folded before their parents
+	Node **children[NODE_CHILDREN_MAX];
+	const int count = node_children( node, children );
+	for( int i = 0; i < count; i++ ) { pass_fold( children[i] ); }
+
+	switch( node->nodeType )
+	{
+		case NodeType_Group:
+		{
+			// The generators emit these without parentheses anyway
+			Node *expr = reinterpret_cast<NodeGroup *>( node )->expr;
+			switch( expr->nodeType )
+			{
+				case NodeType_Variable:
+				case NodeType_Integer:
+				case NodeType_Number:
+				case NodeType_Boolean:
+				case NodeType_FunctionCall:
+				case NodeType_Cast:
+				case NodeType_Group:
+					*slot = expr;
+				break;
+
+				default: break;
+			}
+		}
+		break;
+
+		case NodeType_ExpressionBinary:
+		{
+			pass_fold_binary( slot, reinterpret_cast<NodeExpressionBinary *>( node ) );
+		}
+		break;
+
+		case NodeType_FunctionCall:
+		{
+			pass_fold_function_call( slot, reinterpret_cast<NodeFunctionCall *>( node ) );
+		}
+		break;
+
+		default: break;
+	}
+}
+
+
+void Optimizer::pass_fold_binary( Node **slot, NodeExpressionBinary *node )
+{
+	Node *literal1 = node_literal( node->expr1 );
+	Node *literal2 = node_literal( node->expr2 );
+
+	// Constant Folding
+	if( literal1 != nullptr && literal2 != nullptr )
+	{
+		Node *folded = fold_literals( parser.ast, node->exprType, literal1, literal2 );
+		if( folded != nullptr ) { *slot = folded; }
+		return;
+	}
+
+	// Algebraic Simplification: x + 0, 0 + x, x - 0, x * 1, 1 * x, x / 1
+	Node *operand = nullptr;
+	Node *identity = nullptr;
+	switch( node->exprType )
+	{
+		case ExpressionBinaryType_Add:
+		{
+			if( literal2 != nullptr && literal_value( literal2 ) == 0.0 ) { operand = node->expr1; identity = literal2; } else
+			if( literal1 != nullptr && literal_value( literal1 ) == 0.0 ) { operand = node->expr2; identity = literal1; }
+		}
+		break;
+
+		case ExpressionBinaryType_Sub:
+		{
+			if( literal2 != nullptr && literal_value( literal2 ) == 0.0 ) { operand = node->expr1; identity = literal2; }
+		}
+		break;
+
+		case ExpressionBinaryType_Mul:
+		{
+			if( literal2 != nullptr && literal_value( literal2 ) == 1.0 ) { operand = node->expr1; identity = literal2; } else
+			if( literal1 != nullptr && literal_value( literal1 ) == 1.0 ) { operand = node->expr2; identity = literal1; }
+		}
+		break;
+
+		case ExpressionBinaryType_Div:
+		{
+			if( literal2 != nullptr && literal_value( literal2 ) == 1.0 ) { operand = node->expr1; identity = literal2; }
+		}
+		break;
+
+		default: return;
+	}
+	if( operand == nullptr ) { return; }
+
+	// The identity must not change the result type (e.g. 'i * 1.0' promotes an int to float)
+	Primitive base;
+	u32 components;
+	if( !primitive_vector( infer_type( operand ), base, components ) ) { return; }
+	if( identity->nodeType == NodeType_Number ? base != Primitive_Float : base == Primitive_Bool ) { return; }
+
+	// An operand binds at least as tightly as the expression it replaces, so no parentheses are needed
+	*slot = operand;
+}
+
+
+void Optimizer::pass_fold_function_call( Node **slot, NodeFunctionCall *node )
+{
+	// pow( x, 1 ) -> x, pow( x, 2 ) -> x * x
+	if( node->functionID != Intrinsic_Pow || node->param == nullptr ) { return; }
+	NodeExpressionList *param1 = reinterpret_cast<NodeExpressionList *>( node->param );
+	NodeExpressionList *param2 = reinterpret_cast<NodeExpressionList *>( param1->next );
+	if( param2 == nullptr || param2->next != nullptr ) { return; }
+
+	Node *literal = node_literal( param2->expr );
+	if( literal == nullptr ) { return; }
+
+	Primitive base;
+	u32 components;
+	if( !primitive_vector( infer_type( param1->expr ), base, components ) || base != Primitive_Float ) { return; }
+
+	const double exponent = literal_value( literal );
+	if( exponent == 1.0 )
+	{
+		*slot = node_is_primary( param1->expr ) ? param1->expr : parser.ast.add( NodeGroup( param1->expr ) );
+	}
+	else if( exponent == 2.0 && node_is_simple( param1->expr ) )
+	{
+		Node *square = parser.ast.add( NodeExpressionBinary( ExpressionBinaryType_Mul,
+			param1->expr, clone_node( param1->expr ) ) );
+		*slot = parser.ast.add( NodeGroup( square ) );
+	}
+}
+
+
+static void propagate_constant( Node **slot, VariableID variableID, Node *literal )
+{
+	Node *node = *slot;
+	if( node == nullptr ) { return; }
+
+	if( node->nodeType == NodeType_Variable )
+	{
+		if( reinterpret_cast<NodeVariable *>( node )->variableID == variableID ) { *slot = literal; }
+		return;
+	}
+
+	Node **children[NODE_CHILDREN_MAX];
+	const int count = node_children( node, children );
+	for( int i = 0; i < count; i++ ) { propagate_constant( children[i], variableID, literal ); }
+}
+
+
+void Optimizer::pass_propagate_constants( Node *body )
+{
+	List<NodeStatementBlock *> declarations;
+	collect_declarations( body, declarations );
+
+	for( NodeStatementBlock *entry : declarations )
+	{
+		// 'const' locals initialized with a literal of the variable's own type
+		NodeVariableDeclaration *declaration = statement_declaration( entry );
+		Variable &variable = parser.variables[declaration->variableID];
+		if( !variable.constant || variable.arrayLengthX != 0 ) { continue; }
+
+		Node *literal = node_literal( declaration->assignment );
+		if( literal == nullptr ) { continue; }
+
+		const bool matches = literal->nodeType == NodeType_Number ? variable.typeID == Primitive_Float :
+			( variable.typeID == Primitive_Int || variable.typeID == Primitive_UInt );
+		if( !matches ) { continue; }
+
+		// Unused-local elimination removes the declaration afterwards
+		propagate_constant( &body, declaration->variableID, literal );
+	}
+}
+
+
+bool Optimizer::pass_eliminate_dead_stores( NodeStatementBlock *block, const List<bool> &locals )
+{
+	bool changed = false;
+
+	for( NodeStatementBlock *entry = block; entry != nullptr;
+		entry = reinterpret_cast<NodeStatementBlock *>( entry->next ) )
+	{
+		// Store: 'type x = value;' or 'x = value;'
+		NodeVariableDeclaration *declaration = statement_declaration( entry );
+		NodeExpressionBinary *assignment = statement_assignment( entry );
+
+		VariableID variableID;
+		Node *value;
+		if( declaration != nullptr )
+		{
+			Variable &variable = parser.variables[declaration->variableID];
+			if( variable.constant || variable.arrayLengthX != 0 ) { continue; }
+			variableID = declaration->variableID;
+			value = declaration->assignment;
+		}
+		else if( assignment != nullptr )
+		{
+			variableID = reinterpret_cast<NodeVariable *>( assignment->expr1 )->variableID;
+			value = assignment->expr2;
+		}
+		else
+		{
+			continue;
+		}
+
+		if( value == nullptr || !locals[variableID] || !node_is_pure( value ) ) { continue; }
+
+		// Dead if overwritten later in this block before anything can read it
+		for( NodeStatementBlock *later = reinterpret_cast<NodeStatementBlock *>( entry->next ); later != nullptr;
+			later = reinterpret_cast<NodeStatementBlock *>( later->next ) )
+		{
+			if( later->expr == nullptr ) { continue; }
+
+			NodeExpressionBinary *overwrite = statement_assignment( later );
+			if( overwrite != nullptr &&
+			    reinterpret_cast<NodeVariable *>( overwrite->expr1 )->variableID == variableID &&
+			    !node_reads( overwrite->expr2, variableID ) )
+			{
+				if( declaration != nullptr ) { declaration->assignment = nullptr; } else { entry->expr = nullptr; }
+				changed = true;
+				break;
+			}
+
+			// Control flow or a possible read ends the search
+			if( reinterpret_cast<NodeStatement *>( later->expr )->statementType != StatementType_Expression ||
+			    node_reads( later->expr, variableID ) )
+			{
+				break;
+			}
+		}
+	}
+
+	return changed;
+}
+
+
+static void count_local_reads( Node *node, List<LocalUsage> &usage )
+{
+	if( node == nullptr ) { return; }
+
+	if( node->nodeType == NodeType_Variable )
+	{
+		usage[reinterpret_cast<NodeVariable *>( node )->variableID].reads++;
+		return;
+	}
+
+	// 'x = value;' statements store to 'x' without reading it
+	if( node->nodeType == NodeType_Statement &&
+	    reinterpret_cast<NodeStatement *>( node )->statementType == StatementType_Block )
+	{
+		NodeStatementBlock *entry = reinterpret_cast<NodeStatementBlock *>( node );
+		NodeExpressionBinary *assignment = statement_assignment( entry );
+		if( assignment != nullptr )
+		{
+			LocalUsage &local = usage[reinterpret_cast<NodeVariable *>( assignment->expr1 )->variableID];
+			local.storesImpure |= !node_is_pure( assignment->expr2 );
+			count_local_reads( assignment->expr2, usage );
+			count_local_reads( entry->next, usage );
+			return;
+		}
+	}
+
+	Node **children[NODE_CHILDREN_MAX];
+	const int count = node_children( node, children );
+	for( int i = 0; i < count; i++ ) { count_local_reads( *children[i], usage ); }
+}
+
+
+static void remove_local_stores( Node *node, List<LocalUsage> &usage )
+{
+	if( node == nullptr ) { return; }
+
+	if( node->nodeType == NodeType_Statement &&
+	    reinterpret_cast<NodeStatement *>( node )->statementType == StatementType_Block )
+	{
+		NodeStatementBlock *entry = reinterpret_cast<NodeStatementBlock *>( node );
+		NodeExpressionBinary *assignment = statement_assignment( entry );
+		if( assignment != nullptr && usage[reinterpret_cast<NodeVariable *>( assignment->expr1 )->variableID].removed )
+		{
+			entry->expr = nullptr;
+		}
+	}
+
+	Node **children[NODE_CHILDREN_MAX];
+	const int count = node_children( node, children );
+	for( int i = 0; i < count; i++ ) { remove_local_stores( *children[i], usage ); }
+}
+
+
+bool Optimizer::pass_eliminate_unused_locals( Node *body )
+{
+	List<LocalUsage> usage { parser.variables.size() };
+	for( usize i = 0; i < parser.variables.size(); i++ ) { usage.add( LocalUsage { } ); }
+	count_local_reads( body, usage );
+
+	List<NodeStatementBlock *> declarations;
+	collect_declarations( body, declarations );
+
+	// Locals that are never read, along with their (side-effect free) stores
+	bool changed = false;
+	for( NodeStatementBlock *entry : declarations )
+	{
+		NodeVariableDeclaration *declaration = statement_declaration( entry );
+		LocalUsage &local = usage[declaration->variableID];
+		if( local.reads > 0 || local.storesImpure || !node_is_pure( declaration->assignment ) ) { continue; }
+
+		entry->expr = nullptr;
+		local.removed = true;
+		changed = true;
+	}
+
+	if( changed ) { remove_local_stores( body, usage ); }
+	return changed;
+}
+
+
+void Optimizer::pass_hoist_subexpressions( NodeStatementBlock *block )
+{
+	for( ;; )
+	{
+		// Name
+		const char *name = nullptr;
+		for( const char *candidate : HoistedNames )
+		{
+			const usize length = strlen( candidate );
+			bool used = false;
+			for( Variable &variable : parser.variables )
+			{
+				if( variable.name.length == length && strncmp( variable.name.data, candidate, length ) == 0 )
+				{
+					used = true;
+					break;
+				}
+			}
+			if( !used ) { name = candidate; break; }
+		}
+		if( name == nullptr ) { return; }
+
+		// Occurrences
+		List<NodeStatementBlock *> statements;
+		List<Occurrence> occurrences;
+		for( NodeStatementBlock *entry = block; entry != nullptr;
+			entry = reinterpret_cast<NodeStatementBlock *>( entry->next ) )
+		{
+			const usize statement = statements.size();
+			statements.add( entry );
+			if( entry->expr == nullptr ) { continue; }
+
+			switch( reinterpret_cast<NodeStatement *>( entry->expr )->statementType )
+			{
+				case StatementType_Expression:
+					collect_occurrences( &reinterpret_cast<NodeStatementExpression *>( entry->expr )->expr,
+						statement, occurrences );
+				break;
+
+				case StatementType_Return:
+					collect_occurrences( &reinterpret_cast<NodeStatementReturn *>( entry->expr )->expr,
+						statement, occurrences );
+				break;
+
+				case StatementType_If:
+					collect_occurrences( &reinterpret_cast<NodeStatementIf *>( entry->expr )->expr,
+						statement, occurrences );
+				break;
+
+				default: break;
+			}
+		}
+
+		// Pick the repeated expression that shrinks the tree the most
+		usize best = USIZE_MAX;
+		usize bestSavings = 0;
+		usize bestFirst = 0;
+		for( usize i = 0; i < occurrences.size(); i++ )
+		{
+			Node *node = *occurrences[i].slot;
+			if( !is_hoistable( node ) ) { continue; }
+
+			bool repeat = false;
+			usize count = 1;
+			usize first = occurrences[i].statement;
+			usize last = occurrences[i].statement;
+			for( usize j = 0; j < occurrences.size() && !repeat; j++ )
+			{
+				if( j == i || !node_equal( node, *occurrences[j].slot ) ) { continue; }
+				if( j < i ) { repeat = true; continue; }
+				count++;
+				first = occurrences[j].statement < first ? occurrences[j].statement : first;
+				last = occurrences[j].statement > last ? occurrences[j].statement : last;
+			}
+			if( repeat || count < 2 ) { continue; }
+
+			// 'count' copies become 'count' variables plus one declaration
+			const usize size = node_count( node );
+			if( ( count - 1 ) * size <= count + 2 ) { continue; }
+			const usize savings = ( count - 1 ) * size - ( count + 2 );
+			if( savings <= bestSavings ) { continue; }
+
+			// Operands must hold the same values across every occurrence
+			List<VariableID> operands;
+			node_variables( node, operands );
+			List<VariableID> writes;
+			for( usize statement = first; statement <= last; statement++ )
+			{
+				node_writes( statements[statement]->expr, writes );
+			}
+
+			bool interferes = false;
+			for( VariableID write : writes )
+			{
+				for( VariableID operand : operands ) { interferes |= ( write == operand ); }
+			}
+			if( interferes ) { continue; }
+
+			best = i;
+			bestSavings = savings;
+			bestFirst = first;
+		}
+		if( best == USIZE_MAX ) { return; }
+
+		// Hoist
+		Node *expression = *occurrences[best].slot;
+		Variable variable;
+		variable.name = StringView { name, strlen( name ) };
+		variable.typeID = infer_type( expression );
+		const VariableID variableID = parser.variables.size();
+		parser.variables.add( variable );
+
+		for( Occurrence &occurrence : occurrences )
+		{
+			if( node_equal( expression, *occurrence.slot ) )
+			{
+				*occurrence.slot = parser.ast.add( NodeVariable( variableID ) );
+			}
+		}
+
+		// Declare it ahead of the first use (the new statement takes over the existing list node)
+		NodeStatementBlock *entry = statements[bestFirst];
+		NodeStatementBlock *moved = reinterpret_cast<NodeStatementBlock *>(
+			parser.ast.add( NodeStatementBlock( entry->expr ) ) );
+		moved->next = entry->next;
+		entry->expr = parser.ast.add( NodeStatementExpression(
+			parser.ast.add( NodeVariableDeclaration( variableID, expression ) ) ) );
+		entry->next = moved;
+	}
+}
+
+
+TypeID Optimizer::infer_type( Node *node )
+{
+	// Conservative: USIZE_MAX unless the type is certain
+	if( node == nullptr ) { return USIZE_MAX; }
+
+	switch( node->nodeType )
+	{
+		case NodeType_Variable:
+		{
+			return parser.variables[reinterpret_cast<NodeVariable *>( node )->variableID].typeID;
+		}
+
+		case NodeType_Integer: return Primitive_Int;
+		case NodeType_Number: return Primitive_Float;
+		case NodeType_Boolean: return Primitive_Bool;
+		case NodeType_Group: return infer_type( reinterpret_cast<NodeGroup *>( node )->expr );
+		case NodeType_Cast: return reinterpret_cast<NodeCast *>( node )->typeID;
+
+		case NodeType_ExpressionUnary:
+		{
+			NodeExpressionUnary *expression = reinterpret_cast<NodeExpressionUnary *>( node );
+			if( expression->exprType != ExpressionUnaryType_Plus &&
+			    expression->exprType != ExpressionUnaryType_Minus ) { return USIZE_MAX; }
+			return infer_type( expression->expr );
+		}
+
+		case NodeType_ExpressionBinary:
+		{
+			NodeExpressionBinary *expression = reinterpret_cast<NodeExpressionBinary *>( node );
+			if( expression->exprType == ExpressionBinaryType_Dot )
+			{
+				// Member (or the rest of a member chain)
+				if( expression->expr2->nodeType != NodeType_Swizzle ) { return infer_type( expression->expr2 ); }
+
+				// Swizzle
+				Primitive base;
+				u32 components;
+				if( !primitive_vector( infer_type( expression->expr1 ), base, components ) ) { return USIZE_MAX; }
+				return base + strlen( SwizzleTypeNames[reinterpret_cast<NodeSwizzle *>( expression->expr2 )->swizzleID] ) - 1;
+			}
+
+			if( expression->exprType != ExpressionBinaryType_Add && expression->exprType != ExpressionBinaryType_Sub &&
+			    expression->exprType != ExpressionBinaryType_Mul && expression->exprType != ExpressionBinaryType_Div )
+			{
+				return USIZE_MAX;
+			}
+
+			Primitive base1, base2;
+			u32 components1, components2;
+			const TypeID type1 = infer_type( expression->expr1 );
+			const TypeID type2 = infer_type( expression->expr2 );
+			if( !primitive_vector( type1, base1, components1 ) || !primitive_vector( type2, base2, components2 ) )
+			{
+				return USIZE_MAX;
+			}
+			if( type1 == type2 ) { return type1; }
+
+			// Literals adopt the other operand's type ('float' literals only combine with floats)
+			const bool literal1 = node_literal( expression->expr1 ) != nullptr;
+			const bool literal2 = node_literal( expression->expr2 ) != nullptr;
+			if( literal1 && ( type1 == Primitive_Int || base2 == Primitive_Float ) && base2 != Primitive_Bool ) { return type2; }
+			if( literal2 && ( type2 == Primitive_Int || base1 == Primitive_Float ) && base1 != Primitive_Bool ) { return type1; }
+
+			// Scalar & vector
+			if( base1 != base2 ) { return USIZE_MAX; }
+			if( components1 == 1 ) { return type2; }
+			if( components2 == 1 ) { return type1; }
+			return USIZE_MAX;
+		}
+
+		case NodeType_FunctionCall:
+		{
+			NodeFunctionCall *call = reinterpret_cast<NodeFunctionCall *>( node );
+			switch( call->functionID )
+			{
+				case Intrinsic_Length:
+				case Intrinsic_Distance:
+				case Intrinsic_Dot:
+					return Primitive_Float;
+
+				case Intrinsic_Cos: case Intrinsic_Sin: case Intrinsic_Tan:
+				case Intrinsic_Sinh: case Intrinsic_Cosh: case Intrinsic_Tanh:
+				case Intrinsic_ASin: case Intrinsic_ACos: case Intrinsic_ATan: case Intrinsic_ATan2:
+				case Intrinsic_Exp: case Intrinsic_Exp2: case Intrinsic_Log: case Intrinsic_Log2:
+				case Intrinsic_Degrees: case Intrinsic_Radians:
+				case Intrinsic_Round: case Intrinsic_Trunc: case Intrinsic_Ceil: case Intrinsic_Floor:
+				case Intrinsic_Abs: case Intrinsic_Pow: case Intrinsic_Sqrt: case Intrinsic_RSqrt:
+				case Intrinsic_Clamp: case Intrinsic_Max: case Intrinsic_Min: case Intrinsic_Mod:
+				case Intrinsic_Frac: case Intrinsic_Saturate: case Intrinsic_Normalize: case Intrinsic_Lerp:
+				{
+					// Component-wise: every non-literal argument must agree
+					TypeID type = USIZE_MAX;
+					for( Node *param = call->param; param != nullptr;
+						param = reinterpret_cast<NodeExpressionList *>( param )->next )
+					{
+						Node *expr = reinterpret_cast<NodeExpressionList *>( param )->expr;
+						if( node_literal( expr ) != nullptr ) { continue; }
+						const TypeID paramType = infer_type( expr );
+						if( paramType == USIZE_MAX || ( type != USIZE_MAX && type != paramType ) ) { return USIZE_MAX; }
+						type = paramType;
+					}
+					return type;
+				}
+
+				default: return USIZE_MAX;
+			}
+		}
+
+		default: return USIZE_MAX;
+	}
+}
+
+
+bool Optimizer::is_hoistable( Node *node )
+{
+	// Side-effect free arithmetic over variables, members, swizzles & literals, with a type we can declare
+	bool variables = false;
+	if( !node_is_arithmetic( node, variables ) || !variables ) { return false; }
+
+	Primitive base;
+	u32 components;
+	return primitive_vector( infer_type( node ), base, components );
+}
+
+
+Node *Optimizer::clone_node( Node *node )
+{
+	switch( node->nodeType )
+	{
+		case NodeType_Variable:
+			return parser.ast.add( NodeVariable( reinterpret_cast<NodeVariable *>( node )->variableID ) );
+
+		case NodeType_Swizzle:
+			return parser.ast.add( NodeSwizzle( reinterpret_cast<NodeSwizzle *>( node )->swizzleID ) );
+
+		case NodeType_Group:
+			return parser.ast.add( NodeGroup( clone_node( reinterpret_cast<NodeGroup *>( node )->expr ) ) );
+
+		case NodeType_ExpressionBinary:
+		{
+			NodeExpressionBinary *expression = reinterpret_cast<NodeExpressionBinary *>( node );
+			return parser.ast.add( NodeExpressionBinary( expression->exprType,
+				clone_node( expression->expr1 ), clone_node( expression->expr2 ) ) );
+		}
+
+		// Leaves are never rewritten in place, so they can be shared
+		default: return node;
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 }
\ No newline at end of file
@@ -45,6 +45,27 @@ struct Optimizer
 	void optimize_group( NodeGroup *node );
 	void optimize_structure( NodeStruct *node );
 	void optimize_texture( NodeTexture *node );
+
+	// AST Passes
+	//
+	// optimize_program() rewrites the AST once per shader (ahead of optimize_stage), so every stage and backend
+	// benefits. Each pass is conservative: expressions it cannot prove side-effect free and type-preserving are
+	// left untouched
+	void optimize_program();
+	usize nodesBefore = 0LLU;
+	usize nodesAfter = 0LLU;
+
+	void pass_fold( Node **slot );
+	void pass_fold_binary( Node **slot, NodeExpressionBinary *node );
+	void pass_fold_function_call( Node **slot, NodeFunctionCall *node );
+	void pass_propagate_constants( Node *body );
+	void pass_hoist_subexpressions( NodeStatementBlock *block );
+	bool pass_eliminate_dead_stores( NodeStatementBlock *block, const List<bool> &locals );
+	bool pass_eliminate_unused_locals( Node *body );
+
+	TypeID infer_type( Node *node );
+	bool is_hoistable( Node *node );
+	Node *clone_node( Node *node );
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -264,6 +264,7 @@ const Directive DirectiveNames[] =
 	{ "#elif", TokenType_Directive_ElseIf },
 	{ "#endif", TokenType_Directive_EndIf },
 	{ "#pragma", TokenType_Directive_Pragma },
+	{ "#variant", TokenType_Directive_Variant },
 	{ "once", TokenType_Directive_Once },
 	{ "defined", TokenType_Directive_Defined },
 	{ "undefined", TokenType_Directive_Undefined },
@@ -3157,37 +3158,37 @@ Node *Parser::parse_prefix_operators()
 		case TokenType_PlusPlus:
 		{
 			scanner.next();
-			return ast.add( NodeExpressionUnary( ExpressionUnaryType_PreIncrement, parse_expression() ) );
+			return ast.add( NodeExpressionUnary( ExpressionUnaryType_PreIncrement, parse_prefix_operators() ) );
 		}
 
 		case TokenType_MinusMinus:
 		{
 			scanner.next();
-			return ast.add( NodeExpressionUnary( ExpressionUnaryType_PreDecrement, parse_expression() ) );
+			return ast.add( NodeExpressionUnary( ExpressionUnaryType_PreDecrement, parse_prefix_operators() ) );
 		}
 
 		case TokenType_Plus:
 		{
 			scanner.next();
-			return ast.add( NodeExpressionUnary( ExpressionUnaryType_Plus, parse_expression() ) );
+			return ast.add( NodeExpressionUnary( ExpressionUnaryType_Plus, parse_prefix_operators() ) );
 		}
 
 		case TokenType_Minus:
 		{
 			scanner.next();
-			return ast.add( NodeExpressionUnary( ExpressionUnaryType_Minus, parse_expression() ) );
+			return ast.add( NodeExpressionUnary( ExpressionUnaryType_Minus, parse_prefix_operators() ) );
 		}
 
 		case TokenType_BitNot:
 		{
 			scanner.next();
-			return ast.add( NodeExpressionUnary( ExpressionUnaryType_BitNot, parse_expression() ) );
+			return ast.add( NodeExpressionUnary( ExpressionUnaryType_BitNot, parse_prefix_operators() ) );
 		}
 
 		case TokenType_Bang:
 		{
 			scanner.next();
-			Node *node = ast.add( NodeExpressionUnary( ExpressionUnaryType_Not, parse_expression() ) );
+			Node *node = ast.add( NodeExpressionUnary( ExpressionUnaryType_Not, parse_prefix_operators() ) );
 			return node;
 		}
 	}
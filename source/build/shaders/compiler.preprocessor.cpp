@@ -3,7 +3,7 @@
 #include <build/shaders/compiler.hpp>
 #include <build/shaders/compiler.parser.hpp>
 
-#include <core/hashmap.hpp>
+#include <core/flathashmap.hpp>
 #include <core/string.hpp>
 #include <core/math.hpp>
 
@@ -38,12 +38,14 @@ struct Include
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-static HashMap<u32, Macro> macros;
-static HashMap<u32, Include> includes;
-static int branchDepth = 0;
-static bool branchEvaluateElseIf = false;
-static String conditionLine;
-static NodeBuffer conditionAST;
+// Preprocessor state is per-thread so shaders can be preprocessed in parallel (each thread keeps its own
+// #include cache)
+thread_local static FlatHashMap<u32, Macro> macros;
+thread_local static FlatHashMap<u32, Include> includes;
+thread_local static int branchDepth = 0;
+thread_local static bool branchEvaluateElseIf = false;
+thread_local static String conditionLine;
+thread_local static NodeBuffer conditionAST;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -848,10 +850,41 @@ static void parse_directive_pragma( String &input, String &output, Scanner &scan
 }
 
 
+static void parse_directive_variant( String &input, String &output, Scanner &scanner, List<String> *variants )
+{
+	// Expect space after #variant
+	Token token = scanner.next( false );
+
+	// #variant NAME -- the macro itself is defined by the build for permutations that enable it
+	bool sawName = false;
+	for( ;; )
+	{
+		token = scanner.next( false );
+		if( token.type == TokenType_Newline || token.type == TokenType_EndOfFile ) { break; }
+
+		if( token.type == TokenType_Identifier )
+		{
+			ErrorIf( sawName, "#variant: expected a single key name per directive!" );
+			sawName = true;
+
+			if( variants == nullptr ) { continue; }
+			for( String &variant : *variants )
+			{
+				ErrorIf( variant == token.name, "#variant: duplicate key '%.*s'!",
+					static_cast<int>( token.name.length ), token.name.data );
+			}
+			variants->add( "" ).append( token.name );
+		}
+	}
+
+	ErrorIf( !sawName, "Invalid #variant directive!" );
+}
+
+
 static void parse_directive_define( String &input, String &output, Scanner &scanner )
 {
-	static HashMap<u32, int> parameters;
-	static char parameter[256];
+	thread_local static FlatHashMap<u32, int> parameters;
+	thread_local static char parameter[256];
 	parameters.clear();
 
 	Macro macro;
@@ -977,8 +1010,8 @@ static void parse_directive_undefine( String &input, String &output, Scanner &sc
 static void parse_directive_macro( String &input, String &output, Scanner &scanner,
 	const char *name, const u32 hash, const usize start, const bool condition )
 {
-	static List<String> parameters;
-	static String substitute;
+	thread_local static List<String> parameters;
+	thread_local static String substitute;
 	parameters.clear();
 	substitute.clear();
 
@@ -1031,7 +1064,7 @@ static void parse_directive_macro( String &input, String &output, Scanner &scann
 	}
 
 	// Substitute Parameters
-	static char replace[16];
+	thread_local static char replace[16];
 	substitute = macro.definition;
 	for( int i = 0; i < macro.parameters; i++ )
 	{
@@ -1356,6 +1389,12 @@ void preprocess_input( const char *path, String &input, String &output )
 			}
 			continue;
 
+			case TokenType_Directive_Variant:
+			{
+				parse_directive_variant( input, output, scanner, nullptr );
+			}
+			continue;
+
 			case TokenType_Directive_Define:
 			{
 				parse_directive_define( input, output, scanner );
@@ -1465,7 +1504,7 @@ bool preprocess_shader( const char *path, String &output,
 	}
 
 	// Insert Macros
-	static char scratch[256];
+	thread_local static char scratch[256];
 	for( int i = 0; i < pipelineMacrosCount; i++ )
 	{
 		if( pipelineMacros[i][0] == '\0' ) { continue; }
@@ -1479,4 +1518,48 @@ bool preprocess_shader( const char *path, String &output,
 	return true;
 }
 
-////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+
+bool preprocess_variants( const char *path, List<String> &variants )
+{
+	// Only the shader file itself is scanned: permutation keys are declared at the top level, not by #include's
+	String contents;
+	ErrorReturnIf( !contents.load( path ), false, "Failed to read shader file: %s", path );
+
+	Scanner scanner;
+	scanner.init( contents, 0LLU );
+	scanner.mode = Scanner::ScannerMode_Preprocessor;
+
+	bool inCommentLine = false;
+	bool inCommentBlock = false;
+	String unused;
+
+	for( ;; )
+	{
+		Token token = scanner.next( false );
+		if( token.type == TokenType_EndOfFile ) { break; }
+
+		if( inCommentLine )
+		{
+			if( token.type == TokenType_Newline ) { inCommentLine = false; }
+			continue;
+		}
+
+		if( inCommentBlock )
+		{
+			if( token.type == TokenType_CommentEnd ) { inCommentBlock = false; }
+			continue;
+		}
+
+		switch( token.type )
+		{
+			case TokenType_CommentLine: inCommentLine = true; continue;
+			case TokenType_CommentStart: inCommentBlock = true; continue;
+			case TokenType_Directive_Variant: parse_directive_variant( contents, unused, scanner, &variants ); continue;
+			default: continue;
+		}
+	}
+
+	return true;
+}
\ No newline at end of file
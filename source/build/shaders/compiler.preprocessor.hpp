@@ -10,4 +10,7 @@ extern void preprocess_input( const char *path, String &input, String &output );
 extern bool preprocess_shader( const char *path, String &output,
 	const char **pipelineMacros = nullptr, int pipelineMacrosCount = 0 );
 
+// Gathers the '#variant NAME' permutation keys declared by a shader file (in declaration order)
+extern bool preprocess_variants( const char *path, List<String> &variants );
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -925,4 +925,109 @@ double Timer::elapsed_us()
 	return ( timeEnd - timeStart ) * 1000.0 * 1000.0;
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined( _MSC_VER )
+	#include <vendor/intrin.hpp>
+	#define PARALLEL_ATOMIC_INCREMENT( value ) \
+		static_cast<usize>( _InterlockedExchangeAdd64( reinterpret_cast<long long volatile *>( value ), 1 ) )
+#else
+	#define PARALLEL_ATOMIC_INCREMENT( value ) __atomic_fetch_add( value, 1, __ATOMIC_RELAXED )
+#endif
+
+#if !PIPELINE_OS_WINDOWS
+	#include <vendor/pthread.hpp>
+#endif
+
+#define PARALLEL_THREADS_MAX ( 64 )
+
+struct ParallelFor
+{
+	ParallelForFunction function;
+	void *context;
+	usize count;
+	volatile usize next;
+};
+
+
+static void parallel_for_worker( ParallelFor *job )
+{
+	for( usize index = PARALLEL_ATOMIC_INCREMENT( &job->next ); index < job->count;
+		index = PARALLEL_ATOMIC_INCREMENT( &job->next ) )
+	{
+		job->function( index, job->context );
+	}
+}
+
+
+#if PIPELINE_OS_WINDOWS
+	static DWORD CALLBACK parallel_for_thread( void *job )
+	{
+		parallel_for_worker( reinterpret_cast<ParallelFor *>( job ) );
+		return 0;
+	}
+#else
+	static void *parallel_for_thread( void *job )
+	{
+		parallel_for_worker( reinterpret_cast<ParallelFor *>( job ) );
+		return nullptr;
+	}
+#endif
+
+
+int processor_count()
+{
+#if PIPELINE_OS_WINDOWS
+	const int count = static_cast<int>( GetActiveProcessorCount( ALL_PROCESSOR_GROUPS ) );
+#else
+	const int count = static_cast<int>( sysconf( _SC_NPROCESSORS_ONLN ) );
+#endif
+	return count < 1 ? 1 : count;
+}
+
+
+void parallel_for( usize count, ParallelForFunction function, void *context )
+{
+	Assert( function != nullptr );
+	if( count == 0 ) { return; }
+
+	ParallelFor job { function, context, count, 0 };
+
+	// Spawn helpers (the calling thread is a worker too)
+	usize threadCount = static_cast<usize>( processor_count() );
+	threadCount = threadCount < count ? threadCount : count;
+	threadCount = threadCount < PARALLEL_THREADS_MAX ? threadCount : PARALLEL_THREADS_MAX;
+
+#if PIPELINE_OS_WINDOWS
+	HANDLE threads[PARALLEL_THREADS_MAX];
+#else
+	pthread_t threads[PARALLEL_THREADS_MAX];
+#endif
+
+	usize spawned = 0;
+	for( usize i = 1; i < threadCount; i++ )
+	{
+	#if PIPELINE_OS_WINDOWS
+		threads[spawned] = CreateThread( nullptr, 0, parallel_for_thread, &job, 0, nullptr );
+		if( threads[spawned] == nullptr ) { break; }
+	#else
+		if( pthread_create( &threads[spawned], nullptr, parallel_for_thread, &job ) != 0 ) { break; }
+	#endif
+		spawned++;
+	}
+
+	// Work & join (if no helpers could be spawned this simply runs serially)
+	parallel_for_worker( &job );
+
+	for( usize i = 0; i < spawned; i++ )
+	{
+	#if PIPELINE_OS_WINDOWS
+		WaitForSingleObject( threads[i], INFINITE );
+		CloseHandle( threads[i] );
+	#else
+		pthread_join( threads[i], nullptr );
+	#endif
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -157,4 +157,13 @@ public:
 	double timeEnd = 0.0;
 };
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Calls 'function( index, context )' for every index in [0, count) across up to processor_count() threads
+// (the calling thread included). Indices are handed out one at a time, so 'function' should do a meaningful
+// amount of work per call. Blocks until every index has completed
+using ParallelForFunction = void ( * )( usize index, void *context );
+extern void parallel_for( usize count, ParallelForFunction function, void *context );
+extern int processor_count();
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -20,6 +20,11 @@ enum_type( TextureColorFormat, u8 )
 	TextureColorFormat_R32G32,
 	TextureColorFormat_R32,
 	TextureColorFormat_R10G10B10A2,
+	TextureColorFormat_BC1,
+	TextureColorFormat_BC3,
+	TextureColorFormat_BC4,
+	TextureColorFormat_BC5,
+	TextureColorFormat_BC7,
 	// ...
 	TEXTURECOLORFORMAT_COUNT,
 };
@@ -48,6 +53,11 @@ enum_type( MeshFormatTypeVertex, u32 )
 	MeshFormatTypeVertex_PositionNormal,
 	MeshFormatTypeVertex_PositionNormalUV,
 	MeshFormatTypeVertex_PositionNormalTangentUV,
+	MeshFormatTypeVertex_PositionPacked,
+	MeshFormatTypeVertex_PositionUVPacked,
+	MeshFormatTypeVertex_PositionNormalPacked,
+	MeshFormatTypeVertex_PositionNormalUVPacked,
+	MeshFormatTypeVertex_PositionNormalTangentUVPacked,
 	// ...
 
 	MESHFORMATTYPEVERTEX_COUNT,
@@ -63,6 +73,11 @@ constexpr const char *MeshFormatTypeVertexNames[MESHFORMATTYPEVERTEX_COUNT] =
 	"VertexPositionNormal",
 	"VertexPositionNormalUV",
 	"VertexPositionNormalTangentUV",
+	"VertexPositionPacked",
+	"VertexPositionUVPacked",
+	"VertexPositionNormalPacked",
+	"VertexPositionNormalUVPacked",
+	"VertexPositionNormalTangentUVPacked",
 };
 
 
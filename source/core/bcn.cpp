@@ -0,0 +1,840 @@
+#include <core/bcn.hpp>
+
+#include <core/debug.hpp>
+#include <core/memory.hpp>
+
+#include <vendor/math.hpp>
+#include <vendor/string.hpp>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Common
+
+static inline int clamp_int( const int value, const int min, const int max )
+{
+	return value < min ? min : ( value > max ? max : value );
+}
+
+
+static inline float clamp_channel( const float value )
+{
+	return value < 0.0f ? 0.0f : ( value > 255.0f ? 255.0f : value );
+}
+
+
+static void block_gather( const u8 *rgba, const u16 width, const u16 height,
+	const u32 blockX, const u32 blockY, u8 *texels )
+{
+	for( u32 y = 0; y < 4; y++ )
+	{
+		const u32 sourceY = blockY * 4 + y < height ? blockY * 4 + y : height - 1U;
+		for( u32 x = 0; x < 4; x++ )
+		{
+			const u32 sourceX = blockX * 4 + x < width ? blockX * 4 + x : width - 1U;
+			memcpy( &texels[( y * 4 + x ) * 4], &rgba[( sourceY * width + sourceX ) * 4], 4 );
+		}
+	}
+}
+
+
+static void block_scatter( const u8 *texels, const u16 width, const u16 height,
+	const u32 blockX, const u32 blockY, u8 *rgba )
+{
+	const u32 destX = blockX * 4;
+	const u32 count = width - destX < 4 ? width - destX : 4;
+	for( u32 y = 0; y < 4 && blockY * 4 + y < height; y++ )
+	{
+		memcpy( &rgba[( ( blockY * 4 + y ) * width + destX ) * 4], &texels[y * 16], count * 4 );
+	}
+}
+
+
+static void block_flip( u8 *texels )
+{
+	u8 row[16];
+	for( u32 y = 0; y < 2; y++ )
+	{
+		memcpy( row, &texels[y * 16], 16 );
+		memcpy( &texels[y * 16], &texels[( 3 - y ) * 16], 16 );
+		memcpy( &texels[( 3 - y ) * 16], row, 16 );
+	}
+}
+
+
+static bool fit_endpoints( const u8 *texels, const u32 channels, const u16 mask, float *low, float *high )
+{
+	// Extents of the texels in 'mask' along their principal axis
+	float mean[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	u32 count = 0;
+	for( u32 i = 0; i < 16; i++ )
+	{
+		if( !( mask & ( 1U << i ) ) ) { continue; }
+		for( u32 c = 0; c < channels; c++ ) { mean[c] += texels[i * 4 + c]; }
+		count++;
+	}
+	if( count == 0 ) { return false; }
+	for( u32 c = 0; c < channels; c++ ) { mean[c] /= count; }
+
+	float covariance[4][4] = { };
+	for( u32 i = 0; i < 16; i++ )
+	{
+		if( !( mask & ( 1U << i ) ) ) { continue; }
+		float delta[4];
+		for( u32 c = 0; c < channels; c++ ) { delta[c] = texels[i * 4 + c] - mean[c]; }
+		for( u32 a = 0; a < channels; a++ )
+		{
+			for( u32 b = 0; b < channels; b++ ) { covariance[a][b] += delta[a] * delta[b]; }
+		}
+	}
+
+	// Power iteration
+	float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+	for( u32 iteration = 0; iteration < 8; iteration++ )
+	{
+		float next[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float scale = 0.0f;
+		for( u32 a = 0; a < channels; a++ )
+		{
+			for( u32 b = 0; b < channels; b++ ) { next[a] += covariance[a][b] * axis[b]; }
+			const float magnitude = next[a] < 0.0f ? -next[a] : next[a];
+			scale = magnitude > scale ? magnitude : scale;
+		}
+		if( scale <= 0.0f ) { break; } // Uniform block
+		for( u32 a = 0; a < channels; a++ ) { axis[a] = next[a] / scale; }
+	}
+
+	float length = 0.0f;
+	for( u32 c = 0; c < channels; c++ ) { length += axis[c] * axis[c]; }
+	length = sqrtf( length );
+	for( u32 c = 0; c < channels; c++ ) { axis[c] /= length; }
+
+	float extentLow = FLOAT_MAX;
+	float extentHigh = -FLOAT_MAX;
+	for( u32 i = 0; i < 16; i++ )
+	{
+		if( !( mask & ( 1U << i ) ) ) { continue; }
+		float t = 0.0f;
+		for( u32 c = 0; c < channels; c++ ) { t += ( texels[i * 4 + c] - mean[c] ) * axis[c]; }
+		extentLow = t < extentLow ? t : extentLow;
+		extentHigh = t > extentHigh ? t : extentHigh;
+	}
+
+	for( u32 c = 0; c < channels; c++ )
+	{
+		low[c] = clamp_channel( mean[c] + axis[c] * extentLow );
+		high[c] = clamp_channel( mean[c] + axis[c] * extentHigh );
+	}
+
+	return true;
+}
+
+
+static bool refine_endpoints( const u8 *texels, const u32 channels, const u16 mask, const float *weights,
+	float *endpoint0, float *endpoint1 )
+{
+	// Least-squares endpoints for fixed interpolation weights (0.0f: endpoint0, 1.0f: endpoint1)
+	float aa = 0.0f;
+	float ab = 0.0f;
+	float bb = 0.0f;
+	float xa[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	float xb[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	for( u32 i = 0; i < 16; i++ )
+	{
+		if( !( mask & ( 1U << i ) ) ) { continue; }
+		const float b = weights[i];
+		const float a = 1.0f - b;
+		aa += a * a;
+		ab += a * b;
+		bb += b * b;
+		for( u32 c = 0; c < channels; c++ )
+		{
+			xa[c] += a * texels[i * 4 + c];
+			xb[c] += b * texels[i * 4 + c];
+		}
+	}
+
+	const float determinant = aa * bb - ab * ab;
+	if( determinant < 1e-4f ) { return false; } // Every texel on the same weight
+
+	const float inverse = 1.0f / determinant;
+	for( u32 c = 0; c < channels; c++ )
+	{
+		endpoint0[c] = clamp_channel( ( bb * xa[c] - ab * xb[c] ) * inverse );
+		endpoint1[c] = clamp_channel( ( aa * xb[c] - ab * xa[c] ) * inverse );
+	}
+
+	return true;
+}
+
+
+struct BlockWriter
+{
+	u8 *data;
+	u32 cursor;
+
+	void write( const u32 value, const u32 bits )
+	{
+		for( u32 i = 0; i < bits; i++, cursor++ )
+		{
+			data[cursor >> 3] |= static_cast<u8>( ( ( value >> i ) & 1U ) << ( cursor & 7 ) );
+		}
+	}
+};
+
+
+struct BlockReader
+{
+	const u8 *data;
+	u32 cursor;
+
+	u32 read( const u32 bits )
+	{
+		u32 value = 0;
+		for( u32 i = 0; i < bits; i++, cursor++ )
+		{
+			value |= ( ( data[cursor >> 3] >> ( cursor & 7 ) ) & 1U ) << i;
+		}
+		return value;
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// BC1 (color block, shared with BC3)
+
+static const float bc1WeightsFourColor[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+static const float bc1WeightsThreeColor[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+
+
+static u16 rgb565_pack( const float *rgb )
+{
+	const int r = clamp_int( static_cast<int>( rgb[0] * ( 31.0f / 255.0f ) + 0.5f ), 0, 31 );
+	const int g = clamp_int( static_cast<int>( rgb[1] * ( 63.0f / 255.0f ) + 0.5f ), 0, 63 );
+	const int b = clamp_int( static_cast<int>( rgb[2] * ( 31.0f / 255.0f ) + 0.5f ), 0, 31 );
+	return static_cast<u16>( ( r << 11 ) | ( g << 5 ) | b );
+}
+
+
+static void rgb565_unpack( const u16 color, int *rgb )
+{
+	const int r = ( color >> 11 ) & 31;
+	const int g = ( color >> 5 ) & 63;
+	const int b = color & 31;
+	rgb[0] = ( r << 3 ) | ( r >> 2 );
+	rgb[1] = ( g << 2 ) | ( g >> 4 );
+	rgb[2] = ( b << 3 ) | ( b >> 2 );
+}
+
+
+static void bc1_palette( const u16 color0, const u16 color1, const bool fourColor, int palette[4][4] )
+{
+	rgb565_unpack( color0, palette[0] );
+	rgb565_unpack( color1, palette[1] );
+	for( u32 c = 0; c < 3; c++ )
+	{
+		if( fourColor )
+		{
+			palette[2][c] = ( 2 * palette[0][c] + palette[1][c] + 1 ) / 3;
+			palette[3][c] = ( palette[0][c] + 2 * palette[1][c] + 1 ) / 3;
+		}
+		else
+		{
+			palette[2][c] = ( palette[0][c] + palette[1][c] + 1 ) / 2;
+			palette[3][c] = 0;
+		}
+	}
+	palette[0][3] = 255;
+	palette[1][3] = 255;
+	palette[2][3] = 255;
+	palette[3][3] = fourColor ? 255 : 0;
+}
+
+
+static u32 bc1_select( const u8 *texels, const u16 color0, const u16 color1, const bool fourColor,
+	const u16 transparent, u32 &indices )
+{
+	int palette[4][4];
+	bc1_palette( color0, color1, fourColor, palette );
+
+	u32 error = 0;
+	indices = 0;
+	for( u32 i = 0; i < 16; i++ )
+	{
+		if( transparent & ( 1U << i ) ) { indices |= 3U << ( i * 2 ); continue; }
+
+		u32 best = U32_MAX;
+		u32 bestIndex = 0;
+		for( u32 k = 0; k < ( fourColor ? 4U : 3U ); k++ )
+		{
+			const int dr = texels[i * 4 + 0] - palette[k][0];
+			const int dg = texels[i * 4 + 1] - palette[k][1];
+			const int db = texels[i * 4 + 2] - palette[k][2];
+			const u32 distance = static_cast<u32>( dr * dr + dg * dg + db * db );
+			if( distance < best ) { best = distance; bestIndex = k; }
+		}
+
+		indices |= bestIndex << ( i * 2 );
+		error += best;
+	}
+
+	return error;
+}
+
+
+static void bc1_encode_color( const u8 *texels, const bool punchThrough, u8 *block )
+{
+	// Texels with alpha < 128 use the 3-color palette's transparent entry (BC1 only)
+	u16 transparent = 0;
+	for( u32 i = 0; punchThrough && i < 16; i++ )
+	{
+		if( texels[i * 4 + 3] < 128 ) { transparent |= static_cast<u16>( 1U << i ); }
+	}
+	const u16 opaque = static_cast<u16>( ~transparent );
+	const bool fourColor = ( transparent == 0 );
+
+	u16 color0 = 0;
+	u16 color1 = 0;
+	u32 indices = U32_MAX;
+
+	float low[4];
+	float high[4];
+	if( fit_endpoints( texels, 3, opaque, low, high ) )
+	{
+		color0 = rgb565_pack( high );
+		color1 = rgb565_pack( low );
+		u32 error = bc1_select( texels, color0, color1, fourColor, transparent, indices );
+
+		for( u32 iteration = 0; iteration < 2 && error > 0; iteration++ )
+		{
+			float weights[16];
+			for( u32 i = 0; i < 16; i++ )
+			{
+				const u32 index = ( indices >> ( i * 2 ) ) & 3;
+				weights[i] = fourColor ? bc1WeightsFourColor[index] : bc1WeightsThreeColor[index];
+			}
+
+			float endpoint0[4];
+			float endpoint1[4];
+			if( !refine_endpoints( texels, 3, opaque, weights, endpoint0, endpoint1 ) ) { break; }
+
+			const u16 refined0 = rgb565_pack( endpoint0 );
+			const u16 refined1 = rgb565_pack( endpoint1 );
+			u32 refinedIndices;
+			const u32 refinedError = bc1_select( texels, refined0, refined1, fourColor, transparent, refinedIndices );
+			if( refinedError >= error ) { break; }
+
+			color0 = refined0;
+			color1 = refined1;
+			indices = refinedIndices;
+			error = refinedError;
+		}
+
+		// Endpoint order selects the palette (color0 > color1: 4 colors, otherwise 3 colors + transparent)
+		if( fourColor ? color0 < color1 : color0 > color1 )
+		{
+			const u16 swap = color0;
+			color0 = color1;
+			color1 = swap;
+
+			u32 swapped = 0;
+			for( u32 i = 0; i < 16; i++ )
+			{
+				u32 index = ( indices >> ( i * 2 ) ) & 3;
+				if( fourColor || index < 2 ) { index ^= 1; }
+				swapped |= index << ( i * 2 );
+			}
+			indices = swapped;
+		}
+
+		// Equal endpoints decode with the 3-color palette -- keep clear of its transparent entry
+		if( fourColor && color0 == color1 ) { indices = 0; }
+	}
+
+	block[0] = static_cast<u8>( color0 );
+	block[1] = static_cast<u8>( color0 >> 8 );
+	block[2] = static_cast<u8>( color1 );
+	block[3] = static_cast<u8>( color1 >> 8 );
+	for( u32 i = 0; i < 4; i++ ) { block[4 + i] = static_cast<u8>( indices >> ( i * 8 ) ); }
+}
+
+
+static void bc1_decode_color( const u8 *block, const bool forceFourColor, u8 *texels )
+{
+	const u16 color0 = static_cast<u16>( block[0] | ( block[1] << 8 ) );
+	const u16 color1 = static_cast<u16>( block[2] | ( block[3] << 8 ) );
+	const u32 indices = static_cast<u32>( block[4] ) | ( static_cast<u32>( block[5] ) << 8 ) |
+		( static_cast<u32>( block[6] ) << 16 ) | ( static_cast<u32>( block[7] ) << 24 );
+
+	int palette[4][4];
+	bc1_palette( color0, color1, forceFourColor || color0 > color1, palette );
+
+	for( u32 i = 0; i < 16; i++ )
+	{
+		const u32 index = ( indices >> ( i * 2 ) ) & 3;
+		for( u32 c = 0; c < 4; c++ ) { texels[i * 4 + c] = static_cast<u8>( palette[index][c] ); }
+	}
+}
+
+
+static void bc1_flip( const u8 *block, u8 *dest )
+{
+	// One index byte per texel row
+	memcpy( dest, block, 4 );
+	for( u32 y = 0; y < 4; y++ ) { dest[4 + y] = block[7 - y]; }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// BC4 (single channel block, shared with BC3 alpha & BC5)
+
+static void bc4_palette( const int value0, const int value1, int palette[8] )
+{
+	palette[0] = value0;
+	palette[1] = value1;
+
+	if( value0 > value1 )
+	{
+		for( int i = 1; i < 7; i++ ) { palette[i + 1] = ( ( 7 - i ) * value0 + i * value1 + 3 ) / 7; }
+	}
+	else
+	{
+		for( int i = 1; i < 5; i++ ) { palette[i + 1] = ( ( 5 - i ) * value0 + i * value1 + 2 ) / 5; }
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+
+static void bc4_encode( const u8 *texels, const u32 channel, u8 *block )
+{
+	int low = 255;
+	int high = 0;
+	for( u32 i = 0; i < 16; i++ )
+	{
+		const int value = texels[i * 4 + channel];
+		low = value < low ? value : low;
+		high = value > high ? value : high;
+	}
+
+	// 8-value palette spanning [low, high] (uniform blocks use index 0 throughout)
+	u64 indices = 0LLU;
+	if( high > low )
+	{
+		int palette[8];
+		bc4_palette( high, low, palette );
+
+		for( u32 i = 0; i < 16; i++ )
+		{
+			const int value = texels[i * 4 + channel];
+			int best = 256;
+			u64 bestIndex = 0;
+			for( u32 k = 0; k < 8; k++ )
+			{
+				const int distance = value > palette[k] ? value - palette[k] : palette[k] - value;
+				if( distance < best ) { best = distance; bestIndex = k; }
+			}
+			indices |= bestIndex << ( i * 3 );
+		}
+	}
+
+	block[0] = static_cast<u8>( high );
+	block[1] = static_cast<u8>( low );
+	for( u32 i = 0; i < 6; i++ ) { block[2 + i] = static_cast<u8>( indices >> ( i * 8 ) ); }
+}
+
+
+static void bc4_decode( const u8 *block, const u32 channel, u8 *texels )
+{
+	int palette[8];
+	bc4_palette( block[0], block[1], palette );
+
+	u64 indices = 0LLU;
+	for( u32 i = 0; i < 6; i++ ) { indices |= static_cast<u64>( block[2 + i] ) << ( i * 8 ); }
+
+	for( u32 i = 0; i < 16; i++ )
+	{
+		texels[i * 4 + channel] = static_cast<u8>( palette[( indices >> ( i * 3 ) ) & 7] );
+	}
+}
+
+
+static void bc4_flip( const u8 *block, u8 *dest )
+{
+	// 12 index bits per texel row
+	u64 indices = 0LLU;
+	for( u32 i = 0; i < 6; i++ ) { indices |= static_cast<u64>( block[2 + i] ) << ( i * 8 ); }
+
+	u64 flipped = 0LLU;
+	for( u32 y = 0; y < 4; y++ ) { flipped |= ( ( indices >> ( y * 12 ) ) & 0xFFF ) << ( ( 3 - y ) * 12 ); }
+
+	dest[0] = block[0];
+	dest[1] = block[1];
+	for( u32 i = 0; i < 6; i++ ) { dest[2 + i] = static_cast<u8>( flipped >> ( i * 8 ) ); }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// BC7 (mode 6)
+
+static const int bc7Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+
+struct BC7Mode6
+{
+	int endpoints[2][4]; // 7-bit RGBA
+	int pbits[2];
+	u8 indices[16];
+};
+
+
+static inline int bc7_interpolate( const int endpoint0, const int endpoint1, const int weight )
+{
+	return ( ( 64 - weight ) * endpoint0 + weight * endpoint1 + 32 ) >> 6;
+}
+
+
+static void bc7_quantize( const float *endpoint, int *quantized, int &pbit )
+{
+	// 7 bits per channel + a p-bit shared by all 4 channels (whichever p-bit lands closer)
+	u32 bestError = U32_MAX;
+	for( int p = 0; p < 2; p++ )
+	{
+		int candidate[4];
+		u32 error = 0;
+		for( u32 c = 0; c < 4; c++ )
+		{
+			candidate[c] = clamp_int( static_cast<int>( ( endpoint[c] - p ) * 0.5f + 0.5f ), 0, 127 );
+			const int delta = ( ( candidate[c] << 1 ) | p ) - static_cast<int>( endpoint[c] + 0.5f );
+			error += static_cast<u32>( delta * delta );
+		}
+
+		if( error < bestError )
+		{
+			bestError = error;
+			pbit = p;
+			memcpy( quantized, candidate, sizeof( candidate ) );
+		}
+	}
+}
+
+
+static u32 bc7_select( const u8 *texels, BC7Mode6 &mode6 )
+{
+	int palette[16][4];
+	for( u32 c = 0; c < 4; c++ )
+	{
+		const int endpoint0 = ( mode6.endpoints[0][c] << 1 ) | mode6.pbits[0];
+		const int endpoint1 = ( mode6.endpoints[1][c] << 1 ) | mode6.pbits[1];
+		for( u32 k = 0; k < 16; k++ ) { palette[k][c] = bc7_interpolate( endpoint0, endpoint1, bc7Weights4[k] ); }
+	}
+
+	u32 error = 0;
+	for( u32 i = 0; i < 16; i++ )
+	{
+		u32 best = U32_MAX;
+		for( u32 k = 0; k < 16; k++ )
+		{
+			u32 distance = 0;
+			for( u32 c = 0; c < 4; c++ )
+			{
+				const int delta = texels[i * 4 + c] - palette[k][c];
+				distance += static_cast<u32>( delta * delta );
+			}
+			if( distance < best ) { best = distance; mode6.indices[i] = static_cast<u8>( k ); }
+		}
+		error += best;
+	}
+
+	return error;
+}
+
+
+static void bc7_pack( BC7Mode6 &mode6, u8 *block )
+{
+	// The anchor (texel 0) index is stored without its top bit -- swap the endpoints when it is set
+	if( mode6.indices[0] & 8 )
+	{
+		for( u32 c = 0; c < 4; c++ )
+		{
+			const int swap = mode6.endpoints[0][c];
+			mode6.endpoints[0][c] = mode6.endpoints[1][c];
+			mode6.endpoints[1][c] = swap;
+		}
+		const int swap = mode6.pbits[0];
+		mode6.pbits[0] = mode6.pbits[1];
+		mode6.pbits[1] = swap;
+		for( u32 i = 0; i < 16; i++ ) { mode6.indices[i] = static_cast<u8>( 15 - mode6.indices[i] ); }
+	}
+
+	memset( block, 0, 16 );
+	BlockWriter bits { block, 0 };
+	bits.write( 1U << 6, 7 );
+	for( u32 c = 0; c < 4; c++ )
+	{
+		bits.write( static_cast<u32>( mode6.endpoints[0][c] ), 7 );
+		bits.write( static_cast<u32>( mode6.endpoints[1][c] ), 7 );
+	}
+	bits.write( static_cast<u32>( mode6.pbits[0] ), 1 );
+	bits.write( static_cast<u32>( mode6.pbits[1] ), 1 );
+	for( u32 i = 0; i < 16; i++ ) { bits.write( mode6.indices[i], i == 0 ? 3 : 4 ); }
+}
+
+
+static bool bc7_unpack( const u8 *block, BC7Mode6 &mode6 )
+{
+	if( ( block[0] & 0x7F ) != 0x40 ) { return false; } // Mode 6: six 0 bits followed by a 1
+
+	BlockReader bits { block, 7 };
+	for( u32 c = 0; c < 4; c++ )
+	{
+		mode6.endpoints[0][c] = static_cast<int>( bits.read( 7 ) );
+		mode6.endpoints[1][c] = static_cast<int>( bits.read( 7 ) );
+	}
+	mode6.pbits[0] = static_cast<int>( bits.read( 1 ) );
+	mode6.pbits[1] = static_cast<int>( bits.read( 1 ) );
+	for( u32 i = 0; i < 16; i++ ) { mode6.indices[i] = static_cast<u8>( bits.read( i == 0 ? 3 : 4 ) ); }
+
+	return true;
+}
+
+
+static void bc7_encode( const u8 *texels, u8 *block )
+{
+	BC7Mode6 mode6;
+	float low[4];
+	float high[4];
+	fit_endpoints( texels, 4, 0xFFFF, low, high );
+	bc7_quantize( low, mode6.endpoints[0], mode6.pbits[0] );
+	bc7_quantize( high, mode6.endpoints[1], mode6.pbits[1] );
+	u32 error = bc7_select( texels, mode6 );
+
+	for( u32 iteration = 0; iteration < 2 && error > 0; iteration++ )
+	{
+		float weights[16];
+		for( u32 i = 0; i < 16; i++ ) { weights[i] = bc7Weights4[mode6.indices[i]] / 64.0f; }
+
+		float endpoint0[4];
+		float endpoint1[4];
+		if( !refine_endpoints( texels, 4, 0xFFFF, weights, endpoint0, endpoint1 ) ) { break; }
+
+		BC7Mode6 refined;
+		bc7_quantize( endpoint0, refined.endpoints[0], refined.pbits[0] );
+		bc7_quantize( endpoint1, refined.endpoints[1], refined.pbits[1] );
+		const u32 refinedError = bc7_select( texels, refined );
+		if( refinedError >= error ) { break; }
+
+		mode6 = refined;
+		error = refinedError;
+	}
+
+	bc7_pack( mode6, block );
+}
+
+
+static void bc7_decode( const u8 *block, u8 *texels )
+{
+	BC7Mode6 mode6;
+	if( !bc7_unpack( block, mode6 ) )
+	{
+		for( u32 i = 0; i < 16; i++ )
+		{
+			texels[i * 4 + 0] = 255;
+			texels[i * 4 + 1] = 0;
+			texels[i * 4 + 2] = 255;
+			texels[i * 4 + 3] = 255;
+		}
+		return;
+	}
+
+	for( u32 c = 0; c < 4; c++ )
+	{
+		const int endpoint0 = ( mode6.endpoints[0][c] << 1 ) | mode6.pbits[0];
+		const int endpoint1 = ( mode6.endpoints[1][c] << 1 ) | mode6.pbits[1];
+		for( u32 i = 0; i < 16; i++ )
+		{
+			texels[i * 4 + c] = static_cast<u8>( bc7_interpolate( endpoint0, endpoint1,
+				bc7Weights4[mode6.indices[i]] ) );
+		}
+	}
+}
+
+
+static void bc7_flip( const u8 *block, u8 *dest )
+{
+	BC7Mode6 mode6;
+	if( !bc7_unpack( block, mode6 ) )
+	{
+		// Other modes: re-encode (as mode 6)
+		u8 texels[64];
+		bc7_decode( block, texels );
+		block_flip( texels );
+		bc7_encode( texels, dest );
+		return;
+	}
+
+	u8 indices[16];
+	memcpy( indices, mode6.indices, sizeof( indices ) );
+	for( u32 y = 0; y < 4; y++ ) { memcpy( &mode6.indices[y * 4], &indices[( 3 - y ) * 4], 4 ); }
+	bc7_pack( mode6, dest );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void bcn_encode_block( const BCnFormat format, const u8 *rgba, void *block )
+{
+	u8 *dest = reinterpret_cast<u8 *>( block );
+
+	switch( format )
+	{
+		case BCnFormat_BC1: bc1_encode_color( rgba, true, dest ); return;
+		case BCnFormat_BC3: bc4_encode( rgba, 3, dest ); bc1_encode_color( rgba, false, dest + 8 ); return;
+		case BCnFormat_BC4: bc4_encode( rgba, 0, dest ); return;
+		case BCnFormat_BC5: bc4_encode( rgba, 0, dest ); bc4_encode( rgba, 1, dest + 8 ); return;
+		case BCnFormat_BC7: bc7_encode( rgba, dest ); return;
+	}
+
+	AssertMsg( false, "%s: invalid BCnFormat: %u", __FUNCTION__, format );
+}
+
+
+void bcn_decode_block( const BCnFormat format, const void *block, u8 *rgba )
+{
+	const u8 *source = reinterpret_cast<const u8 *>( block );
+
+	if( format == BCnFormat_BC4 || format == BCnFormat_BC5 )
+	{
+		for( u32 i = 0; i < 16; i++ )
+		{
+			rgba[i * 4 + 0] = 0;
+			rgba[i * 4 + 1] = 0;
+			rgba[i * 4 + 2] = 0;
+			rgba[i * 4 + 3] = 255;
+		}
+	}
+
+	switch( format )
+	{
+		case BCnFormat_BC1: bc1_decode_color( source, false, rgba ); return;
+		case BCnFormat_BC3: bc1_decode_color( source + 8, true, rgba ); bc4_decode( source, 3, rgba ); return;
+		case BCnFormat_BC4: bc4_decode( source, 0, rgba ); return;
+		case BCnFormat_BC5: bc4_decode( source, 0, rgba ); bc4_decode( source + 8, 1, rgba ); return;
+		case BCnFormat_BC7: bc7_decode( source, rgba ); return;
+	}
+
+	AssertMsg( false, "%s: invalid BCnFormat: %u", __FUNCTION__, format );
+}
+
+
+void bcn_encode( const BCnFormat format, const void *rgba, const u16 width, const u16 height, void *blocks,
+	const u32 blockRowBegin, const u32 blockRowEnd )
+{
+	Assert( format < BCNFORMAT_COUNT );
+	const u8 *source = reinterpret_cast<const u8 *>( rgba );
+	u8 *dest = reinterpret_cast<u8 *>( blocks );
+	const u32 blocksX = bcn_block_count( width );
+	const u32 blocksY = bcn_block_count( height );
+	const u32 blockSizeBytes = bcnFormatBlockSizeBytes[format];
+
+	u8 texels[64];
+	for( u32 blockY = blockRowBegin; blockY < blockRowEnd && blockY < blocksY; blockY++ )
+	{
+		for( u32 blockX = 0; blockX < blocksX; blockX++ )
+		{
+			block_gather( source, width, height, blockX, blockY, texels );
+			bcn_encode_block( format, texels, &dest[( blockY * blocksX + blockX ) * blockSizeBytes] );
+		}
+	}
+}
+
+
+void bcn_decode( const BCnFormat format, const void *blocks, const u16 width, const u16 height, void *rgba )
+{
+	Assert( format < BCNFORMAT_COUNT );
+	const u8 *source = reinterpret_cast<const u8 *>( blocks );
+	u8 *dest = reinterpret_cast<u8 *>( rgba );
+	const u32 blocksX = bcn_block_count( width );
+	const u32 blocksY = bcn_block_count( height );
+	const u32 blockSizeBytes = bcnFormatBlockSizeBytes[format];
+
+	u8 texels[64];
+	for( u32 blockY = 0; blockY < blocksY; blockY++ )
+	{
+		for( u32 blockX = 0; blockX < blocksX; blockX++ )
+		{
+			bcn_decode_block( format, &source[( blockY * blocksX + blockX ) * blockSizeBytes], texels );
+			block_scatter( texels, width, height, blockX, blockY, dest );
+		}
+	}
+}
+
+
+void bcn_flip_vertical( const BCnFormat format, const void *blocks, const u16 width, const u16 height, void *dest )
+{
+	Assert( format < BCNFORMAT_COUNT );
+	Assert( blocks != dest );
+	const u8 *source = reinterpret_cast<const u8 *>( blocks );
+	u8 *output = reinterpret_cast<u8 *>( dest );
+	const u32 blocksX = bcn_block_count( width );
+	const u32 blocksY = bcn_block_count( height );
+	const u32 blockSizeBytes = bcnFormatBlockSizeBytes[format];
+
+	// Partial bottom blocks would end up at the top -- round trip through RGBA8
+	if( height % 4 != 0 )
+	{
+		const usize stride = static_cast<usize>( width ) * 4;
+		u8 *decoded = reinterpret_cast<u8 *>( memory_alloc( stride * height * 2 ) );
+		u8 *flipped = decoded + stride * height;
+		bcn_decode( format, source, width, height, decoded );
+		for( u16 y = 0; y < height; y++ )
+		{
+			memcpy( &flipped[y * stride], &decoded[( height - 1 - y ) * stride], stride );
+		}
+		bcn_encode( format, flipped, width, height, output );
+		memory_free( decoded );
+		return;
+	}
+
+	for( u32 blockY = 0; blockY < blocksY; blockY++ )
+	{
+		const u8 *sourceRow = &source[( blocksY - 1 - blockY ) * blocksX * blockSizeBytes];
+		u8 *outputRow = &output[blockY * blocksX * blockSizeBytes];
+
+		for( u32 blockX = 0; blockX < blocksX; blockX++ )
+		{
+			const u8 *block = &sourceRow[blockX * blockSizeBytes];
+			u8 *flipped = &outputRow[blockX * blockSizeBytes];
+
+			switch( format )
+			{
+				case BCnFormat_BC1: bc1_flip( block, flipped ); break;
+				case BCnFormat_BC3: bc4_flip( block, flipped ); bc1_flip( block + 8, flipped + 8 ); break;
+				case BCnFormat_BC4: bc4_flip( block, flipped ); break;
+				case BCnFormat_BC5: bc4_flip( block, flipped ); bc4_flip( block + 8, flipped + 8 ); break;
+				case BCnFormat_BC7: bc7_flip( block, flipped ); break;
+			}
+		}
+	}
+}
+
+
+double bcn_psnr( const void *rgbaA, const void *rgbaB, const u16 width, const u16 height, const u8 channelMask )
+{
+	const u8 *a = reinterpret_cast<const u8 *>( rgbaA );
+	const u8 *b = reinterpret_cast<const u8 *>( rgbaB );
+	const usize texels = static_cast<usize>( width ) * height;
+
+	u64 error = 0LLU;
+	u64 samples = 0LLU;
+	for( usize i = 0; i < texels; i++ )
+	{
+		for( u32 c = 0; c < 4; c++ )
+		{
+			if( !( channelMask & ( 1U << c ) ) ) { continue; }
+			const int delta = a[i * 4 + c] - b[i * 4 + c];
+			error += static_cast<u64>( delta * delta );
+			samples++;
+		}
+	}
+
+	if( error == 0 || samples == 0 ) { return 100.0; }
+	const double mse = static_cast<double>( error ) / static_cast<double>( samples );
+	return 10.0 * log10( 255.0 * 255.0 / mse );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
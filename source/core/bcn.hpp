@@ -0,0 +1,80 @@
+#pragma once
+
+#include <core/types.hpp>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// BCn block compression (CPU encoder & decoder)
+//
+// Images are RGBA8 (4 bytes per texel, row-major). Compressed images are rows of 4x4 texel blocks; partial blocks
+// along the right & bottom edges replicate the nearest edge texel when encoding and are clipped when decoding.
+//
+// BC4 encodes the red channel and BC5 the red & green channels of the source image; their decoders write 0 to the
+// missing color channels and 255 to alpha (matching how GPUs sample them).
+//
+// BC7 is encoded with mode 6 only (single subset, 7.7.7.7 RGBA endpoints + p-bits, 4-bit indices). The decoder
+// supports mode 6; blocks in any other mode decode to magenta.
+
+enum_type( BCnFormat, u8 )
+{
+	BCnFormat_BC1 = 0, // RGB (1-bit alpha)
+	BCnFormat_BC3,     // RGBA (BC1 color + BC4 alpha)
+	BCnFormat_BC4,     // R
+	BCnFormat_BC5,     // RG (2x BC4)
+	BCnFormat_BC7,     // RGBA
+	BCNFORMAT_COUNT,
+};
+
+
+constexpr u32 bcnFormatBlockSizeBytes[BCNFORMAT_COUNT] =
+{
+	8,  // BCnFormat_BC1
+	16, // BCnFormat_BC3
+	8,  // BCnFormat_BC4
+	16, // BCnFormat_BC5
+	16, // BCnFormat_BC7
+};
+static_assert( ARRAY_LENGTH( bcnFormatBlockSizeBytes ) == BCNFORMAT_COUNT, "Missing bcnFormatBlockSizeBytes!" );
+
+
+constexpr const char *bcnFormatName[BCNFORMAT_COUNT] =
+{
+	"BC1", // BCnFormat_BC1
+	"BC3", // BCnFormat_BC3
+	"BC4", // BCnFormat_BC4
+	"BC5", // BCnFormat_BC5
+	"BC7", // BCnFormat_BC7
+};
+static_assert( ARRAY_LENGTH( bcnFormatName ) == BCNFORMAT_COUNT, "Missing bcnFormatName!" );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+inline u32 bcn_block_count( const u16 texels ) { return ( static_cast<u32>( texels ) + 3 ) / 4; }
+
+inline usize bcn_size_bytes( const BCnFormat format, const u16 width, const u16 height )
+{
+	return static_cast<usize>( bcn_block_count( width ) ) * bcn_block_count( height ) * bcnFormatBlockSizeBytes[format];
+}
+
+// Single 4x4 block ('rgba' is 16 RGBA8 texels, row-major)
+extern void bcn_encode_block( const BCnFormat format, const u8 *rgba, void *block );
+extern void bcn_decode_block( const BCnFormat format, const void *block, u8 *rgba );
+
+// Encodes block rows [blockRowBegin, blockRowEnd) of a width x height image into 'blocks' (the whole compressed
+// image -- disjoint row ranges may be encoded concurrently)
+extern void bcn_encode( const BCnFormat format, const void *rgba, const u16 width, const u16 height, void *blocks,
+	const u32 blockRowBegin = 0, const u32 blockRowEnd = U32_MAX );
+
+extern void bcn_decode( const BCnFormat format, const void *blocks, const u16 width, const u16 height, void *rgba );
+
+// Flips a compressed image vertically (for bottom-left origin APIs). Images with a height that is a multiple of 4
+// are flipped losslessly; others are decoded, flipped, and re-encoded
+extern void bcn_flip_vertical( const BCnFormat format, const void *blocks, const u16 width, const u16 height,
+	void *dest );
+
+// Peak signal-to-noise ratio (dB) between two RGBA8 images across the channels set in 'channelMask'
+// (bit 0: R, bit 1: G, bit 2: B, bit 3: A). Identical images return 100 dB
+extern double bcn_psnr( const void *rgbaA, const void *rgbaB, const u16 width, const u16 height,
+	const u8 channelMask = 0xF );
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -10,16 +10,17 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void Buffer::init( usize reserve, bool grow )
+void Buffer::init( usize reserve, bool grow, Allocator *allocator )
 {
 	capacity = reserve;
 	current = 0LLU;
 	tell = 0LLU;
 	fixed = !grow;
+	this->allocator = allocator;
 
 	MemoryAssert( data == nullptr );
 	Assert( capacity >= 1 );
-	data = reinterpret_cast<byte *>( memory_alloc( capacity ) );
+	data = reinterpret_cast<byte *>( memory_alloc( allocator, capacity ) );
 }
 
 
@@ -34,7 +35,7 @@ void Buffer::free()
 	#endif
 	}
 
-	memory_free( data );
+	memory_free( allocator, data, capacity );
 	data = nullptr;
 
 	capacity = 0LLU;
@@ -59,7 +60,7 @@ bool Buffer::load( const char *path, bool grow )
 	const usize size = fsize( file );
 	if( size == 0LLU ) { success = false; goto cleanup; }
 
-	init( size, grow );
+	init( size, grow, allocator );
 	if( fread( data, size, 1, file ) < 1 ) { success = false; goto cleanup; }
 
 	current = size;
@@ -101,7 +102,7 @@ Buffer &Buffer::copy( const Buffer &other )
 
 	MemoryAssert( data == nullptr );
 	Assert( capacity >= 1 );
-	data = reinterpret_cast<byte *>( memory_alloc( capacity ) );
+	data = reinterpret_cast<byte *>( memory_alloc( allocator, capacity ) );
 	memory_copy( data, other.data, capacity );
 
 	return *this;
@@ -119,6 +120,7 @@ Buffer &Buffer::move( Buffer &&other )
 	current = other.current;
 	tell = other.tell;
 	fixed = other.fixed;
+	allocator = other.allocator;
 
 	other.data = nullptr;
 	other.capacity = 0LLU;
@@ -135,8 +137,9 @@ void Buffer::grow()
 	MemoryAssert( data != nullptr );
 	Assert( capacity >= 1 && capacity < USIZE_MAX );
 
+	const usize capacityPrevious = capacity;
 	capacity = capacity > USIZE_MAX / 2 ? USIZE_MAX : capacity * 2;
-	data = reinterpret_cast<byte *>( memory_realloc( data, capacity ) );
+	data = reinterpret_cast<byte *>( memory_realloc( allocator, data, capacityPrevious, capacity ) );
 	ErrorIf( data == nullptr, "Failed to reallocate memory for grow Buffer (%p: realloc %d bytes)",
 		data, capacity );
 }
@@ -146,8 +149,9 @@ bool Buffer::shrink()
 {
 	MemoryAssert( data != nullptr );
 	if( current == capacity ) { return false; }
+	const usize capacityPrevious = capacity;
 	capacity = current > 1 ? current : 1;
-	data = reinterpret_cast<byte *>( memory_realloc( data, capacity ) );
+	data = reinterpret_cast<byte *>( memory_realloc( allocator, data, capacityPrevious, capacity ) );
 	ErrorIf( data == nullptr, "Failed to reallocate memory for shrink Buffer (%p: alloc %d bytes)",
 		data, capacity );
 
@@ -166,8 +170,9 @@ usize Buffer::compress()
 {
 	MemoryAssert( data != nullptr );
 
+	MemoryScratchScope scratch;
 	const usize sizeCompressedBound = static_cast<usize>( lzav_compress_bound( size() ) );
-	void *compressed = memory_alloc( sizeCompressedBound );
+	void *compressed = memory_alloc( scratch, sizeCompressedBound );
 	MemoryAssert( compressed );
 
 	const usize sizeCompressed =
@@ -181,8 +186,6 @@ usize Buffer::compress()
 	tell = 0LLU;
 	current = sizeCompressed;
 
-	memory_free( compressed );
-
 	return sizeCompressed;
 }
 
@@ -12,7 +12,7 @@ class Buffer
 {
 public:
 #if MEMORY_RAII
-	Buffer( usize reserve = 1, bool grow = true ) { init( reserve, grow ); }
+	Buffer( usize reserve = 1, bool grow = true, Allocator *allocator = nullptr ) { init( reserve, grow, allocator ); }
 	Buffer( const char *path, bool grow = true ) { load( path, grow ); }
 	Buffer( const Buffer &other ) { copy( other ); }
 	Buffer( Buffer &&other ) { move( static_cast<Buffer &&>( other ) ); }
@@ -58,7 +58,7 @@ private:
 	void grow();
 
 public:
-	void init( usize reserve = 1, bool grow = true );
+	void init( usize reserve = 1, bool grow = true, Allocator *allocator = nullptr );
 	void free();
 	bool load( const char *path, bool grow = false );
 	bool save( const char *path );
@@ -218,6 +218,7 @@ public:
 public:
 	byte *data = nullptr;
 	usize tell = 0LLU;
+	Allocator *allocator = nullptr; // nullptr: general heap
 
 private:
 	usize capacity = 0LLU;
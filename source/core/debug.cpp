@@ -31,6 +31,25 @@ namespace Debug
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#if defined( _MSC_VER )
+	#include <vendor/intrin.hpp>
+	#define DEBUG_ATOMIC_LOAD( value ) \
+		reinterpret_cast<decltype( value )>( _InterlockedCompareExchangePointer( \
+			reinterpret_cast<void *volatile *>( &( value ) ), nullptr, nullptr ) )
+	#define DEBUG_ATOMIC_STORE( value, desired ) \
+		_InterlockedExchangePointer( reinterpret_cast<void *volatile *>( &( value ) ), \
+			reinterpret_cast<void *>( desired ) )
+#else
+	#define DEBUG_ATOMIC_LOAD( value ) __atomic_load_n( &( value ), __ATOMIC_ACQUIRE )
+	#define DEBUG_ATOMIC_STORE( value, desired ) __atomic_store_n( &( value ), desired, __ATOMIC_RELEASE )
+#endif
+
+// Read and written by any thread: only ever accessed through DEBUG_ATOMIC_LOAD / DEBUG_ATOMIC_STORE
+static Debug::PrintSinkFunction printSink = nullptr;
+static Debug::PrintFlushFunction printFlush = nullptr;
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 static void str_append( char *buffer, usize size, const char *string )
 {
 	if( buffer == nullptr || string == nullptr || size == 0 ) { return; }
@@ -44,17 +63,58 @@ static void str_append( char *buffer, usize size, const char *string )
 void Debug::exit( int code )
 {
 	Debug::exitCode = code;
+	Debug::print_flush();
 	::exit( code );
 }
 
 
+void Debug::print_redirect( PrintSinkFunction sink, PrintFlushFunction flush )
+{
+	Debug::print_flush();
+
+	// Sink last: a thread that observes the new sink also observes its flush function
+	DEBUG_ATOMIC_STORE( printSink, nullptr );
+	DEBUG_ATOMIC_STORE( printFlush, flush );
+	DEBUG_ATOMIC_STORE( printSink, sink );
+}
+
+
+Debug::PrintSinkFunction Debug::print_redirect_sink()
+{
+	return DEBUG_ATOMIC_LOAD( printSink );
+}
+
+
+Debug::PrintFlushFunction Debug::print_redirect_flush()
+{
+	return DEBUG_ATOMIC_LOAD( printFlush );
+}
+
+
+void Debug::print_flush()
+{
+	const PrintFlushFunction flush = DEBUG_ATOMIC_LOAD( printFlush );
+	if( flush != nullptr ) { flush(); }
+}
+
+
+static void print_sink( Debug::PrintSinkFunction sink, int color, bool newline, const char *format, va_list args )
+{
+	// NOTE: Output longer than the buffer is truncated
+	char buffer[4096];
+	const int length = vsnprintf( buffer, sizeof( buffer ), format, args );
+	if( length < 0 ) { return; }
+	sink( color, newline, buffer,
+		length < static_cast<int>( sizeof( buffer ) ) ? length : static_cast<int>( sizeof( buffer ) ) - 1 );
+}
+
+
 void Debug::print_formatted( bool newline, const char *format, ... )
 {
 #if COMPILE_TERMINAL
 	va_list args;
 	va_start( args, format );
-	vprintf( format, args );
-	if( newline ) { printf( "\n" ); }
+	Debug::print_formatted_variadic( newline, format, args );
 	va_end( args );
 #endif
 }
@@ -63,6 +123,8 @@ void Debug::print_formatted( bool newline, const char *format, ... )
 void Debug::print_formatted_variadic( bool newline, const char *format, va_list args )
 {
 #if COMPILE_TERMINAL
+	const PrintSinkFunction sink = DEBUG_ATOMIC_LOAD( printSink );
+	if( sink != nullptr ) { print_sink( sink, -1, newline, format, args ); return; }
 	vprintf( format, args );
 	if( newline ) { printf( "\n" ); }
 #endif
@@ -74,9 +136,7 @@ void Debug::print_formatted_color( bool newline, int color, const char *format,
 #if COMPILE_TERMINAL
 	va_list args;
 	va_start( args, format );
-	printf( "\x1b[%dm", color );
-	vprintf( format, args );
-	printf( newline ? "\x1b[%dm\n" : "\x1b[%dm", PrintColor_Default );
+	Debug::print_formatted_variadic_color( newline, color, format, args );
 	va_end( args );
 #endif
 }
@@ -85,6 +145,8 @@ void Debug::print_formatted_color( bool newline, int color, const char *format,
 void Debug::print_formatted_variadic_color( bool newline, int color, const char *format, va_list args )
 {
 #if COMPILE_TERMINAL
+	const PrintSinkFunction sink = DEBUG_ATOMIC_LOAD( printSink );
+	if( sink != nullptr ) { print_sink( sink, color, newline, format, args ); return; }
 	printf( "\x1b[%dm", color );
 	vprintf( format, args );
 	printf( newline ? "\x1b[%dm\n" : "\x1b[%dm", PrintColor_Default );
@@ -39,12 +39,24 @@ namespace Debug
 {
 	extern int exitCode;
 	extern bool memoryLeakDetection;
+
+	// Optional redirect for Print() output (i.e. the asynchronous terminal writer, see: manta/terminal.cpp)
+	// When set, print functions format on the calling thread and hand the text to the sink instead of writing
+	// to stdout. 'color' is -1 for uncolored prints. The flush function must block until queued output is written
+	using PrintSinkFunction = void ( * )( int color, bool newline, const char *string, int length );
+	using PrintFlushFunction = void ( * )();
 }
 
 namespace Debug
 {
 	extern void exit( const int code );
 
+	// The redirect may be installed or removed while other threads print (i.e. from an init worker)
+	extern void print_redirect( PrintSinkFunction sink, PrintFlushFunction flush );
+	extern PrintSinkFunction print_redirect_sink();
+	extern PrintFlushFunction print_redirect_flush();
+	extern void print_flush();
+
 	extern void print_formatted_variadic( bool newline, const char *format, va_list args );
 	extern void print_formatted_variadic_color( bool newline, int color, const char *format, va_list args );
 	extern void print_formatted( bool newline, const char *format, ... );
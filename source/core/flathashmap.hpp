@@ -0,0 +1,532 @@
+#pragma once
+
+#include <vendor/vendor.hpp>
+#include <vendor/new.hpp>
+#include <vendor/simd.hpp>
+
+#include <core/debug.hpp>
+#include <core/traits.hpp>
+#include <core/memory.hpp>
+#include <core/buffer.hpp>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// FlatHashMap is an open-addressing hashmap with a separate control byte per slot ("SwissTable" layout)
+//
+// Each control byte is either EMPTY, DELETED, or the low 7 bits of the key hash (H2) for a full slot. The
+// remaining hash bits (H1) pick the first group of GROUP_WIDTH slots to probe. A whole group is matched
+// against H2 in a handful of SIMD instructions, so keys are only compared on (likely) hits and probing
+// touches one control cache line per group rather than one KeyValue per slot
+//
+// The control array has GROUP_WIDTH - 1 trailing bytes that mirror the first slots, so a group load starting
+// anywhere in [0, capacity) never needs to wrap
+//
+// Key types follow the same Hash:: contract as HashMap (only hash() and equals() are used here)
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace CoreFlatHashMap
+{
+	static constexpr u8 CONTROL_EMPTY = 0x80;
+	static constexpr u8 CONTROL_DELETED = 0xFE;
+
+#if SIMD_SSE2
+	static constexpr u32 GROUP_WIDTH = 16;
+	static constexpr int GROUP_MASK_SHIFT = 0; // One mask bit per slot
+
+	struct Group
+	{
+		Group( const u8 *control ) { bytes = _mm_loadu_si128( reinterpret_cast<const __m128i *>( control ) ); }
+
+		u64 match( const u8 h2 ) const
+		{
+			return static_cast<u64>( _mm_movemask_epi8(
+				_mm_cmpeq_epi8( bytes, _mm_set1_epi8( static_cast<char>( h2 ) ) ) ) );
+		}
+
+		u64 match_empty() const
+		{
+			return static_cast<u64>( _mm_movemask_epi8(
+				_mm_cmpeq_epi8( bytes, _mm_set1_epi8( static_cast<char>( CONTROL_EMPTY ) ) ) ) );
+		}
+
+		u64 match_empty_or_deleted() const
+		{
+			// EMPTY & DELETED are the only control bytes with the sign bit set
+			return static_cast<u64>( _mm_movemask_epi8( bytes ) );
+		}
+
+		__m128i bytes;
+	};
+#elif SIMD_NEON
+	static constexpr u32 GROUP_WIDTH = 16;
+	static constexpr int GROUP_MASK_SHIFT = 2; // One mask nibble per slot (see to_mask)
+
+	struct Group
+	{
+		Group( const u8 *control ) { bytes = vld1q_u8( control ); }
+
+		static u64 to_mask( const uint8x16_t lanes )
+		{
+			// Narrow 16 x 8-bit lanes to 16 x 4-bit nibbles, keeping the top bit of each nibble
+			const uint8x8_t nibbles = vshrn_n_u16( vreinterpretq_u16_u8( lanes ), 4 );
+			return vget_lane_u64( vreinterpret_u64_u8( nibbles ), 0 ) & 0x8888888888888888ULL;
+		}
+
+		u64 match( const u8 h2 ) const { return to_mask( vceqq_u8( bytes, vdupq_n_u8( h2 ) ) ); }
+		u64 match_empty() const { return to_mask( vceqq_u8( bytes, vdupq_n_u8( CONTROL_EMPTY ) ) ); }
+		u64 match_empty_or_deleted() const { return to_mask( vcltzq_s8( vreinterpretq_s8_u8( bytes ) ) ); }
+
+		uint8x16_t bytes;
+	};
+#else
+	static_assert( false, "FlatHashMap: unsupported architecture (requires SSE2 or NEON)" );
+#endif
+
+	// Slot index helpers for a Group match mask (mask must be non-zero)
+	inline u32 mask_first( const u64 mask ) { return static_cast<u32>( simd_ctz64( mask ) >> GROUP_MASK_SHIFT ); }
+	inline u64 mask_next( const u64 mask ) { return mask & ( mask - 1 ); }
+	inline u32 mask_leading( const u64 mask )
+	{
+		constexpr int unused = 64 - static_cast<int>( GROUP_WIDTH << GROUP_MASK_SHIFT );
+		return static_cast<u32>( ( simd_clz64( mask ) - unused ) >> GROUP_MASK_SHIFT );
+	}
+
+	inline u32 hash_mix( u32 hash )
+	{
+		// Hash::hash() is the identity for integer keys, so avalanche it before splitting into H1/H2
+		// (MurmurHash3 fmix32)
+		hash ^= hash >> 16;
+		hash *= 0x85EBCA6BU;
+		hash ^= hash >> 13;
+		hash *= 0xC2B2AE35U;
+		hash ^= hash >> 16;
+		return hash;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename K, typename V>
+struct FlatHashMap
+{
+public:
+#if MEMORY_RAII
+	FlatHashMap( u32 reserve = 32, const V &nullElement = { } ) { init( reserve, nullElement ); }
+	FlatHashMap( const FlatHashMap<K, V> &other ) { copy( other ); }
+	FlatHashMap( FlatHashMap<K, V> &&other ) { move( static_cast<FlatHashMap<K, V> &&>( other ) ); }
+	~FlatHashMap() { free(); }
+
+	FlatHashMap<K, V> &operator=( const FlatHashMap<K, V> &other ) { return copy( other ); }
+	FlatHashMap<K, V> &operator=( FlatHashMap<K, V> &&other )
+		{ return move( static_cast<FlatHashMap<K, V> &&>( other ) ); }
+#else
+	FlatHashMap<K, V> &operator=( const FlatHashMap<K, V> &other )
+		{ Error( "FlatHashMap: assignment disabled" ); return *this; }
+	FlatHashMap<K, V> &operator=( FlatHashMap<K, V> &&other )
+		{ Error( "FlatHashMap: assignment disabled" ); return *this; }
+
+#if MEMORY_ASSERTS
+	~FlatHashMap()
+	{
+		if( Debug::memoryLeakDetection && Debug::exitCode == 0 )
+		{
+			MemoryAssertMsg( data == nullptr, "ERROR: Memory leak in FlatHashMap (%p) (size: %.2f kb)",
+				this, KB( size_allocated_bytes() ) );
+		}
+	}
+#endif
+#endif
+
+private:
+	struct KeyValue { K key; V value; };
+
+	static constexpr u32 GROUP_WIDTH = CoreFlatHashMap::GROUP_WIDTH;
+	using Group = CoreFlatHashMap::Group;
+
+	static bool is_full( const u8 control ) { return ( control & 0x80 ) == 0; }
+	static u32 capacity_max_load( const u32 capacity ) { return capacity - capacity / 8; } // 7/8
+
+	void allocate( const u32 capacityNew )
+	{
+		Assert( capacityNew >= GROUP_WIDTH && ( capacityNew & ( capacityNew - 1 ) ) == 0 );
+		capacity = capacityNew;
+		growthLeft = capacity_max_load( capacity );
+
+		MemoryAssert( data == nullptr && control == nullptr );
+		data = reinterpret_cast<KeyValue *>( memory_alloc( allocator, capacity * sizeof( KeyValue ) ) );
+		control = reinterpret_cast<u8 *>( memory_alloc( allocator, capacity + GROUP_WIDTH - 1 ) );
+		memory_set( control, CoreFlatHashMap::CONTROL_EMPTY, capacity + GROUP_WIDTH - 1 );
+	}
+
+	void set_control( const u32 index, const u8 value )
+	{
+		// Keep the mirrored tail bytes in sync with the first GROUP_WIDTH - 1 slots
+		control[index] = value;
+		control[( ( index - ( GROUP_WIDTH - 1 ) ) & ( capacity - 1 ) ) + ( GROUP_WIDTH - 1 )] = value;
+	}
+
+	bool find( const K &key, const u32 hash, u32 &outIndex ) const
+	{
+		MemoryAssert( data != nullptr && control != nullptr );
+		const u8 h2 = static_cast<u8>( hash & 0x7F );
+		const u32 mask = capacity - 1;
+		u32 position = ( hash >> 7 ) & mask;
+
+		// Triangular probing over groups visits every group when capacity / GROUP_WIDTH is a power of two
+		for( u32 stride = GROUP_WIDTH; ; stride += GROUP_WIDTH )
+		{
+			const Group group { &control[position] };
+
+			for( u64 match = group.match( h2 ); match != 0; match = CoreFlatHashMap::mask_next( match ) )
+			{
+				const u32 index = ( position + CoreFlatHashMap::mask_first( match ) ) & mask;
+				if( LIKELY( Hash::equals( key, data[index].key ) ) ) { outIndex = index; return true; }
+			}
+
+			// An EMPTY slot ends the probe sequence: the key was never inserted past it
+			if( LIKELY( group.match_empty() != 0 ) ) { return false; }
+			position = ( position + stride ) & mask;
+		}
+	}
+
+	u32 find_insert_slot( const u32 hash ) const
+	{
+		const u32 mask = capacity - 1;
+		u32 position = ( hash >> 7 ) & mask;
+
+		for( u32 stride = GROUP_WIDTH; ; stride += GROUP_WIDTH )
+		{
+			const u64 match = Group { &control[position] }.match_empty_or_deleted();
+			if( LIKELY( match != 0 ) ) { return ( position + CoreFlatHashMap::mask_first( match ) ) & mask; }
+			position = ( position + stride ) & mask;
+		}
+	}
+
+	void resize( const u32 capacityNew )
+	{
+		KeyValue *dataOld = data;
+		u8 *controlOld = control;
+		const u32 capacityOld = capacity;
+
+		data = nullptr;
+		control = nullptr;
+		allocate( capacityNew );
+
+		for( u32 indexOld = 0; indexOld < capacityOld; indexOld++ )
+		{
+			if( !is_full( controlOld[indexOld] ) ) { continue; }
+
+			const u32 hash = CoreFlatHashMap::hash_mix( Hash::hash( dataOld[indexOld].key ) );
+			const u32 index = find_insert_slot( hash );
+			set_control( index, static_cast<u8>( hash & 0x7F ) );
+			new ( &data[index].key ) K( static_cast<K &&>( dataOld[indexOld].key ) );
+			new ( &data[index].value ) V( static_cast<V &&>( dataOld[indexOld].value ) );
+			dataOld[indexOld].~KeyValue();
+		}
+
+		growthLeft -= size;
+		memory_free( allocator, dataOld, capacityOld * sizeof( KeyValue ) );
+		memory_free( allocator, controlOld, capacityOld + GROUP_WIDTH - 1 );
+	}
+
+	void reserve_one()
+	{
+		if( LIKELY( growthLeft > 0 ) ) { return; }
+
+		// Out of EMPTY slots: if tombstones are the cause, rehash in place (same capacity) to reclaim them,
+		// otherwise grow
+		if( size <= capacity_max_load( capacity ) / 2 ) { resize( capacity ); return; }
+		ErrorIf( capacity > U32_MAX / 2, "FlatHashMap grow exceeded maximum capacity: %u", U32_MAX );
+		resize( capacity * 2 );
+	}
+
+	u32 insert( const K &key, bool &outInserted )
+	{
+		const u32 hash = CoreFlatHashMap::hash_mix( Hash::hash( key ) );
+		u32 index;
+		if( find( key, hash, index ) ) { outInserted = false; return index; }
+
+		reserve_one();
+		index = find_insert_slot( hash );
+		growthLeft -= control[index] == CoreFlatHashMap::CONTROL_EMPTY; // DELETED slots are reused for free
+		set_control( index, static_cast<u8>( hash & 0x7F ) );
+		new ( &data[index].key ) K( key );
+		size++;
+
+		outInserted = true;
+		return index;
+	}
+
+public:
+	void init( const u32 reserve = 32, const V &nullElement = { }, Allocator *allocator = nullptr )
+	{
+		Assert( reserve >= 1 );
+		u32 capacityInitial = static_cast<u32>( align_pow2( reserve ) );
+		capacityInitial = capacityInitial < GROUP_WIDTH ? GROUP_WIDTH : capacityInitial;
+		size = 0;
+		new ( &null ) V( nullElement );
+		this->allocator = allocator;
+		allocate( capacityInitial );
+	}
+
+	void free()
+	{
+		if( data == nullptr )
+		{
+		#if MEMORY_RAII
+			return;
+		#else
+			MemoryWarning( "FlatHashMap: attempting to free() hashmap that is already freed!" ); return;
+		#endif
+		}
+
+		for( u32 i = 0; i < capacity; i++ )
+		{
+			if( is_full( control[i] ) ) { data[i].~KeyValue(); }
+		}
+
+		memory_free( allocator, data, capacity * sizeof( KeyValue ) );
+		data = nullptr;
+		memory_free( allocator, control, capacity + GROUP_WIDTH - 1 );
+		control = nullptr;
+
+		capacity = 0;
+		size = 0;
+		growthLeft = 0;
+		null.~V();
+	}
+
+	FlatHashMap<K, V> &copy( const FlatHashMap<K, V> &other )
+	{
+		MemoryAssert( other.data != nullptr && other.control != nullptr );
+		if( this == &other ) { return *this; }
+		if( data != nullptr ) { free(); }
+
+		null.~V();
+		new ( &null ) V( other.null );
+		allocator = other.allocator;
+		allocate( other.capacity );
+		size = other.size;
+		growthLeft = other.growthLeft;
+		memory_copy( control, other.control, capacity + GROUP_WIDTH - 1 );
+
+		for( u32 i = 0; i < capacity; i++ )
+		{
+			if( !is_full( control[i] ) ) { continue; }
+			new ( &data[i].key ) K( other.data[i].key );
+			new ( &data[i].value ) V( other.data[i].value );
+		}
+
+		return *this;
+	}
+
+	FlatHashMap<K, V> &move( FlatHashMap<K, V> &&other )
+	{
+		MemoryAssert( other.data != nullptr && other.control != nullptr );
+		if( this == &other ) { return *this; }
+		if( data != nullptr ) { free(); }
+
+		data = other.data;
+		control = other.control;
+		capacity = other.capacity;
+		allocator = other.allocator;
+		size = other.size;
+		growthLeft = other.growthLeft;
+		null.~V();
+		null = static_cast<V &&>( other.null );
+
+		other.data = nullptr;
+		other.control = nullptr;
+		other.capacity = 0;
+		other.size = 0;
+		other.growthLeft = 0;
+		other.null.~V();
+
+		return *this;
+	}
+
+	void clear()
+	{
+		MemoryAssert( data != nullptr && control != nullptr );
+		for( u32 i = 0; i < capacity; i++ )
+		{
+			if( is_full( control[i] ) ) { data[i].~KeyValue(); }
+		}
+
+		memory_set( control, CoreFlatHashMap::CONTROL_EMPTY, capacity + GROUP_WIDTH - 1 );
+		growthLeft = capacity_max_load( capacity );
+		size = 0;
+	}
+
+	void rehash()
+	{
+		// Rebuild at the same capacity, dropping all tombstones
+		MemoryAssert( data != nullptr && control != nullptr );
+		resize( capacity );
+	}
+
+	bool is_initialized() const
+	{
+		return data != nullptr;
+	}
+
+	V &get( const K &key )
+	{
+		MemoryAssert( data != nullptr && control != nullptr );
+		bool inserted;
+		const u32 index = insert( key, inserted );
+		if( inserted ) { new ( &data[index].value ) V( null ); }
+		return data[index].value;
+	}
+
+	V &set( const K &key, const V &value )
+	{
+		MemoryAssert( data != nullptr && control != nullptr );
+		V &outValue = get( key );
+		new ( &outValue ) V( value );
+		return outValue;
+	}
+
+	V &set( const K &key, V &&value )
+	{
+		MemoryAssert( data != nullptr && control != nullptr );
+		V &outValue = get( key );
+		new ( &outValue ) V( static_cast<V &&>( value ) );
+		return outValue;
+	}
+
+	bool add( const K &key, const V &value )
+	{
+		MemoryAssert( data != nullptr && control != nullptr );
+		bool inserted;
+		const u32 index = insert( key, inserted );
+		if( inserted ) { new ( &data[index].value ) V( value ); }
+		return inserted;
+	}
+
+	bool add( const K &key, V &&value )
+	{
+		MemoryAssert( data != nullptr && control != nullptr );
+		bool inserted;
+		const u32 index = insert( key, inserted );
+		if( inserted ) { new ( &data[index].value ) V( static_cast<V &&>( value ) ); }
+		return inserted;
+	}
+
+	bool remove( const K &key )
+	{
+		MemoryAssert( data != nullptr && control != nullptr );
+		u32 index;
+		if( !find( key, CoreFlatHashMap::hash_mix( Hash::hash( key ) ), index ) ) { return false; }
+
+		// If no group containing this slot was ever full, no probe sequence can pass over it: mark it EMPTY
+		// (reclaiming the slot immediately) instead of leaving a DELETED tombstone
+		const u32 indexBefore = ( index - GROUP_WIDTH ) & ( capacity - 1 );
+		const u64 emptyAfter = Group { &control[index] }.match_empty();
+		const u64 emptyBefore = Group { &control[indexBefore] }.match_empty();
+		const bool neverFull = emptyAfter != 0 && emptyBefore != 0 &&
+			CoreFlatHashMap::mask_first( emptyAfter ) + CoreFlatHashMap::mask_leading( emptyBefore ) < GROUP_WIDTH;
+
+		set_control( index, neverFull ? CoreFlatHashMap::CONTROL_EMPTY : CoreFlatHashMap::CONTROL_DELETED );
+		growthLeft += neverFull;
+		data[index].~KeyValue();
+		size--;
+		return true;
+	}
+
+	bool contains( const K &key ) const
+	{
+		u32 index;
+		return find( key, CoreFlatHashMap::hash_mix( Hash::hash( key ) ), index );
+	}
+
+	usize count() const
+	{
+		return size;
+	}
+
+	usize size_allocated_bytes() const
+	{
+		return capacity * ( sizeof( KeyValue ) + sizeof( u8 ) ) + ( GROUP_WIDTH - 1 );
+	}
+
+	V &operator[]( const K &key ) { return get( key ); }
+
+	class forward_iterator
+	{
+	public:
+		forward_iterator( KeyValue *data, const u8 *control, u32 index, u32 end ) :
+			data { data }, control { control }, index { index }, end { end } { find_next(); } // begin();
+		forward_iterator( u32 end ) : index { end }, end { end } { } // end();
+		KeyValue &operator*() { return data[index]; }
+		forward_iterator &operator++() { index++; find_next(); return *this; }
+		bool operator!=( const forward_iterator &other ) const { return index != other.index; }
+
+	private:
+		void find_next()
+		{
+			while( index != end && !is_full( control[index] ) ) { index++; }
+		}
+
+		KeyValue *data = nullptr;
+		const u8 *control = nullptr;
+		u32 index;
+		u32 end;
+	};
+
+	forward_iterator begin() { return forward_iterator( data, control, 0, capacity ); }
+	forward_iterator end() { return forward_iterator( capacity ); }
+	forward_iterator begin() const { return forward_iterator( data, control, 0, capacity ); }
+	forward_iterator end() const { return forward_iterator( capacity ); }
+
+	explicit operator bool() const { return data != nullptr; }
+
+public:
+	static void write( Buffer &buffer, const FlatHashMap<K, V> &hashmap )
+	{
+		MemoryAssert( buffer.data != nullptr );
+		MemoryAssert( hashmap.data != nullptr );
+
+		buffer.write<u32>( hashmap.size );
+		for( u32 i = 0; i < hashmap.capacity; i++ )
+		{
+			if( !is_full( hashmap.control[i] ) ) { continue; }
+			buffer.write<K>( hashmap.data[i].key );
+			buffer.write<V>( hashmap.data[i].value );
+		}
+	}
+
+	NO_DISCARD static bool read( Buffer &buffer, FlatHashMap<K, V> &hashmap )
+	{
+		u32 size;
+		if( !buffer.read<u32>( size ) ) { return false; }
+
+		const bool hashmapAlreadyInitialized = hashmap.data != nullptr;
+		auto cleanup_failure = [&]() { if( !hashmapAlreadyInitialized ) { hashmap.free(); } };
+		if( hashmapAlreadyInitialized ) { hashmap.free(); }
+		hashmap.init( size + size / 7 + 1, { }, hashmap.allocator );
+
+		for( u32 i = 0; i < size; i++ )
+		{
+			K key;
+			if( !buffer.read<K>( key ) ) { cleanup_failure(); return false; };
+			if( !buffer.read<V>( hashmap.get( key ) ) ) { cleanup_failure(); return false; };
+		}
+
+		return true;
+	}
+
+private:
+	KeyValue *data = nullptr;
+	u8 *control = nullptr;
+	u32 capacity = 0;
+	u32 size = 0;
+	u32 growthLeft = 0; // Inserts remaining before an EMPTY slot must be reclaimed (rehash) or the table grown
+	V null;
+
+public:
+	Allocator *allocator = nullptr; // nullptr: general heap
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -71,9 +71,10 @@ private:
 		// Allocate memory
 		MemoryAssert( data != nullptr );
 		KeyValue *dataOld = data;
-		data = reinterpret_cast<KeyValue *>( memory_alloc( capacity * sizeof( KeyValue ) ) );
+		data = reinterpret_cast<KeyValue *>( memory_alloc( allocator, capacity * sizeof( KeyValue ) ) );
 		MemoryAssert( deadslot != nullptr );
-		deadslot = reinterpret_cast<bool *>( memory_realloc( deadslot, capacity * sizeof( bool ) ) );
+		deadslot = reinterpret_cast<bool *>( memory_realloc( allocator, deadslot,
+			capacityPrevious * sizeof( bool ), capacity * sizeof( bool ) ) );
 
 		// Initialize new slots
 		for( u32 i = 0; i < capacity; i++ )
@@ -95,7 +96,7 @@ private:
 		}
 
 		// Free old data
-		memory_free( dataOld );
+		memory_free( allocator, dataOld, capacityPrevious * sizeof( KeyValue ) );
 	}
 
 	bool find( const K &key, u32 &outIndex ) const
@@ -142,17 +143,18 @@ private:
 	}
 
 public:
-	void init( const u32 reserve = 32, const V &nullElement = { } )
+	void init( const u32 reserve = 32, const V &nullElement = { }, Allocator *allocator = nullptr )
 	{
 		Assert( reserve >= 1 );
 		capacity = align_pow2( reserve );
 		size = 0;
 		new ( &null ) V( nullElement );
+		this->allocator = allocator;
 
 		MemoryAssert( data == nullptr );
-		data = reinterpret_cast<KeyValue *>( memory_alloc( capacity * sizeof( KeyValue ) ) );
+		data = reinterpret_cast<KeyValue *>( memory_alloc( allocator, capacity * sizeof( KeyValue ) ) );
 		MemoryAssert( deadslot == nullptr );
-		deadslot = reinterpret_cast<bool *>( memory_alloc( capacity * sizeof( bool ) ) );
+		deadslot = reinterpret_cast<bool *>( memory_alloc( allocator, capacity * sizeof( bool ) ) );
 
 		for( u32 i = 0; i < capacity; i++ )
 		{
@@ -178,9 +180,9 @@ public:
 			data[i].~KeyValue();
 		}
 
-		memory_free( data );
+		memory_free( allocator, data, capacity * sizeof( KeyValue ) );
 		data = nullptr;
-		memory_free( deadslot );
+		memory_free( allocator, deadslot, capacity * sizeof( bool ) );
 		deadslot = nullptr;
 
 		capacity = 0LLU;
@@ -201,8 +203,8 @@ public:
 		new ( &null ) V( other.null );
 
 		MemoryAssert( data == nullptr );
-		data = reinterpret_cast<KeyValue *>( memory_alloc( capacity * sizeof( KeyValue ) ) );
-		deadslot = reinterpret_cast<bool *>( memory_alloc( capacity * sizeof( bool ) ) );
+		data = reinterpret_cast<KeyValue *>( memory_alloc( allocator, capacity * sizeof( KeyValue ) ) );
+		deadslot = reinterpret_cast<bool *>( memory_alloc( allocator, capacity * sizeof( bool ) ) );
 
 		for( u32 i = 0; i < capacity; i++ )
 		{
@@ -224,6 +226,7 @@ public:
 		data = other.data;
 		deadslot = other.deadslot;
 		capacity = other.capacity;
+		allocator = other.allocator;
 		size = other.size;
 		null.~V();
 		null = static_cast<V &&>( other.null );
@@ -262,7 +265,7 @@ public:
 		Assert( capacity >= 1 );
 		MemoryAssert( data != nullptr );
 		KeyValue *dataOld = data;
-		data = reinterpret_cast<KeyValue *>( memory_alloc( capacity * sizeof( KeyValue ) ) );
+		data = reinterpret_cast<KeyValue *>( memory_alloc( allocator, capacity * sizeof( KeyValue ) ) );
 
 		// Initialize new slots
 		for( u32 i = 0; i < capacity; i++ )
@@ -284,7 +287,7 @@ public:
 		}
 
 		// Free old data
-		memory_free( dataOld );
+		memory_free( allocator, dataOld, capacity * sizeof( KeyValue ) );
 	}
 
 	bool is_initialized() const
@@ -460,7 +463,7 @@ public:
 		const bool hashmapAlreadyInitialized = hashmap.data != nullptr;
 		auto cleanup_failure = [&]() { if( !hashmapAlreadyInitialized ) { hashmap.free(); } };
 		if( hashmapAlreadyInitialized ) { hashmap.free(); }
-		hashmap.init( size );
+		hashmap.init( size, { }, hashmap.allocator );
 
 		for( usize i = 0; i < size; i++ )
 		{
@@ -491,6 +494,9 @@ private:
 	u32 capacity = 0;
 	u32 size = 0;
 	V null;
+
+public:
+	Allocator *allocator = nullptr; // nullptr: general heap
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -45,8 +45,10 @@ private:
 		MemoryAssert( data != nullptr );
 		Assert( capacity >= 1 && capacity < USIZE_MAX );
 
+		const usize capacityPrevious = capacity;
 		capacity = capacity > USIZE_MAX / 2 ? USIZE_MAX : capacity * 2;
-		data = reinterpret_cast<T *>( memory_realloc( data, capacity * sizeof( T ) ) );
+		data = reinterpret_cast<T *>( memory_realloc( allocator, data,
+			capacityPrevious * sizeof( T ), capacity * sizeof( T ) ) );
 		ErrorIf( data == nullptr, "Failed to reallocate memory for grow List (%p: realloc %d bytes)",
 			data, capacity * sizeof( T ) );
 	}
@@ -100,14 +102,15 @@ public:
 		data[j] = static_cast<T &&>( temp );
 	}
 
-	void init( usize reserve = 1 )
+	void init( usize reserve = 1, Allocator *allocator = nullptr )
 	{
 		Assert( reserve >= 1 );
 		capacity = reserve;
 		current = 0LLU;
+		this->allocator = allocator;
 
 		MemoryAssert( data == nullptr );
-		data = reinterpret_cast<T *>( memory_alloc( capacity * sizeof( T ) ) );
+		data = reinterpret_cast<T *>( memory_alloc( allocator, capacity * sizeof( T ) ) );
 		memory_set( data, 0, capacity * sizeof( T ) );
 	}
 
@@ -123,7 +126,7 @@ public:
 		}
 
 		for( usize i = 0; i < current; i++ ) { data[i].~T(); }
-		memory_free( data );
+		memory_free( allocator, data, capacity * sizeof( T ) );
 		data = nullptr;
 
 		capacity = 0LLU;
@@ -134,10 +137,12 @@ public:
 	{
 		Assert( reserve > 0 );
 		if( reserve <= capacity ) { return; }
+		const usize capacityPrevious = capacity;
 		capacity = reserve;
 
 		MemoryAssert( data != nullptr );
-		data = reinterpret_cast<T *>( memory_realloc( data, capacity * sizeof( T ) ) );
+		data = reinterpret_cast<T *>( memory_realloc( allocator, data,
+			capacityPrevious * sizeof( T ), capacity * sizeof( T ) ) );
 		ErrorIf( data == nullptr, "Failed to reallocate memory for reserve List (%p: realloc %d bytes)",
 			data, capacity * sizeof( T ) );
 	}
@@ -159,7 +164,7 @@ public:
 
 		MemoryAssert( data == nullptr );
 		Assert( capacity >= 1 );
-		data = reinterpret_cast<T *>( memory_alloc( capacity * sizeof( T ) ) );
+		data = reinterpret_cast<T *>( memory_alloc( allocator, capacity * sizeof( T ) ) );
 		for( usize i = 0; i < current; i++ ) { new ( &data[i] ) T( other.data[i] ); }
 
 		return *this;
@@ -175,6 +180,7 @@ public:
 		data = other.data;
 		capacity = other.capacity;
 		current = other.current;
+		allocator = other.allocator;
 
 		other.data = nullptr;
 		other.capacity = 0LLU;
@@ -205,9 +211,11 @@ public:
 	bool shrink()
 	{
 		if( current == capacity ) { return false; }
+		const usize capacityPrevious = capacity;
 		capacity = current > 1 ? current : 1;
 		MemoryAssert( data != nullptr );
-		data = reinterpret_cast<T *>( memory_realloc( data, capacity * sizeof( T ) ) );
+		data = reinterpret_cast<T *>( memory_realloc( allocator, data,
+			capacityPrevious * sizeof( T ), capacity * sizeof( T ) ) );
 		ErrorIf( data == nullptr, "Failed to reallocate memory for shrink List (%p: alloc %d bytes)",
 			data, capacity * sizeof( T ) );
 		return true;
@@ -474,7 +482,7 @@ public:
 		const bool listAlreadyInitialized = list.data != nullptr;
 		auto cleanup_failure = [&]() { if( !listAlreadyInitialized ) { list.free(); } };
 		if( listAlreadyInitialized ) { list.free(); }
-		list.init( size );
+		list.init( size, list.allocator );
 		list.current = list.capacity;
 
 		for( usize i = 0; i < list.current; i++ )
@@ -510,7 +518,7 @@ public:
 			const bool listAlreadyInitialized = list.data != nullptr;
 			auto cleanup_failure = [&]() { if( !listAlreadyInitialized ) { list.free(); } };
 			if( listAlreadyInitialized ) { list.free(); }
-			list.init( current );
+			list.init( current, list.allocator );
 			list.current = current;
 
 			if( !deserializer.read_array<T>( "elements", list.data, list.current ) )
@@ -527,6 +535,7 @@ public:
 	T *data = nullptr;
 	usize capacity = 0LLU;
 	usize current = 0LLU;
+	Allocator *allocator = nullptr; // nullptr: general heap
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -164,6 +164,64 @@ void fast_sinf_cosf( float radians, float &sin, float &cos )
 		y2 + 0.0416666380f ) * y2 - 0.50000000f ) * y2 + 1.0f ) * sign;
 }
 
+
+u16 float_to_half( float value )
+{
+	u32 bits;
+	memory_copy( &bits, &value, sizeof( u32 ) );
+	const u16 sign = static_cast<u16>( ( bits >> 16 ) & 0x8000 );
+	const u32 magnitude = bits & 0x7FFFFFFF;
+
+	if( magnitude >= 0x7F800000 )
+	{
+		return sign | 0x7C00 | ( magnitude > 0x7F800000 ? 0x200 : 0 ); // Inf / NaN
+	}
+	if( magnitude >= 0x477FF000 )
+	{
+		return sign | 0x7C00; // Overflow (rounds past 65504)
+	}
+	if( magnitude < 0x38800000 )
+	{
+		// Subnormal: round to nearest multiple of 2^-24
+		float abs;
+		memory_copy( &abs, &magnitude, sizeof( float ) );
+		return sign | static_cast<u16>( abs * 16777216.0f + 0.5f );
+	}
+
+	// Normal: rebias exponent, round mantissa to nearest even
+	const u32 rebiased = magnitude - ( 112 << 23 );
+	return sign | static_cast<u16>( ( rebiased + 0x0FFF + ( ( rebiased >> 13 ) & 1 ) ) >> 13 );
+}
+
+
+float half_to_float( u16 half )
+{
+	const u32 sign = static_cast<u32>( half & 0x8000 ) << 16;
+	const u32 exponent = ( half >> 10 ) & 0x1F;
+	const u32 mantissa = half & 0x3FF;
+
+	u32 bits;
+	if( exponent == 0x1F )
+	{
+		bits = sign | 0x7F800000 | ( mantissa << 13 ); // Inf / NaN
+	}
+	else if( exponent != 0 )
+	{
+		bits = sign | ( ( exponent + 112 ) << 23 ) | ( mantissa << 13 );
+	}
+	else
+	{
+		// Zero / subnormal
+		const float value = static_cast<float>( mantissa ) * ( 1.0f / 16777216.0f );
+		memory_copy( &bits, &value, sizeof( u32 ) );
+		bits |= sign;
+	}
+
+	float value;
+	memory_copy( &value, &bits, sizeof( float ) );
+	return value;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 double lerp_degrees( double value1, double value2, double amount )
@@ -43,6 +43,10 @@ extern float fast_floorf( float x );
 extern void fast_sin_cos( double radians, double &sin, double &cos );
 extern void fast_sinf_cosf( float radians, float &sin, float &cos );
 
+// IEEE 754 binary16 <-> binary32 (rounds to nearest even; overflow saturates to infinity)
+extern u16 float_to_half( float value );
+extern float half_to_float( u16 half );
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 template <typename T> inline T lengthdir_x( T dist, double degrees )
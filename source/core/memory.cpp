@@ -82,6 +82,408 @@ void memory_free( void *block )
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#if defined( _MSC_VER )
+	#include <vendor/intrin.hpp>
+	#define MEMORY_ATOMIC_ADD( value, delta ) \
+		( _InterlockedExchangeAdd64( reinterpret_cast<long long volatile *>( value ), ( delta ) ) + ( delta ) )
+#else
+	#define MEMORY_ATOMIC_ADD( value, delta ) __atomic_add_fetch( value, delta, __ATOMIC_RELAXED )
+#endif
+
+static const char *MEMORY_TAG_NAMES[MEMORYTAG_COUNT] =
+{
+	"General",
+	"Assets",
+	"Gfx",
+	"Audio",
+	"Fonts",
+	"Text",
+	"Console",
+	"Objects",
+	"Network",
+	"Build",
+	"Frame",
+	"Scratch",
+};
+
+static Allocator MEMORY_HEAPS[MEMORYTAG_COUNT] =
+{
+	{ AllocatorType_Heap, MemoryTag_General },
+	{ AllocatorType_Heap, MemoryTag_Assets },
+	{ AllocatorType_Heap, MemoryTag_Gfx },
+	{ AllocatorType_Heap, MemoryTag_Audio },
+	{ AllocatorType_Heap, MemoryTag_Fonts },
+	{ AllocatorType_Heap, MemoryTag_Text },
+	{ AllocatorType_Heap, MemoryTag_Console },
+	{ AllocatorType_Heap, MemoryTag_Objects },
+	{ AllocatorType_Heap, MemoryTag_Network },
+	{ AllocatorType_Heap, MemoryTag_Build },
+	{ AllocatorType_Heap, MemoryTag_Frame },
+	{ AllocatorType_Heap, MemoryTag_Scratch },
+};
+
+static volatile i64 tagBytesLive[MEMORYTAG_COUNT];
+static volatile i64 tagBytesPeak[MEMORYTAG_COUNT];
+static volatile i64 tagAllocations[MEMORYTAG_COUNT];
+
+static usize align_up( const usize size )
+{
+	const usize aligned = ( size + ( MEMORY_ALIGNMENT - 1 ) ) & ~static_cast<usize>( MEMORY_ALIGNMENT - 1 );
+	return aligned == 0LLU ? MEMORY_ALIGNMENT : aligned;
+}
+
+
+void memory_tag_track( const MemoryTag tag, const i64 bytes )
+{
+	Assert( tag < MEMORYTAG_COUNT );
+	const i64 live = MEMORY_ATOMIC_ADD( &tagBytesLive[tag], bytes );
+	if( bytes <= 0 ) { return; }
+	MEMORY_ATOMIC_ADD( &tagAllocations[tag], 1 );
+	if( live > tagBytesPeak[tag] ) { tagBytesPeak[tag] = live; } // NOTE: Racy high-water mark (stats only)
+}
+
+
+MemoryTagStats memory_tag_stats( const MemoryTag tag )
+{
+	Assert( tag < MEMORYTAG_COUNT );
+	return MemoryTagStats { tagBytesLive[tag], tagBytesPeak[tag], tagAllocations[tag] };
+}
+
+
+const char *memory_tag_name( const MemoryTag tag )
+{
+	Assert( tag < MEMORYTAG_COUNT );
+	return MEMORY_TAG_NAMES[tag];
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+Allocator *memory_heap( const MemoryTag tag )
+{
+	Assert( tag < MEMORYTAG_COUNT );
+	return &MEMORY_HEAPS[tag];
+}
+
+
+void *memory_alloc( Allocator *allocator, const usize size )
+{
+	if( allocator == nullptr || allocator->type == AllocatorType_Heap )
+	{
+		memory_tag_track( allocator == nullptr ? MemoryTag_General : allocator->tag, static_cast<i64>( size ) );
+		return memory_alloc( size );
+	}
+
+	switch( allocator->type )
+	{
+		case AllocatorType_Arena: return static_cast<ArenaAllocator *>( allocator )->alloc( size );
+		case AllocatorType_Pool: return static_cast<PoolAllocator *>( allocator )->alloc( size );
+		default: Error( "Memory: invalid allocator type %u", allocator->type ); return nullptr;
+	}
+}
+
+
+void *memory_realloc( Allocator *allocator, void *block, const usize sizeOld, const usize size )
+{
+	if( allocator == nullptr || allocator->type == AllocatorType_Heap )
+	{
+		memory_tag_track( allocator == nullptr ? MemoryTag_General : allocator->tag,
+			static_cast<i64>( size ) - static_cast<i64>( sizeOld ) );
+		return block == nullptr ? memory_alloc( size ) : memory_realloc( static_cast<void *>( block ), size );
+	}
+
+	switch( allocator->type )
+	{
+		case AllocatorType_Arena: return static_cast<ArenaAllocator *>( allocator )->realloc( block, sizeOld, size );
+		case AllocatorType_Pool:
+			ErrorIf( size > static_cast<PoolAllocator *>( allocator )->size_block(),
+				"Memory: PoolAllocator blocks cannot grow (%llu -> %llu bytes)", sizeOld, size );
+			return block == nullptr ? static_cast<PoolAllocator *>( allocator )->alloc( size ) : block;
+		default: Error( "Memory: invalid allocator type %u", allocator->type ); return nullptr;
+	}
+}
+
+
+void memory_free( Allocator *allocator, void *block, const usize size )
+{
+	if( allocator == nullptr || allocator->type == AllocatorType_Heap )
+	{
+		memory_tag_track( allocator == nullptr ? MemoryTag_General : allocator->tag, -static_cast<i64>( size ) );
+		memory_free( block );
+		return;
+	}
+
+	switch( allocator->type )
+	{
+		case AllocatorType_Arena: static_cast<ArenaAllocator *>( allocator )->release( block, size ); return;
+		case AllocatorType_Pool: static_cast<PoolAllocator *>( allocator )->release( block ); return;
+		default: Error( "Memory: invalid allocator type %u", allocator->type ); return;
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static byte *arena_chunk_base( ArenaAllocator::Chunk *chunk )
+{
+	return reinterpret_cast<byte *>( chunk ) + align_up( sizeof( ArenaAllocator::Chunk ) );
+}
+
+
+void ArenaAllocator::init( const MemoryTag tag, const usize chunkSize )
+{
+	Assert( chunkSize > 0 );
+	MemoryAssert( chunk == nullptr );
+	this->type = AllocatorType_Arena;
+	this->tag = tag;
+	this->chunkSize = chunkSize;
+	last = nullptr;
+	used = 0LLU;
+	peak = 0LLU;
+	allocated = 0LLU;
+}
+
+
+void ArenaAllocator::free()
+{
+	while( chunk != nullptr )
+	{
+		Chunk *previous = chunk->previous;
+		const usize size = align_up( sizeof( Chunk ) ) + chunk->capacity;
+		memory_tag_track( tag, -static_cast<i64>( size ) );
+		memory_free( chunk );
+		chunk = previous;
+	}
+
+	last = nullptr;
+	chunkSize = 0LLU;
+	used = 0LLU;
+	allocated = 0LLU;
+}
+
+
+ArenaAllocator::Chunk *ArenaAllocator::chunk_push( const usize size )
+{
+	const usize capacity = size > chunkSize ? size : chunkSize;
+	const usize bytes = align_up( sizeof( Chunk ) ) + capacity;
+	Chunk *chunkNew = reinterpret_cast<Chunk *>( memory_alloc( bytes ) );
+	memory_tag_track( tag, static_cast<i64>( bytes ) );
+	allocated += bytes;
+
+	chunkNew->previous = chunk;
+	chunkNew->capacity = capacity;
+	chunkNew->used = 0LLU;
+	chunk = chunkNew;
+	return chunkNew;
+}
+
+
+void *ArenaAllocator::alloc( usize size )
+{
+	Assert( is_initialized() );
+	size = align_up( size );
+	if( chunk == nullptr || chunk->used + size > chunk->capacity ) { chunk_push( size ); }
+
+	void *block = arena_chunk_base( chunk ) + chunk->used;
+	chunk->used += size;
+	used += size;
+	peak = used > peak ? used : peak;
+	last = block;
+	return block;
+}
+
+
+void *ArenaAllocator::realloc( void *block, const usize sizeOld, const usize size )
+{
+	if( block == nullptr ) { return alloc( size ); }
+	const usize alignedOld = align_up( sizeOld );
+	const usize alignedNew = align_up( size );
+
+	// Most recent allocation: grow/shrink in place
+	if( block == last )
+	{
+		const usize offset = static_cast<usize>( reinterpret_cast<byte *>( block ) - arena_chunk_base( chunk ) );
+		if( offset + alignedNew <= chunk->capacity )
+		{
+			chunk->used = offset + alignedNew;
+			used = used - alignedOld + alignedNew;
+			peak = used > peak ? used : peak;
+			return block;
+		}
+	}
+
+	if( alignedNew <= alignedOld ) { return block; }
+
+	void *blockNew = alloc( size );
+	memory_copy( blockNew, block, sizeOld );
+	return blockNew;
+}
+
+
+void ArenaAllocator::release( void *block, const usize size )
+{
+	// Only the most recent allocation can be reclaimed -- everything else waits for reset()/rewind()
+	if( block != last || block == nullptr ) { return; }
+	const usize aligned = align_up( size );
+	chunk->used -= aligned;
+	used -= aligned;
+	last = nullptr;
+}
+
+
+void ArenaAllocator::reset()
+{
+	if( chunk == nullptr ) { return; }
+
+	// Spilled into several chunks? Coalesce into one chunk large enough for all of them
+	if( chunk->previous != nullptr )
+	{
+		usize capacity = 0LLU;
+		for( Chunk *c = chunk; c != nullptr; c = c->previous ) { capacity += c->capacity; }
+		const usize chunkSizeDefault = chunkSize;
+		free();
+		chunkSize = chunkSizeDefault;
+		chunk_push( capacity );
+	}
+
+	chunk->used = 0LLU;
+	used = 0LLU;
+	last = nullptr;
+}
+
+
+void ArenaAllocator::rewind( const Marker marker )
+{
+	while( chunk != nullptr && chunk != marker.chunk )
+	{
+		// Keep the first chunk around for reuse
+		if( chunk->previous == nullptr && marker.chunk == nullptr ) { used -= chunk->used; chunk->used = 0LLU; break; }
+
+		Chunk *previous = chunk->previous;
+		const usize size = align_up( sizeof( Chunk ) ) + chunk->capacity;
+		used -= chunk->used;
+		allocated -= size;
+		memory_tag_track( tag, -static_cast<i64>( size ) );
+		memory_free( chunk );
+		chunk = previous;
+	}
+
+	if( chunk != nullptr && chunk == marker.chunk )
+	{
+		Assert( marker.used <= chunk->used );
+		used -= chunk->used - marker.used;
+		chunk->used = marker.used;
+	}
+
+	last = nullptr;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void PoolAllocator::init( const MemoryTag tag, const usize blockSize, const u32 blocksPerChunk )
+{
+	Assert( blockSize > 0 && blocksPerChunk > 0 );
+	MemoryAssert( chunks == nullptr );
+	this->type = AllocatorType_Pool;
+	this->tag = tag;
+	this->blockSize = align_up( blockSize > sizeof( Block ) ? blockSize : sizeof( Block ) );
+	this->blocksPerChunk = blocksPerChunk;
+	freeList = nullptr;
+	allocated = 0LLU;
+}
+
+
+void PoolAllocator::free()
+{
+	const usize bytes = align_up( sizeof( Chunk ) ) + blockSize * blocksPerChunk;
+	while( chunks != nullptr )
+	{
+		Chunk *next = chunks->next;
+		memory_tag_track( tag, -static_cast<i64>( bytes ) );
+		memory_free( chunks );
+		chunks = next;
+	}
+
+	freeList = nullptr;
+	allocated = 0LLU;
+}
+
+
+void PoolAllocator::chunk_push()
+{
+	const usize bytes = align_up( sizeof( Chunk ) ) + blockSize * blocksPerChunk;
+	Chunk *chunk = reinterpret_cast<Chunk *>( memory_alloc( bytes ) );
+	memory_tag_track( tag, static_cast<i64>( bytes ) );
+	allocated += bytes;
+
+	chunk->next = chunks;
+	chunks = chunk;
+
+	// Thread the new blocks onto the free list (lowest address first)
+	byte *base = reinterpret_cast<byte *>( chunk ) + align_up( sizeof( Chunk ) );
+	for( u32 i = blocksPerChunk; i > 0; i-- )
+	{
+		Block *block = reinterpret_cast<Block *>( base + ( i - 1 ) * blockSize );
+		block->next = freeList;
+		freeList = block;
+	}
+}
+
+
+void *PoolAllocator::alloc( const usize size )
+{
+	Assert( blockSize != 0LLU );
+	ErrorIf( size > blockSize, "Memory: PoolAllocator allocation exceeds block size (%llu > %llu bytes)",
+		size, blockSize );
+	if( freeList == nullptr ) { chunk_push(); }
+
+	Block *block = freeList;
+	freeList = block->next;
+	return block;
+}
+
+
+void PoolAllocator::release( void *block )
+{
+	if( block == nullptr ) { return; }
+	Block *node = reinterpret_cast<Block *>( block );
+	node->next = freeList;
+	freeList = node;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static ArenaAllocator frameArena;
+
+struct ScratchArena
+{
+	~ScratchArena() { if( arena.is_initialized() ) { arena.free(); } }
+	ArenaAllocator arena;
+};
+
+thread_local static ScratchArena scratchArena;
+
+
+ArenaAllocator &memory_frame()
+{
+	if( UNLIKELY( !frameArena.is_initialized() ) ) { frameArena.init( MemoryTag_Frame ); }
+	return frameArena;
+}
+
+
+void memory_frame_reset()
+{
+	if( frameArena.is_initialized() ) { frameArena.reset(); }
+}
+
+
+ArenaAllocator &memory_scratch()
+{
+	ArenaAllocator &arena = scratchArena.arena;
+	if( UNLIKELY( !arena.is_initialized() ) ) { arena.init( MemoryTag_Scratch, MEMORY_ARENA_CHUNK_SIZE / 4 ); }
+	return arena;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 usize align_pow2( usize n )
 {
 	if( n == 0 ) { return 1; }
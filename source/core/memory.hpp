@@ -35,6 +35,162 @@ extern void memory_free( void *block );
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Allocators
+//
+// Containers take an optional 'Allocator *' at init() (nullptr = the general heap). Every allocation through the
+// memory_alloc( allocator, ... ) family passes its size, so live/peak bytes can be tracked per MemoryTag without
+// allocation headers. Heap allocators are tagged views of malloc; arenas & pools carve allocations out of larger
+// chunks (which are themselves accounted to the arena/pool tag)
+
+#ifndef MEMORY_ARENA_CHUNK_SIZE
+	#define MEMORY_ARENA_CHUNK_SIZE ( 1024 * 1024 )
+#endif
+
+#ifndef MEMORY_ALIGNMENT
+	#define MEMORY_ALIGNMENT ( 16 )
+#endif
+
+
+enum_type( MemoryTag, u8 )
+{
+	MemoryTag_General,
+	MemoryTag_Assets,
+	MemoryTag_Gfx,
+	MemoryTag_Audio,
+	MemoryTag_Fonts,
+	MemoryTag_Text,
+	MemoryTag_Console,
+	MemoryTag_Objects,
+	MemoryTag_Network,
+	MemoryTag_Build,
+	MemoryTag_Frame,
+	MemoryTag_Scratch,
+	MEMORYTAG_COUNT,
+};
+
+
+enum_type( AllocatorType, u8 )
+{
+	AllocatorType_Heap,
+	AllocatorType_Arena,
+	AllocatorType_Pool,
+};
+
+
+struct Allocator
+{
+	AllocatorType type = AllocatorType_Heap;
+	MemoryTag tag = MemoryTag_General;
+};
+
+
+class ArenaAllocator : public Allocator
+{
+public:
+	struct Chunk
+	{
+		Chunk *previous;
+		usize capacity;
+		usize used;
+	};
+
+	struct Marker
+	{
+		Chunk *chunk;
+		usize used;
+	};
+
+public:
+	void init( MemoryTag tag, usize chunkSize = MEMORY_ARENA_CHUNK_SIZE );
+	void free();
+
+	void *alloc( usize size );
+	void *realloc( void *block, usize sizeOld, usize size );
+	void release( void *block, usize size );
+
+	void reset();
+	Marker mark() const { return Marker { chunk, chunk == nullptr ? 0LLU : chunk->used }; }
+	void rewind( Marker marker );
+
+	bool is_initialized() const { return chunkSize != 0LLU; }
+	usize size_used() const { return used; }
+	usize size_peak() const { return peak; }
+	usize size_allocated_bytes() const { return allocated; }
+
+private:
+	Chunk *chunk_push( usize size );
+
+	Chunk *chunk = nullptr; // Newest chunk
+	void *last = nullptr; // Most recent allocation (grown/released in place)
+	usize chunkSize = 0LLU;
+	usize used = 0LLU;
+	usize peak = 0LLU;
+	usize allocated = 0LLU;
+};
+
+
+class PoolAllocator : public Allocator
+{
+public:
+	void init( MemoryTag tag, usize blockSize, u32 blocksPerChunk = 256 );
+	void free();
+
+	void *alloc( usize size );
+	void release( void *block );
+
+	usize size_block() const { return blockSize; }
+	usize size_allocated_bytes() const { return allocated; }
+
+private:
+	struct Block { Block *next; };
+	struct Chunk { Chunk *next; };
+
+	void chunk_push();
+
+	Chunk *chunks = nullptr;
+	Block *freeList = nullptr;
+	usize blockSize = 0LLU;
+	u32 blocksPerChunk = 0;
+	usize allocated = 0LLU;
+};
+
+
+struct MemoryTagStats
+{
+	i64 bytesLive;
+	i64 bytesPeak;
+	i64 allocations;
+};
+
+
+extern Allocator *memory_heap( MemoryTag tag );
+
+extern void *memory_alloc( Allocator *allocator, usize size );
+extern void *memory_realloc( Allocator *allocator, void *block, usize sizeOld, usize size );
+extern void memory_free( Allocator *allocator, void *block, usize size );
+
+extern ArenaAllocator &memory_frame(); // Main thread: valid until memory_frame_reset()
+extern void memory_frame_reset();
+extern ArenaAllocator &memory_scratch(); // Thread-local: use with MemoryScratchScope
+
+extern const char *memory_tag_name( MemoryTag tag );
+extern MemoryTagStats memory_tag_stats( MemoryTag tag );
+extern void memory_tag_track( MemoryTag tag, i64 bytes );
+
+
+class MemoryScratchScope
+{
+public:
+	MemoryScratchScope() : arena { memory_scratch() }, marker { arena.mark() } { }
+	~MemoryScratchScope() { arena.rewind( marker ); }
+	operator Allocator *() { return &arena; }
+
+	ArenaAllocator &arena;
+	ArenaAllocator::Marker marker;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 extern usize align_pow2( usize n );
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
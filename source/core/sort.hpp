@@ -0,0 +1,78 @@
+#pragma once
+
+#include <vendor/vendor.hpp>
+
+#include <core/types.hpp>
+#include <core/debug.hpp>
+#include <core/memory.hpp>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// LSD radix sort (8-bit digits) of unsigned integer 'keys', carrying 'values' along
+//
+// Stable, O( n * sizeof( Key ) ), and requires caller-provided scratch arrays of the same length. Digits that are
+// equal across every key (i.e. unused high bits) are skipped, so a sort over narrow keys only pays for the digits
+// that actually vary. The sorted result is always written back to 'keys' & 'values' ('Value' must be trivially
+// copyable)
+
+template <typename Key, typename Value>
+void radix_sort( Key *keys, Value *values, usize count, Key *keysScratch, Value *valuesScratch )
+{
+	static_assert( static_cast<Key>( -1 ) > static_cast<Key>( 0 ), "Key must be an unsigned integer type" );
+	constexpr usize DIGITS = sizeof( Key );
+	if( count <= 1 ) { return; }
+	Assert( keys != nullptr && values != nullptr );
+	Assert( keysScratch != nullptr && valuesScratch != nullptr );
+
+	// Histogram every digit in a single pass
+	usize histogram[DIGITS][256];
+	memory_set( histogram, 0, sizeof( histogram ) );
+	for( usize i = 0; i < count; i++ )
+	{
+		const Key key = keys[i];
+		for( usize digit = 0; digit < DIGITS; digit++ ) { histogram[digit][( key >> ( digit * 8 ) ) & 0xFF]++; }
+	}
+
+	Key *srcKeys = keys;
+	Value *srcValues = values;
+	Key *dstKeys = keysScratch;
+	Value *dstValues = valuesScratch;
+
+	for( usize digit = 0; digit < DIGITS; digit++ )
+	{
+		usize *const counts = histogram[digit];
+		const usize shift = digit * 8;
+
+		// Skip digits shared by every key
+		if( counts[( srcKeys[0] >> shift ) & 0xFF] == count ) { continue; }
+
+		// Exclusive prefix sum -> bucket offsets
+		usize offset = 0;
+		for( usize bucket = 0; bucket < 256; bucket++ )
+		{
+			const usize size = counts[bucket];
+			counts[bucket] = offset;
+			offset += size;
+		}
+
+		// Scatter
+		for( usize i = 0; i < count; i++ )
+		{
+			const usize index = counts[( srcKeys[i] >> shift ) & 0xFF]++;
+			dstKeys[index] = srcKeys[i];
+			dstValues[index] = srcValues[i];
+		}
+
+		Key *const tempKeys = srcKeys; srcKeys = dstKeys; dstKeys = tempKeys;
+		Value *const tempValues = srcValues; srcValues = dstValues; dstValues = tempValues;
+	}
+
+	// Odd number of passes: result is in the scratch arrays
+	if( srcKeys != keys )
+	{
+		memory_copy( keys, srcKeys, count * sizeof( Key ) );
+		memory_copy( values, srcValues, count * sizeof( Value ) );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -275,21 +275,23 @@ u32 StringView::hash()
 void String::grow()
 {
 	MemoryAssert( data != nullptr );
+	const usize capacityPrevious = capacity;
 	if( capacity == 0 ) { capacity = 1; } else { capacity = capacity > USIZE_MAX / 2 ? USIZE_MAX : capacity * 2; }
 
-	data = reinterpret_cast<char *>( memory_realloc( data, capacity + 1 ) );
+	data = reinterpret_cast<char *>( memory_realloc( allocator, data, capacityPrevious + 1, capacity + 1 ) );
 	ErrorIf( data == nullptr, "Failed to allocate memory for grow String (%p: alloc %d bytes)", data, capacity + 1 );
 	data[capacity] = '\0';
 }
 
 
-void String::init( const char *string, usize length )
+void String::init( const char *string, usize length, Allocator *allocator )
 {
 	capacity = length == USIZE_MAX ? strlen( string ) : length;
 	current = capacity;
+	this->allocator = allocator;
 
 	MemoryAssert( data == nullptr );
-	data = reinterpret_cast<char *>( memory_alloc( capacity + 1 ) );
+	data = reinterpret_cast<char *>( memory_alloc( allocator, capacity + 1 ) );
 	memory_copy( data, string, current );
 	data[current] = '\0';
 }
@@ -306,7 +308,7 @@ void String::free()
 	#endif
 	}
 
-	memory_free( data );
+	memory_free( allocator, data, capacity + 1 );
 	data = nullptr;
 
 	capacity = 0LLU;
@@ -339,11 +341,11 @@ bool String::load( const char *path )
 	const usize size = fsize( file );
 	if( size == 0 ) { returnCode = false; goto cleanup; }
 
-	capacity = size + 1;
+	data = reinterpret_cast<char *>( memory_realloc( allocator, data, capacity + 1, size + 1 ) );
+	capacity = size;
 	current = size;
-	data = reinterpret_cast<char *>( memory_realloc( data, capacity ) );
 	ErrorIf( data == nullptr,
-		"Failed to allocate memory for load String (%p: alloc %d bytes)", data, capacity );
+		"Failed to allocate memory for load String (%p: alloc %d bytes)", data, capacity + 1 );
 
 	if( fread( data, size, 1, file ) < 1 ) { returnCode = false; goto cleanup; }
 	data[size] = '\0';
@@ -364,7 +366,7 @@ String &String::copy( const String &other )
 	current = other.current;
 
 	MemoryAssert( data == nullptr );
-	data = reinterpret_cast<char *>( memory_alloc( capacity + 1 ) );
+	data = reinterpret_cast<char *>( memory_alloc( allocator, capacity + 1 ) );
 	memory_copy( data, other.data, current );
 	data[current] = '\0';
 
@@ -385,7 +387,7 @@ String &String::copy_part( const String &other, usize start, usize end )
 	current = capacity;
 
 	MemoryAssert( data == nullptr );
-	data = reinterpret_cast<char *>( memory_alloc( capacity + 1 ) );
+	data = reinterpret_cast<char *>( memory_alloc( allocator, capacity + 1 ) );
 	memory_copy( data, other.data + start, current );
 	data[current] = '\0';
 
@@ -402,6 +404,7 @@ String &String::move( String &&other )
 	data = other.data;
 	capacity = other.capacity;
 	current = other.current;
+	allocator = other.allocator;
 
 	other.data = nullptr;
 	other.capacity = 0LLU;
@@ -790,8 +793,8 @@ bool String::read( Buffer &buffer, String &string )
 	string.current = string.capacity;
 
 	MemoryAssert( string.data == nullptr );
-	string.data = reinterpret_cast<char *>( memory_alloc( string.capacity + 1 ) );
-	memory_copy( string.data, buffer.read_bytes( string.capacity ), string.capacity );
+	string.data = reinterpret_cast<char *>( memory_alloc( string.allocator, string.capacity + 1 ) );
+	memory_copy( string.data, buffer.read_bytes( string.capacity + 1 ), string.capacity ); // + null terminator
 	string.data[string.current] = '\0';
 	return true;
 }
@@ -3,6 +3,7 @@
 #include <core/types.hpp>
 #include <core/debug.hpp>
 #include <core/traits.hpp>
+#include <core/memory.hpp>
 
 #include <vendor/string.hpp>
 
@@ -83,6 +84,7 @@ public:
 	String() { init( "" ); }
 	String( const char *string ) { init( string ); }
 	String( const StringView &other ) { init( other.data, other.length ); }
+	explicit String( Allocator *allocator ) { init( "", USIZE_MAX, allocator ); }
 	String( const String &other ) { copy( other ); }
 	String( const String &other, usize start, usize end ) { copy_part( other, start, end ); }
 	String( String &&other ) { move( static_cast<String &&>( other ) ); }
@@ -108,7 +110,7 @@ private:
 	void grow();
 
 public:
-	void init( const char *string = "", usize length = USIZE_MAX );
+	void init( const char *string = "", usize length = USIZE_MAX, Allocator *allocator = nullptr );
 	void free();
 	bool save( const char *path );
 	bool load( const char *path );
@@ -214,6 +216,7 @@ public:
 	char *data = nullptr;
 	usize capacity = 0LLU;
 	usize current = 0LLU;
+	Allocator *allocator = nullptr; // nullptr: general heap
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -89,10 +89,30 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#if defined( HEADLESS )
+	#define COMPILE_HEADLESS ( 1 )
+#else
+	#define COMPILE_HEADLESS ( 0 )
+#endif
+
+#ifndef HEADLESS_TICK_RATE
+	#define HEADLESS_TICK_RATE ( 30 )
+#endif
+
+#ifndef HEADLESS_TICK_STATS
+	#define HEADLESS_TICK_STATS ( 1 ) // Seconds between tick timing reports (0 to disable)
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 #ifndef GFX_QUAD_BATCH_SIZE
 	#define GFX_QUAD_BATCH_SIZE ( 4096 )
 #endif
 
+#ifndef GFX_QUAD_BATCH_MULTI_TEXTURE
+	#define GFX_QUAD_BATCH_MULTI_TEXTURE ( 1 ) // Batch up to 8 textures per draw (see: Gfx::quad_batch_multi_texture)
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #ifndef AUDIO_BUS_COUNT
@@ -109,9 +129,9 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-#define AUDIO_ALSA ( OS_LINUX | OS_ANDROID )
-#define AUDIO_COREAUDIO ( OS_MACOS | OS_IOS | OS_IPADOS )
-#define AUDIO_WASAPI ( OS_WINDOWS )
+#define AUDIO_ALSA ( ( OS_LINUX | OS_ANDROID ) && !COMPILE_HEADLESS )
+#define AUDIO_COREAUDIO ( ( OS_MACOS | OS_IOS | OS_IPADOS ) && !COMPILE_HEADLESS )
+#define AUDIO_WASAPI ( ( OS_WINDOWS ) && !COMPILE_HEADLESS )
 #define AUDIO_NONE ( !( AUDIO_ALSA || AUDIO_COREAUDIO || AUDIO_WASAPI ))
 
 #if AUDIO_ALSA
@@ -188,9 +208,9 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-#define WINDOW_COCOA ( OS_MACOS | OS_IOS | OS_IPADOS )
-#define WINDOW_WINDOWS ( OS_WINDOWS )
-#define WINDOW_X11 ( OS_LINUX )
+#define WINDOW_COCOA ( ( OS_MACOS | OS_IOS | OS_IPADOS ) && !COMPILE_HEADLESS )
+#define WINDOW_WINDOWS ( ( OS_WINDOWS ) && !COMPILE_HEADLESS )
+#define WINDOW_X11 ( ( OS_LINUX ) && !COMPILE_HEADLESS )
 #define WINDOW_NONE ( !( WINDOW_COCOA || WINDOW_WINDOWS || WINDOW_X11 ) )
 
 #if WINDOW_COCOA
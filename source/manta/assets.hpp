@@ -5,6 +5,7 @@
 #include <config.hpp>
 
 #include <core/assets.hpp>
+#include <core/math.hpp>
 #include <core/memory.hpp>
 
 #include <manta/filesystem.hpp>
@@ -124,7 +125,7 @@ namespace Assets
 		Assets::MeshFormatTypeVertex formatVertex;
 		usize offsetVertex;
 		usize sizeVertex;
-		Assets::MeshFormatTypeVertex formatIndex;
+		Assets::MeshFormatTypeIndex formatIndex;
 		usize offsetIndex;
 		usize sizeIndex;
 		float x1, y1, z1;
@@ -134,6 +135,17 @@ namespace Assets
 
 	inline u32 mesh_count() { return CoreAssets::meshCount; }
 	extern const Assets::MeshEntry &mesh( u32 mesh );
+
+	// Packed vertex formats (MeshFormatTypeVertex_*Packed) store positions relative to the mesh bounds. Call this
+	// before drawing such a mesh to fill the shader's bounds uniforms for vertex_unpack_position(). 'uniforms' is any
+	// uniform buffer with 'float3 boundsMin; float3 boundsMax;' (see: shaderlib/vertex_formats.h)
+	template <typename T> void mesh_bounds_upload( T &uniforms, u32 mesh )
+	{
+		const Assets::MeshEntry &entry = Assets::mesh( mesh );
+		uniforms.boundsMin = float_v3 { entry.x1, entry.y1, entry.z1 };
+		uniforms.boundsMax = float_v3 { entry.x2, entry.y2, entry.z2 };
+		uniforms.upload();
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
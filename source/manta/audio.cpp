@@ -6,6 +6,7 @@
 #include <core/math.hpp>
 
 #include <manta/thread.hpp>
+#include <manta/profiler.hpp>
 #include <manta/assets.hpp>
 #include <manta/random.hpp>
 #include <manta/time.hpp>
@@ -596,6 +597,8 @@ static u16 find_stream()
 static THREAD_FUNCTION( audio_stream )
 {
 #if AUDIO_ENABLED
+	PROFILE_THREAD( "Audio Stream" );
+
 	for( ;; )
 	{
 		// For each stream
@@ -614,6 +617,7 @@ static THREAD_FUNCTION( audio_stream )
 			{
 				// This buffer is already filled and queued for mixing
 				if( stream.ready & ( 1 << j ) ) { continue; }
+				PROFILE_SCOPE( "Audio Stream Block" );
 
 				// Read the samples into the buffer
 				const usize frames = min( static_cast<usize>( AUDIO_STREAM_BLOCK ),
@@ -731,6 +735,8 @@ bool CoreAudio::free()
 void CoreAudio::audio_mixer( i16 *output, u32 frames )
 {
 #if AUDIO_ENABLED
+	PROFILE_SCOPE( "Audio Mixer" );
+
 	constexpr int CHANNELS = 2;
 	const usize framesBufferI16Size = frames * CHANNELS * sizeof( i16 );
 	const usize framesBufferFloatSize = frames * CHANNELS * sizeof( float );
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <config.hpp>
+
 #include <core/types.hpp>
 #include <core/debug.hpp>
 
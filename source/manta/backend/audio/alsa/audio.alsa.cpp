@@ -6,6 +6,7 @@
 #include <core/memory.hpp>
 
 #include <manta/thread.hpp>
+#include <manta/profiler.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -150,6 +151,8 @@ static THREAD_FUNCTION ( audio_mixer_thread )
 		goto error;
 	}
 
+    PROFILE_THREAD( "Audio Mixer" );
+
     // Mixer Loop
     for( ;; )
     {
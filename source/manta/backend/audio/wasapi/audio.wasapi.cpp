@@ -6,6 +6,7 @@
 
 #include <manta/assets.hpp>
 #include <manta/thread.hpp>
+#include <manta/profiler.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -46,6 +47,8 @@ static UINT32 bufferSize;
 
 static THREAD_FUNCTION( audio_mixer_thread )
 {
+	PROFILE_THREAD( "Audio Mixer" );
+
 	// Mixer Loop
 	const char *errorMessage = "";
 	for( ;; )
@@ -83,6 +83,11 @@ static const DXGI_FORMAT D3D11ColorFormats[] =
 	DXGI_FORMAT_R32G32_FLOAT,       // GfxColorFormat_R32G32_FLOAT
 	DXGI_FORMAT_R32G32B32A32_FLOAT, // GfxColorFormat_R32G32B32A32_FLOAT
 	DXGI_FORMAT_R32G32B32A32_UINT,  // GfxColorFormat_R32G32B32A32_UINT
+	DXGI_FORMAT_BC1_UNORM,          // GfxColorFormat_BC1
+	DXGI_FORMAT_BC3_UNORM,          // GfxColorFormat_BC3
+	DXGI_FORMAT_BC4_UNORM,          // GfxColorFormat_BC4
+	DXGI_FORMAT_BC5_UNORM,          // GfxColorFormat_BC5
+	DXGI_FORMAT_BC7_UNORM,          // GfxColorFormat_BC7
 };
 static_assert( ARRAY_LENGTH( D3D11ColorFormats ) == GFXCOLORFORMAT_COUNT,
 	"Missing GfxColorFormat!" );
@@ -2175,7 +2180,6 @@ bool CoreGfx::api_texture_init( GfxTextureResource *&resource, void *pixels,
 {
 	Assert( resource == nullptr );
 
-	const usize pixelSizeBytes = CoreGfx::colorFormatPixelSizeBytes[format];
 	const byte *source = reinterpret_cast<const byte *>( pixels );
 
 	ErrorReturnIf( Gfx::mip_level_count_2d( width, height ) < levels, false,
@@ -2214,10 +2218,10 @@ bool CoreGfx::api_texture_init( GfxTextureResource *&resource, void *pixels,
 	{
 		D3D11_SUBRESOURCE_DATA &data = subresources[level];
 		data.pSysMem = source;
-		data.SysMemPitch = mipWidth * pixelSizeBytes;
+		data.SysMemPitch = static_cast<UINT>( CoreGfx::color_format_pitch_bytes( format, mipWidth ) );
 		data.SysMemSlicePitch = 0;
 
-		const usize mipLevelSizeBytes = mipWidth * mipHeight * pixelSizeBytes;
+		const usize mipLevelSizeBytes = CoreGfx::color_format_size_bytes( format, mipWidth, mipHeight );
 		source += mipLevelSizeBytes;
 		resource->size += mipLevelSizeBytes;
 
@@ -2246,6 +2250,15 @@ bool CoreGfx::api_texture_init( GfxTextureResource *&resource, void *pixels,
 }
 
 
+bool CoreGfx::api_texture_format_supported( const GfxColorFormat &format )
+{
+	// BC7 requires feature level 11_0
+	UINT support = 0;
+	if( FAILED( device->CheckFormatSupport( D3D11ColorFormats[format], &support ) ) ) { return false; }
+	return ( support & D3D11_FORMAT_SUPPORT_TEXTURE2D ) && ( support & D3D11_FORMAT_SUPPORT_SHADER_SAMPLE );
+}
+
+
 bool CoreGfx::api_texture_free( GfxTextureResource *&resource )
 {
 	Assert( resource != nullptr && resource->id != GFX_RESOURCE_ID_NULL );
@@ -94,6 +94,11 @@ static const MTLPixelFormat MetalColorFormats[] =
 	MTLPixelFormatRG32Float,    // GfxColorFormat_R32G32_FLOAT
 	MTLPixelFormatRGBA32Float,  // GfxColorFormat_R32G32B32A32_FLOAT
 	MTLPixelFormatRGBA32Uint,   // GfxColorFormat_R32G32B32A32_UINT
+	MTLPixelFormatBC1_RGBA,     // GfxColorFormat_BC1
+	MTLPixelFormatBC3_RGBA,     // GfxColorFormat_BC3
+	MTLPixelFormatBC4_RUnorm,   // GfxColorFormat_BC4
+	MTLPixelFormatBC5_RGUnorm,  // GfxColorFormat_BC5
+	MTLPixelFormatBC7_RGBAUnorm, // GfxColorFormat_BC7
 };
 static_assert( ARRAY_LENGTH( MetalColorFormats ) == GFXCOLORFORMAT_COUNT,
 	"Missing GfxColorFormat!" );
@@ -2182,7 +2187,6 @@ bool CoreGfx::api_texture_init( GfxTextureResource *&resource, void *pixels,
 {
 	Assert( resource == nullptr );
 
-	const usize pixelSizeBytes = CoreGfx::colorFormatPixelSizeBytes[format];
 	const byte *source = reinterpret_cast<const byte *>( pixels );
 
 	ErrorReturnIf( Gfx::mip_level_count_2d( width, height ) < levels, false,
@@ -2226,9 +2230,9 @@ bool CoreGfx::api_texture_init( GfxTextureResource *&resource, void *pixels,
 			replaceRegion: region
 			mipmapLevel: level
 			withBytes: src
-			bytesPerRow: mipWidth * pixelSizeBytes];
+			bytesPerRow: CoreGfx::color_format_pitch_bytes( format, mipWidth )];
 
-		const usize mipLevelSizeBytes = mipWidth * mipHeight * pixelSizeBytes;
+		const usize mipLevelSizeBytes = CoreGfx::color_format_size_bytes( format, mipWidth, mipHeight );
 		src += mipLevelSizeBytes;
 		resource->size += mipLevelSizeBytes;
 		mipWidth = ( mipWidth > 1 ) ? ( mipWidth >> 1 ) : 1;
@@ -2244,6 +2248,13 @@ bool CoreGfx::api_texture_init( GfxTextureResource *&resource, void *pixels,
 }
 
 
+bool CoreGfx::api_texture_format_supported( const GfxColorFormat &format )
+{
+	// BCn is supported by every Mac GPU (Apple silicon & Intel/AMD)
+	return true;
+}
+
+
 bool CoreGfx::api_texture_free( GfxTextureResource *&resource )
 {
 	Assert( resource != nullptr && resource->id != GFX_RESOURCE_ID_NULL );
@@ -1,6 +1,12 @@
 #include <manta/gfx.hpp>
 #include <config.hpp>
 
+#include <manta/backend/gfx/gfxfactory.hpp>
+
+// Null device: no GPU work is done. With the frontend opted in (GRAPHICS_NONE_FRONTEND), vertex/instance buffers
+// count the bytes written so quad batching, render commands, and draw statistics behave as on a real backend.
+// Otherwise (e.g. headless servers) every call is a no-op
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Resources
 
@@ -13,12 +19,16 @@ struct GfxShaderResource : public GfxResource
 struct GfxVertexBufferResource : public GfxResource
 {
 	static void release( GfxVertexBufferResource *&resource );
+	u32 capacity = 0;
+	u32 current = 0;
 };
 
 
 struct GfxInstanceBufferResource : public GfxResource
 {
 	static void release( GfxInstanceBufferResource *&resource );
+	u32 capacity = 0;
+	u32 current = 0;
 };
 
 
@@ -45,17 +55,33 @@ struct GfxRenderTargetResource : public GfxResource
 	static void release( GfxRenderTargetResource *&resource );
 };
 
+#if GRAPHICS_ENABLED
+static GfxResourceFactory<GfxVertexBufferResource, GFX_RESOURCE_COUNT_VERTEX_BUFFER> vertexBufferResources;
+static GfxResourceFactory<GfxInstanceBufferResource, GFX_RESOURCE_COUNT_INSTANCE_BUFFER> instanceBufferResources;
+static GfxResourceFactory<GfxTextureResource, GFX_RESOURCE_COUNT_TEXTURE> textureResources;
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // GFX System
 
 bool CoreGfx::init_api()
 {
+#if GRAPHICS_ENABLED
+	vertexBufferResources.init();
+	instanceBufferResources.init();
+	textureResources.init();
+#endif
 	return true;
 }
 
 
 bool CoreGfx::free_api()
 {
+#if GRAPHICS_ENABLED
+	vertexBufferResources.free();
+	instanceBufferResources.free();
+	textureResources.free();
+#endif
 	return true;
 }
 
@@ -196,7 +222,7 @@ bool CoreGfx::api_buffer_free( GfxBufferResource *&resource )
 
 void CoreGfx::api_buffer_write_begin( GfxBufferResource *resource )
 {
-	// ...
+	PROFILE_GFX( Gfx::stats.frame.bufferMaps++ );
 }
 
 
@@ -216,24 +242,41 @@ void CoreGfx::api_buffer_write( GfxBufferResource *resource, const void *data, u
 
 void GfxVertexBufferResource::release( GfxVertexBufferResource *&resource )
 {
+#if GRAPHICS_ENABLED
+	if( resource == nullptr || resource->id == GFX_RESOURCE_ID_NULL ) { return; }
+	vertexBufferResources.remove( resource->id );
+	resource = nullptr;
+#endif
 }
 
 
 bool CoreGfx::api_vertex_buffer_init( GfxVertexBufferResource *&resource, u32 vertexFormatID,
 	const GfxWriteMode writeMode, u32 capacity, u32 stride )
 {
+#if GRAPHICS_ENABLED
+	Assert( resource == nullptr );
+	resource = vertexBufferResources.make_new();
+	resource->capacity = capacity;
+	resource->current = 0;
+#endif
 	return true;
 }
 
 
 bool CoreGfx::api_vertex_buffer_free( GfxVertexBufferResource *&resource )
 {
+	GfxVertexBufferResource::release( resource );
 	return true;
 }
 
 
 void CoreGfx::api_vertex_buffer_write_begin( GfxVertexBufferResource *resource )
 {
+#if GRAPHICS_ENABLED
+	Assert( resource != nullptr && resource->id != GFX_RESOURCE_ID_NULL );
+	PROFILE_GFX( Gfx::stats.frame.bufferMaps++ );
+	resource->current = 0;
+#endif
 }
 
 
@@ -245,12 +288,22 @@ void CoreGfx::api_vertex_buffer_write_end( GfxVertexBufferResource *resource )
 void CoreGfx::api_vertex_buffer_write( GfxVertexBufferResource *resource,
 	const void *data, u32 size )
 {
+#if GRAPHICS_ENABLED
+	Assert( resource != nullptr && resource->id != GFX_RESOURCE_ID_NULL );
+	Assert( resource->current + size <= resource->capacity );
+	resource->current += size;
+#endif
 }
 
 
 u32 CoreGfx::api_vertex_buffer_current( const GfxVertexBufferResource *resource )
 {
+#if GRAPHICS_ENABLED
+	Assert( resource != nullptr && resource->id != GFX_RESOURCE_ID_NULL );
+	return resource->current;
+#else
 	return 0;
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -258,24 +311,41 @@ u32 CoreGfx::api_vertex_buffer_current( const GfxVertexBufferResource *resource
 
 void GfxInstanceBufferResource::release( GfxInstanceBufferResource *&resource )
 {
+#if GRAPHICS_ENABLED
+	if( resource == nullptr || resource->id == GFX_RESOURCE_ID_NULL ) { return; }
+	instanceBufferResources.remove( resource->id );
+	resource = nullptr;
+#endif
 }
 
 
 bool CoreGfx::api_instance_buffer_init( GfxInstanceBufferResource *&resource, u32 instanceFormatID,
 	GfxWriteMode writeMode, u32 capacity, u32 stride )
 {
+#if GRAPHICS_ENABLED
+	Assert( resource == nullptr );
+	resource = instanceBufferResources.make_new();
+	resource->capacity = capacity;
+	resource->current = 0;
+#endif
 	return true;
 }
 
 
 bool CoreGfx::api_instance_buffer_free( GfxInstanceBufferResource *&resource )
 {
+	GfxInstanceBufferResource::release( resource );
 	return true;
 }
 
 
 void CoreGfx::api_instance_buffer_write_begin( GfxInstanceBufferResource *resource )
 {
+#if GRAPHICS_ENABLED
+	Assert( resource != nullptr && resource->id != GFX_RESOURCE_ID_NULL );
+	PROFILE_GFX( Gfx::stats.frame.bufferMaps++ );
+	resource->current = 0;
+#endif
 }
 
 
@@ -287,12 +357,22 @@ void CoreGfx::api_instance_buffer_write_end( GfxInstanceBufferResource *resource
 void CoreGfx::api_instance_buffer_write( GfxInstanceBufferResource *resource,
 	const void *data, u32 size )
 {
+#if GRAPHICS_ENABLED
+	Assert( resource != nullptr && resource->id != GFX_RESOURCE_ID_NULL );
+	Assert( resource->current + size <= resource->capacity );
+	resource->current += size;
+#endif
 }
 
 
 u32 CoreGfx::api_instance_buffer_current( const GfxInstanceBufferResource *resource )
 {
+#if GRAPHICS_ENABLED
+	Assert( resource != nullptr && resource->id != GFX_RESOURCE_ID_NULL );
+	return resource->current;
+#else
 	return 0;
+#endif
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -339,6 +419,7 @@ bool CoreGfx::api_uniform_buffer_free( GfxUniformBufferResource *&resource )
 
 void CoreGfx::api_uniform_buffer_write_begin( GfxUniformBufferResource *resource )
 {
+	PROFILE_GFX( Gfx::stats.frame.bufferMaps++ );
 }
 
 
@@ -379,24 +460,44 @@ bool CoreGfx::api_uniform_buffer_bind_compute( GfxUniformBufferResource *resourc
 
 void GfxTextureResource::release( GfxTextureResource *&resource )
 {
+#if GRAPHICS_ENABLED
+	if( resource == nullptr || resource->id == GFX_RESOURCE_ID_NULL ) { return; }
+	textureResources.remove( resource->id );
+	resource = nullptr;
+#endif
 }
 
 
 bool CoreGfx::api_texture_init( GfxTextureResource *&resource, void *pixels,
 	u16 width, u16 height, u16 levels, const GfxColorFormat &format )
 {
+#if GRAPHICS_ENABLED
+	// Textures still get a unique resource so texture switches (and their batch breaks) are counted
+	Assert( resource == nullptr );
+	resource = textureResources.make_new();
+#endif
 	return true;
 }
 
 
+bool CoreGfx::api_texture_format_supported( const GfxColorFormat &format )
+{
+	// Block-compressed textures take the CPU decode path in GfxTexture::init_2d(), so headless runs exercise the
+	// same fallback as devices without BCn support
+	return CoreGfx::colorFormatBlockSizeBytes[format] == 0;
+}
+
+
 bool CoreGfx::api_texture_free( GfxTextureResource *&resource )
 {
+	GfxTextureResource::release( resource );
 	return true;
 }
 
 
 bool CoreGfx::api_texture_bind( GfxTextureResource *resource, int slot )
 {
+	PROFILE_GFX( Gfx::stats.frame.textureBinds++ );
 	return true;
 }
 
@@ -430,6 +531,22 @@ bool CoreGfx::api_render_target_free( GfxRenderTargetResource *&resource,
 }
 
 
+bool CoreGfx::api_render_target_copy_color(
+	GfxRenderTargetResource *&srcResource, GfxTextureResource *&srcResourceColor,
+	GfxRenderTargetResource *&dstResource, GfxTextureResource *&dstResourceColor )
+{
+	return true;
+}
+
+
+bool CoreGfx::api_render_target_copy_depth(
+	GfxRenderTargetResource *&srcResource, GfxTextureResource *&srcResourceDepth,
+	GfxRenderTargetResource *&dstResource, GfxTextureResource *&dstResourceDepth )
+{
+	return true;
+}
+
+
 bool CoreGfx::api_render_target_copy(
 	GfxRenderTargetResource *&srcResource,
 	GfxTextureResource *&srcResourceColor, GfxTextureResource *&srcResourceDepth,
@@ -475,7 +592,7 @@ bool CoreGfx::api_render_target_buffer_read_color_async_poll( GfxRenderTargetRes
 }
 
 
-bool api_render_target_buffer_read_depth( GfxRenderTargetResource *&resource,
+bool CoreGfx::api_render_target_buffer_read_depth( GfxRenderTargetResource *&resource,
 	GfxTextureResource *&resourceDepth,
 	void *buffer, u32 size )
 {
@@ -523,6 +640,8 @@ bool CoreGfx::api_draw(
 	const GfxIndexBufferResource *resourceIndex,
 	GfxPrimitiveType type )
 {
+	PROFILE_GFX( Gfx::stats.frame.drawCalls++ );
+	PROFILE_GFX( Gfx::stats.frame.vertexCount += vertexCount * ( instanceCount > 0 ? instanceCount : 1 ) );
 	return true;
 }
 
@@ -538,6 +657,16 @@ bool CoreGfx::api_dispatch( const u32 x, const u32 y, const u32 z )
 
 void CoreGfx::api_render_command_execute( const GfxRenderCommand &command )
 {
+	if( CoreGfx::state.pipeline.shader != command.pipeline.shader )
+	{
+		CoreGfx::state.pipeline.shader = command.pipeline.shader;
+		PROFILE_GFX( Gfx::stats.frame.shaderBinds++ );
+	}
+	CoreGfx::state.pipeline.description = command.pipeline.description;
+
+	if( !command.workFunctionInvoker ) { return; }
+	command.workFunctionInvoker( command.workFunction,
+		GfxRenderCommand::renderCommandArgsStack.get( command.workPayloadOffset, command.workPayloadSize ) );
 }
 
 
@@ -8,6 +8,7 @@
 #include <core/hashmap.hpp>
 #include <core/checksum.hpp>
 #include <core/math.hpp>
+#include <core/bcn.hpp>
 
 #include <manta/window.hpp>
 
@@ -121,6 +122,11 @@ static const OpenGLColorFormat OpenGLColorFormats[] =
 	{ GL_RG, GL_RG32F, GL_FLOAT },                        // GfxColorFormat_R32G32_FLOAT
 	{ GL_RGBA, GL_RGBA32F, GL_FLOAT },                    // GfxColorFormat_R32G32B32A32_FLOAT
 	{ GL_RGBA_INTEGER, GL_RGBA32UI, GL_UNSIGNED_INT },    // GfxColorFormat_R32G32B32A32_UINT
+	{ GL_RGBA, GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 0 },     // GfxColorFormat_BC1
+	{ GL_RGBA, GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 0 },     // GfxColorFormat_BC3
+	{ GL_RED, GL_COMPRESSED_RED_RGTC1, 0 },               // GfxColorFormat_BC4
+	{ GL_RG, GL_COMPRESSED_RG_RGTC2, 0 },                 // GfxColorFormat_BC5
+	{ GL_RGBA, GL_COMPRESSED_RGBA_BPTC_UNORM, 0 },        // GfxColorFormat_BC7
 };
 static_assert( ARRAY_LENGTH( OpenGLColorFormats ) == GFXCOLORFORMAT_COUNT,
 	"Missing GfxColorFormat!" );
@@ -1963,6 +1969,7 @@ bool CoreGfx::api_texture_init( GfxTextureResource *&resource, void *pixels,
 	const GLint glFormatInternal = OpenGLColorFormats[format].formatInternal;
 	const GLenum glFormat = OpenGLColorFormats[format].format;
 	const GLenum glFormatType = OpenGLColorFormats[format].formatType;
+	const bool blockCompressed = CoreGfx::colorFormatBlockSizeBytes[format] > 0;
 
 	if( Gfx::mip_level_count_2d( width, height ) < levels )
 	{
@@ -1997,21 +2004,38 @@ bool CoreGfx::api_texture_init( GfxTextureResource *&resource, void *pixels,
 		for( u16 level = 0, mipWidth = width, mipHeight = height; level < levels; level++ )
 		{
 			const byte *sourceLevel = source;
+			const usize mipLevelSize = CoreGfx::color_format_size_bytes( format, mipWidth, mipHeight );
 
 #if true
 			// Flip texture vertically
-			const usize stride = mipWidth * pixelSizeBytes;
-			u8* flipped = CoreGfx::scratch_buffer( stride * mipHeight );
-			for (u16 y = 0; y < mipHeight; y++)
+			u8* flipped = CoreGfx::scratch_buffer( mipLevelSize );
+			if( blockCompressed )
 			{
-				memory_copy( &flipped[y * stride], &source[ ( mipHeight - 1 - y ) * stride], stride );
+				bcn_flip_vertical( static_cast<BCnFormat>( format - GfxColorFormat_BC1 ), source,
+					mipWidth, mipHeight, flipped );
+			}
+			else
+			{
+				const usize stride = mipWidth * pixelSizeBytes;
+				for (u16 y = 0; y < mipHeight; y++)
+				{
+					memory_copy( &flipped[y * stride], &source[ ( mipHeight - 1 - y ) * stride], stride );
+				}
 			}
 			sourceLevel = flipped;
 #endif
 
 			// Upload Level Data
-			glTexImage2D( GL_TEXTURE_2D, level, glFormatInternal, mipWidth, mipHeight, 0,
-				glFormat, glFormatType, sourceLevel );
+			if( blockCompressed )
+			{
+				nglCompressedTexImage2D( GL_TEXTURE_2D, level, glFormatInternal, mipWidth, mipHeight, 0,
+					static_cast<GLsizei>( mipLevelSize ), sourceLevel );
+			}
+			else
+			{
+				glTexImage2D( GL_TEXTURE_2D, level, glFormatInternal, mipWidth, mipHeight, 0,
+					glFormat, glFormatType, sourceLevel );
+			}
 
 			if( OPENGL_ERROR() )
 			{
@@ -2020,7 +2044,6 @@ bool CoreGfx::api_texture_init( GfxTextureResource *&resource, void *pixels,
 					__FUNCTION__, glGetError(), level );
 			}
 
-			const usize mipLevelSize = pixelSizeBytes * mipWidth * mipHeight;
 			source += mipLevelSize;
 
 			resource->size += mipLevelSize;
@@ -2036,6 +2059,19 @@ bool CoreGfx::api_texture_init( GfxTextureResource *&resource, void *pixels,
 }
 
 
+bool CoreGfx::api_texture_format_supported( const GfxColorFormat &format )
+{
+	// S3TC (BC1/BC3) and RGTC (BC4/BC5) are available on every desktop driver; BPTC (BC7) is core in OpenGL 4.2
+	if( format != GfxColorFormat_BC7 ) { return true; }
+
+	GLint versionMajor = 0;
+	GLint versionMinor = 0;
+	glGetIntegerv( GL_MAJOR_VERSION, &versionMajor );
+	glGetIntegerv( GL_MINOR_VERSION, &versionMinor );
+	return versionMajor > 4 || ( versionMajor == 4 && versionMinor >= 2 );
+}
+
+
 bool CoreGfx::api_texture_free( GfxTextureResource *&resource )
 {
 	OPENGL_CHECK_ERRORS_SCOPE
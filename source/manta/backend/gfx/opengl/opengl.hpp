@@ -710,6 +710,11 @@ struct OpenGLInputLayoutFormats
 #define GL_MULTISAMPLE 0x809D
 #define GL_TEXTURE_2D_MULTISAMPLE 0x9100
 #define GL_TEXTURE_2D_MULTISAMPLE_ARRAY 0x9102
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT 0x83F1
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#define GL_COMPRESSED_RED_RGTC1 0x8DBB
+#define GL_COMPRESSED_RG_RGTC2 0x8DBD
+#define GL_COMPRESSED_RGBA_BPTC_UNORM 0x8E8C
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -775,6 +780,7 @@ struct OpenGLInputLayoutFormats
 	#define nglRenderbufferStorageMultisample glRenderbufferStorageMultisample
 	#define nglFramebufferRenderbuffer glFramebufferRenderbuffer
 	#define nglTexImage3D glTexImage3D
+	#define nglCompressedTexImage2D glCompressedTexImage2D
 	#define nglTexImage2DMultisample glTexImage2DMultisample
 	#define nglTexImage3DMultisample glTexImage3DMultisample
 	#define nglDrawElementsInstanced glDrawElementsInstanced
@@ -57,6 +57,7 @@ META( void, glBindRenderbuffer, GLenum, GLuint  )
 META( void, glRenderbufferStorageMultisample, GLenum, GLsizei, GLenum, GLsizei, GLsizei )
 META( void, glFramebufferRenderbuffer, GLenum, GLenum, GLenum, GLuint )
 META( void, glTexImage3D, GLenum target, GLint, GLint, GLsizei, GLsizei, GLsizei, GLint, GLenum, GLenum, const void * )
+META( void, glCompressedTexImage2D, GLenum, GLint, GLenum, GLsizei, GLsizei, GLint, GLsizei, const void * )
 META( void, glTexImage2DMultisample, GLenum, GLsizei, GLint, GLsizei, GLsizei, GLboolean )
 META( void, glTexImage3DMultisample, GLenum, GLsizei, GLint, GLsizei, GLsizei, GLsizei, GLboolean )
 META( void, glDrawArraysInstanced, GLenum, GLint, GLsizei, GLsizei )
@@ -528,6 +528,12 @@ bool CoreGfx::api_texture_init( GfxTextureResource *&resource, void *pixels,
 }
 
 
+bool CoreGfx::api_texture_format_supported( const GfxColorFormat &format )
+{
+	return true;
+}
+
+
 bool CoreGfx::api_texture_free( GfxTextureResource *&resource )
 {
 	return true;
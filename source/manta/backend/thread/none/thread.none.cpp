@@ -71,6 +71,12 @@ void Condition::sleep( Mutex &mutex )
 }
 
 
+bool Condition::sleep( Mutex &mutex, u32 timeoutMS )
+{
+	return true;
+}
+
+
 void Condition::wake()
 {
 }
@@ -106,6 +106,19 @@ void Condition::sleep( Mutex &mutex )
 }
 
 
+bool Condition::sleep( Mutex &mutex, u32 timeoutMS )
+{
+	// NOTE: pthread_cond_timedwait() takes an absolute CLOCK_REALTIME deadline
+	timespec deadline;
+	clock_gettime( CLOCK_REALTIME, &deadline );
+	deadline.tv_sec += timeoutMS / 1000;
+	deadline.tv_nsec += static_cast<long long>( timeoutMS % 1000 ) * 1000000LL;
+	if( deadline.tv_nsec >= 1000000000LL ) { deadline.tv_sec++; deadline.tv_nsec -= 1000000000LL; }
+
+	return pthread_cond_timedwait( &condition, &mutex.mutex, &deadline ) == 0;
+}
+
+
 void Condition::wake()
 {
 	pthread_cond_signal( &condition );
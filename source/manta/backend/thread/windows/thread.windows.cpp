@@ -117,6 +117,12 @@ void Condition::sleep( Mutex &mutex )
 }
 
 
+bool Condition::sleep( Mutex &mutex, u32 timeoutMS )
+{
+	return SleepConditionVariableCS( &condition, &mutex.mutex, timeoutMS ) != 0;
+}
+
+
 void Condition::wake()
 {
 	WakeConditionVariable( &condition );
@@ -7,8 +7,8 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-thread_local static u64 offset;
-thread_local static double frequency;
+static u64 offset;
+static double frequency;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
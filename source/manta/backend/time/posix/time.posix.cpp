@@ -4,7 +4,7 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-thread_local static timespec offset;
+static timespec offset;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
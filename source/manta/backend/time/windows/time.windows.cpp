@@ -6,8 +6,8 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-thread_local static LARGE_INTEGER offset;
-thread_local static double frequency;
+static LARGE_INTEGER offset;
+static double frequency;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
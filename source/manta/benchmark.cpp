@@ -0,0 +1,1667 @@
+#include <manta/benchmark.hpp>
+
+#include <vendor/new.hpp>
+
+#include <core/debug.hpp>
+#include <core/memory.hpp>
+#include <core/math.hpp>
+#include <core/hashmap.hpp>
+#include <core/flathashmap.hpp>
+#include <core/string.hpp>
+#include <core/bcn.hpp>
+
+#include <manta/console.hpp>
+#include <manta/time.hpp>
+#include <manta/gfx.hpp>
+#include <manta/thread.hpp>
+#include <manta/terminal.hpp>
+#include <manta/objects.hpp>
+#include <manta/network.hpp>
+#include <manta/replication.hpp>
+#include <manta/filesystem.hpp>
+#include <manta/skeleton.hpp>
+#include <manta/simplex.hpp>
+#include <manta/random.hpp>
+#include <manta/draw.hpp>
+#include <manta/fonts.hpp>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static CommandHandle CMD_BENCHMARK_HASHMAP;
+static CommandHandle CMD_BENCHMARK_RENDER_GRAPH;
+static CommandHandle CMD_BENCHMARK_RENDER_GRAPH_RECORD;
+static CommandHandle CMD_BENCHMARK_PRINT;
+static CommandHandle CMD_BENCHMARK_THREADED_WRITER;
+static CommandHandle CMD_BENCHMARK_REPLICATION;
+static CommandHandle CMD_BENCHMARK_SAVE;
+static CommandHandle CMD_BENCHMARK_TEXTURE_COMPRESSION;
+static CommandHandle CMD_BENCHMARK_SKELETON;
+static CommandHandle CMD_BENCHMARK_SIMPLEX;
+static CommandHandle CMD_BENCHMARK_RANDOM;
+static CommandHandle CMD_BENCHMARK_GFX;
+
+static u64 splitmix64( u64 &state )
+{
+	u64 z = ( state += 0x9E3779B97F4A7C15ULL );
+	z = ( z ^ ( z >> 30 ) ) * 0xBF58476D1CE4E5B9ULL;
+	z = ( z ^ ( z >> 27 ) ) * 0x94D049BB133111EBULL;
+	return z ^ ( z >> 31 );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Worker fan-out shared by the threaded benchmarks
+//
+// workers_begin() starts 'threads - 1' workers. Each workers_run() hands them, and the calling thread, chunk indices
+// [0, count) from an atomic counter, and returns once every chunk is done and every worker has checked in (so a
+// late worker never claims chunks of the next run). Between runs workers sleep on an EventCount, so per-frame
+// stages (see: Benchmark::skeleton) don't pay for thread creation. With the 'none' thread backend the calling
+// thread runs every chunk.
+
+#define BENCHMARK_THREADS_MAX ( 16 )
+
+using WorkersFunction = void ( * )( u32 chunk, void *context );
+
+static WorkersFunction workersFunction;
+static void *workersContext;
+static Atomic_U32 workersGeneration; // Bumped to hand workers a run
+static Atomic_U32 workersChunkCount;
+static Atomic_U32 workersChunkNext;
+static Atomic_U32 workersFinished; // Workers done with the current run
+static Atomic_U32 workersAlive;
+static Atomic_U32 workersQuit;
+static EventCount workersWake; // Caller -> workers
+static EventCount workersIdle; // Workers -> caller
+
+
+static void workers_chunks()
+{
+	const u32 count = workersChunkCount.load();
+	for( u32 chunk = workersChunkNext.fetch_add( 1 ); chunk < count; chunk = workersChunkNext.fetch_add( 1 ) )
+	{
+		workersFunction( chunk, workersContext );
+	}
+}
+
+
+static THREAD_FUNCTION( workers_thread )
+{
+	for( u32 generation = 0; ; )
+	{
+		workersWake.wait_until( [&generation]() { return workersGeneration.load() != generation; } );
+		generation = workersGeneration.load();
+		if( workersQuit.load() != 0 ) { break; }
+		workers_chunks();
+		workersFinished.fetch_add( 1 );
+		workersIdle.notify_all();
+	}
+
+	workersAlive.fetch_sub( 1 );
+	workersIdle.notify_all();
+	return 0;
+}
+
+
+static void workers_begin( const u32 threads )
+{
+	Assert( threads >= 1 && threads <= BENCHMARK_THREADS_MAX );
+	workersWake.init();
+	workersIdle.init();
+	workersGeneration.init( 0 );
+	workersChunkCount.init( 0 );
+	workersChunkNext.init( 0 );
+	workersFinished.init( 0 );
+	workersAlive.init( 0 );
+	workersQuit.init( 0 );
+
+	for( u32 i = 1; i < threads; i++ )
+	{
+		workersAlive.fetch_add( 1 );
+		void *thread = Thread::create( workers_thread );
+		if( thread == nullptr ) { workersAlive.fetch_sub( 1 ); break; }
+		Thread::free( thread );
+	}
+}
+
+
+static void workers_run( const u32 count, WorkersFunction function, void *context )
+{
+	workersFunction = function;
+	workersContext = context;
+	workersChunkCount.store( count );
+	workersChunkNext.store( 0 );
+	workersFinished.store( 0 );
+	workersGeneration.fetch_add( 1 );
+	workersWake.notify_all();
+
+	workers_chunks();
+	workersIdle.wait_until( []() { return workersFinished.load() == workersAlive.load(); } );
+}
+
+
+static void workers_end()
+{
+	workersQuit.store( 1 );
+	workersGeneration.fetch_add( 1 );
+	workersWake.notify_all();
+	workersIdle.wait_until( []() { return workersAlive.load() == 0; } );
+	workersIdle.free();
+	workersWake.free();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+template <typename Map> static void benchmark_map( const char *name, const u32 count,
+	const u64 *keys, const u64 *keysMissing )
+{
+	Map map;
+	map.init();
+	Timer timer;
+	u64 sink = 0;
+
+	// Insert (growing from the default reserve)
+	timer.start();
+	for( u32 i = 0; i < count; i++ ) { map.add( keys[i], i ); }
+	timer.stop();
+	const double nsInsert = timer.elapsed_us() * 1000.0 / count;
+
+	// Find (hits)
+	timer.start();
+	for( u32 i = 0; i < count; i++ ) { sink += map.get( keys[i] ); }
+	timer.stop();
+	const double nsFind = timer.elapsed_us() * 1000.0 / count;
+
+	// Find (misses)
+	timer.start();
+	for( u32 i = 0; i < count; i++ ) { sink += map.contains( keysMissing[i] ); }
+	timer.stop();
+	const double nsMiss = timer.elapsed_us() * 1000.0 / count;
+
+	// Erase + re-insert (tombstone churn)
+	timer.start();
+	for( u32 i = 0; i < count; i += 2 ) { map.remove( keys[i] ); }
+	for( u32 i = 0; i < count; i += 2 ) { map.add( keysMissing[i], i ); }
+	timer.stop();
+	const double nsChurn = timer.elapsed_us() * 1000.0 / count;
+
+	// Find after churn
+	timer.start();
+	for( u32 i = 1; i < count; i += 2 ) { sink += map.get( keys[i] ); }
+	timer.stop();
+	const double nsFindChurn = timer.elapsed_us() * 1000.0 / ( count / 2 );
+
+	Console::Log( c_white, "%-12s insert %6.1f ns | find %6.1f ns | miss %6.1f ns | churn %6.1f ns | "
+		"find (churned) %6.1f ns | %.2f mb (%llu)", name, nsInsert, nsFind, nsMiss, nsChurn, nsFindChurn,
+		MB( map.size_allocated_bytes() ), sink & 1 );
+
+	map.free();
+}
+
+
+void Benchmark::hashmap( const u32 count )
+{
+	if( count < 2 ) { Console::Log( c_red, "benchmark hashmap: count must be at least 2" ); return; }
+
+	u64 *keys = reinterpret_cast<u64 *>( memory_alloc( count * sizeof( u64 ) ) );
+	u64 *keysMissing = reinterpret_cast<u64 *>( memory_alloc( count * sizeof( u64 ) ) );
+
+	// Random keys (odd = present, even = missing) so both sets are distinct
+	u64 state = 0x6D616E7461ULL;
+	for( u32 i = 0; i < count; i++ )
+	{
+		keys[i] = splitmix64( state ) | 1;
+		keysMissing[i] = splitmix64( state ) & ~1ULL;
+	}
+
+	Console::Log( c_white, "benchmark hashmap: %u u64 keys (ns per op)", count );
+	benchmark_map<HashMap<u64, u32>>( "HashMap", count, keys, keysMissing );
+	benchmark_map<FlatHashMap<u64, u32>>( "FlatHashMap", count, keys, keysMissing );
+
+	memory_free( keys );
+	memory_free( keysMissing );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if GRAPHICS_ENABLED
+static u32 render_graph_pipeline_changes( const GfxRenderCommand *commands, const u32 *order, const u32 count )
+{
+	u32 changes = 1;
+	for( u32 i = 1; i < count; i++ )
+	{
+		const GfxStatePipeline &a = commands[order != nullptr ? order[i - 1] : i - 1].pipeline;
+		const GfxStatePipeline &b = commands[order != nullptr ? order[i] : i].pipeline;
+		changes += !( a == b );
+	}
+	return changes;
+}
+#endif
+
+
+void Benchmark::render_graph( const u32 count )
+{
+#if GRAPHICS_ENABLED
+	if( count < 2 ) { Console::Log( c_red, "benchmark render_graph: count must be at least 2" ); return; }
+
+	// Random commands: 8 passes, 16 shaders, 4 blend states, random depth
+	GfxRenderCommand *commands =
+		reinterpret_cast<GfxRenderCommand *>( memory_alloc( count * sizeof( GfxRenderCommand ) ) );
+	u64 state = 0x6D616E7461ULL;
+	for( u32 i = 0; i < count; i++ )
+	{
+		const u64 random = splitmix64( state );
+		GfxRenderCommand &command = commands[i];
+		new ( &command ) GfxRenderCommand { };
+		command.pipeline.shader = CoreGfx::shaders[( random & 0xF ) % CoreGfx::shaderCount].resource;
+		command.pipeline.description.blendSrcFactorColor = ( random >> 4 ) & 0x3;
+		command.pipeline.description.depthFunction = ( random >> 6 ) & 0x1;
+		command.sort_key( static_cast<u8>( ( random >> 8 ) & 0x7 ),
+			static_cast<float>( ( random >> 16 ) & 0xFFFF ) / 65535.0f, static_cast<u8>( random >> 32 ) );
+	}
+
+	Timer timer;
+	GfxRenderGraph graphQuicksort;
+	GfxRenderGraph graphRadix;
+	for( u32 i = 0; i < count; i++ ) { graphQuicksort.add_command( commands[i] ); }
+	for( u32 i = 0; i < count; i++ ) { graphRadix.add_command( commands[i] ); }
+
+	// Comparator quicksort (moves whole GfxRenderCommands)
+	timer.start();
+	Gfx::render_graph_sort( graphQuicksort,
+		[]( GfxRenderCommand &a, GfxRenderCommand &b ) { return a.sortKey < b.sortKey; } );
+	timer.stop();
+	const double msQuicksort = timer.elapsed_ms();
+
+	// Radix sort of a key/index array
+	timer.start();
+	Gfx::render_graph_sort( graphRadix );
+	timer.stop();
+	const double msRadix = timer.elapsed_ms();
+
+	// Validate & count pipeline changes between consecutive commands
+	const List<GfxRenderCommand> &listQuicksort = graphQuicksort.command_list();
+	const List<GfxRenderCommand> &listRadix = graphRadix.command_list();
+	const List<u32> &order = GfxRenderGraph::renderGraphCommandOrders[graphRadix.commandList];
+	bool valid = order.current == count;
+	for( u32 i = 0; valid && i < count; i++ )
+	{
+		valid &= listQuicksort[i].sortKey == listRadix[order[i]].sortKey;
+	}
+
+	Console::Log( c_white, "benchmark render_graph: %u commands (%llu bytes each)",
+		count, sizeof( GfxRenderCommand ) );
+	Console::Log( c_white, "  quicksort (comparator)  %8.3f ms | %6.1f ns per command", msQuicksort,
+		msQuicksort * 1000000.0 / count );
+	Console::Log( c_white, "  radix (64-bit key)      %8.3f ms | %6.1f ns per command | %s", msRadix,
+		msRadix * 1000000.0 / count, valid ? "matches" : "MISMATCH" );
+	Console::Log( c_white, "  pipeline changes: %u unsorted -> %u sorted",
+		render_graph_pipeline_changes( commands, nullptr, count ),
+		render_graph_pipeline_changes( listRadix.data, order.data, count ) );
+
+	memory_free( commands );
+#else
+	Console::Log( c_red, "benchmark render_graph: requires a graphics backend "
+		"(gfx/none: set \"gfxFrontend\" in configs.json)" );
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if GRAPHICS_ENABLED
+struct RecordPayload
+{
+	u32 index;
+	float_m44 matrix; // Stand-in for per-object render state
+};
+
+static GfxRenderGraphRecorder recordRecorders[BENCHMARK_THREADS_MAX];
+static u32 recordCount;
+static u32 recordThreads;
+static u64 recordSink;
+
+
+template <typename Target> static void record_commands( Target &target, const u32 begin, const u32 end )
+{
+	for( u32 i = begin; i < end; i++ )
+	{
+		GfxRenderCommand command;
+		command.work( RecordPayload { i, float_m44 { } }, +[]( RecordPayload &payload ) { recordSink += payload.index; } );
+		command.sort_key( 0, static_cast<float>( i ) / recordCount );
+		target.add_command( static_cast<GfxRenderCommand &&>( command ) );
+	}
+}
+
+
+static void record_slot( const u32 slot, void * )
+{
+	GfxRenderGraphRecorder &recorder = recordRecorders[slot];
+	recorder.begin();
+	record_commands( recorder, static_cast<u32>( static_cast<u64>( recordCount ) * slot / recordThreads ),
+		static_cast<u32>( static_cast<u64>( recordCount ) * ( slot + 1 ) / recordThreads ) );
+	recorder.end();
+}
+#endif
+
+
+void Benchmark::render_graph_record( const u32 count, const u32 threads )
+{
+#if GRAPHICS_ENABLED
+	if( count < 1 ) { Console::Log( c_red, "benchmark render_graph_record: count must be at least 1" ); return; }
+	if( threads < 1 || threads > BENCHMARK_THREADS_MAX )
+	{
+		Console::Log( c_red, "benchmark render_graph_record: threads must be in [1, %d]", BENCHMARK_THREADS_MAX );
+		return;
+	}
+
+	recordCount = count;
+	recordThreads = threads;
+	Timer timer;
+
+	// Single thread: straight into the graph
+	GfxRenderGraph graphSingle;
+	timer.start();
+	record_commands( graphSingle, 0, count );
+	timer.stop();
+	const double msSingle = timer.elapsed_ms();
+
+	// Recorders (one per thread), merged in slot order
+	for( u32 i = 0; i < threads; i++ ) { recordRecorders[i].init( count / threads + 1 ); }
+	workers_begin( threads );
+
+	GfxRenderGraph graphThreaded;
+	timer.start();
+	workers_run( threads, record_slot, nullptr );
+	timer.stop();
+	workers_end();
+	const double msRecord = timer.elapsed_ms();
+
+	timer.start();
+	for( u32 i = 0; i < threads; i++ ) { graphThreaded.merge( recordRecorders[i] ); }
+	timer.stop();
+	const double msMerge = timer.elapsed_ms();
+
+	// Validate: same commands & payloads in the same order
+	const List<GfxRenderCommand> &listSingle = graphSingle.command_list();
+	const List<GfxRenderCommand> &listThreaded = graphThreaded.command_list();
+	bool valid = listSingle.current == listThreaded.current;
+	for( usize i = 0; valid && i < listSingle.current; i++ )
+	{
+		const GfxRenderCommand &a = listSingle[i];
+		const GfxRenderCommand &b = listThreaded[i];
+		const RecordPayload *payloadA = reinterpret_cast<const RecordPayload *>(
+			GfxRenderCommand::renderCommandArgsStack.get( a.workPayloadOffset, a.workPayloadSize ) );
+		const RecordPayload *payloadB = reinterpret_cast<const RecordPayload *>(
+			GfxRenderCommand::renderCommandArgsStack.get( b.workPayloadOffset, b.workPayloadSize ) );
+		valid &= a.sortKey == b.sortKey && payloadA->index == payloadB->index;
+	}
+
+	for( u32 i = 0; i < threads; i++ ) { recordRecorders[i].free(); }
+
+	Console::Log( c_white, "benchmark render_graph_record: %u commands (%llu byte payloads)",
+		count, sizeof( RecordPayload ) );
+	Console::Log( c_white, "  1 thread   record %8.3f ms", msSingle );
+	Console::Log( c_white, "  %u threads  record %8.3f ms + merge %8.3f ms | %s", threads, msRecord, msMerge,
+		valid ? "matches" : "MISMATCH" );
+#else
+	Console::Log( c_red, "benchmark render_graph_record: requires a graphics backend "
+		"(gfx/none: set \"gfxFrontend\" in configs.json)" );
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Benchmark::print( const u32 count )
+{
+	if( count < 1 ) { Console::Log( c_red, "benchmark print: count must be at least 1" ); return; }
+
+	Debug::print_flush();
+	const Debug::PrintSinkFunction sink = Debug::print_redirect_sink();
+	const Debug::PrintFlushFunction flush = Debug::print_redirect_flush();
+	Timer timer;
+
+	// Synchronous: printf on the calling thread
+	Debug::print_redirect( nullptr, nullptr );
+	timer.start();
+	for( u32 i = 0; i < count; i++ ) { PrintLn( PrintColor_Cyan, "benchmark print: sync %u", i ); }
+	timer.stop();
+	const double msSync = timer.elapsed_ms();
+	Debug::print_redirect( sink, flush );
+
+	if( sink == nullptr )
+	{
+		Console::Log( c_white, "benchmark print: %u lines", count );
+		Console::Log( c_white, "  sync   %8.3f ms (no asynchronous writer)", msSync );
+		return;
+	}
+
+	// Asynchronous: queued to the terminal writer thread
+	const TerminalLogStats statsStart = Terminal::log_stats();
+	timer.start();
+	for( u32 i = 0; i < count; i++ ) { PrintLn( PrintColor_Cyan, "benchmark print: async %u", i ); }
+	timer.stop();
+	const double msAsync = timer.elapsed_ms();
+
+	timer.start();
+	Debug::print_flush();
+	timer.stop();
+	const double msDrain = timer.elapsed_ms();
+	const TerminalLogStats statsEnd = Terminal::log_stats();
+
+	Console::Log( c_white, "benchmark print: %u lines (caller thread time)", count );
+	Console::Log( c_white, "  sync   %8.3f ms", msSync );
+	Console::Log( c_white, "  async  %8.3f ms + drain %8.3f ms | %llu batches, %llu stalls", msAsync, msDrain,
+		statsEnd.batches - statsStart.batches, statsEnd.stalls - statsStart.stalls );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// CPU-side stand-in for a mapped GPU buffer
+struct WriterResource
+{
+	bool init( usize capacity ) { data = reinterpret_cast<byte *>( memory_alloc( capacity ) ); return true; }
+	bool free() { memory_free( data ); data = nullptr; return true; }
+	void write_begin() { }
+	void write_end() { }
+	void write( const void *source, usize size, usize offset ) { memory_copy( data + offset, source, size ); }
+	void *map( usize offset, usize size ) { return data + offset; }
+	byte *data = nullptr;
+};
+
+struct WriterMessage
+{
+	double timeCommit; // Time::value() at commit
+	u64 sequence;
+};
+
+static constexpr int WRITER_RESOURCES = 16;
+static constexpr u32 WRITER_BATCH = 8;
+static constexpr u32 WRITER_QUEUE = 32; // > WRITER_RESOURCES: OVERWRITE commits in flight are bounded by resources
+
+static ThreadedWriterSPSC<WriterResource> writer;
+static WriterResource writerResources[WRITER_RESOURCES];
+static ThreadedWriterSPSC<WriterResource>::CommitResult writerQueue[WRITER_QUEUE];
+static Atomic_U32 writerQueueTail; // Producer -> consumer
+static EventCount writerQueued;
+static u32 writerQueueHead; // Consumer only
+static Atomic_U32 writerConsumerAlive;
+static u32 writerCount;
+static u64 writerSequence; // Consumer: next expected sequence
+static u64 writerChecksum;
+static double writerLatencySum;
+static double writerLatencyMax;
+static bool writerValid;
+
+
+static bool writer_consume()
+{
+	if( writerQueueHead == writerQueueTail.load() ) { return false; }
+	const ThreadedWriterSPSC<WriterResource>::CommitResult &result = writerQueue[writerQueueHead % WRITER_QUEUE];
+
+	const byte *data = result.resource->data + result.offset;
+	const WriterMessage &message = *reinterpret_cast<const WriterMessage *>( data );
+	const double latency = Time::value() - message.timeCommit;
+	writerLatencySum += latency;
+	writerLatencyMax = max( writerLatencyMax, latency );
+	writerValid &= message.sequence == writerSequence++;
+
+	// Touch the payload like a real consumer would
+	const u64 *words = reinterpret_cast<const u64 *>( data );
+	for( usize i = 0; i < result.size / sizeof( u64 ); i++ ) { writerChecksum += words[i]; }
+
+	writer.release( result.commitID );
+	writerQueueHead++;
+	return true;
+}
+
+
+static THREAD_FUNCTION( writer_consumer )
+{
+	while( writerSequence < writerCount )
+	{
+		writerQueued.wait_until( []() { return writerQueueHead != writerQueueTail.load(); } );
+		while( writer_consume() ) { }
+	}
+	writerConsumerAlive.fetch_sub( 1 );
+	return 0;
+}
+
+
+static void writer_fill( byte *destination, const u32 size, const u64 sequence )
+{
+	u64 *words = reinterpret_cast<u64 *>( destination );
+	for( usize i = 0; i < size / sizeof( u64 ); i++ ) { words[i] = sequence + i; }
+	WriterMessage &message = *reinterpret_cast<WriterMessage *>( destination );
+	message.sequence = sequence;
+	message.timeCommit = Time::value();
+}
+
+
+static void benchmark_writer( const char *name, const u32 count, const u32 size, const bool buffered,
+	const bool zeroCopy, const u32 batch )
+{
+	writer.init( writerResources, WRITER_RESOURCES, size, WriteMode_OVERWRITE, buffered );
+	writerQueueTail.init( 0 );
+	writerQueued.init();
+	writerQueueHead = 0;
+	writerCount = count;
+	writerSequence = 0LLU;
+	writerChecksum = 0LLU;
+	writerLatencySum = 0.0;
+	writerLatencyMax = 0.0;
+	writerValid = true;
+
+	byte *staging = reinterpret_cast<byte *>( memory_alloc( size ) );
+	ThreadedWriterSPSC<WriterResource>::CommitResult results[WRITER_BATCH];
+
+	writerConsumerAlive.init( 1 );
+	void *thread = Thread::create( writer_consumer );
+	const bool threaded = thread != nullptr;
+	if( threaded ) { Thread::free( thread ); } else { writerConsumerAlive.init( 0 ); }
+
+	Timer timer;
+	u32 queueTail = 0;
+	for( u32 i = 0; i < count; i += batch )
+	{
+		const u32 commits = min( batch, count - i );
+		if( batch > 1 ) { writer.commit_batch_begin(); }
+
+		for( u32 j = 0; j < commits; j++ )
+		{
+			writer.write_begin();
+			if( zeroCopy )
+			{
+				writer_fill( reinterpret_cast<byte *>( writer.reserve( size, alignof( u64 ) ) ), size, i + j );
+			}
+			else
+			{
+				writer_fill( staging, size, i + j );
+				writer.write( staging, size, alignof( u64 ) );
+			}
+			writer.write_end();
+			results[j] = writer.commit();
+		}
+
+		if( batch > 1 ) { writer.commit_batch_end(); }
+
+		// Hand off to the consumer (one store per batch)
+		for( u32 j = 0; j < commits; j++ ) { writerQueue[( queueTail + j ) % WRITER_QUEUE] = results[j]; }
+		queueTail += commits;
+		writerQueueTail.store( queueTail );
+		writerQueued.notify_all();
+
+		if( !threaded ) { while( writer_consume() ) { } }
+	}
+	Thread::wait_until( []() { return writerConsumerAlive.load() == 0; } );
+	timer.stop();
+
+	writer.free();
+	writerQueued.free();
+	memory_free( staging );
+
+	const double ms = timer.elapsed_ms();
+	const double megabytes = static_cast<double>( count ) * size / ( 1024.0 * 1024.0 );
+	Console::Log( c_white, "  %-20s %8.3f ms | %8.1f MB/s | %6.2f M commits/s | latency avg %7.2f us max %8.2f us | %s",
+		name, ms, megabytes / ( ms / 1000.0 ), count / ( ms * 1000.0 ), writerLatencySum / count * 1000000.0,
+		writerLatencyMax * 1000000.0, writerValid ? "ok" : "MISMATCH" );
+}
+
+
+void Benchmark::threaded_writer( const u32 count, const u32 size )
+{
+	if( count < 1 ) { Console::Log( c_red, "benchmark threaded_writer: count must be at least 1" ); return; }
+	if( size < sizeof( WriterMessage ) || size % sizeof( u64 ) != 0 )
+	{
+		Console::Log( c_red, "benchmark threaded_writer: size must be a multiple of 8 and at least %llu",
+			sizeof( WriterMessage ) );
+		return;
+	}
+
+	Console::Log( c_white, "benchmark threaded_writer: %u commits of %u bytes (OVERWRITE, %d resources)",
+		count, size, WRITER_RESOURCES );
+	benchmark_writer( "buffered write", count, size, true, false, 1 );
+	benchmark_writer( "unbuffered write", count, size, false, false, 1 );
+	benchmark_writer( "reserve", count, size, false, true, 1 );
+	benchmark_writer( "reserve + batch", count, size, false, true, WRITER_BATCH );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if COMPILE_BENCHMARK_OBJECTS
+#define REPLICATION_TICKS ( 32 )
+#define REPLICATION_DROP_TICK ( 3 ) // every 8th tick loses a datagram (delta falls back to the older baseline)
+
+static void replication_mutate( ObjectContext &context, const ObjectInstance &instance, u64 &seed )
+{
+	auto object = context.handle<Object::BenchmarkReplicated>( instance );
+	const u64 random = splitmix64( seed );
+	object->x += object->velocity;
+	object->y -= object->velocity;
+	if( ( random & 0x3 ) == 0 ) { object->rotation = static_cast<float>( random >> 40 ) * 1e-6f; }
+	if( ( random & 0x30 ) == 0 ) { object->health = static_cast<u16>( ( random >> 8 ) % 100 ); }
+	if( ( random & 0x300 ) == 0 ) { object->score += static_cast<i32>( ( random >> 16 ) % 16 ) - 4; }
+	if( ( random & 0x3000 ) == 0 ) { object->visible = !object->visible; }
+}
+
+
+static void replication_spawn( ObjectContext &context, ObjectInstance &instance, u64 &seed )
+{
+	instance = context.create( Object::BenchmarkReplicated );
+	auto object = context.handle<Object::BenchmarkReplicated>( instance );
+	const u64 random = splitmix64( seed );
+	object->x = static_cast<float>( random & 0xFFFF );
+	object->y = static_cast<float>( ( random >> 16 ) & 0xFFFF );
+	object->velocity = static_cast<float>( ( random >> 32 ) & 0xFF ) * 0.01f + 0.01f;
+	object->color = static_cast<u32>( random >> 32 );
+	object->state = static_cast<u8>( random & 0x7 );
+}
+
+
+static u64 replication_checksum( const ObjectContext &context )
+{
+	// Order independent (server & client objects live at different indices)
+	u64 checksum = 0LLU;
+	for( auto object : context.iterator<Object::BenchmarkReplicated>() )
+	{
+		u64 hash = 0LLU;
+		u32 words[8];
+		memcpy( &words[0], &object->x, 4 );
+		memcpy( &words[1], &object->y, 4 );
+		memcpy( &words[2], &object->rotation, 4 );
+		words[3] = object->health;
+		words[4] = object->state;
+		words[5] = object->visible;
+		words[6] = object->color;
+		words[7] = static_cast<u32>( object->score );
+		for( u32 i = 0; i < 8; i++ ) { hash = splitmix64( hash ) ^ words[i]; }
+		checksum += splitmix64( hash );
+	}
+	return checksum;
+}
+
+
+void Benchmark::replication( const u32 count )
+{
+	if( count < 1 ) { Console::Log( c_red, "benchmark replication: count must be at least 1" ); return; }
+
+	ObjectContext server;
+	ObjectContext client;
+	server.init();
+	client.init();
+
+	// No socket is opened: the connection only tracks the client's acknowledged baseline
+	const NetworkConnectionHandle connection = 1;
+	NetworkServerUDP network;
+	network.init( 0, 1, nullptr );
+	network.connection_register( connection );
+
+	ReplicationServer replicationServer;
+	ReplicationClient replicationClient;
+	replicationServer.init( server );
+	replicationClient.init( client );
+
+	Buffer packet;
+	packet.init( 1024 );
+	Buffer datagram;
+	datagram.init( REPLICATION_DATAGRAM_BYTES );
+	Buffer truncated;
+	truncated.init( 1024 );
+
+	// Loopback: fragment the snapshot as ReplicationServer::send() would and feed each datagram to the client
+	// (optionally dropping one). Returns the datagram count
+	auto loopback = [&]( const bool drop, bool &applied ) -> u32
+	{
+		const u32 fragments = ReplicationServer::fragment_count( packet );
+		const u32 dropped = drop ? fragments / 2 : fragments;
+		byte bytes[REPLICATION_DATAGRAM_BYTES];
+		applied = false;
+		for( u32 i = 0; i < fragments; i++ )
+		{
+			const usize size = ReplicationServer::fragment( packet, i, bytes );
+			if( i == dropped ) { continue; }
+			datagram.clear();
+			datagram.write( bytes, size );
+			datagram.seek_start();
+			applied |= replicationClient.receive( datagram );
+		}
+		return fragments;
+	};
+
+	// Acknowledge the client's tick as a ReplicationClient::acknowledge() datagram would
+	auto acknowledge = [&]()
+	{
+		datagram.clear();
+		datagram.write<u32>( replicationClient.tick );
+		datagram.seek_start();
+		return replicationServer.receive( network, connection, datagram );
+	};
+
+	u64 seed = 0x5EED;
+	List<ObjectInstance> instances;
+	instances.init( count );
+	for( u32 i = 0; i < count; i++ ) { replication_spawn( server, instances.add( ObjectInstance { } ), seed ); }
+
+	// Initial full snapshot
+	replicationServer.sample();
+	replicationServer.write( packet, network.connection_baseline( connection ) );
+	bool valid = true;
+	const u32 datagramsInitial = loopback( false, valid );
+	valid &= acknowledge();
+
+	Console::Log( c_white, "benchmark replication: %u objects, %d ticks per row (initial snapshot: %llu bytes, "
+		"%u datagrams of <= %d bytes)", count, REPLICATION_TICKS, packet.size(), datagramsInitial,
+		REPLICATION_DATAGRAM_BYTES );
+
+	// Larger snapshots can't be sent (see: ReplicationServer::send)
+	if( datagramsInitial > REPLICATION_FRAGMENTS_MAX )
+	{
+		Console::Log( c_red, "  snapshot exceeds REPLICATION_FRAGMENTS_MAX (%d datagrams)", REPLICATION_FRAGMENTS_MAX );
+	}
+	else
+	{
+		const u32 changedPercent[] = { 0, 1, 10, 100 };
+		for( const u32 percent : changedPercent )
+		{
+			const u32 changed = static_cast<u32>( static_cast<u64>( count ) * percent / 100 );
+			const u32 churn = changed / 100; // destroyed & recreated objects per tick
+			usize bytesDelta = 0LLU;
+			usize bytesFull = 0LLU;
+			u32 datagrams = 0;
+			u32 dropped = 0;
+			double msDelta = 0.0;
+			double msFull = 0.0;
+
+			for( u32 t = 0; t < REPLICATION_TICKS; t++ )
+			{
+				for( u32 i = 0; i < changed; i++ )
+				{
+					replication_mutate( server, instances[splitmix64( seed ) % count], seed );
+				}
+
+				for( u32 i = 0; i < churn; i++ )
+				{
+					ObjectInstance &instance = instances[splitmix64( seed ) % count];
+					server.destroy( instance );
+					replication_spawn( server, instance, seed );
+				}
+
+				// Delta (relative to the acknowledged baseline)
+				Timer timerDelta;
+				replicationServer.sample();
+				packet.clear();
+				replicationServer.write( packet, network.connection_baseline( connection ) );
+				msDelta += timerDelta.ms();
+				bytesDelta += packet.size();
+
+				// A lost datagram must leave the snapshot unapplied (and unacknowledged) -- the next tick's delta
+				// against the older baseline recovers it
+				const bool drop = t % 8 == REPLICATION_DROP_TICK;
+				bool applied = false;
+				datagrams += loopback( drop, applied );
+				dropped += drop;
+				valid &= applied != drop;
+				if( applied ) { valid &= acknowledge(); }
+
+				// A truncated snapshot must be rejected before it touches the client
+				if( drop )
+				{
+					const u64 checksum = replication_checksum( client );
+					const u32 objects = client.count( Object::BenchmarkReplicated );
+					truncated.clear();
+					truncated.write( packet.data, packet.size() / 2 );
+					truncated.seek_start();
+					valid &= !replicationClient.read( truncated );
+					valid &= replication_checksum( client ) == checksum;
+					valid &= client.count( Object::BenchmarkReplicated ) == objects;
+				}
+
+				// Full snapshot
+				Timer timerFull;
+				packet.clear();
+				replicationServer.write( packet, 0 );
+				msFull += timerFull.ms();
+				bytesFull += packet.size();
+			}
+
+			valid &= replication_checksum( server ) == replication_checksum( client );
+			valid &= server.count( Object::BenchmarkReplicated ) == client.count( Object::BenchmarkReplicated );
+
+			Console::Log( c_white, "  %3u%% changed | delta %10.1f bytes/tick %7.3f ms/tick %6.1f datagrams/tick | "
+				"full %10.1f bytes/tick %7.3f ms/tick | %u dropped | %s", percent,
+				static_cast<double>( bytesDelta ) / REPLICATION_TICKS, msDelta / REPLICATION_TICKS,
+				static_cast<double>( datagrams ) / REPLICATION_TICKS,
+				static_cast<double>( bytesFull ) / REPLICATION_TICKS, msFull / REPLICATION_TICKS, dropped,
+				valid ? "ok" : "MISMATCH" );
+		}
+	}
+
+	instances.free();
+	truncated.free();
+	datagram.free();
+	packet.free();
+	replicationClient.free();
+	replicationServer.free();
+	network.connection_release( connection );
+	network.free();
+	client.free();
+	server.free();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Benchmark::save( const u32 count )
+{
+	if( count < 1 ) { Console::Log( c_red, "benchmark save: count must be at least 1" ); return; }
+
+	char path[PATH_SIZE];
+	strjoin( path, EXECUTABLE_DIRECTORY, SLASH "benchmark.save" );
+
+	ObjectContext context;
+	context.init();
+	u64 seed = 0x5A7E;
+	List<ObjectInstance> instances;
+	instances.init( count );
+	for( u32 i = 0; i < count; i++ ) { replication_spawn( context, instances.add( ObjectInstance { } ), seed ); }
+	const u64 checksum = replication_checksum( context );
+
+	Console::Log( c_white, "benchmark save: %u objects", count );
+
+	// Blocking: the caller stalls for serialization, compression, and the file write
+	Timer timerBlocking;
+	bool valid = context.save( path );
+	const double msBlocking = timerBlocking.ms();
+	Console::Log( c_white, "  %-12s hitch %9.3f ms", "save", msBlocking );
+
+	// Asynchronous: the caller stalls for the snapshot, then keeps mutating objects while the save is written
+	Timer timerAsync;
+	valid &= context.save_async( path );
+	const double msHitch = timerAsync.ms();
+	u32 frames = 0;
+	while( ObjectContext::save_busy() )
+	{
+		for( u32 i = 0; i < count && i < 1024; i++ )
+		{
+			replication_mutate( context, instances[splitmix64( seed ) % count], seed );
+		}
+		frames++;
+		Thread::yield();
+	}
+	valid &= ObjectContext::save_wait();
+	const double msAsync = timerAsync.ms();
+
+	// The file must hold the objects as they were at save_async(), not as they are now
+	ObjectContext loaded;
+	loaded.init();
+	valid &= loaded.load( path );
+	valid &= loaded.count( Object::BenchmarkReplicated ) == count;
+	valid &= replication_checksum( loaded ) == checksum;
+	valid &= replication_checksum( context ) != checksum || frames == 0;
+
+	Console::Log( c_white, "  %-12s hitch %9.3f ms | written after %9.3f ms (%u batches of mutations) | %s",
+		"save_async", msHitch, msAsync, frames, valid ? "ok" : "MISMATCH" );
+
+	file_delete( path );
+	loaded.free();
+	instances.free();
+	context.free();
+}
+
+#else
+
+void Benchmark::replication( const u32 count )
+{
+	Console::Log( c_red, "benchmark replication: requires the benchmark objects "
+		"(set \"benchmarkObjects\" in configs.json)" );
+}
+
+
+void Benchmark::save( const u32 count )
+{
+	Console::Log( c_red, "benchmark save: requires the benchmark objects "
+		"(set \"benchmarkObjects\" in configs.json)" );
+}
+
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Benchmark::texture_compression( const u32 size )
+{
+	if( size < 4 || size > U16_MAX || size % 4 != 0 )
+	{
+		Console::Log( c_red, "benchmark texture_compression: size must be a multiple of 4 in [4, %u]", U16_MAX );
+		return;
+	}
+
+	// Procedural image: noisy gradients, a hard-edged checker, and a cut-out alpha circle (transparent texels are
+	// black, as BC1 punch-through alpha decodes them)
+	const u16 width = static_cast<u16>( size );
+	const u16 height = static_cast<u16>( size );
+	const usize sizeBytes = static_cast<usize>( width ) * height * 4;
+	u8 *image = reinterpret_cast<u8 *>( memory_alloc( sizeBytes ) );
+	u8 *decoded = reinterpret_cast<u8 *>( memory_alloc( sizeBytes ) );
+	u64 seed = 0xBC7;
+	for( u16 y = 0; y < height; y++ )
+	{
+		for( u16 x = 0; x < width; x++ )
+		{
+			u8 *texel = &image[( static_cast<usize>( y ) * width + x ) * 4];
+			const u64 noise = splitmix64( seed );
+			const bool checker = ( ( x >> 5 ) ^ ( y >> 5 ) ) & 1;
+			const int dx = x - width / 2;
+			const int dy = y - height / 2;
+			const bool opaque = dx * dx + dy * dy < ( width / 3 ) * ( width / 3 );
+			texel[0] = opaque ? static_cast<u8>( x * 239 / width + ( noise & 0x0F ) ) : 0;
+			texel[1] = opaque ? static_cast<u8>( y * 239 / height + ( ( noise >> 4 ) & 0x0F ) ) : 0;
+			texel[2] = opaque ? static_cast<u8>( ( checker ? 192 : 32 ) + ( ( noise >> 8 ) & 0x0F ) ) : 0;
+			texel[3] = opaque ? 255 : 0;
+		}
+	}
+
+	// BC4/BC5 only store the red/green channels (and BC1 only 1-bit alpha)
+	static constexpr u8 channels[BCNFORMAT_COUNT] = { 0xF, 0xF, 0x1, 0x3, 0xF };
+
+	Console::Log( c_white, "benchmark texture_compression: %u x %u RGBA8 (%.2f MB)", width, height, MB( sizeBytes ) );
+	for( u32 i = 0; i < BCNFORMAT_COUNT; i++ )
+	{
+		const BCnFormat format = static_cast<BCnFormat>( i );
+		const usize sizeCompressed = bcn_size_bytes( format, width, height );
+		void *blocks = memory_alloc( sizeCompressed );
+
+		Timer timerEncode;
+		bcn_encode( format, image, width, height, blocks );
+		const double msEncode = timerEncode.ms();
+
+		Timer timerDecode;
+		bcn_decode( format, blocks, width, height, decoded );
+		const double msDecode = timerDecode.ms();
+
+		const double psnr = bcn_psnr( image, decoded, width, height, channels[i] );
+		Console::Log( c_white, "  %-4s encode %9.3f ms | decode %8.3f ms | %5.1f:1 | PSNR %5.1f dB",
+			bcnFormatName[i], msEncode, msDecode, static_cast<double>( sizeBytes ) / sizeCompressed, psnr );
+
+		memory_free( blocks );
+	}
+
+	memory_free( decoded );
+	memory_free( image );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void skeleton_sample( const u32 chunk, void *context )
+{
+	reinterpret_cast<Skeleton2DBatch *>( context )->sample_chunk( chunk );
+}
+
+
+static void skeleton_pose( const u32 chunk, void *context )
+{
+	reinterpret_cast<Skeleton2DBatch *>( context )->pose_chunk( chunk );
+}
+
+
+static void skeleton_spawn( List<Skeleton2D> &skeletons, const u32 count )
+{
+	// Every bone blends both test animations; instances start at one of 16 phases (so poses are shared)
+	skeletons.init( count );
+	for( u32 i = 0; i < count; i++ )
+	{
+		Skeleton2D &skeleton = skeletons.add( Skeleton2D { } );
+		skeleton.init( SkeletonID_Test );
+		for( u32 b = 0; b < skeletonEntries[SkeletonID_Test].boneCount; b++ )
+		{
+			Bone &bone = skeleton.get_bone( static_cast<BoneID>( b ) );
+			for( u32 a = 0; a < numAnimations; a++ )
+			{
+				const AnimationID animation = static_cast<AnimationID>( a );
+				bone.animation_start( animation, true, a == 0 ? 1.0f : 0.5f );
+				bone.animation_time( animation, ( i % 16 ) / 16.0f );
+			}
+		}
+	}
+}
+
+
+void Benchmark::skeleton( const u32 count, const u32 threads )
+{
+	if( count < 1 ) { Console::Log( c_red, "benchmark skeleton: count must be at least 1" ); return; }
+	if( threads < 1 || threads > BENCHMARK_THREADS_MAX )
+	{
+		Console::Log( c_red, "benchmark skeleton: threads must be in [1, %d]", BENCHMARK_THREADS_MAX );
+		return;
+	}
+
+	constexpr u32 frames = 60;
+	constexpr Delta delta = 1.0 / 60.0;
+	List<Skeleton2D> reference;
+	List<Skeleton2D> batched;
+	List<Skeleton2D> threaded;
+	skeleton_spawn( reference, count );
+	skeleton_spawn( batched, count );
+	skeleton_spawn( threaded, count );
+
+	// Per instance: Skeleton2D::update()
+	Timer timerReference;
+	for( u32 frame = 0; frame < frames; frame++ )
+	{
+		for( Skeleton2D &skeleton : reference ) { skeleton.update( delta ); }
+	}
+	const double msReference = timerReference.ms() / frames;
+
+	// Batched (calling thread)
+	Skeleton2DBatch batch;
+	batch.init();
+	for( Skeleton2D &skeleton : batched ) { batch.add( skeleton ); }
+	Timer timerBatched;
+	for( u32 frame = 0; frame < frames; frame++ ) { batch.update( delta ); }
+	const double msBatched = timerBatched.ms() / frames;
+
+	// Batched (worker threads take sample & pose chunks)
+	Skeleton2DBatch batchThreaded;
+	batchThreaded.init();
+	for( Skeleton2D &skeleton : threaded ) { batchThreaded.add( skeleton ); }
+	workers_begin( threads );
+
+	Timer timerThreaded;
+	for( u32 frame = 0; frame < frames; frame++ )
+	{
+		batchThreaded.update_begin( delta );
+		workers_run( batchThreaded.sample_chunk_count(), skeleton_sample, &batchThreaded );
+		workers_run( batchThreaded.pose_chunk_count(), skeleton_pose, &batchThreaded );
+	}
+	const double msThreaded = timerThreaded.ms() / frames;
+	workers_end();
+
+	// Validate: batched bones match Skeleton2D::update()
+	float errorMax = 0.0f;
+	auto compare = [&errorMax]( const Bone &a, const Bone &b )
+	{
+		errorMax = max( errorMax, fabsf( a.get_translation_x() - b.get_translation_x() ) );
+		errorMax = max( errorMax, fabsf( a.get_translation_y() - b.get_translation_y() ) );
+		errorMax = max( errorMax, fabsf( a.get_rotation() - b.get_rotation() ) );
+		errorMax = max( errorMax, fabsf( a.get_scale_x() - b.get_scale_x() ) );
+	};
+	for( u32 i = 0; i < count; i++ )
+	{
+		for( u32 b = 0; b < skeletonEntries[SkeletonID_Test].boneCount; b++ )
+		{
+			const BoneID boneID = static_cast<BoneID>( b );
+			compare( reference[i].get_bone( boneID ), batched[i].get_bone( boneID ) );
+			compare( reference[i].get_bone( boneID ), threaded[i].get_bone( boneID ) );
+		}
+	}
+
+	Console::Log( c_white, "benchmark skeleton: %u skeletons x %u bones x %u animations (%u frames)", count,
+		skeletonEntries[SkeletonID_Test].boneCount, numAnimations, frames );
+	Console::Log( c_white, "  %-20s %8.3f ms per frame", "Skeleton2D::update", msReference );
+	Console::Log( c_white, "  %-20s %8.3f ms per frame | %u poses for %u bone animations", "Skeleton2DBatch",
+		msBatched, batch.pose_count(), batch.animation_count() );
+	Console::Log( c_white, "  %-20s %8.3f ms per frame (%u threads) | max error %g | %s", "Skeleton2DBatch",
+		msThreaded, threads, errorMax, errorMax <= 1e-3f ? "ok" : "MISMATCH" );
+
+	batchThreaded.free();
+	batch.free();
+	for( Skeleton2D &skeleton : reference ) { skeleton.free(); }
+	for( Skeleton2D &skeleton : batched ) { skeleton.free(); }
+	for( Skeleton2D &skeleton : threaded ) { skeleton.free(); }
+	threaded.free();
+	batched.free();
+	reference.free();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static constexpr int SIMPLEX_ROWS_CHUNK = 16;
+
+struct SimplexJob
+{
+	const Simplex *noise;
+	SimplexGrid grid;
+};
+
+
+static void simplex_rows( const u32 chunk, void *context )
+{
+	const SimplexJob &job = *reinterpret_cast<const SimplexJob *>( context );
+	const int rowFirst = static_cast<int>( chunk ) * SIMPLEX_ROWS_CHUNK;
+	job.noise->sample_grid_rows( job.grid, rowFirst, min( rowFirst + SIMPLEX_ROWS_CHUNK, job.grid.height ) );
+}
+
+void Benchmark::simplex( const u32 size, const u32 threads )
+{
+	if( size < 1 || size > 8192 ) { Console::Log( c_red, "benchmark simplex: size must be in [1, 8192]" ); return; }
+	if( threads < 1 || threads > BENCHMARK_THREADS_MAX )
+	{
+		Console::Log( c_red, "benchmark simplex: threads must be in [1, %d]", BENCHMARK_THREADS_MAX );
+		return;
+	}
+
+	const usize count = static_cast<usize>( size ) * size;
+	float *reference = reinterpret_cast<float *>( memory_alloc( count * sizeof( float ) ) );
+	float *batched = reinterpret_cast<float *>( memory_alloc( count * sizeof( float ) ) );
+	float *threaded = reinterpret_cast<float *>( memory_alloc( count * sizeof( float ) ) );
+	const Simplex noise { 0x6E6F697365ULL };
+
+	SimplexGrid grid;
+	grid.width = static_cast<int>( size );
+	grid.height = static_cast<int>( size );
+	grid.x = -123.25f;
+	grid.y = 77.5f;
+	grid.step = 1.0f / 64.0f;
+
+	auto mismatch = [count]( const float *a, const float *b )
+	{
+		return memory_compare( a, b, count * sizeof( float ) ) != 0;
+	};
+
+	// Every mode of the scalar API must match bit for bit (single octave, unorm, tiled)
+	bool exact = true;
+	for( int mode = 0; mode < 6; mode++ )
+	{
+		SimplexGrid check = grid;
+		check.octaves = mode >= 4 ? 3 : 0;
+		check.fast = mode == 1 || mode == 5;
+		check.period = mode == 2 ? 16 : 0;
+		check.unorm = mode == 3 || mode == 5;
+		check.output = reference; noise.sample_grid_scalar( check );
+		check.output = batched; noise.sample_grid( check );
+		exact &= !mismatch( reference, batched );
+	}
+
+	Console::Log( c_white, "benchmark simplex: %ux%u grid, fbm (Msamples/s; %u threads for the threaded column)",
+		size, size, threads );
+	Console::Log( exact ? c_white : c_red, "  single octave, fast, tiled, unorm: %s", exact ? "bit-exact" : "MISMATCH" );
+
+	const u32 chunks = ( size + SIMPLEX_ROWS_CHUNK - 1 ) / SIMPLEX_ROWS_CHUNK;
+	workers_begin( threads );
+
+	static const int octaves[] = { 1, 2, 4, 8 };
+	for( const int octave : octaves )
+	{
+		for( int fast = 0; fast < 2; fast++ )
+		{
+			grid.octaves = octave;
+			grid.fast = fast != 0;
+
+			Timer timer;
+			grid.output = reference;
+			timer.start(); noise.sample_grid_scalar( grid ); timer.stop();
+			const double msScalar = timer.elapsed_ms();
+
+			grid.output = batched;
+			timer.start(); noise.sample_grid( grid ); timer.stop();
+			const double msBatched = timer.elapsed_ms();
+
+			grid.output = threaded;
+			SimplexJob job { &noise, grid };
+			timer.start(); workers_run( chunks, simplex_rows, &job ); timer.stop();
+			const double msThreaded = timer.elapsed_ms();
+
+			const bool valid = !mismatch( reference, batched ) && !mismatch( reference, threaded );
+			Console::Log( valid ? c_white : c_red,
+				"  %-16s %d octave%s | scalar %8.2f | batched %8.2f | threaded %8.2f | %s",
+				fast ? "sample_fbm_fast" : "sample_fbm", octave, octave == 1 ? " " : "s",
+				count / ( msScalar * 1000.0 ), count / ( msBatched * 1000.0 ), count / ( msThreaded * 1000.0 ),
+				valid ? "bit-exact" : "MISMATCH" );
+		}
+	}
+
+	workers_end();
+	memory_free( threaded );
+	memory_free( batched );
+	memory_free( reference );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static constexpr u32 RANDOM_CHUNK = 65536;
+
+struct RandomJob
+{
+	Random start;
+	u32 *output;
+	u32 count;
+};
+
+
+static void random_chunk( const u32 chunk, void *context )
+{
+	// Each chunk advances a copy of the start generator to its offset, so the result doesn't depend on the split
+	const RandomJob &job = *reinterpret_cast<const RandomJob *>( context );
+	const u32 first = chunk * RANDOM_CHUNK;
+	Random random = job.start;
+	random.advance( first );
+	random.fill_u32( &job.output[first], min( RANDOM_CHUNK, job.count - first ) );
+}
+
+
+static double random_correlation( const u32 *a, const u32 *b, const u32 count )
+{
+	double sumA = 0.0, sumB = 0.0, sumAA = 0.0, sumBB = 0.0, sumAB = 0.0;
+	for( u32 i = 0; i < count; i++ )
+	{
+		const double x = a[i] * 0x1.0p-32;
+		const double y = b[i] * 0x1.0p-32;
+		sumA += x; sumB += y; sumAA += x * x; sumBB += y * y; sumAB += x * y;
+	}
+	const double n = static_cast<double>( count );
+	const double covariance = sumAB / n - ( sumA / n ) * ( sumB / n );
+	const double varianceA = sumAA / n - ( sumA / n ) * ( sumA / n );
+	const double varianceB = sumBB / n - ( sumB / n ) * ( sumB / n );
+	return covariance / sqrt( varianceA * varianceB );
+}
+
+
+void Benchmark::random( const u32 count, const u32 threads )
+{
+	if( count < 1024 ) { Console::Log( c_red, "benchmark random: count must be at least 1024" ); return; }
+	if( threads < 1 || threads > BENCHMARK_THREADS_MAX )
+	{
+		Console::Log( c_red, "benchmark random: threads must be in [1, %d]", BENCHMARK_THREADS_MAX );
+		return;
+	}
+
+	u32 *reference = reinterpret_cast<u32 *>( memory_alloc( count * sizeof( u32 ) ) );
+	u32 *batched = reinterpret_cast<u32 *>( memory_alloc( count * sizeof( u32 ) ) );
+	u32 *threaded = reinterpret_cast<u32 *>( memory_alloc( count * sizeof( u32 ) ) );
+	float *floatsReference = reinterpret_cast<float *>( memory_alloc( count * sizeof( float ) ) );
+	float *floatsBatched = reinterpret_cast<float *>( memory_alloc( count * sizeof( float ) ) );
+	constexpr u64 seed = 0x72616E646F6DULL;
+	Timer timer;
+
+	// Fault the pages in up front so the timings measure generation rather than first-touch page faults
+	memory_set( reference, 0, count * sizeof( u32 ) );
+	memory_set( batched, 0, count * sizeof( u32 ) );
+	memory_set( threaded, 0, count * sizeof( u32 ) );
+	memory_set( floatsReference, 0, count * sizeof( float ) );
+	memory_set( floatsBatched, 0, count * sizeof( float ) );
+
+	// Throughput: base() vs. fill_u32() vs. fill_u32() over chunks split across threads
+	Random random { seed };
+	timer.start();
+	for( u32 i = 0; i < count; i++ ) { reference[i] = random.base(); }
+	timer.stop();
+	const double msBase = timer.elapsed_ms();
+	const u32 nextReference = random.base();
+
+	random.seed( seed );
+	timer.start();
+	random.fill_u32( batched, count );
+	timer.stop();
+	const double msFill = timer.elapsed_ms();
+	const u32 nextBatched = random.base();
+
+	RandomJob job { Random { seed }, threaded, count };
+	workers_begin( threads );
+	timer.start();
+	workers_run( ( count + RANDOM_CHUNK - 1 ) / RANDOM_CHUNK, random_chunk, &job );
+	timer.stop();
+	workers_end();
+	const double msThreaded = timer.elapsed_ms();
+
+	random.seed( seed );
+	timer.start();
+	for( u32 i = 0; i < count; i++ ) { floatsReference[i] = random.next_float( -1.0f, 1.0f ); }
+	timer.stop();
+	const double msNextFloat = timer.elapsed_ms();
+
+	random.seed( seed );
+	timer.start();
+	random.fill_float( floatsBatched, count, -1.0f, 1.0f );
+	timer.stop();
+	const double msFillFloat = timer.elapsed_ms();
+
+	// Exactness: identical sequences, and advance( n ) lands where n base() calls do
+	const bool exactFill = memory_compare( reference, batched, count * sizeof( u32 ) ) == 0 &&
+		nextReference == nextBatched;
+	const bool exactThreaded = memory_compare( reference, threaded, count * sizeof( u32 ) ) == 0;
+	const bool exactFloat = memory_compare( floatsReference, floatsBatched, count * sizeof( float ) ) == 0;
+	bool exactAdvance = true;
+	for( u32 offset = 0; offset < count; offset = offset * 3 + 1 )
+	{
+		random.seed( seed );
+		random.advance( offset );
+		exactAdvance &= random.base() == reference[offset];
+	}
+
+	// Statistics: top-byte chi-square (255 degrees of freedom; 99% of samples fall in [200, 317]), per-bit balance
+	u32 buckets[256] = { };
+	u32 bits[32] = { };
+	for( u32 i = 0; i < count; i++ )
+	{
+		buckets[batched[i] >> 24]++;
+		for( u32 b = 0; b < 32; b++ ) { bits[b] += ( batched[i] >> b ) & 1; }
+	}
+
+	double chiSquare = 0.0;
+	const double expected = count / 256.0;
+	for( u32 i = 0; i < 256; i++ ) { chiSquare += ( buckets[i] - expected ) * ( buckets[i] - expected ) / expected; }
+
+	double bitsSigma = 0.0;
+	for( u32 b = 0; b < 32; b++ )
+	{
+		bitsSigma = max( bitsSigma, fabs( ( bits[b] - count * 0.5 ) / sqrt( count * 0.25 ) ) );
+	}
+
+	// Correlation: lag 1 (i, i + 1), lag 8 (i, i + 8), and neighbouring streams
+	const u32 pairs = count - 8;
+	const double correlationLag1 = random_correlation( batched, batched + 1, pairs );
+	const double correlationLag8 = random_correlation( batched, batched + 8, pairs );
+	Random streamA { seed, 0 };
+	Random streamB { seed, 1 };
+	streamA.fill_u32( reference, count );
+	streamB.fill_u32( threaded, count );
+	const double correlationStreams = random_correlation( reference, threaded, count );
+	const double correlationLimit = 4.0 / sqrt( static_cast<double>( count ) ); // ~4 sigma
+
+	double floatMean = 0.0;
+	for( u32 i = 0; i < count; i++ ) { floatMean += floatsBatched[i]; }
+	floatMean /= count;
+
+	auto rate = [count]( const double ms ) { return count / ( ms * 1000.0 ); };
+	Console::Log( c_white, "benchmark random: %u outputs (M/s)", count );
+	Console::Log( c_white, "  base()        %8.1f | fill_u32()   %8.1f | fill_u32() x%u threads %8.1f",
+		rate( msBase ), rate( msFill ), threads, rate( msThreaded ) );
+	Console::Log( c_white, "  next_float()  %8.1f | fill_float() %8.1f", rate( msNextFloat ), rate( msFillFloat ) );
+	const bool exact = exactFill && exactThreaded && exactFloat && exactAdvance;
+	Console::Log( exact ? c_white : c_red, "  matches base(): fill %s | threaded %s | float %s | advance %s",
+		exactFill ? "ok" : "MISMATCH", exactThreaded ? "ok" : "MISMATCH", exactFloat ? "ok" : "MISMATCH",
+		exactAdvance ? "ok" : "MISMATCH" );
+
+	const bool chiSquareOk = chiSquare > 200.0 && chiSquare < 317.0;
+	Console::Log( chiSquareOk ? c_white : c_red, "  chi-square (top byte) %.1f | worst bit balance %.2f sigma | "
+		"float mean %+.5f", chiSquare, bitsSigma, floatMean );
+	const bool correlationOk = fabs( correlationLag1 ) < correlationLimit &&
+		fabs( correlationLag8 ) < correlationLimit && fabs( correlationStreams ) < correlationLimit;
+	Console::Log( correlationOk ? c_white : c_red, "  correlation: lag 1 %+.5f | lag 8 %+.5f | streams %+.5f "
+		"(limit %.5f)", correlationLag1, correlationLag8, correlationStreams, correlationLimit );
+
+	memory_free( floatsBatched );
+	memory_free( floatsReference );
+	memory_free( threaded );
+	memory_free( batched );
+	memory_free( reference );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if GRAPHICS_ENABLED
+static constexpr u32 GFX_SPRITES = 100000;
+static constexpr u32 GFX_LABELS = 10000;
+static constexpr u32 GFX_COMMANDS = 5000;
+static constexpr u32 GFX_TEXTURES = 4;
+static constexpr u32 GFX_LABEL_STRINGS = 64;
+
+static GfxTexture gfxTextures[GFX_TEXTURES];
+static char gfxLabels[GFX_LABEL_STRINGS][32];
+
+struct GfxBenchmarkCommand
+{
+	float x, y;
+	u32 texture;
+};
+
+
+static u64 gfx_allocations()
+{
+	u64 allocations = 0LLU;
+	for( MemoryTag tag = 0; tag < MEMORYTAG_COUNT; tag++ ) { allocations += memory_tag_stats( tag ).allocations; }
+	return allocations;
+}
+
+
+static void gfx_workload_sprites( const u32 frame )
+{
+	for( u32 i = 0; i < GFX_SPRITES; i++ )
+	{
+		draw_sprite( Sprite::SPRITE_DEFAULT, 0, static_cast<float>( ( i * 7 + frame ) % 1920 ),
+			static_cast<float>( ( i * 13 ) % 1080 ) );
+	}
+}
+
+
+static void gfx_workload_sprites_textures( const u32 frame )
+{
+	// Every quad switches texture: worst case for the quad batch
+	for( u32 i = 0; i < GFX_SPRITES; i++ )
+	{
+		const float x = static_cast<float>( ( i * 7 + frame ) % 1920 );
+		const float y = static_cast<float>( ( i * 13 ) % 1080 );
+		Gfx::quad_batch_write( x, y, x + 16.0f, y + 16.0f, 0, 0, 0xFFFF, 0xFFFF, c_white,
+			&gfxTextures[i % GFX_TEXTURES], 0.0f );
+	}
+}
+
+
+static void gfx_workload_sprites_sorted( const u32 frame )
+{
+	Gfx::quad_batch_sort_begin();
+	gfx_workload_sprites_textures( frame );
+	Gfx::quad_batch_sort_end();
+}
+
+
+static void gfx_workload_text( const u32 frame )
+{
+	const Font font { 0, CoreAssets::fonts[0].ttfs[0] };
+	for( u32 i = 0; i < GFX_LABELS; i++ )
+	{
+		draw_text( font, 14, static_cast<float>( ( i * 37 + frame ) % 1920 ), static_cast<float>( ( i * 17 ) % 1080 ),
+			c_white, gfxLabels[i % GFX_LABEL_STRINGS] );
+	}
+}
+
+
+static void gfx_workload_commands( const u32 frame )
+{
+	// Random commands: 8 passes, 16 shaders, 4 blend states, random depth -- each uploads its model matrix and
+	// writes 4 quads
+	GfxRenderGraph graph;
+	u64 state = 0x676678ULL;
+	for( u32 i = 0; i < GFX_COMMANDS; i++ )
+	{
+		const u64 random = splitmix64( state );
+		GfxRenderCommand command;
+		command.pipeline.shader = CoreGfx::shaders[( random & 0xF ) % CoreGfx::shaderCount].resource;
+		command.pipeline.description.blendSrcFactorColor = ( random >> 4 ) & 0x3;
+		command.sort_key( static_cast<u8>( ( random >> 8 ) & 0x7 ),
+			static_cast<float>( ( random >> 16 ) & 0xFFFF ) / 65535.0f, static_cast<u8>( random >> 32 ) );
+
+		const GfxBenchmarkCommand payload { static_cast<float>( ( i * 7 + frame ) % 1920 ),
+			static_cast<float>( ( i * 13 ) % 1080 ), static_cast<u32>( random >> 40 ) % GFX_TEXTURES };
+		command.work( payload, +[]( GfxBenchmarkCommand &args )
+			{
+				Gfx::set_matrix_model( double_m44_build_translation( args.x, args.y, 0.0 ) );
+				for( int q = 0; q < 4; q++ )
+				{
+					const float x = q * 16.0f;
+					Gfx::quad_batch_write( x, 0.0f, x + 16.0f, 16.0f, 0, 0, 0xFFFF, 0xFFFF, c_white,
+						&gfxTextures[args.texture], 0.0f );
+				}
+			} );
+		graph.add_command( command );
+	}
+
+	Gfx::render_graph_sort( graph );
+	Gfx::render_graph_execute( graph );
+}
+
+
+static void gfx_workload( const char *name, void ( *workload )( const u32 frame ), const u32 ops, const u32 frames )
+{
+	u64 allocations = 0LLU;
+	double ms = 0.0;
+#if PROFILING_GFX
+	GfxStatisticsFrame stats { };
+#endif
+
+	// Frame 0 warms up (batch buffers, render graph command lists, glyph cache) and is not measured
+	for( u32 frame = 0; frame <= frames; frame++ )
+	{
+		const ArenaAllocator::Marker marker = memory_frame().mark();
+		const u64 allocationsStart = gfx_allocations();
+		Timer timer;
+
+		Gfx::frame_begin();
+		workload( frame );
+		Gfx::frame_end();
+
+		const double msFrame = timer.ms();
+		const u64 allocationsFrame = gfx_allocations() - allocationsStart;
+		memory_frame().rewind( marker );
+		if( frame == 0 ) { continue; }
+
+		ms += msFrame;
+		allocations += allocationsFrame;
+	#if PROFILING_GFX
+		const GfxStatisticsFrame &frameStats = Gfx::statsPrevious.frame;
+		stats.drawCalls += frameStats.drawCalls;
+		stats.bufferMaps += frameStats.bufferMaps;
+		stats.textureBinds += frameStats.textureBinds;
+		stats.shaderBinds += frameStats.shaderBinds;
+		stats.quadCount += frameStats.quadCount;
+		stats.batchBreaks += frameStats.batchBreaks;
+		stats.batchBreaksTexture += frameStats.batchBreaksTexture;
+		stats.renderGraphPipelineChanges += frameStats.renderGraphPipelineChanges;
+	#endif
+	}
+
+	Console::Log( c_white, "  %-18s %6u ops | %7.1f ns/op | %7.3f ms/frame | %6.1f allocations/frame", name, ops,
+		ms * 1000000.0 / ( static_cast<double>( ops ) * frames ), ms / frames,
+		static_cast<double>( allocations ) / frames );
+#if PROFILING_GFX
+	Console::Log( c_gray, "  %-18s per frame: %u quads, %u draws, %u batch breaks (%u texture), %u texture binds, "
+		"%u shader binds, %u buffer maps, %u pipeline changes", "", stats.quadCount / frames,
+		stats.drawCalls / frames, stats.batchBreaks / frames, stats.batchBreaksTexture / frames,
+		stats.textureBinds / frames, stats.shaderBinds / frames, stats.bufferMaps / frames,
+		stats.renderGraphPipelineChanges / frames );
+#endif
+}
+#endif
+
+
+void Benchmark::gfx( const u32 frames )
+{
+#if GRAPHICS_ENABLED
+	if( frames == 0 ) { Console::Log( c_red, "benchmark gfx: frames must be at least 1" ); return; }
+	if( CoreGfx::state.rendering )
+	{
+		Console::Log( c_red, "benchmark gfx: must run between frames (e.g. from the terminal of a headless build)" );
+		return;
+	}
+
+	for( u32 i = 0; i < GFX_TEXTURES; i++ )
+	{
+		u32 texel = 0xFFFFFFFF;
+		gfxTextures[i].init_2d( &texel, 1, 1, GfxColorFormat_R8G8B8A8_FLOAT );
+	}
+	for( u32 i = 0; i < GFX_LABEL_STRINGS; i++ )
+	{
+		snprintf( gfxLabels[i], sizeof( gfxLabels[i] ), "Label %02u: %u HP", i, i * 97 % 1000 );
+	}
+
+	Console::Log( c_white, "benchmark gfx: %u frames per workload (CPU submission cost only on gfx/none)", frames );
+	gfx_workload( "sprites", gfx_workload_sprites, GFX_SPRITES, frames );
+	gfx_workload( "sprites 4 tex", gfx_workload_sprites_textures, GFX_SPRITES, frames );
+	gfx_workload( "sprites 4 tex sort", gfx_workload_sprites_sorted, GFX_SPRITES, frames );
+	if( CoreAssets::fontCount > 0 ) { gfx_workload( "text labels", gfx_workload_text, GFX_LABELS, frames ); }
+	gfx_workload( "render commands", gfx_workload_commands, GFX_COMMANDS, frames );
+#if !PROFILING_GFX
+	Console::Log( c_gray, "  (GfxStatistics counters require a debug build)" );
+#endif
+#if COMPILE_HEADLESS
+	Console::Log( c_gray, "  (headless: the font system has no glyph atlas, so text labels emit no quads)" );
+#endif
+
+	for( u32 i = 0; i < GFX_TEXTURES; i++ ) { gfxTextures[i].free(); }
+#else
+	Console::Log( c_red, "benchmark gfx: requires a graphics backend "
+		"(gfx/none: set \"gfxFrontend\" in configs.json)" );
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool CoreBenchmark::init()
+{
+	CMD_BENCHMARK_HASHMAP = Console::command_init( "benchmark hashmap <count>",
+		"Time insert/find/erase of HashMap vs. FlatHashMap",
+		CONSOLE_COMMAND_LAMBDA { Benchmark::hashmap( Console::get_parameter_u32( 0, 1000000 ) ); } );
+
+	CMD_BENCHMARK_RENDER_GRAPH = Console::command_init( "benchmark render_graph <count>",
+		"Time GfxRenderGraph sorting: comparator quicksort vs. 64-bit key radix sort",
+		CONSOLE_COMMAND_LAMBDA { Benchmark::render_graph( Console::get_parameter_u32( 0, 100000 ) ); } );
+
+	CMD_BENCHMARK_RENDER_GRAPH_RECORD = Console::command_init( "benchmark render_graph_record <count> <threads>",
+		"Time GfxRenderGraph recording: 1 thread vs. per-thread GfxRenderGraphRecorders + merge",
+		CONSOLE_COMMAND_LAMBDA
+		{
+			Benchmark::render_graph_record( Console::get_parameter_u32( 0, 100000 ),
+				Console::get_parameter_u32( 1, 4 ) );
+		} );
+
+	CMD_BENCHMARK_PRINT = Console::command_init( "benchmark print <count>",
+		"Time PrintLn() on the calling thread: synchronous printf vs. the asynchronous terminal writer",
+		CONSOLE_COMMAND_LAMBDA { Benchmark::print( Console::get_parameter_u32( 0, 10000 ) ); } );
+
+	CMD_BENCHMARK_THREADED_WRITER = Console::command_init( "benchmark threaded_writer <count> <size>",
+		"Time ThreadedWriterSPSC producer -> consumer: copies vs. zero-copy reservations vs. batched commits",
+		CONSOLE_COMMAND_LAMBDA
+		{
+			Benchmark::threaded_writer( Console::get_parameter_u32( 0, 200000 ),
+				Console::get_parameter_u32( 1, 4096 ) );
+		} );
+
+	CMD_BENCHMARK_REPLICATION = Console::command_init( "benchmark replication <count>",
+		"Time & measure NETWORKED object replication: per-client delta snapshots vs. full snapshots",
+		CONSOLE_COMMAND_LAMBDA { Benchmark::replication( Console::get_parameter_u32( 0, 10000 ) ); } );
+
+	CMD_BENCHMARK_SAVE = Console::command_init( "benchmark save <count>",
+		"Time ObjectContext save games: blocking save() vs. snapshot + background save_async()",
+		CONSOLE_COMMAND_LAMBDA { Benchmark::save( Console::get_parameter_u32( 0, 100000 ) ); } );
+
+	CMD_BENCHMARK_TEXTURE_COMPRESSION = Console::command_init( "benchmark texture_compression <size>",
+		"Time BCn block compression: encode & decode per format, compression ratio, and round-trip PSNR",
+		CONSOLE_COMMAND_LAMBDA { Benchmark::texture_compression( Console::get_parameter_u32( 0, 1024 ) ); } );
+
+	CMD_BENCHMARK_SKELETON = Console::command_init( "benchmark skeleton <count> <threads>",
+		"Time Skeleton2D::update() per instance vs. Skeleton2DBatch (shared SoA poses, optionally threaded)",
+		CONSOLE_COMMAND_LAMBDA { Benchmark::skeleton( Console::get_parameter_u32( 0, 1000 ),
+			Console::get_parameter_u32( 1, 4 ) ); } );
+
+	CMD_BENCHMARK_SIMPLEX = Console::command_init( "benchmark simplex <size> <threads>",
+		"Compare scalar, batched (SIMD), and threaded Simplex fbm grid sampling across octave counts",
+		CONSOLE_COMMAND_LAMBDA { Benchmark::simplex( Console::get_parameter_u32( 0, 1024 ),
+			Console::get_parameter_u32( 1, 4 ) ); } );
+
+	CMD_BENCHMARK_RANDOM = Console::command_init( "benchmark random <count> <threads>",
+		"Compare Random::base() with the bulk fill_u32()/fill_float() (and threaded jump-ahead), plus sanity stats",
+		CONSOLE_COMMAND_LAMBDA { Benchmark::random( Console::get_parameter_u32( 0, 16777216 ),
+			Console::get_parameter_u32( 1, 4 ) ); } );
+
+	CMD_BENCHMARK_GFX = Console::command_init( "benchmark gfx <frames>",
+		"Time the CPU side of the gfx frontend: sprites, quad batch breaks, text, and sorted render commands",
+		CONSOLE_COMMAND_LAMBDA { Benchmark::gfx( Console::get_parameter_u32( 0, 10 ) ); } );
+
+	return true;
+}
+
+
+bool CoreBenchmark::free()
+{
+	Console::command_free( CMD_BENCHMARK_HASHMAP );
+	Console::command_free( CMD_BENCHMARK_RENDER_GRAPH );
+	Console::command_free( CMD_BENCHMARK_RENDER_GRAPH_RECORD );
+	Console::command_free( CMD_BENCHMARK_PRINT );
+	Console::command_free( CMD_BENCHMARK_THREADED_WRITER );
+	Console::command_free( CMD_BENCHMARK_REPLICATION );
+	Console::command_free( CMD_BENCHMARK_SAVE );
+	Console::command_free( CMD_BENCHMARK_TEXTURE_COMPRESSION );
+	Console::command_free( CMD_BENCHMARK_SKELETON );
+	Console::command_free( CMD_BENCHMARK_SIMPLEX );
+	Console::command_free( CMD_BENCHMARK_RANDOM );
+	Console::command_free( CMD_BENCHMARK_GFX );
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <core/types.hpp>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace CoreBenchmark
+{
+	extern bool init();
+	extern bool free();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Benchmark
+{
+	// Console: "benchmark hashmap <count>"
+	extern void hashmap( u32 count );
+
+	// Console: "benchmark render_graph <count>"
+	extern void render_graph( u32 count );
+
+	// Console: "benchmark render_graph_record <count> <threads>"
+	extern void render_graph_record( u32 count, u32 threads );
+
+	// Console: "benchmark print <count>"
+	extern void print( u32 count );
+
+	// Console: "benchmark threaded_writer <count> <size>"
+	extern void threaded_writer( u32 count, u32 size );
+
+	// Console: "benchmark replication <count>"
+	extern void replication( u32 count );
+
+	// Console: "benchmark save <count>"
+	extern void save( u32 count );
+
+	// Console: "benchmark texture_compression <size>"
+	extern void texture_compression( u32 size );
+
+	// Console: "benchmark skeleton <count> <threads>"
+	extern void skeleton( u32 count, u32 threads );
+
+	// Console: "benchmark simplex <size> <threads>"
+	extern void simplex( u32 size, u32 threads );
+
+	// Console: "benchmark random <count> <threads>"
+	extern void random( u32 count, u32 threads );
+
+	// Console: "benchmark gfx <frames>"
+	extern void gfx( u32 frames );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
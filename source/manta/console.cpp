@@ -1,6 +1,7 @@
 #include <manta/console.hpp>
 
 #include <core/list.hpp>
+#include <core/memory.hpp>
 #include <core/string.hpp>
 #include <core/math.hpp>
 #include <core/color.hpp>
@@ -9,11 +10,13 @@
 #include <manta/input.hpp>
 #include <manta/window.hpp>
 #include <manta/draw.hpp>
+#include <manta/gfx.hpp>
 #include <manta/text.hpp>
 #include <manta/ui.hpp>
 #include <manta/objects.hpp>
 #include <manta/time.hpp>
 #include <manta/thread.hpp>
+#include <manta/terminal.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -428,6 +431,82 @@ struct LogLine
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+class LogRing
+{
+	// Fixed capacity ring of LogLines: once full, add() overwrites the oldest line in O(1) rather than shifting
+	// the whole log down. Indices are logical (0 = oldest)
+
+public:
+	class Iterator
+	{
+	public:
+		Iterator( LogRing &ring, const usize index ) : ring { ring }, index { index } { }
+		LogLine &operator*() const { return ring[index]; }
+		Iterator &operator++() { index++; return *this; }
+		bool operator!=( const Iterator &other ) const { return index != other.index; }
+
+	private:
+		LogRing &ring;
+		usize index;
+	};
+
+	void init( const usize capacity, Allocator *allocator )
+	{
+		Assert( capacity >= 1 );
+		MemoryAssert( data == nullptr );
+		this->capacity = capacity;
+		this->allocator = allocator;
+		data = reinterpret_cast<LogLine *>( memory_alloc( allocator, capacity * sizeof( LogLine ) ) );
+		clear();
+	}
+
+	void free()
+	{
+		if( data == nullptr ) { return; }
+		memory_free( allocator, data, capacity * sizeof( LogLine ) );
+		data = nullptr;
+	}
+
+	void clear()
+	{
+		head = 0;
+		current = 0;
+	}
+
+	void add( const LogLine &line )
+	{
+		Assert( data != nullptr );
+		if( current == capacity )
+		{
+			data[head] = line;
+			head = ( head + 1 ) % capacity;
+			return;
+		}
+		data[( head + current ) % capacity] = line;
+		current++;
+	}
+
+	usize count() const { return current; }
+
+	LogLine &operator[]( const usize index )
+	{
+		Assert( index < current );
+		return data[( head + index ) % capacity];
+	}
+
+	Iterator begin() { return Iterator { *this, 0 }; }
+	Iterator end() { return Iterator { *this, current }; }
+
+private:
+	LogLine *data = nullptr;
+	Allocator *allocator = nullptr;
+	usize capacity = 0;
+	usize head = 0;
+	usize current = 0;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 class ConsoleRegion
 {
 public:
@@ -643,7 +722,7 @@ namespace CoreConsole
 	static TextEditor input;
 	static char buffer[LINE_SIZE];
 
-	static List<LogLine> log;
+	static LogRing log;
 	static List<Token> tokens;
 	static List<Command> commands;
 	static List<CommandHistory> history;
@@ -770,11 +849,12 @@ bool CoreConsole::init()
 	input->defaultFormat = format;
 
 	// Initalize Memory
-	CoreConsole::log.init( LOG_MAX );
-	CoreConsole::tokens.init();
-	CoreConsole::commands.init();
-	CoreConsole::history.init( HISTORY_MAX );
-	for( int i = 0; i < COMMANDCOMPARE_COUNT; i++ ) { CoreConsole::candidates[i].init(); }
+	Allocator *allocator = memory_heap( MemoryTag_Console );
+	CoreConsole::log.init( LOG_MAX, allocator );
+	CoreConsole::tokens.init( 1, allocator );
+	CoreConsole::commands.init( 1, allocator );
+	CoreConsole::history.init( HISTORY_MAX, allocator );
+	for( int i = 0; i < COMMANDCOMPARE_COUNT; i++ ) { CoreConsole::candidates[i].init( 1, allocator ); }
 
 	// System Ready
 	CoreConsole::initialized = true;
@@ -826,6 +906,66 @@ bool CoreConsole::init()
 			Console::Log( c_lime, "fps %u", Frame::fpsLimit );
 		} );
 
+	Console::command_init( "memory", "Lists live/peak CPU memory per allocation tag", CONSOLE_COMMAND_LAMBDA
+		{
+			Console::Log( c_white, "" );
+			for( int tag = MEMORYTAG_COUNT - 1; tag >= 0; tag-- )
+			{
+				const MemoryTagStats stats = memory_tag_stats( static_cast<MemoryTag>( tag ) );
+				if( stats.allocations == 0 ) { continue; }
+				Console::Log( c_white, "  %-8s  live: %9.2f kb  peak: %9.2f kb  allocs: %lld",
+					memory_tag_name( static_cast<MemoryTag>( tag ) ),
+					KB( stats.bytesLive ), KB( stats.bytesPeak ), stats.allocations );
+			}
+			Console::Log( c_yellow, "Memory (tagged allocations):" );
+		} );
+
+	Console::command_init( "log_file <path>", "Appends terminal output to a binary log file (no path: closes it)",
+		CONSOLE_COMMAND_LAMBDA
+		{
+			const char *path = Console::get_parameter_string( 0 );
+			if( path[0] == '\0' )
+			{
+				Terminal::log_file_close();
+				Console::Log( c_lime, "log_file closed" );
+				return;
+			}
+
+			if( !Terminal::log_file_open( path ) )
+			{
+				Console::Log( c_red, "log_file: failed to open '%s'", path );
+				return;
+			}
+
+			Console::Log( c_lime, "log_file %s", path );
+		} );
+
+#if GRAPHICS_ENABLED
+	Console::command_init( "gfx_multi_texture [enabled]", "Toggles multi-texture quad batching",
+		CONSOLE_COMMAND_LAMBDA
+		{
+			const bool enabled = Console::get_parameter_toggle( 0, CoreGfx::state.quadBatchMultiTexture );
+			Gfx::quad_batch_multi_texture( enabled );
+			Console::Log( c_lime, "gfx_multi_texture %s", enabled ? "true" : "false" );
+		} );
+#endif
+
+#if PROFILING_GFX
+	Console::command_init( "gfx", "Lists the previous frame's draw & quad batch statistics", CONSOLE_COMMAND_LAMBDA
+		{
+			const GfxStatisticsFrame &frame = Gfx::statsPrevious.frame;
+			Console::Log( c_white, "" );
+			Console::Log( c_white, "  Batch Breaks: %u (texture: %u)", frame.batchBreaks, frame.batchBreaksTexture );
+			Console::Log( c_white, "  Batch Draws: %u", frame.batchDraws );
+			Console::Log( c_white, "  Quads: %u", frame.quadCount );
+			Console::Log( c_white, "  Shader Binds: %u", frame.shaderBinds );
+			Console::Log( c_white, "  Texture Binds: %u", frame.textureBinds );
+			Console::Log( c_white, "  Vertices: %u", frame.vertexCount );
+			Console::Log( c_white, "  Draw Calls: %u", frame.drawCalls );
+			Console::Log( c_yellow, "Gfx (previous frame):" );
+		} );
+#endif
+
 #if 0
 	// Standard In Listener
 	CoreConsole::stdinAlive = false;
@@ -1450,8 +1590,7 @@ void CoreConsole::Log( Color color, const char *command, const char *message )
 	// Reset log seek position
 	CoreConsole::logIndex = USIZE_MAX;
 
-	// Add line
-	if( CoreConsole::log.count() >= LOG_MAX ) { CoreConsole::log.remove( 0 ); }
+	// Add line (overwrites the oldest once LOG_MAX lines are stored)
 	CoreConsole::log.add( LogLine { color, command, message } );
 	CoreConsole::logRegion.set_position_percent( 0.0f, true );
 	CoreConsole::logRegion.set_position_percent( 0.0f, false );
@@ -2389,7 +2528,8 @@ void Console::clear_log()
 
 void Console::dump_log( const char *path )
 {
-	String dump;
+	MemoryScratchScope scratch;
+	String dump { scratch };
 	for( const LogLine &line : CoreConsole::log ) { dump.append( line.string ).append( "\n" ); }
 	dump.save( path );
 }
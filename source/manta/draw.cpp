@@ -585,12 +585,8 @@ void draw_text( Font font, u16 size, float x, float y, Color color, const char *
 			const u16 u2 = ( glyphInfo.u + glyphInfo.width ) * uvScale;
 			const u16 v2 = ( glyphInfo.v + glyphInfo.height ) * uvScale;
 
-			// TODO: Implement this properly...
-			if( UNLIKELY( Gfx::quad_batch_can_break() ) ||
-			    UNLIKELY( CoreGfx::state.boundTexture[0] != CoreFonts::glyphAtlasTexture.resource ) )
-			{
-				CoreFonts::update();
-			}
+			// Newly packed glyphs must be uploaded before the batch flushes
+			if( UNLIKELY( Gfx::quad_batch_can_break() ) ) { CoreFonts::update(); }
 
 			Gfx::quad_batch_write( glyphX1, glyphY1, glyphX2, glyphY2,
 				u1, v1, u2, v2, color, &CoreFonts::glyphAtlasTexture, 0.0f );
@@ -599,6 +595,8 @@ void draw_text( Font font, u16 size, float x, float y, Color color, const char *
 		// Advance Character
 		offsetX += glyphInfo.advance;
 	}
+
+	CoreFonts::update();
 #endif
 }
 
@@ -5,6 +5,7 @@
 #include <core/debug.hpp>
 #include <core/types.hpp>
 #include <core/string.hpp>
+#include <core/memory.hpp>
 
 #include <manta/terminal.hpp>
 #include <manta/profiler.hpp>
@@ -19,6 +20,8 @@
 #include <manta/fonts.hpp>
 #include <manta/ui.hpp>
 #include <manta/network.hpp>
+#include <manta/benchmark.hpp>
+#include <manta/replay.hpp>
 
 #include <manta/text.hpp>
 #include <manta/input.hpp>
@@ -32,35 +35,197 @@
 
 namespace Engine
 {
+	// Subsystem initialization is expressed as a dependency graph. Nodes without main-thread affinity are
+	// dispatched to a small pool of init workers as soon as their dependencies complete, so e.g. audio sample
+	// setup overlaps window & graphics creation on the main thread.
+
+	enum_type( InitNode, int )
+	{
+		InitNode_Terminal,
+		InitNode_Steamworks,
+		InitNode_Assets,
+		InitNode_Window,
+		InitNode_Gfx,
+		InitNode_Console,
+		InitNode_Audio,
+		InitNode_Objects,
+		InitNode_Fonts,
+		InitNode_UI,
+		InitNode_Network,
+		INITNODE_COUNT,
+	};
+
+	#define INIT_DEPENDS( node ) ( 1U << ( node ) )
+
+	struct InitNodeInfo
+	{
+		const char *name;
+		const char *description;
+		bool ( *init )();
+		u32 dependencies; // Bitmask of INIT_DEPENDS( InitNode )
+		bool mainThread;
+	};
+
+	static bool init_window() { return CoreWindow::init(); }
+	static bool init_steamworks() { STEAMWORKS( return Steamworks::init() ); return true; }
+	static bool init_fonts() { return COMPILE_HEADLESS || CoreFonts::init(); }
+	static bool init_ui() { return COMPILE_HEADLESS || CoreUI::init(); }
+
+	static const InitNodeInfo INIT_NODES[INITNODE_COUNT] =
+	{
+		{ "Terminal", "terminal", CoreTerminal::init, 0, false },
+		{ "Steamworks", "Steam API", init_steamworks, 0, true },
+		{ "Assets", "assets", CoreAssets::init, 0, false },
+		{ "Window", "window", init_window, 0, true },
+		{ "Gfx", "graphics system", CoreGfx::init,
+			INIT_DEPENDS( InitNode_Window ) | INIT_DEPENDS( InitNode_Assets ), true },
+		{ "Console", "console system", CoreConsole::init,
+			INIT_DEPENDS( InitNode_Terminal ) | INIT_DEPENDS( InitNode_Objects ), false },
+		{ "Audio", "audio system", CoreAudio::init, // WASAPI: COM apartment must outlive init
+			INIT_DEPENDS( InitNode_Assets ) | INIT_DEPENDS( InitNode_Console ), AUDIO_WASAPI },
+		{ "Objects", "object system", CoreObjects::init, 0, false },
+		{ "Fonts", "font system", init_fonts,
+			INIT_DEPENDS( InitNode_Assets ) | INIT_DEPENDS( InitNode_Gfx ), true },
+		{ "UI", "UI system", init_ui, INIT_DEPENDS( InitNode_Objects ), false },
+		{ "Network", "network system", CoreNetwork::init, 0, false },
+	};
+
+	static constexpr int INIT_WORKERS = 3;
+
+	static ConcurrentQueue<int> initQueueMain;
+	static ConcurrentQueue<int> initQueueWorker;
+	static Atomic_U32 initPending[INITNODE_COUNT];
+	static Atomic_U32 initCompleted;
+	static Atomic_U32 initFailed; // InitNode + 1 of the first failure (0 if none)
+	static Atomic_U32 initWorkersAlive;
+	static int initWorkers = 0;
+
+	static double initTimeStart[INITNODE_COUNT];
+	static double initTimeEnd[INITNODE_COUNT];
+	static bool initOnWorker[INITNODE_COUNT];
+
+	static void init_dispatch( const int node )
+	{
+		if( INIT_NODES[node].mainThread || initWorkers == 0 ) { initQueueMain.enqueue( node ); }
+		else { initQueueWorker.enqueue( node ); }
+	}
+
+	static void init_run( const int node, const bool worker )
+	{
+		// Run (dependents of a failed node still complete so the graph drains)
+		initOnWorker[node] = worker;
+		initTimeStart[node] = Time::value();
+		if( initFailed.load() == 0 && !INIT_NODES[node].init() ) { initFailed.store( node + 1 ); }
+		initTimeEnd[node] = Time::value();
+
+		// Release dependents
+		for( int i = 0; i < INITNODE_COUNT; i++ )
+		{
+			if( ( INIT_NODES[i].dependencies & INIT_DEPENDS( node ) ) == 0 ) { continue; }
+			if( initPending[i].fetch_sub( 1 ) == 1 ) { init_dispatch( i ); }
+		}
+
+		// Wake the main thread once the graph has drained
+		if( initCompleted.fetch_add( 1 ) + 1 == INITNODE_COUNT ) { initQueueMain.enqueue( -1 ); }
+	}
+
+	static THREAD_FUNCTION( init_worker )
+	{
+		int node;
+		while( initQueueWorker.dequeue( node, true ) && node >= 0 ) { init_run( node, true ); }
+		initWorkersAlive.fetch_sub( 1 );
+		return 0;
+	}
+
+	static void init_timing_log( const double timeStart, const double timeEnd )
+	{
+		PrintLn( PrintColor_Blue, "Engine: initialized in %.3f ms (%d workers)",
+			( timeEnd - timeStart ) * 1000.0, initWorkers );
+
+		for( int i = 0; i < INITNODE_COUNT; i++ )
+		{
+			PrintLn( PrintColor_Blue, "  %-12s %8.3f ms  (+%.3f ms, %s)", INIT_NODES[i].name,
+				( initTimeEnd[i] - initTimeStart[i] ) * 1000.0, ( initTimeStart[i] - timeStart ) * 1000.0,
+				initOnWorker[i] ? "worker" : "main" );
+		}
+	}
+
 	static bool init( int argc, char **argv )
 	{
 		ErrorReturnIf( !CoreThread::init(), false, "Engine: failed to initialize thread" );
-		ErrorReturnIf( !CoreTerminal::init(), false, "Engine: failed to initialize terminal" );
-		STEAMWORKS( ErrorReturnIf( !Steamworks::init(), false, "Failed to initialize Steam API!" ) );
-		ErrorReturnIf( !CoreAssets::init(), false, "Engine: failed to initialize assets" );
 		ErrorReturnIf( !CoreTime::init(), false, "Engine: failed to initialize timer" );
-		ErrorReturnIf( !CoreWindow::init(), false, "Engine: failed to initialize window" );
-		ErrorReturnIf( !CoreGfx::init(), false, "Engine: failed to initialize graphics system" );
-		ErrorReturnIf( !CoreConsole::init(), false, "Engine: failed to initialize console system" );
-		ErrorReturnIf( !CoreAudio::init(), false, "Engine: failed to initialize audio system" );
-		ErrorReturnIf( !CoreObjects::init(), false, "Engine: failed to initialize object system" );
-		ErrorReturnIf( !CoreFonts::init(), false, "Engine: failed to initialize font system" );
-		ErrorReturnIf( !CoreUI::init(), false, "Engine: failed to initialize UI system" );
-		ErrorReturnIf( !CoreNetwork::init(), false, "Engine: failed to initialize network system" );
-
-		PROFILING( CoreProfiler::PROFILER.init() );
+		const double timeStart = Time::value();
+
+		// Graph
+		initQueueMain.init( INITNODE_COUNT + 1 );
+		initQueueWorker.init( INITNODE_COUNT + INIT_WORKERS );
+		initCompleted.init( 0 );
+		initFailed.init( 0 );
+		initWorkersAlive.init( 0 );
+		for( int i = 0; i < INITNODE_COUNT; i++ )
+		{
+			u32 dependencies = 0;
+			for( int j = 0; j < INITNODE_COUNT; j++ ) { dependencies += ( INIT_NODES[i].dependencies >> j ) & 1; }
+			initPending[i].init( dependencies );
+		}
+
+		// Workers (the 'none' thread backend runs the whole graph on the main thread)
+		initWorkers = 0;
+		for( int i = 0; i < INIT_WORKERS; i++ )
+		{
+			initWorkersAlive.fetch_add( 1 );
+			void *thread = Thread::create( init_worker );
+			if( thread == nullptr ) { initWorkersAlive.fetch_sub( 1 ); break; }
+			Thread::free( thread );
+			initWorkers++;
+		}
+
+		// Roots
+		for( int i = 0; i < INITNODE_COUNT; i++ )
+		{
+			if( INIT_NODES[i].dependencies == 0 ) { init_dispatch( i ); }
+		}
+
+		// Main Thread
+		int node;
+		while( initQueueMain.dequeue( node, true ) && node >= 0 ) { init_run( node, false ); }
+
+		for( int i = 0; i < initWorkers; i++ ) { initQueueWorker.enqueue( -1 ); }
+		Thread::wait_until( []() { return initWorkersAlive.load() == 0; } );
+		initQueueWorker.free();
+		initQueueMain.free();
+
+		const u32 failed = initFailed.load();
+		ErrorReturnIf( failed != 0, false, "Engine: failed to initialize %s", INIT_NODES[failed - 1].description );
+
+		// Timing
+		bool timing = false;
+		DEBUG( timing = true; )
+		for( int i = 1; i < argc; i++ ) { if( strcmp( argv[i], "-init-timing" ) == 0 ) { timing = true; } }
+		if( timing ) { init_timing_log( timeStart, Time::value() ); }
+
+		ErrorReturnIf( !CoreBenchmark::init(), false, "Engine: failed to initialize benchmarks" );
+
+		PROFILING( CoreProfiler::PROFILER.init( argc, argv ) );
 		PROFILING( CoreProfiler::PROFILER.capturing = true; );
 
+		ErrorReturnIf( !CoreReplay::init( argc, argv ), false, "Engine: failed to initialize input replay" );
+
 		return true;
 	}
 
 	static bool free()
 	{
+		ErrorReturnIf( !CoreReplay::free(), false, "Engine: failed to free input replay" );
 		PROFILING( CoreProfiler::PROFILER.free() );
 
+		ErrorReturnIf( !CoreBenchmark::free(), false, "Engine: failed to free benchmarks" );
+
 		ErrorReturnIf( !CoreNetwork::free(), false, "Engine: failed to free Network system" );
+	#if !COMPILE_HEADLESS
 		ErrorReturnIf( !CoreUI::free(), false, "Engine: failed to free UI system" );
 		ErrorReturnIf( !CoreFonts::free(), false, "Engine: failed to free font system" );
+	#endif
 		ErrorReturnIf( !CoreObjects::free(), false, "Engine: failed to free object system" );
 		ErrorReturnIf( !CoreConsole::free(), false, "Engine: failed to free console system" );
 		ErrorReturnIf( !CoreGfx::free(), false, "Engine: failed to free graphics system" );
@@ -83,6 +248,82 @@ namespace Engine
 	static bool painted = false; // Delay showing the window until after a frame is rendered
 	static bool exiting = false; // Terminates the main loop
 
+#if COMPILE_HEADLESS
+	struct TickStats
+	{
+		double timeTotal = 0.0;
+		double timeMax = 0.0;
+		double timeReport = 0.0;
+		u32 ticks = 0;
+		u32 overruns = 0;
+	};
+
+	static void tick_stats( TickStats &stats, const double tickTime, const double tickInterval, const double now )
+	{
+		stats.timeTotal += tickTime;
+		stats.timeMax = max( stats.timeMax, tickTime );
+		stats.overruns += tickTime > tickInterval;
+		stats.ticks++;
+
+		if( HEADLESS_TICK_STATS <= 0 || now - stats.timeReport < HEADLESS_TICK_STATS ) { return; }
+
+		const double average = stats.timeTotal / stats.ticks;
+		PrintLn( PrintColor_Blue, "Tick: %u ticks @ %d Hz | avg %.3f ms | max %.3f ms | budget %.1f%% | overruns %u",
+			stats.ticks, HEADLESS_TICK_RATE, average * 1000.0, stats.timeMax * 1000.0,
+			average / tickInterval * 100.0, stats.overruns );
+
+		stats = TickStats { };
+		stats.timeReport = now;
+	}
+
+	static void main_headless( const ProjectCallbacks &project )
+	{
+		// Fixed timestep: sleep until the next tick instead of busy-waiting (see Frame::regulate)
+		constexpr double tickInterval = 1.0 / HEADLESS_TICK_RATE;
+		double tickNext = Time::value();
+		TickStats stats;
+		stats.timeReport = tickNext;
+
+		while( !exiting )
+		{
+			const double tickStart = Time::value();
+			Delta replayDelta;
+			const bool replayed = CoreReplay::frame_start( replayDelta );
+			Frame::start_fixed( replayed ? replayDelta : tickInterval );
+			PROFILING( CoreProfiler::PROFILER.frame_start() );
+			{
+				PROFILE_SCOPE( "Tick" );
+
+				// Pre-Engine
+				STEAMWORKS( Steamworks::callbacks() );
+				CoreTerminal::update();
+				Input::update( Frame::delta );
+				CoreReplay::frame_input();
+
+				// Project
+				project.update( Frame::delta );
+			}
+			PROFILING( CoreProfiler::PROFILER.frame_end() );
+			CoreReplay::frame_end();
+			Frame::end_fixed();
+			memory_frame_reset();
+
+			// Replay: run recorded ticks back-to-back
+			const double now = Time::value();
+			if( replayed ) { tickNext = now; continue; }
+
+			// Stats
+			tick_stats( stats, now - tickStart, tickInterval, now );
+
+			// Schedule
+			tickNext += tickInterval;
+			if( now - tickNext > tickInterval * HEADLESS_TICK_RATE ) { tickNext = now; } // >1s behind: drop ticks
+			const int sleep = static_cast<int>( ( tickNext - now ) * 1000.0 ); // miliseconds
+			if( sleep > 0 ) { Thread::sleep( sleep ); }
+		}
+	}
+#endif
+
 	int main( int argc, char **argv, const ProjectCallbacks &project )
 	{
 		// Seg Fault Listener
@@ -104,9 +345,15 @@ namespace Engine
 			ErrorIf( !Engine::init( argc, argv ), "Failed to initialize the engine" );
 			ErrorIf( !project.init( argc, argv ), "Failed to initialize the project" );
 
+		#if COMPILE_HEADLESS
+			main_headless( project );
+		#else
 			while( !exiting )
 			{
-				Frame::start();
+				// Replay: recorded delta without frame regulation
+				Delta replayDelta;
+				const bool replayed = CoreReplay::frame_start( replayDelta );
+				if( replayed ) { Frame::start_fixed( replayDelta ); } else { Frame::start(); }
 				PROFILING( CoreProfiler::PROFILER.frame_start() );
 				{
 					PROFILE_SCOPE( "Frame" );
@@ -116,6 +363,7 @@ namespace Engine
 					CoreTerminal::update();
 					Input::update( Frame::delta );
 					Window::update( Frame::delta );
+					CoreReplay::frame_input();
 					Input::reset_active();
 
 					// Project
@@ -128,8 +376,11 @@ namespace Engine
 					if( !painted ) { CoreWindow::show(); painted = true; }
 				}
 				PROFILING( CoreProfiler::PROFILER.frame_end() );
-				Frame::end();
+				CoreReplay::frame_end();
+				if( replayed ) { Frame::end_fixed(); } else { Frame::end(); }
+				memory_frame_reset();
 			}
+		#endif
 
 		#if 0
 			// Free Project & Engine (if restarting -- otherwise no need to cleanup)
@@ -98,15 +98,20 @@ bool CoreFonts::FontGlyphInfo::get_glyph_metrics( u32 codepoint, u16 ttf, u16 si
 
 bool CoreFonts::init()
 {
+#if COMPILE_HEADLESS
+	// Headless: no glyph atlas (CoreFonts::get() returns a "null key")
+	return true;
+#endif
+
 	// Init Fonts Table
 	Assert( data == nullptr );
 	constexpr usize size = CoreFonts::FONTS_GROUP_SIZE *
 		CoreFonts::FONTS_TABLE_DEPTH * CoreFonts::FONTS_TABLE_SIZE * sizeof( CoreFonts::FontGlyphEntry );
-	data = reinterpret_cast<CoreFonts::FontGlyphEntry *>( memory_alloc( size ) );
+	data = reinterpret_cast<CoreFonts::FontGlyphEntry *>( memory_alloc( memory_heap( MemoryTag_Fonts ), size ) );
 	memory_set( data, 0, size ); // Zero memory
 
 	// Load Font Metrics
-	fontInfos.init( CoreAssets::fontCount );
+	fontInfos.init( CoreAssets::fontCount, memory_heap( MemoryTag_Fonts ) );
 	for( u16 ttf = 0; ttf < CoreAssets::ttfCount; ttf++ )
 	{
 		// Get Font Info
@@ -117,7 +122,7 @@ bool CoreFonts::init()
 	}
 
 	// Init dirtyGlyphs list
-	dirtyGlyphs.init();
+	dirtyGlyphs.init( 1, memory_heap( MemoryTag_Fonts ) );
 
 	// Init Texture2DBuffer
 	glyphAtlasTextureBuffer.init( CoreFonts::FONTS_TEXTURE_SIZE, CoreFonts::FONTS_TEXTURE_SIZE );
@@ -140,7 +145,9 @@ bool CoreFonts::free()
 	// Free RTFonts table
 	if( data != nullptr )
 	{
-		memory_free( data );
+		constexpr usize size = CoreFonts::FONTS_GROUP_SIZE *
+			CoreFonts::FONTS_TABLE_DEPTH * CoreFonts::FONTS_TABLE_SIZE * sizeof( CoreFonts::FontGlyphEntry );
+		memory_free( memory_heap( MemoryTag_Fonts ), data, size );
 		data = nullptr;
 	}
 
@@ -173,6 +180,11 @@ CoreFonts::FontGlyphInfo &CoreFonts::get( FontGlyphKey key )
 	// a single L1 cache line. Since the hashing function can produce collisions, 'FONTS_TABLE_DEPTH' number of
 	// collisions are allowed before the glyph retrieval is aborted
 
+#if COMPILE_HEADLESS
+	static FontGlyphInfo glyphNull { };
+	return glyphNull;
+#endif
+
 	const usize index = key.hash() * ( CoreFonts::FONTS_GROUP_SIZE * CoreFonts::FONTS_TABLE_DEPTH ) +
 	                                 ( key.codepoint % CoreFonts::FONTS_GROUP_SIZE );
 
@@ -302,9 +314,22 @@ void CoreFonts::update()
 	dirtyGlyphs.clear();
 
 	// Update GPU texture
+	GfxTextureResource *const resourcePrevious = glyphAtlasTexture.resource;
 	glyphAtlasTexture.free();
 	glyphAtlasTexture.init_2d( glyphAtlasTextureBuffer.data, glyphAtlasTextureBuffer.width,
 		glyphAtlasTextureBuffer.height, GfxColorFormat_R8G8B8A8_FLOAT );
+
+#if GRAPHICS_ENABLED
+	// Rebind in place of the old resource (without a batch break). The new atlas is a superset of the old one, so
+	// quads already in the pending batch remain valid
+	for( int slot = 0; slot < GFX_TEXTURE_SLOT_COUNT; slot++ )
+	{
+		if( CoreGfx::state.boundTexture[slot] != resourcePrevious ) { continue; }
+		CoreGfx::state.boundTexture[slot] = glyphAtlasTexture.resource;
+		ErrorIf( !CoreGfx::api_texture_bind( glyphAtlasTexture.resource, slot ),
+			"Failed to bind GfxTexture to slot %d!", slot );
+	}
+#endif
 }
 
 
@@ -3,6 +3,10 @@
 #include <pipeline.generated.hpp>
 
 #include <core/memory.hpp>
+#include <core/list.hpp>
+#include <core/flathashmap.hpp>
+#include <core/sort.hpp>
+#include <core/bcn.hpp>
 
 #include <manta/window.hpp>
 #include <manta/draw.hpp>
@@ -13,6 +17,7 @@ namespace CoreGfx
 {
 	GfxState state = { };
 	GfxQuadBatch<GfxVertex::BuiltinVertex> batch;
+	GfxQuadBatch<GfxVertex::BuiltinVertexMulti> batchMulti;
 
 	GfxShader shaders[CoreGfx::shaderCount] = { };
 	GfxTexture textures[CoreAssets::textureCount] = { };
@@ -22,8 +27,11 @@ namespace CoreGfx
 
 GfxStack GfxRenderCommand::renderCommandArgsStack;
 GfxStack GfxRenderCommand::renderCommandTagsStack;
+thread_local GfxStack *GfxRenderCommand::renderCommandArgsStackThread = nullptr;
+thread_local GfxStack *GfxRenderCommand::renderCommandTagsStackThread = nullptr;
 
 List<List<GfxRenderCommand>> GfxRenderGraph::renderGraphCommandLists;
+List<List<u32>> GfxRenderGraph::renderGraphCommandOrders;
 usize GfxRenderGraph::renderGraphCommandListCurrent = 0LLU;
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -102,6 +110,22 @@ void debug_overlay_gfx( float x, float y )
 		"Shader Binds: %d", stats.frame.shaderBinds );
 	drawY += 20.0f;
 
+	// Quad Batch
+
+	drawY += 20.0f;
+	format_integer( buffer, sizeof( buffer ), stats.frame.quadCount );
+	draw_text_f( fnt_iosevka, 14, drawX, drawY, c_yellow,
+		"Quads: %s", buffer );
+	drawY += 20.0f;
+
+	draw_text_f( fnt_iosevka, 14, drawX, drawY, c_white,
+		"  Batch Draws: %d", stats.frame.batchDraws );
+	drawY += 20.0f;
+
+	draw_text_f( fnt_iosevka, 14, drawX, drawY, c_white,
+		"  Batch Breaks: %d (texture: %d)", stats.frame.batchBreaks, stats.frame.batchBreaksTexture );
+	drawY += 20.0f;
+
 	// Memory
 
 	drawY += 20.0f;
@@ -148,6 +172,21 @@ void debug_overlay_gfx( float x, float y )
 	draw_text_f( fnt_iosevka, 14, drawX, drawY, c_white,
 		"  Render Targets: %.4f mb", MB( stats.gpuMemoryRenderTargets ) );
 	drawY += 20.0f;
+
+	// CPU Memory
+
+	drawY += 20.0f;
+	draw_text_f( fnt_iosevka, 14, drawX, drawY, c_yellow, "CPU Memory (live / peak)" );
+	drawY += 20.0f;
+
+	for( int tag = 0; tag < MEMORYTAG_COUNT; tag++ )
+	{
+		const MemoryTagStats tagStats = memory_tag_stats( static_cast<MemoryTag>( tag ) );
+		if( tagStats.allocations == 0 ) { continue; }
+		draw_text_f( fnt_iosevka, 14, drawX, drawY, c_white, "  %s: %.4f mb / %.4f mb",
+			memory_tag_name( static_cast<MemoryTag>( tag ) ), MB( tagStats.bytesLive ), MB( tagStats.bytesPeak ) );
+		drawY += 20.0f;
+	}
 }
 #else
 void debug_overlay_gfx( float x, float y ) { }
@@ -165,6 +204,8 @@ bool CoreGfx::init()
 	ErrorReturnIf( !CoreGfx::init_shaders(), false, "%s: Failed to initialize shaders!", __FUNCTION__ );
 	ErrorReturnIf( !CoreGfx::init_commands(), false, "%s: Failed to initialize command system!", __FUNCTION__ );
 	ErrorReturnIf( !CoreGfx::batch.init(), false, "%s: Failed to initialize default quad batch!", __FUNCTION__ );
+	ErrorReturnIf( !CoreGfx::batchMulti.init( GFX_QUAD_BATCH_SIZE, Shader::SHADER_DEFAULT_MULTI ), false,
+		"%s: Failed to initialize multi-texture quad batch!", __FUNCTION__ );
 #endif
 	return true;
 }
@@ -173,6 +214,7 @@ bool CoreGfx::init()
 bool CoreGfx::free()
 {
 #if GRAPHICS_ENABLED
+	ErrorReturnIf( !CoreGfx::batchMulti.free(), false, "%s: Failed to free multi-texture quad batch!", __FUNCTION__ );
 	ErrorReturnIf( !CoreGfx::batch.free(), false, "%s: Failed to free default quad batch!", __FUNCTION__ );
 	ErrorReturnIf( !CoreGfx::free_commands(),false, "%s: Failed to free command system!", __FUNCTION__ );
 	ErrorReturnIf( !CoreGfx::free_shaders(),false, "%s: Failed to free shaders!", __FUNCTION__ );
@@ -199,6 +241,11 @@ bool CoreGfx::init_textures()
 		GfxColorFormat_R32G32_FLOAT, // TextureColorFormat_R32G32
 		GfxColorFormat_R32_FLOAT, // TextureColorFormat_R32
 		GfxColorFormat_R10G10B10A2_FLOAT, // TextureColorFormat_R10G10B10A2
+		GfxColorFormat_BC1, // TextureColorFormat_BC1
+		GfxColorFormat_BC3, // TextureColorFormat_BC3
+		GfxColorFormat_BC4, // TextureColorFormat_BC4
+		GfxColorFormat_BC5, // TextureColorFormat_BC5
+		GfxColorFormat_BC7, // TextureColorFormat_BC7
 	};
 
 	for( u32 i = 0; i < CoreAssets::textureCount; i++ )
@@ -287,6 +334,7 @@ bool CoreGfx::init_commands()
 	GfxRenderCommand::renderCommandTagsStack.init( 4096 );
 
 	GfxRenderGraph::renderGraphCommandLists.init();
+	GfxRenderGraph::renderGraphCommandOrders.init();
 	GfxRenderGraph::renderGraphCommandListCurrent = 0LLU;
 
 	return true;
@@ -299,6 +347,7 @@ bool CoreGfx::free_commands()
 	GfxRenderCommand::renderCommandTagsStack.free();
 
 	GfxRenderGraph::renderGraphCommandLists.free();
+	GfxRenderGraph::renderGraphCommandOrders.free();
 
 	return true;
 }
@@ -312,6 +361,7 @@ void CoreGfx::clear_commands()
 	for( usize i = 0; i < GfxRenderGraph::renderGraphCommandListCurrent; i++ )
 	{
 		GfxRenderGraph::renderGraphCommandLists[i].clear();
+		GfxRenderGraph::renderGraphCommandOrders[i].clear();
 	}
 	GfxRenderGraph::renderGraphCommandListCurrent = 0LLU;
 }
@@ -385,7 +435,8 @@ void GfxStack::grow()
 	MemoryAssert( data != nullptr );
 	Assert( capacity >= 1 && capacity < USIZE_MAX );
 
-	capacity = capacity > USIZE_MAX / 2 ? USIZE_MAX : capacity * 2;
+	ErrorIf( capacity > USIZE_MAX / 2, "GfxStack: exceeded maximum capacity" );
+	capacity = capacity * 2;
 	data = reinterpret_cast<byte *>( memory_realloc( data, capacity ) );
 	ErrorIf( data == nullptr, "Failed to reallocate memory for GfxStack (%p: realloc %d bytes)",
 		data, capacity );
@@ -418,6 +469,25 @@ usize GfxStack::add( const void *buffer, u16 size, u16 alignment )
 }
 
 
+usize GfxStack::append( const GfxStack &other )
+{
+	MemoryAssert( data != nullptr );
+
+	// Align to the allocator's alignment, so payloads keep their alignment relative to the base
+	constexpr usize alignment = 16;
+	current = ( current + alignment - 1 ) & ~( alignment - 1 );
+
+	// Grow
+	for( ; current + other.current > capacity; grow() ) { }
+
+	// Write
+	const usize offset = current;
+	if( other.current > 0 ) { memory_copy( &data[offset], other.data, other.current ); }
+	current += other.current;
+	return offset;
+}
+
+
 void *GfxStack::get( usize offset, u16 size )
 {
 	Assert( offset + size <= current );
@@ -1078,10 +1148,7 @@ void Gfx::set_shader_globals( const CoreGfxUniformBuffer::UniformsPipeline_t &gl
 
 void GfxTexture::init_2d( void *data, u16 width, u16 height, const GfxColorFormat &format )
 {
-#if GRAPHICS_ENABLED
-	ErrorIf( !CoreGfx::api_texture_init( resource, data, width, height, 1, format ),
-		"Failed to init GfxTexture!" );
-#endif
+	init_2d( data, width, height, 1, format );
 }
 
 
@@ -1090,6 +1157,41 @@ void GfxTexture::init_2d( void *data, u16 width, u16 height, u16 levels, const G
 #if GRAPHICS_ENABLED
 	ErrorIf( levels == 0,
 		"Must have at least one mip level (highest resolution)" );
+
+	// Block-compressed formats the backend can't sample are decoded to RGBA8
+	if( CoreGfx::colorFormatBlockSizeBytes[format] > 0 && !CoreGfx::api_texture_format_supported( format ) )
+	{
+		static_assert( GfxColorFormat_BC7 - GfxColorFormat_BC1 == BCnFormat_BC7 - BCnFormat_BC1,
+			"GfxColorFormat BCn formats must match BCnFormat order" );
+		const BCnFormat formatBCn = static_cast<BCnFormat>( format - GfxColorFormat_BC1 );
+
+		usize size = 0;
+		for( u16 level = 0, mipWidth = width, mipHeight = height; level < levels; level++ )
+		{
+			size += static_cast<usize>( mipWidth ) * mipHeight * 4;
+			mipWidth = ( mipWidth > 1 ) ? ( mipWidth >> 1 ) : 1;
+			mipHeight = ( mipHeight > 1 ) ? ( mipHeight >> 1 ) : 1;
+		}
+
+		byte *decoded = reinterpret_cast<byte *>( memory_alloc( size ) );
+		const byte *source = reinterpret_cast<const byte *>( data );
+		byte *dest = decoded;
+		for( u16 level = 0, mipWidth = width, mipHeight = height; level < levels; level++ )
+		{
+			bcn_decode( formatBCn, source, mipWidth, mipHeight, dest );
+			source += CoreGfx::color_format_size_bytes( format, mipWidth, mipHeight );
+			dest += static_cast<usize>( mipWidth ) * mipHeight * 4;
+			mipWidth = ( mipWidth > 1 ) ? ( mipWidth >> 1 ) : 1;
+			mipHeight = ( mipHeight > 1 ) ? ( mipHeight >> 1 ) : 1;
+		}
+
+		const bool success = CoreGfx::api_texture_init( resource, decoded, width, height, levels,
+			GfxColorFormat_R8G8B8A8_FLOAT );
+		memory_free( decoded );
+		ErrorIf( !success, "Failed to init GfxTexture!" );
+		return;
+	}
+
 	ErrorIf( !CoreGfx::api_texture_init( resource, data, width, height, levels, format ),
 		"Failed to init GfxTexture!" );
 #endif
@@ -1348,6 +1450,17 @@ void GfxRenderCommand::shader( Shader shader )
 }
 
 
+void GfxRenderCommand::shader( Shader shader, u32 variant )
+{
+#if GRAPHICS_ENABLED
+	Assert( shader < CoreGfx::shaderCount );
+	const ShaderVariantEntry &entry = CoreGfx::shaderVariantEntries[shader];
+	Assert( variant < ( 1U << entry.keys ) );
+	this->shader( CoreGfx::shaders[entry.base + variant] );
+#endif
+}
+
+
 void GfxRenderCommand::set_pipeline_description( const GfxPipelineDescription &description )
 {
 #if GRAPHICS_ENABLED
@@ -1453,6 +1566,29 @@ void GfxRenderCommand::clear_depth( float depth )
 }
 
 
+void GfxRenderCommand::sort_key( u8 pass, float depth, u8 material )
+{
+#if GRAPHICS_ENABLED
+	// NOTE: GfxShaderResource is opaque to the frontend, so shaders are grouped by (hashed) resource address
+	const u64 shaderHash = Hash::hash( reinterpret_cast<u64>( this->pipeline.shader ) ) & 0xFFF;
+	const u64 pipelineHash = Hash::hash( this->pipeline.description.hash() ) & 0xFFF;
+	depth = depth < 0.0f ? 0.0f : ( depth > 1.0f ? 1.0f : depth );
+	const u64 depthBits = static_cast<u64>( depth * 16777215.0f );
+
+	this->sortKey = ( static_cast<u64>( pass ) << 56 ) | ( shaderHash << 44 ) | ( pipelineHash << 32 ) |
+		( depthBits << 8 ) | static_cast<u64>( material );
+#endif
+}
+
+
+void GfxRenderCommand::set_sort_key( u64 key )
+{
+#if GRAPHICS_ENABLED
+	this->sortKey = key;
+#endif
+}
+
+
 
 
 void CoreGfx::render_command_execute_begin( const GfxRenderCommand &command )
@@ -1495,6 +1631,10 @@ List<GfxRenderCommand> &GfxRenderGraph::command_list()
 		commandList = GfxRenderGraph::renderGraphCommandListCurrent++;
 		if( commandList == GfxRenderGraph::renderGraphCommandLists.current )
 		{
+			List<u32> order;
+			order.init();
+			GfxRenderGraph::renderGraphCommandOrders.add( static_cast<List<u32> &&>( order ) );
+
 			List<GfxRenderCommand> list;
 			list.init();
 			return GfxRenderGraph::renderGraphCommandLists.add( static_cast<List<GfxRenderCommand> &&>( list ) );
@@ -1516,6 +1656,7 @@ void GfxRenderGraph::add_command( const GfxRenderCommand &command )
 {
 #if GRAPHICS_ENABLED
 	command_list().add( command );
+	GfxRenderGraph::renderGraphCommandOrders[commandList].clear();
 #endif
 }
 
@@ -1524,6 +1665,31 @@ void GfxRenderGraph::add_command( GfxRenderCommand &&command )
 {
 #if GRAPHICS_ENABLED
 	command_list().add( static_cast<GfxRenderCommand &&>( command ) );
+	GfxRenderGraph::renderGraphCommandOrders[commandList].clear();
+#endif
+}
+
+
+void GfxRenderGraph::merge( GfxRenderGraphRecorder &recorder )
+{
+#if GRAPHICS_ENABLED
+	AssertMsg( GfxRenderCommand::renderCommandArgsStackThread == nullptr,
+		"Cannot merge into a GfxRenderGraph while recording into a GfxRenderGraphRecorder!" );
+
+	const usize argsBase = GfxRenderCommand::renderCommandArgsStack.append( recorder.argsStack );
+	const usize tagsBase = GfxRenderCommand::renderCommandTagsStack.append( recorder.tagsStack );
+
+	List<GfxRenderCommand> &list = command_list();
+	if( recorder.commands.current > 0 ) { list.reserve( list.current + recorder.commands.current ); }
+	for( GfxRenderCommand &command : recorder.commands )
+	{
+		if( command.workPayloadSize > 0 ) { command.workPayloadOffset += argsBase; }
+		if( command.tagsPayloadSize > 0 ) { command.tagsPayloadOffset += tagsBase; }
+		list.add( command );
+	}
+	GfxRenderGraph::renderGraphCommandOrders[commandList].clear();
+
+	recorder.clear();
 #endif
 }
 
@@ -1556,12 +1722,43 @@ static void render_graph_quicksort( GfxRenderGraph &graph, usize left, usize rig
 }
 
 
+void Gfx::render_graph_sort( GfxRenderGraph &graph )
+{
+#if GRAPHICS_ENABLED
+	if( graph.commandList == USIZE_MAX ) { return; }
+	const List<GfxRenderCommand> &commandList = graph.command_list();
+	List<u32> &order = GfxRenderGraph::renderGraphCommandOrders[graph.commandList];
+	order.clear();
+
+	const usize count = commandList.current;
+	if( count <= 1 ) { return; }
+	Assert( count <= U32_MAX );
+
+	MemoryScratchScope scratch;
+	u64 *const keys = reinterpret_cast<u64 *>( memory_alloc( scratch, count * sizeof( u64 ) * 2 ) );
+	u64 *const keysScratch = keys + count;
+	u32 *const indicesScratch = reinterpret_cast<u32 *>( memory_alloc( scratch, count * sizeof( u32 ) ) );
+
+	order.reserve( count );
+	order.current = count;
+	for( usize i = 0; i < count; i++ )
+	{
+		keys[i] = commandList.data[i].sortKey;
+		order.data[i] = static_cast<u32>( i );
+	}
+
+	radix_sort( keys, order.data, count, keysScratch, indicesScratch );
+#endif
+}
+
+
 void Gfx::render_graph_sort( GfxRenderGraph &graph,
 	bool ( *compare )( GfxRenderCommand &, GfxRenderCommand & ) )
 {
 #if GRAPHICS_ENABLED
 	if( graph.commandList == USIZE_MAX ) { return; }
 	List<GfxRenderCommand> &commandList = graph.command_list();
+	GfxRenderGraph::renderGraphCommandOrders[graph.commandList].clear();
 	if( commandList.current <= 1 ) { return; }
 	render_graph_quicksort( graph, 0LLU, commandList.current - 1LLU, compare );
 #endif
@@ -1573,10 +1770,79 @@ void Gfx::render_graph_execute( const GfxRenderGraph &graph )
 #if GRAPHICS_ENABLED
 	if( graph.commandList == USIZE_MAX ) { return; }
 	const List<GfxRenderCommand> &commandList = graph.command_list();
-	for( const GfxRenderCommand &command : commandList ) { Gfx::render_command_execute( command ); }
+	const List<u32> &order = GfxRenderGraph::renderGraphCommandOrders[graph.commandList];
+	const bool sorted = order.current == commandList.current;
+
+	// NOTE: The backends skip shader/pipeline binds that match CoreGfx::state, so executing in sort key order
+	// (grouped by shader & pipeline) is what eliminates redundant binds between consecutive commands
+	for( usize i = 0; i < commandList.current; i++ )
+	{
+		const GfxRenderCommand &command = commandList.data[sorted ? order.data[i] : i];
+	#if PROFILING_GFX
+		Gfx::stats.frame.renderGraphCommands++;
+		Gfx::stats.frame.renderGraphPipelineChanges += !( CoreGfx::state.pipeline == command.pipeline );
+	#endif
+		Gfx::render_command_execute( command );
+	}
 #endif
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Render Graph Recorder
+
+void GfxRenderGraphRecorder::init( usize reserve )
+{
+	commands.init( reserve, memory_heap( MemoryTag_Gfx ) );
+	argsStack.init( 4096 );
+	tagsStack.init( 4096 );
+}
+
+
+void GfxRenderGraphRecorder::free()
+{
+	commands.free();
+	argsStack.free();
+	tagsStack.free();
+}
+
+
+void GfxRenderGraphRecorder::clear()
+{
+	commands.clear();
+	argsStack.clear();
+	tagsStack.clear();
+}
+
+
+void GfxRenderGraphRecorder::begin()
+{
+	AssertMsg( GfxRenderCommand::renderCommandArgsStackThread == nullptr,
+		"This thread is already recording into a GfxRenderGraphRecorder!" );
+	GfxRenderCommand::renderCommandArgsStackThread = &argsStack;
+	GfxRenderCommand::renderCommandTagsStackThread = &tagsStack;
+}
+
+
+void GfxRenderGraphRecorder::end()
+{
+	AssertMsg( GfxRenderCommand::renderCommandArgsStackThread == &argsStack,
+		"GfxRenderGraphRecorder::end() without matching begin() on this thread!" );
+	GfxRenderCommand::renderCommandArgsStackThread = nullptr;
+	GfxRenderCommand::renderCommandTagsStackThread = nullptr;
+}
+
+
+void GfxRenderGraphRecorder::add_command( const GfxRenderCommand &command )
+{
+	commands.add( command );
+}
+
+
+void GfxRenderGraphRecorder::add_command( GfxRenderCommand &&command )
+{
+	commands.add( static_cast<GfxRenderCommand &&>( command ) );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Render Pass
 
@@ -2021,11 +2287,111 @@ bool Gfx::mip_generate_chain_2d_alloc( const void *data, u16 width, u16 height,
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Quad Batch (Built-in)
 
+#if GRAPHICS_ENABLED
+struct QuadBatchSortEntry
+{
+	GfxQuadBatch<GfxVertex::BuiltinVertex>::Quad quad;
+	const GfxTexture *texture;
+	GfxTextureResource *resource;
+};
+
+static List<QuadBatchSortEntry> quadBatchSortEntries; // memory_frame()
+static List<u32> quadBatchSortKeys; // memory_frame()
+static FlatHashMap<u64, u32> quadBatchSortTextures; // memory_frame()
+
+
+static bool quad_batch_multi_texture_active()
+{
+	// Custom shaders (render commands) expect a single texture in slot 0
+	return CoreGfx::state.quadBatchMultiTexture && CoreGfx::state.renderCommandActive == nullptr;
+}
+
+
+static void quad_batch_submit( const GfxQuadBatch<GfxVertex::BuiltinVertex>::Quad &quad,
+	const GfxTexture *const texture, GfxTextureResource *const resource )
+{
+	// 'resource' is what a quad without a texture samples (i.e. what was bound to slot 0 when it was written)
+	PROFILE_GFX( Gfx::stats.frame.quadCount++ );
+
+	if( quad_batch_multi_texture_active() )
+	{
+		// Flush first: a flush releases the texture slots
+		CoreGfx::batchMulti.break_check();
+
+		int slot = CoreGfx::batchMulti.texture_slot( texture, resource );
+		if( UNLIKELY( slot < 0 ) )
+		{
+			PROFILE_GFX( Gfx::stats.frame.batchBreaksTexture++ );
+			CoreGfx::batchMulti.batch_break();
+			slot = CoreGfx::batchMulti.texture_slot( texture, resource );
+			Assert( slot >= 0 );
+		}
+
+		const u8_v4 s = { static_cast<u8>( slot ), 0, 0, 0 };
+		const GfxQuadBatch<GfxVertex::BuiltinVertexMulti>::Quad quadMulti =
+		{
+			{ quad.v0.position, quad.v0.uv, quad.v0.color, s },
+			{ quad.v1.position, quad.v1.uv, quad.v1.color, s },
+			{ quad.v2.position, quad.v2.uv, quad.v2.color, s },
+			{ quad.v3.position, quad.v3.uv, quad.v3.color, s },
+		};
+
+		CoreGfx::batchMulti.write( quadMulti );
+	}
+	else
+	{
+		if( UNLIKELY( CoreGfx::state.boundTexture[0] != ( texture != nullptr ? texture->resource : resource ) ) )
+		{
+			PROFILE_GFX( Gfx::stats.frame.batchBreaksTexture += !CoreGfx::batch.is_empty() );
+
+			if( LIKELY( texture != nullptr ) ) { Gfx::bind_texture( 0, *texture ); }
+			else
+			{
+				Gfx::quad_batch_break();
+				CoreGfx::state.boundTexture[0] = resource;
+				ErrorIf( !CoreGfx::api_texture_bind( resource, 0 ), "Failed to bind GfxTexture to slot 0!" );
+			}
+		}
+
+		CoreGfx::batch.write( quad );
+	}
+}
+
+
+static void quad_batch_write_quad( const GfxQuadBatch<GfxVertex::BuiltinVertex>::Quad &quad,
+	const GfxTexture *const texture )
+{
+	Assert( CoreGfx::batch.active );
+
+	GfxTextureResource *const resource = texture != nullptr ? nullptr : CoreGfx::state.boundTexture[0];
+
+	if( LIKELY( !CoreGfx::state.quadBatchSorting ) )
+	{
+		quad_batch_submit( quad, texture, resource );
+		return;
+	}
+
+	// Deferred: textures are keyed by first use, so the sort keeps textures in submission order within a layer
+	const u64 textureKey = texture != nullptr ? reinterpret_cast<u64>( texture ) :
+		( reinterpret_cast<u64>( resource ) | 1 );
+	u32 textureID = static_cast<u32>( quadBatchSortTextures.count() );
+	if( !quadBatchSortTextures.contains( textureKey ) ) { quadBatchSortTextures.add( textureKey, textureID ); }
+	else { textureID = quadBatchSortTextures.get( textureKey ); }
+	ErrorIf( textureID > U16_MAX, "%s: too many unique textures in a sorted quad batch", __FUNCTION__ );
+
+	quadBatchSortEntries.add( QuadBatchSortEntry { quad, texture, resource } );
+	quadBatchSortKeys.add( static_cast<u32>( CoreGfx::state.quadBatchLayer ) << 16 | ( textureID & 0xFFFF ) );
+}
+#endif
+
+
 void CoreGfx::quad_batch_frame_begin()
 {
 #if GRAPHICS_ENABLED
 	CoreGfx::batch.active = true;
 	CoreGfx::batch.batch_begin();
+	CoreGfx::batchMulti.active = true;
+	CoreGfx::batchMulti.batch_begin();
 #endif
 }
 
@@ -2033,8 +2399,11 @@ void CoreGfx::quad_batch_frame_begin()
 void CoreGfx::quad_batch_frame_end()
 {
 #if GRAPHICS_ENABLED
+	AssertMsg( !CoreGfx::state.quadBatchSorting, "Gfx::quad_batch_sort_begin() without matching sort_end()!" );
 	CoreGfx::batch.batch_end();
 	CoreGfx::batch.active = false;
+	CoreGfx::batchMulti.batch_end();
+	CoreGfx::batchMulti.active = false;
 #endif
 }
 
@@ -2044,6 +2413,7 @@ void Gfx::quad_batch_break()
 #if GRAPHICS_ENABLED
 	if( !CoreGfx::batch.active ) { return; }
 	CoreGfx::batch.batch_break();
+	CoreGfx::batchMulti.batch_break();
 #endif
 }
 
@@ -2052,7 +2422,7 @@ bool Gfx::quad_batch_can_break()
 {
 #if GRAPHICS_ENABLED
 	if( !CoreGfx::batch.active ) { return false; }
-	return CoreGfx::batch.can_break();
+	return quad_batch_multi_texture_active() ? CoreGfx::batchMulti.can_break() : CoreGfx::batch.can_break();
 #else
 	return true;
 #endif
@@ -2063,23 +2433,81 @@ void Gfx::quad_batch_break_check()
 {
 #if GRAPHICS_ENABLED
 	if( !CoreGfx::batch.active ) { return; }
-	CoreGfx::batch.break_check();
+	if( quad_batch_multi_texture_active() ) { CoreGfx::batchMulti.break_check(); }
+	else { CoreGfx::batch.break_check(); }
 #endif
 }
 
 
-void Gfx::quad_batch_write( const GfxQuadBatch<GfxVertex::BuiltinVertex>::Quad &quad,
-	const GfxTexture *const texture )
+void Gfx::quad_batch_multi_texture( bool enabled )
 {
 #if GRAPHICS_ENABLED
-	Assert( CoreGfx::batch.active );
+	if( CoreGfx::state.quadBatchMultiTexture == enabled ) { return; }
+	Gfx::quad_batch_break();
+	CoreGfx::state.quadBatchMultiTexture = enabled;
+#endif
+}
+
+
+void Gfx::quad_batch_sort_begin()
+{
+#if GRAPHICS_ENABLED
+	ErrorReturnIf( CoreGfx::state.quadBatchSorting, , "%s: quad batch is already sorting", __FUNCTION__ );
+	quadBatchSortEntries.init( 1024, &memory_frame() );
+	quadBatchSortKeys.init( 1024, &memory_frame() );
+	quadBatchSortTextures.init( 32, U32_MAX, &memory_frame() );
+	CoreGfx::state.quadBatchSorting = true;
+	CoreGfx::state.quadBatchLayer = 0;
+#endif
+}
+
+
+void Gfx::quad_batch_sort_end()
+{
+#if GRAPHICS_ENABLED
+	ErrorReturnIf( !CoreGfx::state.quadBatchSorting, , "%s: quad batch is not sorting", __FUNCTION__ );
+	CoreGfx::state.quadBatchSorting = false;
 
-	if( LIKELY( texture != nullptr ) && CoreGfx::state.boundTexture[0] != texture->resource )
+	const usize count = quadBatchSortEntries.size();
+	if( count > 0 )
 	{
-		Gfx::bind_texture( 0, *texture );
+		Allocator *const allocator = &memory_frame();
+		u32 *const indices = reinterpret_cast<u32 *>( memory_alloc( allocator, count * sizeof( u32 ) * 3 ) );
+		u32 *const indicesScratch = indices + count;
+		u32 *const keysScratch = indices + count * 2;
+		for( usize i = 0; i < count; i++ ) { indices[i] = static_cast<u32>( i ); }
+
+		radix_sort( quadBatchSortKeys.data, indices, count, keysScratch, indicesScratch );
+
+		for( usize i = 0; i < count; i++ )
+		{
+			const QuadBatchSortEntry &entry = quadBatchSortEntries[indices[i]];
+			quad_batch_submit( entry.quad, entry.texture, entry.resource );
+		}
+
+		memory_free( allocator, indices, count * sizeof( u32 ) * 3 );
 	}
 
-	CoreGfx::batch.write( quad );
+	quadBatchSortTextures.free();
+	quadBatchSortKeys.free();
+	quadBatchSortEntries.free();
+#endif
+}
+
+
+void Gfx::quad_batch_layer( u16 layer )
+{
+#if GRAPHICS_ENABLED
+	CoreGfx::state.quadBatchLayer = layer;
+#endif
+}
+
+
+void Gfx::quad_batch_write( const GfxQuadBatch<GfxVertex::BuiltinVertex>::Quad &quad,
+	const GfxTexture *const texture )
+{
+#if GRAPHICS_ENABLED
+	quad_batch_write_quad( quad, texture );
 #endif
 }
 
@@ -2089,13 +2517,6 @@ void Gfx::quad_batch_write( float x1, float y1, float x2, float y2,
 	const GfxTexture *texture, float depth )
 {
 #if GRAPHICS_ENABLED
-	Assert( CoreGfx::batch.active );
-
-	if( LIKELY( texture != nullptr ) && CoreGfx::state.boundTexture[0] != texture->resource )
-	{
-		Gfx::bind_texture( 0, *texture );
-	}
-
 	const GfxQuadBatch<GfxVertex::BuiltinVertex>::Quad quad =
 	{
 		{ { x1, y1, depth }, { u1, v1 }, { c1.r, c1.g, c1.b, c1.a } },
@@ -2104,7 +2525,7 @@ void Gfx::quad_batch_write( float x1, float y1, float x2, float y2,
 		{ { x2, y2, depth }, { u2, v2 }, { c4.r, c4.g, c4.b, c4.a } },
 	};
 
-	CoreGfx::batch.write( quad );
+	quad_batch_write_quad( quad, texture );
 #endif
 }
 
@@ -2116,13 +2537,6 @@ void Gfx::quad_batch_write( float x1, float y1, float x2, float y2,
 	const GfxTexture *texture, float depth )
 {
 #if GRAPHICS_ENABLED
-	Assert( CoreGfx::batch.active );
-
-	if( LIKELY( texture != nullptr ) && CoreGfx::state.boundTexture[0] != texture->resource )
-	{
-		Gfx::bind_texture( 0, *texture );
-	}
-
 	const GfxQuadBatch<GfxVertex::BuiltinVertex>::Quad quad =
 	{
 		{ { x1, y1, depth }, { u1, v1 }, { c1.r, c1.g, c1.b, c1.a } },
@@ -2131,7 +2545,7 @@ void Gfx::quad_batch_write( float x1, float y1, float x2, float y2,
 		{ { x4, y4, depth }, { u2, v2 }, { c4.r, c4.g, c4.b, c4.a } },
 	};
 
-	CoreGfx::batch.write( quad );
+	quad_batch_write_quad( quad, texture );
 #endif
 }
 
@@ -2141,13 +2555,6 @@ void Gfx::quad_batch_write( float x1, float y1, float x2, float y2,
 	const GfxTexture *texture, float depth )
 {
 #if GRAPHICS_ENABLED
-	Assert( CoreGfx::batch.active );
-
-	if( LIKELY( texture != nullptr ) && CoreGfx::state.boundTexture[0] != texture->resource )
-	{
-		Gfx::bind_texture( 0, *texture );
-	}
-
 	const GfxQuadBatch<GfxVertex::BuiltinVertex>::Quad quad =
 	{
 		{ { x1, y1, depth }, { u1, v1 }, { color.r, color.g, color.b, color.a } },
@@ -2156,7 +2563,7 @@ void Gfx::quad_batch_write( float x1, float y1, float x2, float y2,
 		{ { x2, y2, depth }, { u2, v2 }, { color.r, color.g, color.b, color.a } },
 	};
 
-	CoreGfx::batch.write( quad );
+	quad_batch_write_quad( quad, texture );
 #endif
 }
 
@@ -2167,13 +2574,6 @@ void Gfx::quad_batch_write( float x1, float y1, float x2, float y2,
 	const GfxTexture *texture, float depth )
 {
 #if GRAPHICS_ENABLED
-	Assert( CoreGfx::batch.active );
-
-	if( LIKELY( texture != nullptr ) && CoreGfx::state.boundTexture[0] != texture->resource )
-	{
-		Gfx::bind_texture( 0, *texture );
-	}
-
 	const GfxQuadBatch<GfxVertex::BuiltinVertex>::Quad quad =
 	{
 		{ { x1, y1, depth }, { u1, v1 }, { color.r, color.g, color.b, color.a } },
@@ -2182,7 +2582,7 @@ void Gfx::quad_batch_write( float x1, float y1, float x2, float y2,
 		{ { x4, y4, depth }, { u2, v2 }, { color.r, color.g, color.b, color.a } },
 	};
 
-	CoreGfx::batch.write( quad );
+	quad_batch_write_quad( quad, texture );
 #endif
 }
 
@@ -15,7 +15,11 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-#if !defined( HEADLESS ) && ( GRAPHICS_D3D11 || GRAPHICS_D3D12 || GRAPHICS_METAL || GRAPHICS_OPENGL /*|| GRAPHICS_VULKAN*/ )
+// NOTE: gfx/none is a null device. Its frontend (batching, render commands, statistics) only runs when a config opts
+// in with "application": { "gfxFrontend": true } -- e.g. to measure CPU submission cost without a GPU
+#if ( !defined( HEADLESS ) && \
+	( GRAPHICS_D3D11 || GRAPHICS_D3D12 || GRAPHICS_METAL || GRAPHICS_OPENGL /*|| GRAPHICS_VULKAN*/ ) ) || \
+	( GRAPHICS_NONE && defined( GRAPHICS_NONE_FRONTEND ) )
 	#define GRAPHICS_ENABLED ( true )
 #else
 	#define GRAPHICS_ENABLED ( false )
@@ -65,6 +69,14 @@ struct GfxStatisticsFrame
 	u32 bufferMaps = 0;
 	u32 textureBinds = 0;
 	u32 shaderBinds = 0;
+
+	u32 quadCount = 0; // Quads written to the built-in quad batch
+	u32 batchDraws = 0; // Draw calls issued by the built-in quad batch
+	u32 batchBreaks = 0; // Quad batch flushes before frame end (state changes, texture switches, full buffer)
+	u32 batchBreaksTexture = 0; // ...of which were caused by a texture switch (or running out of texture slots)
+
+	u32 renderGraphCommands = 0; // Commands executed by Gfx::render_graph_execute()
+	u32 renderGraphPipelineChanges = 0; // ...of which changed shader or pipeline state from the previous command
 };
 
 struct GfxStatistics
@@ -187,6 +199,11 @@ enum_type( GfxColorFormat, u8 )
 	GfxColorFormat_R32G32_FLOAT,
 	GfxColorFormat_R32G32B32A32_FLOAT,
 	GfxColorFormat_R32G32B32A32_UINT,
+	GfxColorFormat_BC1,
+	GfxColorFormat_BC3,
+	GfxColorFormat_BC4,
+	GfxColorFormat_BC5,
+	GfxColorFormat_BC7,
 	GFXCOLORFORMAT_COUNT,
 };
 
@@ -211,9 +228,41 @@ namespace CoreGfx
 		8,  // GfxColorFormat_R32G32_FLOAT
 		16, // GfxColorFormat_R32G32B32A32_FLOAT
 		16, // GfxColorFormat_R32G32B32A32_UINT
+		0,  // GfxColorFormat_BC1 (see: colorFormatBlockSizeBytes)
+		0,  // GfxColorFormat_BC3
+		0,  // GfxColorFormat_BC4
+		0,  // GfxColorFormat_BC5
+		0,  // GfxColorFormat_BC7
 	};
 	static_assert( ARRAY_LENGTH( colorFormatPixelSizeBytes ) == GFXCOLORFORMAT_COUNT, "Missing colorFormatPixelSizeBytes!" );
 
+	// Bytes per 4x4 texel block (0: not block-compressed)
+	constexpr u32 colorFormatBlockSizeBytes[GFXCOLORFORMAT_COUNT] =
+	{
+		0,  // GfxColorFormat_NONE
+		0,  // GfxColorFormat_R8G8B8A8_FLOAT
+		0,  // GfxColorFormat_R8G8B8A8_UINT
+		0,  // GfxColorFormat_R10G10B10A2_FLOAT
+		0,  // GfxColorFormat_R8_UINT
+		0,  // GfxColorFormat_R8G8
+		0,  // GfxColorFormat_R16_UINT
+		0,  // GfxColorFormat_R16_FLOAT
+		0,  // GfxColorFormat_R16G16
+		0,  // GfxColorFormat_R16G16F_FLOAT
+		0,  // GfxColorFormat_R16G16B16A16_FLOAT
+		0,  // GfxColorFormat_R16G16B16A16_UINT
+		0,  // GfxColorFormat_R32_FLOAT
+		0,  // GfxColorFormat_R32G32_FLOAT
+		0,  // GfxColorFormat_R32G32B32A32_FLOAT
+		0,  // GfxColorFormat_R32G32B32A32_UINT
+		8,  // GfxColorFormat_BC1
+		16, // GfxColorFormat_BC3
+		8,  // GfxColorFormat_BC4
+		16, // GfxColorFormat_BC5
+		16, // GfxColorFormat_BC7
+	};
+	static_assert( ARRAY_LENGTH( colorFormatBlockSizeBytes ) == GFXCOLORFORMAT_COUNT, "Missing colorFormatBlockSizeBytes!" );
+
 	constexpr const char *colorFormatName[GFXCOLORFORMAT_COUNT] =
 	{
 		"NONE",               // GfxColorFormat_NONE
@@ -232,8 +281,27 @@ namespace CoreGfx
 		"R32G32_FLOAT",       // GfxColorFormat_R32G32_FLOAT
 		"R32G32B32A32_FLOAT", // GfxColorFormat_R32G32B32A32_FLOAT
 		"R32G32B32A32_UINT",  // GfxColorFormat_R32G32B32A32_UINT
+		"BC1_UNORM",          // GfxColorFormat_BC1
+		"BC3_UNORM",          // GfxColorFormat_BC3
+		"BC4_UNORM",          // GfxColorFormat_BC4
+		"BC5_UNORM",          // GfxColorFormat_BC5
+		"BC7_UNORM",          // GfxColorFormat_BC7
 	};
 	static_assert( ARRAY_LENGTH( colorFormatName ) == GFXCOLORFORMAT_COUNT, "Missing colorFormatName!" );
+
+	// Bytes per row of texels (block-compressed formats: per row of 4x4 blocks)
+	inline usize color_format_pitch_bytes( const GfxColorFormat format, const u16 width )
+	{
+		const usize blockSizeBytes = colorFormatBlockSizeBytes[format];
+		if( blockSizeBytes == 0 ) { return static_cast<usize>( width ) * colorFormatPixelSizeBytes[format]; }
+		return static_cast<usize>( ( width + 3 ) / 4 ) * blockSizeBytes;
+	}
+
+	inline usize color_format_size_bytes( const GfxColorFormat format, const u16 width, const u16 height )
+	{
+		const usize rows = colorFormatBlockSizeBytes[format] == 0 ? height : ( height + 3 ) / 4;
+		return color_format_pitch_bytes( format, width ) * rows;
+	}
 }
 
 
@@ -480,6 +548,7 @@ public:
 
 public:
 	usize add( const void *buffer, u16 size, u16 alignment );
+	usize append( const GfxStack &other );
 	void *get( usize offset, u16 size );
 
 public:
@@ -648,6 +717,10 @@ struct GfxState
 	const class GfxRenderCommand *renderCommandActive = nullptr;
 	bool renderPassAllowBatchBreak = true;
 	bool renderCommandAllowBatchBreak = true;
+
+	bool quadBatchMultiTexture = GFX_QUAD_BATCH_MULTI_TEXTURE;
+	bool quadBatchSorting = false;
+	u16 quadBatchLayer = 0;
 };
 
 
@@ -1069,6 +1142,9 @@ namespace CoreGfx
 	extern bool api_texture_init( GfxTextureResource *&resource, void *data,
 		u16 width, u16 height, u16 levels, const GfxColorFormat &format );
 
+	// Block-compressed formats the backend can't sample are decoded to RGBA8 by GfxTexture::init_2d()
+	extern bool api_texture_format_supported( const GfxColorFormat &format );
+
 	extern bool api_texture_free( GfxTextureResource *&resource );
 
 	extern bool api_texture_bind( GfxTextureResource *resource, int slot );
@@ -1451,6 +1527,8 @@ class GfxRenderCommand
 public:
 	void shader( const GfxShader &shader );
 	void shader( Shader shader );
+	// Selects the '#variant' permutation of 'shader' by key bits (ShaderVariant::<shader>::<KEY> | ...)
+	void shader( Shader shader, u32 variant );
 
 	void set_pipeline_description( const GfxPipelineDescription &description );
 
@@ -1469,12 +1547,18 @@ public:
 	void clear_color( Color color );
 	void clear_depth( float depth );
 
+	// Packed 64-bit key for Gfx::render_graph_sort( graph ), compared as an unsigned integer (most significant first):
+	// [ pass : 8 | shader : 12 | pipeline : 12 | depth : 24 | material : 8 ]
+	// Shader & pipeline are taken from the command, so call this after setting them. 'depth' is clamped to [0, 1]
+	void sort_key( u8 pass, float depth = 0.0f, u8 material = 0 );
+	void set_sort_key( u64 key );
+
 public:
 	template <typename T> void set_tags( const T &tags )
 	{
 	#if GRAPHICS_ENABLED
 		static_assert( sizeof( T ) <= U16_MAX, "Tag payload size must not exceed 65535 bytes!" );
-		tagsPayloadOffset = GfxRenderCommand::renderCommandTagsStack.add( &tags, sizeof( T ), alignof( T ) );
+		tagsPayloadOffset = GfxRenderCommand::tags_stack().add( &tags, sizeof( T ), alignof( T ) );
 		tagsPayloadSize = static_cast<u16>( sizeof( T ) );
 	#endif
 	}
@@ -1482,7 +1566,7 @@ public:
 	template <typename T> T *get_tags()
 	{
 	#if GRAPHICS_ENABLED
-		void *tags = GfxRenderCommand::renderCommandTagsStack.get( tagsPayloadOffset, tagsPayloadSize );
+		void *tags = GfxRenderCommand::tags_stack().get( tagsPayloadOffset, tagsPayloadSize );
 		return reinterpret_cast<T *>( tags );
 	#endif
 	}
@@ -1509,7 +1593,7 @@ public:
 	{
 	#if GRAPHICS_ENABLED
 		static_assert( sizeof( T ) <= U16_MAX, "Payload size must not exceed 65535 bytes!" );
-		workPayloadOffset = GfxRenderCommand::renderCommandArgsStack.add( &payload, sizeof( T ), alignof( T ) );
+		workPayloadOffset = GfxRenderCommand::args_stack().add( &payload, sizeof( T ), alignof( T ) );
 		workPayloadSize = static_cast<u16>( sizeof( T ) );
 
 		workFunction = reinterpret_cast<void *>( function );
@@ -1528,7 +1612,7 @@ public:
 	{
 	#if GRAPHICS_ENABLED
 		static_assert( sizeof( T ) <= U16_MAX, "Payload size must not exceed 65535 bytes!" );
-		workPayloadOffset = GfxRenderCommand::renderCommandArgsStack.add( &payload, sizeof( T ), alignof( T ) );
+		workPayloadOffset = GfxRenderCommand::args_stack().add( &payload, sizeof( T ), alignof( T ) );
 		workPayloadSize = static_cast<u16>( sizeof( T ) );
 
 		workFunction = reinterpret_cast<void *>( function );
@@ -1539,9 +1623,24 @@ public:
 	#endif
 	}
 
+public:
+	// Payload stacks written by the calling thread: those of the GfxRenderGraphRecorder it is recording into (if
+	// any), otherwise the global stacks (main thread)
+	static GfxStack &args_stack()
+	{
+		return renderCommandArgsStackThread != nullptr ? *renderCommandArgsStackThread : renderCommandArgsStack;
+	}
+
+	static GfxStack &tags_stack()
+	{
+		return renderCommandTagsStackThread != nullptr ? *renderCommandTagsStackThread : renderCommandTagsStack;
+	}
+
 public:
 	static GfxStack renderCommandArgsStack;
 	static GfxStack renderCommandTagsStack;
+	static thread_local GfxStack *renderCommandArgsStackThread;
+	static thread_local GfxStack *renderCommandTagsStackThread;
 
 public:
 	GfxStatePipeline pipeline = GfxStatePipeline { };
@@ -1556,6 +1655,8 @@ public:
 	usize tagsPayloadOffset = 0LLU;
 	u16 workPayloadSize = 0U;
 	u16 tagsPayloadSize = 0U;
+
+	u64 sortKey = 0LLU;
 };
 constexpr usize s = sizeof( GfxRenderCommand );
 
@@ -1599,6 +1700,9 @@ namespace Gfx
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Render Graph
 
+class GfxRenderGraphRecorder;
+
+
 class GfxRenderGraph
 {
 public:
@@ -1608,8 +1712,13 @@ public:
 	void add_command( const GfxRenderCommand &command );
 	void add_command( GfxRenderCommand &&command );
 
+	// Appends (and clears) the commands of a recorder, rebasing their payloads into the global stacks. Main thread
+	// only: merge recorders in a fixed order so the result doesn't depend on which thread finished first
+	void merge( GfxRenderGraphRecorder &recorder );
+
 public:
 	static List<List<GfxRenderCommand>>renderGraphCommandLists;
+	static List<List<u32>> renderGraphCommandOrders; // Execution order from render_graph_sort( graph ), if sorted
 	static usize renderGraphCommandListCurrent;
 
 public:
@@ -1617,8 +1726,34 @@ public:
 };
 
 
+// Records GfxRenderCommands on any thread. Between begin() and end(), GfxRenderCommand::work() & set_tags() on
+// the calling thread write their payloads into the recorder's own stacks rather than the global ones. Use one
+// recorder per thread, then GfxRenderGraph::merge() them on the main thread before Gfx::render_graph_execute()
+class GfxRenderGraphRecorder
+{
+public:
+	void init( usize reserve = 256 );
+	void free();
+	void clear();
+
+	void begin();
+	void end();
+
+	void add_command( const GfxRenderCommand &command );
+	void add_command( GfxRenderCommand &&command );
+
+public:
+	List<GfxRenderCommand> commands;
+	GfxStack argsStack;
+	GfxStack tagsStack;
+};
+
+
 namespace Gfx
 {
+	// Sorts by GfxRenderCommand::sortKey (stable radix sort of a key/index array -- commands are not moved).
+	// Adding commands to the graph afterwards discards the sort
+	extern void render_graph_sort( GfxRenderGraph &graph );
 	extern void render_graph_sort( GfxRenderGraph &graph,
 		bool ( *sort )( GfxRenderCommand &cmdA, GfxRenderCommand &cmdB ) );
 	extern void render_graph_execute( const GfxRenderGraph &pass );
@@ -1695,11 +1830,22 @@ template <typename VertexFormat> class GfxQuadBatch
 public:
 	struct Quad { VertexFormat v0, v1, v2, v3; };
 
+	// Textures referenced by the pending batch (multi-texture batching): bound to slots [0, textureCount) right
+	// before the batch is drawn. GfxTexture pointers are resolved at that point, so a texture that is re-created
+	// mid-batch (i.e. the font glyph atlas) stays valid
+	struct TextureSlot
+	{
+		const GfxTexture *texture;
+		GfxTextureResource *resource;
+	};
+
 public:
-	bool init( u32 capacity = GFX_QUAD_BATCH_SIZE )
+	bool init( u32 capacity = GFX_QUAD_BATCH_SIZE, Shader shader = Shader::SHADER_DEFAULT )
 	{
 		Assert( capacity * 6 < U32_MAX );
 		this->capacity = capacity;
+		this->shader = shader;
+		this->textureCount = 0;
 
 #if GRAPHICS_ENABLED
 		vertexBuffer.init( this->capacity * 6, GfxWriteMode_RING );
@@ -1749,22 +1895,25 @@ public:
 #if GRAPHICS_ENABLED
 		vertexBuffer.write_end();
 
-		if( vertexBuffer.current() == 0 ) { return; }
+		if( vertexBuffer.current() == 0 ) { textureCount = 0; return; }
+		PROFILE_GFX( Gfx::stats.frame.batchDraws++ );
 
 		if( CoreGfx::state.renderCommandActive == nullptr )
 		{
 			GfxRenderCommand cmd;
-			cmd.shader( Shader::SHADER_DEFAULT );
+			cmd.shader( shader );
 
 			CoreGfx::state.renderCommandAllowBatchBreak = false;
 			Gfx::render_command_execute( cmd, [this]()
 				{
+					bind_textures();
 					Gfx::draw_vertex_buffer_indexed( vertexBuffer, indexBuffer );
 				} );
 			CoreGfx::state.renderCommandAllowBatchBreak = true;
 		}
 		else
 		{
+			bind_textures();
 			Gfx::draw_vertex_buffer_indexed( vertexBuffer, indexBuffer );
 		}
 #endif
@@ -1775,12 +1924,54 @@ public:
 #if GRAPHICS_ENABLED
 		if( vertexBuffer.current() == 0 ) { return; }
 		if( !CoreGfx::state.renderCommandAllowBatchBreak ) { return; }
+		PROFILE_GFX( Gfx::stats.frame.batchBreaks++ );
 
 		batch_end();
 		batch_begin();
 #endif
 	}
 
+	bool is_empty() const
+	{
+#if GRAPHICS_ENABLED
+		return vertexBuffer.current() == 0;
+#else
+		return true;
+#endif
+	}
+
+	int texture_slot( const GfxTexture *texture, GfxTextureResource *resource )
+	{
+		// Returns the slot 'texture' is bound to in the pending batch, or -1 if all slots are taken
+		for( u8 slot = 0; slot < textureCount; slot++ )
+		{
+			const TextureSlot &entry = textures[slot];
+			if( texture != nullptr ? entry.texture == texture : entry.texture == nullptr && entry.resource == resource )
+			{
+				return slot;
+			}
+		}
+
+		if( textureCount == GFX_TEXTURE_SLOT_COUNT ) { return -1; }
+		textures[textureCount] = TextureSlot { texture, resource };
+		return textureCount++;
+	}
+
+	void bind_textures()
+	{
+#if GRAPHICS_ENABLED
+		for( u8 slot = 0; slot < textureCount; slot++ )
+		{
+			const TextureSlot &entry = textures[slot];
+			GfxTextureResource *resource = entry.texture != nullptr ? entry.texture->resource : entry.resource;
+			if( CoreGfx::state.boundTexture[slot] == resource ) { continue; }
+			CoreGfx::state.boundTexture[slot] = resource;
+			ErrorIf( !CoreGfx::api_texture_bind( resource, slot ), "Failed to bind GfxTexture to slot %d!", slot );
+		}
+		textureCount = 0;
+#endif
+	}
+
 	bool can_break()
 	{
 #if GRAPHICS_ENABLED
@@ -1823,14 +2014,19 @@ public:
 public:
 	bool active = false;
 	u32 capacity = 0;
+	Shader shader = Shader::SHADER_DEFAULT;
 	GfxVertexBuffer<VertexFormat> vertexBuffer;
 	GfxIndexBuffer indexBuffer;
+
+	TextureSlot textures[GFX_TEXTURE_SLOT_COUNT];
+	u8 textureCount = 0;
 };
 
 
 namespace CoreGfx
 {
 	extern GfxQuadBatch<GfxVertex::BuiltinVertex> batch;
+	extern GfxQuadBatch<GfxVertex::BuiltinVertexMulti> batchMulti;
 
 	extern void quad_batch_frame_begin();
 	extern void quad_batch_frame_end();
@@ -1843,6 +2039,18 @@ namespace Gfx
 	extern bool quad_batch_can_break();
 	extern void quad_batch_break_check();
 
+	// Multi-texture batching: outside of a GfxRenderCommand, quads are drawn with SHADER_DEFAULT_MULTI and up to
+	// GFX_TEXTURE_SLOT_COUNT textures per draw call, so texture switches no longer break the batch. Inside a
+	// GfxRenderCommand (custom shader), quads always go through the single-texture batch
+	extern void quad_batch_multi_texture( bool enabled );
+
+	// Deferred sorting: quads written between sort_begin() and sort_end() are buffered, stable sorted by
+	// (layer, texture), and then submitted. Draw order is only preserved within a layer for quads that share a
+	// texture, so use layers for anything that must overlap in a particular order
+	extern void quad_batch_sort_begin();
+	extern void quad_batch_sort_end();
+	extern void quad_batch_layer( u16 layer );
+
 	extern void quad_batch_write( const GfxQuadBatch<GfxVertex::BuiltinVertex>::Quad &quad,
 		const GfxTexture *texture = nullptr );
 
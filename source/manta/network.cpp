@@ -483,6 +483,7 @@ bool NetworkServerUDP::connection_register( NetworkConnectionHandle handle )
 	Assert( connections[connectionsCurrent].handle == NetworkConnectionHandle_Null );
 	connections[connectionsCurrent].handle = handle;
 	connections[connectionsCurrent].sequence = U32_MAX;
+	connections[connectionsCurrent].baseline = 0U;
 
 	for( ++connectionsCurrent;
 		connectionsCurrent < connectionsCapacity &&
@@ -504,11 +505,31 @@ void NetworkServerUDP::connection_release( NetworkConnectionHandle handle )
 
 	connections[connectionIndex].handle = NetworkConnectionHandle_Null;
 	connections[connectionIndex].endpoint = NetworkEndpoint { };
+	connections[connectionIndex].baseline = 0U;
 
 	connectionsCurrent = connectionIndex < connectionsCurrent ? connectionIndex : connectionsCurrent;
 }
 
 
+void NetworkServerUDP::connection_acknowledge( NetworkConnectionHandle handle, u32 tick )
+{
+	const u32 connectionIndex = connection_get_index( handle );
+	if( connectionIndex == U32_MAX ) { return; }
+
+	// Acknowledgements may arrive out of order -- only move the baseline forward
+	NetworkConnectionUDP &connection = connections[connectionIndex];
+	if( static_cast<i32>( tick - connection.baseline ) > 0 ) { connection.baseline = tick; }
+}
+
+
+u32 NetworkServerUDP::connection_baseline( NetworkConnectionHandle handle ) const
+{
+	const u32 connectionIndex = connection_get_index( handle );
+	if( connectionIndex == U32_MAX ) { return 0U; }
+	return connections[connectionIndex].baseline;
+}
+
+
 void NetworkServerUDP::receive(
 	void ( *callbackOnReceive )( void *context, NetworkConnectionHandle handle, Buffer &buffer ) )
 {
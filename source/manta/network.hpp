@@ -284,6 +284,7 @@ struct NetworkConnectionUDP
 	NetworkConnectionHandle handle = NetworkConnectionHandle_Null;
 	NetworkEndpoint endpoint = NetworkEndpoint { };
 	u32 sequence = U32_MAX;
+	u32 baseline = 0U; // last replication tick acknowledged by the client (see: manta/replication.hpp)
 };
 
 
@@ -300,6 +301,9 @@ public:
 	bool connection_register( NetworkConnectionHandle handle );
 	void connection_release( NetworkConnectionHandle handle );
 
+	void connection_acknowledge( NetworkConnectionHandle handle, u32 tick );
+	u32 connection_baseline( NetworkConnectionHandle handle ) const;
+
 	void receive(
 		void ( *callbackOnReceive )( void *context, NetworkConnectionHandle handle, Buffer &buffer ) );
 
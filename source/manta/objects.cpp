@@ -4,6 +4,10 @@
 #include <core/memory.hpp>
 #include <core/buffer.hpp>
 #include <core/serializer.hpp>
+#include <core/string.hpp>
+
+#include <manta/thread.hpp>
+#include <manta/filesystem.hpp>
 
 #include <vendor/vendor.hpp>
 
@@ -47,9 +51,12 @@ bool object_is_child_of( Object thisType, Object otherType )
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-ObjectInstance::Serialization::InstanceTable ObjectInstance::Serialization::instanceTable[CoreObjects::TYPE_COUNT];
-const ObjectContext *ObjectInstance::Serialization::context = nullptr;
-bool ObjectInstance::Serialization::dirty = false;
+thread_local ObjectInstance::Serialization::InstanceTable
+	ObjectInstance::Serialization::instanceTable[CoreObjects::TYPE_COUNT];
+thread_local const ObjectContext *ObjectInstance::Serialization::context = nullptr;
+thread_local bool ObjectInstance::Serialization::dirty = false;
+
+static EventCount saveDone; // impl: ObjectContext::save_async()
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -110,10 +117,19 @@ u32 ObjectInstance::Serialization::InstanceTable::get_serialized_index_from_inst
 void ObjectInstance::Serialization::init()
 {
 	context = nullptr;
+	saveDone.init();
 }
 
 
 void ObjectInstance::Serialization::free()
+{
+	ObjectContext::save_wait();
+	saveDone.free();
+	release();
+}
+
+
+void ObjectInstance::Serialization::release()
 {
 	for( u16 type = 0; type < CoreObjects::TYPE_COUNT; type++ ) { instanceTable[type].free(); }
 	context = nullptr;
@@ -271,6 +287,7 @@ bool ObjectContext::init()
 	capacity = CoreObjects::CATEGORY_TYPE_COUNT[category];
 	current = CoreObjects::CATEGORY_TYPE_COUNT[category];
 	disableEvents = false;
+	frozen = false;
 
 	// Allocate Memory
 	buckets = reinterpret_cast<ObjectBucket *>( memory_alloc( capacity * sizeof( ObjectBucket ) ) );
@@ -301,6 +318,19 @@ bool ObjectContext::free()
 {
 	if( buckets == nullptr ) { return true; }
 
+	// Snapshots own a single allocation and no live objects (see: snapshot())
+	if( frozen )
+	{
+		memory_free( buckets );
+		buckets = nullptr;
+		objectCount = nullptr;
+		bucketCache = nullptr;
+		capacity = 0;
+		current = 0;
+		frozen = false;
+		return true;
+	}
+
 	// Destroy all objects
 	destroy_all();
 
@@ -363,6 +393,7 @@ u16 ObjectContext::new_bucket( u16 type )
 ObjectContext::ObjectBucket *ObjectContext::new_object( u16 type )
 {
 	// Validate type
+	Assert( !frozen );
 	if( TYPE_INVALID( category, type ) ) { return nullptr; }
 
 	// At type capacity?
@@ -438,6 +469,7 @@ ObjectInstance ObjectContext::create( Object type )
 bool ObjectContext::destroy( ObjectInstance &instance )
 {
 	// Fetch Bucket
+	Assert( !frozen );
 	if( UNLIKELY( instance.bucketID >= current ) ) { return false; }
 	ObjectBucket *bucket = &buckets[instance.bucketID];
 	if( TYPE_INVALID( category, instance.type ) ) { return false; }
@@ -543,6 +575,182 @@ bool ObjectContext::deserialize( Buffer &buffer, ObjectContext &context )
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Save file: u64 serialized size | LZAV compressed ObjectContext::serialize() output
+
+#define SNAPSHOT_ALIGNMENT ( 64 )
+#define SNAPSHOT_ALIGN( size ) \
+	( ( ( size ) + ( SNAPSHOT_ALIGNMENT - 1 ) ) & ~static_cast<usize>( SNAPSHOT_ALIGNMENT - 1 ) )
+
+alignas( ObjectContext ) static byte saveContextStorage[sizeof( ObjectContext )];
+static ObjectContext *saveContext = nullptr;
+static char savePath[PATH_SIZE];
+static bool saveSuccess = true;
+static Atomic_U32 saveBusy;
+
+
+void object_context_save_worker()
+{
+	// Serialize, compress, & write the snapshot, then release it (and this thread's instance tables)
+	saveSuccess = ObjectContext::save_file( *saveContext, savePath );
+	saveContext->free();
+	saveContext = nullptr;
+	ObjectInstance::Serialization::release();
+	saveBusy.store( 0 );
+	saveDone.notify_all();
+}
+
+
+static THREAD_FUNCTION( object_context_save_thread )
+{
+	object_context_save_worker();
+	return 0;
+}
+
+
+bool ObjectContext::snapshot( ObjectContext &frozen ) const
+{
+	Assert( is_initialized() );
+	Assert( &frozen != this && frozen.category == category );
+	if( frozen.is_initialized() ) { frozen.free(); }
+
+	// Arena: ObjectBucket[current] | objectCount[] | bucketCache[] | bucket data...
+	const u16 typeCount = CoreObjects::CATEGORY_TYPE_COUNT[category];
+	const usize sizeHeader = SNAPSHOT_ALIGN( current * sizeof( ObjectBucket ) +
+		typeCount * ( sizeof( u32 ) + sizeof( u16 ) ) );
+	usize size = sizeHeader;
+	for( u16 bucketID = 0; bucketID < current; bucketID++ )
+	{
+		const ObjectBucket &bucket = buckets[bucketID];
+		if( bucket.data == nullptr ) { continue; }
+		size += SNAPSHOT_ALIGN( CoreObjects::TYPE_BUCKET_CAPACITY[bucket.type] * CoreObjects::TYPE_SIZE[bucket.type] );
+	}
+
+	byte *arena = reinterpret_cast<byte *>( memory_alloc( size ) );
+	ErrorReturnIf( arena == nullptr, false, "%s: failed to allocate snapshot (%llu bytes)", __FUNCTION__, size );
+
+	// State
+	frozen.buckets = reinterpret_cast<ObjectBucket *>( arena );
+	frozen.objectCount = reinterpret_cast<u32 *>( arena + current * sizeof( ObjectBucket ) );
+	frozen.bucketCache = reinterpret_cast<u16 *>( frozen.objectCount + typeCount );
+	frozen.capacity = current;
+	frozen.current = current;
+	frozen.disableEvents = true;
+	frozen.frozen = true;
+	memory_copy( frozen.objectCount, objectCount, typeCount * sizeof( u32 ) );
+	memory_copy( frozen.bucketCache, bucketCache, typeCount * sizeof( u16 ) );
+
+	// Buckets (bucket data is contiguous, so this is one memcpy per bucket)
+	byte *data = arena + sizeHeader;
+	for( u16 bucketID = 0; bucketID < current; bucketID++ )
+	{
+		const ObjectBucket &bucket = buckets[bucketID];
+		ObjectBucket *copy = new ( &frozen.buckets[bucketID] ) ObjectBucket { frozen };
+		copy->type = bucket.type;
+		copy->bucketIDNext = bucket.bucketIDNext;
+		copy->bucketID = bucket.bucketID;
+		copy->current = bucket.current;
+		copy->bottom = bucket.bottom;
+		copy->top = bucket.top;
+		if( bucket.data == nullptr ) { continue; }
+
+		// Slots past 'top' are dead -- zero them rather than copy them
+		const usize sizeBucket = CoreObjects::TYPE_BUCKET_CAPACITY[bucket.type] * CoreObjects::TYPE_SIZE[bucket.type];
+		const usize sizeLive = bucket.top * CoreObjects::TYPE_SIZE[bucket.type];
+		memory_copy( data, bucket.data, sizeLive );
+		memory_set( data + sizeLive, 0, sizeBucket - sizeLive );
+		copy->data = data;
+		data += SNAPSHOT_ALIGN( sizeBucket );
+	}
+
+	// 'frozen' may reuse the address of a previous snapshot
+	ObjectInstance::Serialization::dirty = true;
+	return true;
+}
+
+
+bool ObjectContext::save_file( const ObjectContext &context, const char *path )
+{
+	Buffer buffer;
+	buffer.init( 1024 + context.count_all() * 64LLU );
+	serialize( buffer, context );
+
+	const u64 sizeSerialized = buffer.size();
+	buffer.compress();
+	buffer.shift( sizeof( u64 ) );
+	buffer.poke<u64>( 0, sizeSerialized );
+
+	const bool success = buffer.save( path );
+	buffer.free();
+	return success;
+}
+
+
+bool ObjectContext::save( const char *path ) const
+{
+	Assert( is_initialized() );
+	save_wait();
+	return save_file( *this, path );
+}
+
+
+bool ObjectContext::save_async( const char *path ) const
+{
+	Assert( is_initialized() );
+	save_wait();
+
+	// Snapshot (the only work done on the calling thread)
+	saveContext = new ( saveContextStorage ) ObjectContext { static_cast<ObjectCategory>( category ) };
+	if( !snapshot( *saveContext ) ) { saveContext = nullptr; return false; }
+	strncpy( savePath, path, sizeof( savePath ) - 1 );
+	savePath[sizeof( savePath ) - 1] = '\0';
+	saveSuccess = false;
+	saveBusy.store( 1 );
+
+	// Without a thread backend, saves are synchronous
+	void *thread = Thread::create( object_context_save_thread );
+	if( thread == nullptr ) { object_context_save_worker(); return saveSuccess; }
+	Thread::free( thread );
+	return true;
+}
+
+
+bool ObjectContext::save_wait()
+{
+	saveDone.wait_until( []() { return saveBusy.load() == 0; } );
+	return saveSuccess;
+}
+
+
+bool ObjectContext::save_busy()
+{
+	return saveBusy.load() != 0;
+}
+
+
+bool ObjectContext::load( const char *path )
+{
+	save_wait();
+
+	Buffer file;
+	if( !file.load( path ) ) { return false; }
+
+	u64 sizeSerialized = 0LLU;
+	bool success = file.read<u64>( sizeSerialized );
+	if( success )
+	{
+		Buffer buffer;
+		buffer.init( sizeSerialized );
+		success = buffer.decompress( file.tell_ptr(), file.bytes_remaining(), sizeSerialized ) &&
+			deserialize( buffer, *this );
+		buffer.free();
+	}
+
+	file.free();
+	return success;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 bool ObjectContext::ObjectBucket::init( u16 type )
 {
 	// State
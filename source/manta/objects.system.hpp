@@ -19,6 +19,8 @@ template <Object_t T> struct ObjectHandle;
 
 class Serializer; // <core/serializer.hpp>
 class Deserializer; // <core/serializer.hpp>
+class BitWriter; // <manta/replication.hpp>
+class BitReader; // <manta/replication.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -62,6 +64,17 @@ namespace CoreObjects
 	// constexpr void ( *TYPE_DESTRUCT[] )( void * ) = { ... }  // IMP: objects.generated.hpp
 
 	template <Object_t T> struct OBJECT_ENCODER;
+	template <Object_t T> struct OBJECT_REPLICATION;
+
+	struct TypeReplication
+	{
+		u16 fields; // REPLICATED variable count (0: type is not replicated)
+		u16 stateSize; // sizeof( OBJECT_REPLICATION<T>::State )
+		u32 ( *sample )( void *object, void *state ); // returns mask of variables changed since 'state'
+		void ( *write )( BitWriter &bits, const void *state, u32 mask );
+		bool ( *read )( BitReader &bits, void *object, u32 mask );
+	};
+	extern const TypeReplication TYPE_REPLICATION[CoreObjects::TYPE_COUNT];
 
 	extern bool init();
 	extern bool free();
@@ -119,18 +132,20 @@ public:
 		};
 
 	public:
+		// State is per-thread, so a background save_async() never shares tables with the main thread
 		static void init();
 		static void free();
+		static void release(); // Frees the calling thread's instance tables
 		static void prepare( const ObjectContext &context );
 		static u32 get_serialized_index_from_instance( const ObjectInstance &instance );
 		static ObjectInstance get_instance_from_serialized_index( Object type, u32 index );
 
 	private:
-		static InstanceTable instanceTable[];
-		static const ObjectContext *context;
+		static thread_local InstanceTable instanceTable[];
+		static thread_local const ObjectContext *context;
 
 	public:
-		static bool dirty;
+		static thread_local bool dirty;
 	};
 
 	static void serialize( Buffer &buffer, const ObjectInstance &instance );
@@ -163,6 +178,8 @@ class ObjectContext
 private:
 	friend ObjectInstance;
 	friend ObjectInstance::Serialization;
+	friend class ReplicationServer;
+	friend void object_context_save_worker(); // impl: objects.cpp
 
 public:
 	ObjectContext() : category { 0 } { };
@@ -198,6 +215,22 @@ public:
 	u32 count( const Object type ) const;
 	u32 count_all() const;
 
+	// Save games: save() serializes, compresses (LZAV), and writes on the calling thread. save_async() only
+	// snapshots bucket memory on the calling thread; the rest runs on a background thread with its own
+	// ObjectInstance::Serialization tables. One save may be in flight at a time (the snapshot storage is shared),
+	// so save_async() waits on the previous save.
+	// NOTE: Snapshots copy object memory, not memory owned by objects (List, String, ...) -- serialized members
+	// that own heap memory must not be reallocated or freed until save_wait() returns
+	bool save( const char *path ) const;
+	bool save_async( const char *path ) const;
+	NO_DISCARD bool load( const char *path );
+	static bool save_wait(); // Returns the success of the last save_async()
+	static bool save_busy();
+
+	// Copies bucket memory into 'frozen' (one allocation, no constructors or events). Frozen contexts are
+	// read-only: they may be iterated and serialized, but not create or destroy objects
+	bool snapshot( ObjectContext &frozen ) const;
+
 	// impl: objects.generated.cpp
 	void event_create();
 	void event_destroy();
@@ -217,6 +250,10 @@ public:
 	void event_wake( Delta delta );
 	void event_flag( u64 code );
 	void event_partition( void *ptr );
+
+	// impl: replication.cpp
+	// Sample & send through the attached ReplicationServer, or reassemble & apply a datagram through the
+	// attached ReplicationClient (returns false when nothing is attached)
 	bool event_network_send( Buffer &buffer );
 	bool event_network_receive( Buffer &buffer );
 
@@ -226,6 +263,9 @@ public:
 	static void serialize( Buffer &buffer, const ObjectContext &context );
 	NO_DISCARD static bool deserialize( Buffer &buffer, ObjectContext &context );
 
+	// impl: objects.cpp
+	static bool save_file( const ObjectContext &context, const char *path );
+
 #if COMPILE_DEBUG
 	void draw( Delta delta, float x, float y );
 #endif
@@ -333,7 +373,8 @@ private:
 	u16 capacity = 0; // Number of allocated ObjectBucket slots
 	u16 current = 0; // Current ObjectBucket insertion index
 	u16 disableEvents : 1;
-	u16 __unused : 15;
+	u16 frozen : 1; // snapshot() copy: 'buckets' is a single allocation holding all memory
+	u16 __unused : 14;
 	const ObjectCategory_t category;
 };
 static_assert( sizeof( ObjectContext ) == 32, "ObjectContext size changed!" );
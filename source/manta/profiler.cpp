@@ -6,6 +6,7 @@
 
 #include <vendor/string.hpp>
 #include <vendor/new.hpp>
+#include <vendor/stdlib.hpp>
 
 #include <manta/thread.hpp>
 #include <manta/draw.hpp>
@@ -19,31 +20,215 @@ namespace CoreProfiler
 ProfilerManager PROFILER;
 static bool SHOW_PROFILER = false;
 
+enum_type( ProfilerSlot, u32 )
+{
+	ProfilerSlot_Free,
+	ProfilerSlot_Claimed, // Registering thread is initializing 'threads[slot]'
+	ProfilerSlot_Live,
+	ProfilerSlot_Exited,  // Thread exited: the main thread drains & frees it (see: threads_reclaim)
+};
+
+static ProfilerThread *threads[ProfilerManager::MAX_THREADS];
+static Atomic_U32 threadSlots[ProfilerManager::MAX_THREADS];
+static Atomic_U32 threadIds; // Trace 'tid' -- never reused, unlike slots
+thread_local static ProfilerThread *threadLocal = nullptr;
+
 
-void ProfilerManager::init()
+struct ProfilerThreadExit
 {
-	CoreTime::init();
+	~ProfilerThreadExit()
+	{
+		if( slot == U32_MAX ) { return; }
+		threadLocal = nullptr;
+		threadSlots[slot].store( ProfilerSlot_Exited );
+	}
 
+	u32 slot = U32_MAX;
+};
+
+thread_local static ProfilerThreadExit threadExit;
+
+
+double time_us()
+{
+	return Time::value() * 1000.0 * 1000.0;
+}
+
+
+ProfilerThread *thread_register( const char *name )
+{
+	if( threadLocal != nullptr )
+	{
+		// Already registered (possibly lazily) -- just apply the name
+		threadLocal->name = name;
+		return threadLocal;
+	}
+
+	for( u32 slot = 0; slot < ProfilerManager::MAX_THREADS; slot++ )
+	{
+		u32 expected = ProfilerSlot_Free;
+		if( !threadSlots[slot].compare_exchange_strong( expected, ProfilerSlot_Claimed ) ) { continue; }
+
+		ProfilerThread *thread = reinterpret_cast<ProfilerThread *>( memory_alloc( sizeof( ProfilerThread ) ) );
+		thread->init( threadIds.fetch_add( 1 ), name );
+		threads[slot] = thread;
+		threadSlots[slot].store( ProfilerSlot_Live );
+		threadLocal = thread;
+		threadExit.slot = slot;
+		return thread;
+	}
+
+	return nullptr;
+}
+
+
+static ProfilerThread *thread_slot( u32 slot )
+{
+	// Main thread: registered thread in 'slot' (live or exited but not yet reclaimed), or nullptr
+	const u32 state = threadSlots[slot].load();
+	return state == ProfilerSlot_Live || state == ProfilerSlot_Exited ? threads[slot] : nullptr;
+}
+
+
+ProfilerThread *thread_current()
+{
+	if( LIKELY( threadLocal != nullptr ) ) { return threadLocal; }
+	return thread_register( Thread::id() == THREAD_ID_MAIN ? "Main" : "Thread" );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ProfilerThread::init( u32 id, const char *name )
+{
+	this->id = id;
+	this->name = name;
+	this->depth = 0;
+	events = nullptr;
+	head.init( 0 );
+	tail.init( 0 );
+	dropped.init( 0 );
+	buffer.init( ProfilerBuffer_None );
+}
+
+
+void ProfilerThread::free()
+{
+	if( events != nullptr ) { memory_free( events ); }
+	events = nullptr;
+}
+
+
+bool ProfilerThread::push( const ProfilerEvent &event )
+{
+	if( UNLIKELY( buffer.load() != ProfilerBuffer_Live ) )
+	{
+		// First event of a capture: allocate (or reuse the retired buffer) -- the consumer is not reading it
+		if( events == nullptr )
+		{
+			events = reinterpret_cast<ProfilerEvent *>( memory_alloc( CAPACITY * sizeof( ProfilerEvent ) ) );
+		}
+		head.store( 0 );
+		tail.store( 0 );
+		buffer.store( ProfilerBuffer_Live );
+	}
+
+	const u32 h = head.v; // Only this thread writes 'head'
+	if( h - tail.load() >= CAPACITY ) { dropped.increment(); return false; }
+	events[h & ( CAPACITY - 1 )] = event;
+	head.store( h + 1 );
+	return true;
+}
+
+
+bool ProfilerThread::pop( ProfilerEvent &event )
+{
+	const u32 t = tail.v; // Only the consumer writes 'tail'
+	if( t == head.load() ) { return false; }
+	event = events[t & ( CAPACITY - 1 )];
+	tail.store( t + 1 );
+	return true;
+}
+
+
+void ProfilerThread::release()
+{
+	// Producer: free the buffer once the consumer retired it (the consumer never frees, so a late push racing
+	// trace_stop() still writes to valid memory)
+	if( buffer.load() != ProfilerBuffer_Retired ) { return; }
+	free();
+	buffer.store( ProfilerBuffer_None );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void threads_reclaim()
+{
+	// Main thread: release the slots of exited threads (their events are drained first when tracing)
+	for( u32 slot = 0; slot < ProfilerManager::MAX_THREADS; slot++ )
+	{
+		if( threadSlots[slot].load() != ProfilerSlot_Exited ) { continue; }
+		ProfilerThread *thread = threads[slot];
+		if( PROFILER.trace_active() ) { PROFILER.trace_flush_thread( thread ); }
+		thread->free();
+		memory_free( thread );
+		threads[slot] = nullptr;
+		threadSlots[slot].store( ProfilerSlot_Free );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ProfilerManager::init( int argc, char **argv )
+{
 	clear();
 
-	Console::command_init( "profiler <enabled>", "Enable the profiler overlay", CONSOLE_COMMAND_LAMBDA
+	Console::command_init( "profiler <enabled> <trace> <frames>",
+		"Enable the profiler overlay (and optionally capture a Chrome/Perfetto trace to a .json file)",
+		CONSOLE_COMMAND_LAMBDA
 		{
 			SHOW_PROFILER = Console::get_parameter_bool( 0, !SHOW_PROFILER );
 			Console::Log( c_white, "profiler %d", SHOW_PROFILER );
+
+			const char *path = Console::get_parameter_string( 1, "" );
+			if( path[0] != '\0' )
+			{
+				if( PROFILER.trace_active() ) { PROFILER.trace_stop(); }
+				if( SHOW_PROFILER ) { PROFILER.trace_start( path, Console::get_parameter_u32( 2, 0 ) ); }
+			}
+			else if( !SHOW_PROFILER && PROFILER.trace_active() )
+			{
+				PROFILER.trace_stop();
+			}
 		} );
+
+	// Command Line: -profiler-trace=<path> -profiler-frames=<count>
+	const char *tracePath = nullptr;
+	u32 traceFrames = 0;
+	for( int i = 1; i < argc; i++ )
+	{
+		if( strncmp( argv[i], "-profiler-trace=", 16 ) == 0 ) { tracePath = argv[i] + 16; }
+		else if( strncmp( argv[i], "-profiler-frames=", 17 ) == 0 )
+		{
+			traceFrames = static_cast<u32>( strtoull( argv[i] + 17, nullptr, 10 ) );
+		}
+	}
+	if( tracePath != nullptr ) { trace_start( tracePath, traceFrames ); }
 }
 
 
 void ProfilerManager::free()
 {
-	/// ...
+	if( trace_active() ) { trace_stop(); }
+	threads_reclaim();
 }
 
 
 void ProfilerManager::clear()
 {
 	Assert( !capturingFrame );
+	Assert( traceFile == nullptr );
 	new ( this ) ProfilerManager();
+	tracing.init( 0 );
 }
 
 
@@ -64,15 +249,21 @@ void ProfilerManager::frame_start()
 	snapshotsCount[frameCurrent] = { 0 };
 	snapshotCurrent = 0;
 	depthCurrent = 0;
-	timer.start();
-	frameTimeStart = timer.us();
+	frameTimeStart = time_us();
 }
 
 
 void ProfilerManager::frame_end()
 {
+	if( trace_active() )
+	{
+		trace_flush();
+		if( traceFramesRemaining > 0 && --traceFramesRemaining == 0 ) { trace_stop(); }
+	}
+	threads_reclaim();
+
 	if( !capturingFrame ) { return; }
-	frameTimeUS[frameCurrent] = timer.us() - frameTimeStart;
+	frameTimeUS[frameCurrent] = time_us() - frameTimeStart;
 	snapshotsCount[frameCurrent] = snapshotCurrent;
 	frameCurrent = ( frameCurrent + 1 ) % MAX_FRAMES;
 
@@ -89,6 +280,123 @@ void ProfilerManager::frame_end()
 	frameTimeUSAverage /= static_cast<double>( MAX_FRAMES );
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static void trace_write_string( FILE *file, const char *string )
+{
+	// JSON string escape (names are static identifiers, so this only needs to cover the basics)
+	char buffer[256];
+	usize length = 0;
+	buffer[length++] = '"';
+	for( const char *c = string; *c != '\0' && length < sizeof( buffer ) - 3; c++ )
+	{
+		if( *c == '"' || *c == '\\' ) { buffer[length++] = '\\'; }
+		buffer[length++] = ( *c < ' ' ) ? ' ' : *c;
+	}
+	buffer[length++] = '"';
+	fwrite( buffer, 1, length, file );
+}
+
+
+bool ProfilerManager::trace_start( const char *path, u32 frames )
+{
+	if( trace_active() ) { return false; }
+
+	traceFile = fopen( path, "wb" );
+	if( traceFile == nullptr )
+	{
+		Console::Log( c_red, "profiler: failed to open trace file '%s'", path );
+		return false;
+	}
+
+	// Discard anything the worker threads recorded before the capture started
+	for( u32 slot = 0; slot < MAX_THREADS; slot++ )
+	{
+		ProfilerThread *thread = thread_slot( slot );
+		if( thread == nullptr || thread->buffer.load() != ProfilerBuffer_Live ) { continue; }
+		ProfilerEvent event;
+		while( thread->pop( event ) ) { }
+	}
+
+	const char *header = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	fwrite( header, 1, strlen( header ), traceFile );
+
+	traceEventCount = 0;
+	traceFramesRemaining = frames;
+	tracing.store( 1 );
+
+	Console::Log( c_lime, "profiler: capturing trace to '%s'", path );
+	return true;
+}
+
+
+bool ProfilerManager::trace_stop()
+{
+	if( !trace_active() ) { return false; }
+	tracing.store( 0 );
+
+	// Drain the remaining events & write thread names
+	trace_flush();
+
+	char buffer[128];
+	u32 dropped = 0;
+	for( u32 slot = 0; slot < MAX_THREADS; slot++ )
+	{
+		ProfilerThread *thread = thread_slot( slot );
+		if( thread == nullptr ) { continue; }
+		const int length = snprintf( buffer, sizeof( buffer ),
+			"%s{\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"name\":\"thread_name\",\"args\":{\"name\":",
+			traceEventCount++ == 0 ? "" : ",\n", thread->id );
+		fwrite( buffer, 1, length, traceFile );
+		trace_write_string( traceFile, thread->name );
+		fwrite( "}}", 1, 2, traceFile );
+		dropped += thread->dropped.exchange( 0 );
+
+		// Hand the buffer back to its thread to free
+		u32 expected = ProfilerBuffer_Live;
+		thread->buffer.compare_exchange_strong( expected, ProfilerBuffer_Retired );
+	}
+
+	const char *footer = "\n]}\n";
+	fwrite( footer, 1, strlen( footer ), traceFile );
+	fclose( traceFile );
+	traceFile = nullptr;
+
+	Console::Log( c_lime, "profiler: wrote %u trace events (%u dropped)", traceEventCount, dropped );
+	return true;
+}
+
+
+void ProfilerManager::trace_flush()
+{
+	// Drains every thread's ring buffer into the trace file (main thread only)
+	if( traceFile == nullptr ) { return; }
+	for( u32 slot = 0; slot < MAX_THREADS; slot++ ) { trace_flush_thread( thread_slot( slot ) ); }
+}
+
+
+void ProfilerManager::trace_flush_thread( ProfilerThread *thread )
+{
+	if( traceFile == nullptr || thread == nullptr ) { return; }
+	if( thread->buffer.load() != ProfilerBuffer_Live ) { return; }
+
+	char buffer[128];
+	ProfilerEvent event;
+	while( thread->pop( event ) )
+	{
+		const int length = snprintf( buffer, sizeof( buffer ),
+			"%s{\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"name\":",
+			traceEventCount++ == 0 ? "" : ",\n", thread->id,
+			event.timeStartUS, event.timeEndUS - event.timeStartUS );
+		fwrite( buffer, 1, length, traceFile );
+		trace_write_string( traceFile, event.nameSnapshot );
+		fwrite( ",\"cat\":", 1, 7, traceFile );
+		trace_write_string( traceFile, event.nameFunction );
+		fwrite( "}", 1, 1, traceFile );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void ProfilerManager::draw( Delta delta )
 {
@@ -207,24 +515,44 @@ void ProfilerManager::draw( Delta delta )
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-ProfilerScope::ProfilerScope( const char *nameSnapshot, const char *nameFunction, Color color )
+ProfilerScope::ProfilerScope( const char *nameSnapshot, const char *nameFunction, Color color ) :
+	nameSnapshot { nameSnapshot }, nameFunction { nameFunction }
 {
-	if( !PROFILER.capturingFrame || PROFILER.snapshotCurrent >= ProfilerManager::MAX_SNAPSHOTS ) { return; }
+	thread = thread_current();
+	timeStartUS = time_us();
+	depth = thread != nullptr ? thread->depth++ : 0;
+
+	// Main thread overlay
+	if( !PROFILER.capturingFrame || Thread::id() != THREAD_ID_MAIN ) { return; }
+	if( PROFILER.snapshotCurrent >= ProfilerManager::MAX_SNAPSHOTS ) { return; }
 	snapshot = &PROFILER.snapshots[PROFILER.frameCurrent][PROFILER.snapshotCurrent++];
-	::strncpy( snapshot->nameSnapshot, nameSnapshot, sizeof( snapshot->nameSnapshot ) - 1 );
-	snapshot->nameSnapshot[sizeof( snapshot->nameSnapshot ) - 1] = '\0';
-	::strncpy( snapshot->nameFunction, nameFunction, sizeof( snapshot->nameFunction ) - 1 );
-	snapshot->nameFunction[sizeof( snapshot->nameFunction ) - 1] = '\0';
+	snapshot->nameSnapshot = nameSnapshot;
+	snapshot->nameFunction = nameFunction;
 	snapshot->color = color;
 	snapshot->depth = PROFILER.depthCurrent++;
-	snapshot->timeStartUS = PROFILER.timer.us();
+	snapshot->timeStartUS = timeStartUS - PROFILER.frameTimeStart;
 }
 
 
 ProfilerScope::~ProfilerScope()
 {
+	const double timeEndUS = time_us();
+
+	if( thread != nullptr )
+	{
+		thread->depth--;
+		if( PROFILER.trace_active() )
+		{
+			thread->push( ProfilerEvent { nameSnapshot, nameFunction, timeStartUS, timeEndUS, depth } );
+		}
+		else if( UNLIKELY( thread->buffer.load() == ProfilerBuffer_Retired ) )
+		{
+			thread->release();
+		}
+	}
+
 	if( !snapshot ) { return; }
-	snapshot->timeEndUS = PROFILER.timer.us();
+	snapshot->timeEndUS = timeEndUS - PROFILER.frameTimeStart;
 	PROFILER.depthCurrent--;
 }
 
@@ -6,8 +6,11 @@
 
 #if COMPILE_PROFILING
 
+#include <vendor/stdio.hpp>
+
 #include <core/color.hpp>
 #include <manta/time.hpp>
+#include <manta/thread.hpp>
 
 namespace CoreProfiler
 {
@@ -15,8 +18,9 @@ namespace CoreProfiler
 
 struct ProfilerSnapshot
 {
-	char nameSnapshot[128] = "";
-	char nameFunction[128] = "";
+	// NOTE: Names must be static strings (string literals, __FUNCTION__, etc.)
+	const char *nameSnapshot = "";
+	const char *nameFunction = "";
 	Color color = Color { 0, 0, 0, 0 };
 	double timeStartUS = 0.0;
 	double timeEndUS = 0.0;
@@ -24,10 +28,55 @@ struct ProfilerSnapshot
 };
 
 
+struct ProfilerEvent
+{
+	const char *nameSnapshot;
+	const char *nameFunction;
+	double timeStartUS;
+	double timeEndUS;
+	int depth;
+};
+
+
+enum_type( ProfilerBuffer, u32 )
+{
+	ProfilerBuffer_None,    // Not allocated
+	ProfilerBuffer_Live,    // Allocated by the producer, readable by the consumer
+	ProfilerBuffer_Retired, // Released by the consumer, to be freed (or reused) by the producer
+};
+
+
+class ProfilerThread
+{
+public:
+	// Single-producer (owning thread), single-consumer (main thread) ring buffer of completed scopes
+	// The buffer only exists while tracing: the producer allocates it on its first event of a capture and frees it
+	// on its first scope after the capture ended (see: ProfilerThread::push, ProfilerThread::release)
+	static constexpr u32 CAPACITY = 16384;
+	static_assert( ( CAPACITY & ( CAPACITY - 1 ) ) == 0, "CAPACITY must be a power of two" );
+
+	void init( u32 id, const char *name );
+	void free();
+	bool push( const ProfilerEvent &event );
+	bool pop( ProfilerEvent &event );
+	void release();
+
+public:
+	ProfilerEvent *events = nullptr;
+	alignas( 64 ) Atomic_U32 head; // Written by producer
+	alignas( 64 ) Atomic_U32 tail; // Written by consumer
+	Atomic_U32 dropped;
+	Atomic_U32 buffer; // ProfilerBuffer
+	const char *name = "";
+	u32 id = 0;
+	int depth = 0;
+};
+
+
 class ProfilerManager
 {
 public:
-	void init();
+	void init( int argc, char **argv );
 	void free();
 	void clear();
 	void start();
@@ -37,9 +86,16 @@ public:
 
 	void draw( Delta delta );
 
+	bool trace_start( const char *path, u32 frames = 0 );
+	bool trace_stop();
+	void trace_flush();
+	void trace_flush_thread( ProfilerThread *thread );
+	bool trace_active() const { return tracing.load() != 0; }
+
 public:
 	static constexpr int MAX_SNAPSHOTS = 512;
 	static constexpr int MAX_FRAMES = 144;
+	static constexpr int MAX_THREADS = 32; // Registered at a time: slots are released when threads exit
 
 	ProfilerSnapshot snapshots[MAX_FRAMES][MAX_SNAPSHOTS] = { };
 	int snapshotsCount[MAX_FRAMES] = { 0 };
@@ -52,16 +108,24 @@ public:
 	int depthCurrent = 0;
 	int frameCurrent = 0;
 
-
 	bool capturingFrame = false;
 	bool capturing = true;
-	Timer timer;
+
+	Atomic_U32 tracing;
+	FILE *traceFile = nullptr;
+	u32 traceFramesRemaining = 0;
+	u32 traceEventCount = 0;
 };
 
 
 extern ProfilerManager PROFILER;
 
 
+extern ProfilerThread *thread_register( const char *name );
+extern ProfilerThread *thread_current();
+extern double time_us();
+
+
 class ProfilerScope
 {
 public:
@@ -69,6 +133,11 @@ public:
 	~ProfilerScope();
 
 	ProfilerSnapshot *snapshot = nullptr;
+	ProfilerThread *thread = nullptr;
+	const char *nameSnapshot;
+	const char *nameFunction;
+	double timeStartUS;
+	int depth;
 };
 
 };
@@ -84,10 +153,14 @@ public:
 
 	#define PROFILE_SCOPE_COLOR( name, color ) \
 		CoreProfiler::ProfilerScope _PROFILE_SCOPE_ { name, __FUNCTION__, color };
+
+	#define PROFILE_THREAD( name ) \
+		CoreProfiler::thread_register( name );
 #else
 	#define PROFILING( code )
 	#define PROFILE_SCOPE( name )
 	#define PROFILE_SCOPE_COLOR( name, color )
+	#define PROFILE_THREAD( name )
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
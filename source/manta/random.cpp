@@ -3,6 +3,43 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+#define PCG_MULTIPLIER ( 6364136223846793005ULL )
+
+static inline u32 pcg_output( u64 state )
+{
+	u32 xorshifted = static_cast<u32>( ( ( state >> 18 ) ^ state ) >> 27 );
+	u32 rot = state >> 59;
+	return ( xorshifted >> rot ) | ( xorshifted << ( ( ~rot + 1 ) & 31 ) );
+}
+
+
+static void pcg_jump( u64 delta, u64 increment, u64 &multiplier, u64 &plus )
+{
+	// Compose 'delta' LCG steps: state' = multiplier * state + plus (Brown, "Random Number Generation with Arbitrary
+	// Strides", 1994) -- square-and-multiply over the bits of delta
+	u64 accMultiplier = 1;
+	u64 accPlus = 0;
+	u64 curMultiplier = PCG_MULTIPLIER;
+	u64 curPlus = increment;
+
+	while( delta > 0 )
+	{
+		if( delta & 1 )
+		{
+			accMultiplier *= curMultiplier;
+			accPlus = accPlus * curMultiplier + curPlus;
+		}
+		curPlus = ( curMultiplier + 1 ) * curPlus;
+		curMultiplier *= curMultiplier;
+		delta >>= 1;
+	}
+
+	multiplier = accMultiplier;
+	plus = accPlus;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 Random::Random()
 {
 	this->seed( Time::seed() );
@@ -15,26 +52,76 @@ Random::Random( u64 seed )
 }
 
 
+Random::Random( u64 seed, u64 stream )
+{
+	this->seed( seed, stream );
+}
+
+
 void Random::seed( u64 seed )
+{
+	this->seed( seed, seed );
+}
+
+
+void Random::seed( u64 seed, u64 stream )
 {
 	state = 0;
-	where = ( seed << 1 ) | 1;
+	where = ( stream << 1 ) | 1;
 	base();
 	state += seed;
 	base();
 }
 
 
+void Random::advance( u64 delta )
+{
+	u64 multiplier, plus;
+	pcg_jump( delta, where, multiplier, plus );
+	state = state * multiplier + plus;
+}
+
+
 u32 Random::base()
 {
-    // Advance State
+	// Advance State
 	u64 oldstate = state;
-    state = oldstate * 6364136223846793005 + where;
+	state = oldstate * PCG_MULTIPLIER + where;
+
+	// Calculate Output
+	return pcg_output( oldstate );
+}
+
+
+void Random::fill_u32( u32 *output, usize count )
+{
+	// Keep the state in a register for the whole run; base() round-trips it through memory every call
+	u64 current = state;
+	const u64 increment = where;
+
+	for( usize i = 0; i < count; i++ )
+	{
+		output[i] = pcg_output( current );
+		current = current * PCG_MULTIPLIER + increment;
+	}
+
+	state = current;
+}
+
+
+void Random::fill_float( float *output, usize count, float min, float max )
+{
+	u64 current = state;
+	const u64 increment = where;
+	const float range = max - min;
+
+	for( usize i = 0; i < count; i++ )
+	{
+		output[i] = pcg_output( current ) * 0x1.0p-32f * range + min;
+		current = current * PCG_MULTIPLIER + increment;
+	}
 
-    // Calculate Output
-    u32 xorshifted = static_cast<u32>( ( ( oldstate >> 18 ) ^ oldstate ) >> 27 );
-    u32 rot = oldstate >> 59;
-    return ( xorshifted >> rot ) | ( xorshifted << ( ( ~rot + 1 ) & 31 ) );
+	state = current;
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
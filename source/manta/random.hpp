@@ -6,15 +6,31 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// PCG32
+//
+// seed( seed ) is seed( seed, seed ): 'stream' selects the LCG increment, so generators with the same seed on different
+// streams are independent. advance() jumps over outputs in O(log n), which makes parallel use deterministic: give
+// each job a copy of one generator advanced to the start of its range, and the job's fill_u32()/fill_float() output
+// is exactly what the single generator would have produced there -- however the range is split.
+//
+// fill_u32()/fill_float() produce the same values as repeated base()/next_float() calls, with the state held in a
+// register for the whole run.
+
 class Random
 {
 public:
 	Random();
 	Random( u64 seed );
+	Random( u64 seed, u64 stream );
 
 	void seed( u64 seed );
+	void seed( u64 seed, u64 stream );
+	void advance( u64 delta );
 	u32 base();
 
+	void fill_u32( u32 *output, usize count );
+	void fill_float( float *output, usize count, float min, float max );
+
 	int next_int( int min, int max );
 	int next_int( int max );
 	u64 next_u64( u64 min, u64 max );
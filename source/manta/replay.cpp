@@ -0,0 +1,506 @@
+#include <manta/replay.hpp>
+
+#include <vendor/stdio.hpp>
+#include <vendor/string.hpp>
+
+#include <core/debug.hpp>
+#include <core/buffer.hpp>
+#include <core/list.hpp>
+
+#include <manta/engine.hpp>
+#include <manta/console.hpp>
+#include <manta/profiler.hpp>
+#include <manta/input.hpp>
+#include <manta/time.hpp>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Frame flags
+static constexpr u8 REPLAY_FRAME_DELTA = ( 1 << 0 ); // Delta (Frame::delta changed)
+static constexpr u8 REPLAY_FRAME_KEYS = ( 1 << 1 ); // u8 count - 1, u8 keys[count] (keyCurrent toggled)
+static constexpr u8 REPLAY_FRAME_REPEAT = ( 1 << 2 ); // u8 count - 1, u8 keys[count] (keyRepeat set)
+static constexpr u8 REPLAY_FRAME_TEXT = ( 1 << 3 ); // u8 length, char text[length] (inputBuffer)
+static constexpr u8 REPLAY_FRAME_MOUSE = ( 1 << 4 ); // u16 field mask, u32 fields[popcount] (Mouse::State changed)
+
+// Mouse::State is diffed as an array of 32-bit fields
+static constexpr u32 REPLAY_MOUSE_FIELDS = sizeof( Mouse::State ) / sizeof( u32 );
+static_assert( sizeof( Mouse::State ) == REPLAY_MOUSE_FIELDS * sizeof( u32 ), "Mouse::State must be 32-bit fields" );
+static_assert( REPLAY_MOUSE_FIELDS <= 16, "Mouse::State field mask is u16" );
+
+static constexpr usize REPLAY_TEXT_LENGTH = sizeof( Keyboard::State::inputBuffer ) - 1;
+static constexpr usize REPLAY_FRAME_SIZE_MAX = 1 + sizeof( Delta ) + ( 1 + 256 ) * 2 + ( 1 + REPLAY_TEXT_LENGTH ) +
+	sizeof( u16 ) + sizeof( Mouse::State );
+
+struct ReplayHeader
+{
+	u32 magic;
+	u32 version;
+};
+
+
+struct ReplayInput
+{
+	Delta delta;
+	bool keyCurrent[256];
+	bool keyRepeat[256];
+	char inputBuffer[REPLAY_TEXT_LENGTH + 1];
+	u32 mouse[REPLAY_MOUSE_FIELDS];
+};
+
+
+#if COMPILE_PROFILING
+struct ReplayScope
+{
+	const char *name;
+	double timeUS;
+	u32 count;
+};
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static CommandHandle CMD_REPLAY_RECORD;
+static CommandHandle CMD_REPLAY_PLAY;
+static CommandHandle CMD_REPLAY_STOP;
+
+// Record
+static FILE *recordFile = nullptr;
+static ReplayInput recordState;
+static u32 recordFrames = 0;
+static usize recordBytes = 0LLU;
+
+// Replay
+static Buffer playBuffer;
+static ReplayInput playState;
+static char playPath[256];
+static bool playExit = false;
+static bool playFrame = false; // current frame is driven by the replay
+static double playFrameTimeStart = 0.0;
+static double playDeltaTotal = 0.0;
+static List<double> playFrameTimes; // milliseconds
+#if COMPILE_PROFILING
+static List<ReplayScope> playScopes;
+#endif
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static usize record_keys( byte *frame, usize size, const bool *keys, bool *state, const bool toggled )
+{
+	// Writes u8 count - 1 followed by the keys that toggled (or are set), returns the new size (unchanged if none)
+	const usize sizeCount = size++;
+	for( int key = 0; key < 256; key++ )
+	{
+		if( toggled ? keys[key] == state[key] : !keys[key] ) { continue; }
+		if( toggled ) { state[key] = keys[key]; }
+		frame[size++] = static_cast<byte>( key );
+	}
+
+	if( size == sizeCount + 1 ) { return sizeCount; }
+	frame[sizeCount] = static_cast<byte>( size - sizeCount - 2 );
+	return size;
+}
+
+
+static void record_frame()
+{
+	const Keyboard::State &keyboard = Keyboard::state();
+	const Mouse::State &mouse = Mouse::state();
+
+	byte frame[REPLAY_FRAME_SIZE_MAX];
+	usize size = 1;
+	u8 flags = 0;
+
+	// Delta
+	if( Frame::delta != recordState.delta )
+	{
+		flags |= REPLAY_FRAME_DELTA;
+		recordState.delta = Frame::delta;
+		memcpy( frame + size, &recordState.delta, sizeof( Delta ) );
+		size += sizeof( Delta );
+	}
+
+	// Keys
+	const usize sizeKeys = size;
+	size = record_keys( frame, size, keyboard.keyCurrent, recordState.keyCurrent, true );
+	flags |= size != sizeKeys ? REPLAY_FRAME_KEYS : 0;
+
+	const usize sizeRepeat = size;
+	size = record_keys( frame, size, keyboard.keyRepeat, recordState.keyRepeat, false );
+	flags |= size != sizeRepeat ? REPLAY_FRAME_REPEAT : 0;
+
+	// Text
+	usize length = 0;
+	while( length < REPLAY_TEXT_LENGTH && keyboard.inputBuffer[length] != '\0' ) { length++; }
+	if( length > 0 )
+	{
+		flags |= REPLAY_FRAME_TEXT;
+		frame[size++] = static_cast<byte>( length );
+		memcpy( frame + size, keyboard.inputBuffer, length );
+		size += length;
+	}
+
+	// Mouse
+	u32 fields[REPLAY_MOUSE_FIELDS];
+	memcpy( fields, &mouse, sizeof( Mouse::State ) );
+	u16 mask = 0;
+	const usize sizeMask = size;
+	size += sizeof( u16 );
+	for( u32 i = 0; i < REPLAY_MOUSE_FIELDS; i++ )
+	{
+		if( fields[i] == recordState.mouse[i] ) { continue; }
+		recordState.mouse[i] = fields[i];
+		mask |= static_cast<u16>( 1 << i );
+		memcpy( frame + size, &fields[i], sizeof( u32 ) );
+		size += sizeof( u32 );
+	}
+
+	if( mask != 0 ) { flags |= REPLAY_FRAME_MOUSE; memcpy( frame + sizeMask, &mask, sizeof( u16 ) ); }
+	else { size = sizeMask; }
+
+	// Write
+	frame[0] = flags;
+	fwrite( frame, 1, size, recordFile );
+	if( Frame::tickSecond ) { fflush( recordFile ); } // Keep the recording usable if the process is killed
+	recordFrames++;
+	recordBytes += size;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static bool play_read_frame()
+{
+	// Bounds-checked reads (a truncated recording ends the replay rather than asserting)
+	const byte *data = playBuffer.data;
+	const usize size = playBuffer.size();
+	usize tell = playBuffer.tell;
+	auto read = [&]( void *dest, const usize bytes )
+	{
+		if( tell + bytes > size ) { return false; }
+		memcpy( dest, data + tell, bytes );
+		tell += bytes;
+		return true;
+	};
+
+	u8 flags;
+	if( !read( &flags, 1 ) ) { return false; }
+
+	// Delta
+	if( ( flags & REPLAY_FRAME_DELTA ) && !read( &playState.delta, sizeof( Delta ) ) ) { return false; }
+
+	// Keys
+	if( flags & REPLAY_FRAME_KEYS )
+	{
+		u8 count, key;
+		if( !read( &count, 1 ) ) { return false; }
+		for( u32 i = 0; i <= count; i++ )
+		{
+			if( !read( &key, 1 ) ) { return false; }
+			playState.keyCurrent[key] = !playState.keyCurrent[key];
+		}
+	}
+
+	memset( playState.keyRepeat, 0, sizeof( playState.keyRepeat ) );
+	if( flags & REPLAY_FRAME_REPEAT )
+	{
+		u8 count, key;
+		if( !read( &count, 1 ) ) { return false; }
+		for( u32 i = 0; i <= count; i++ )
+		{
+			if( !read( &key, 1 ) ) { return false; }
+			playState.keyRepeat[key] = true;
+		}
+	}
+
+	// Text
+	playState.inputBuffer[0] = '\0';
+	if( flags & REPLAY_FRAME_TEXT )
+	{
+		u8 length;
+		if( !read( &length, 1 ) || length > REPLAY_TEXT_LENGTH ) { return false; }
+		if( !read( playState.inputBuffer, length ) ) { return false; }
+		playState.inputBuffer[length] = '\0';
+	}
+
+	// Mouse
+	if( flags & REPLAY_FRAME_MOUSE )
+	{
+		u16 mask;
+		if( !read( &mask, sizeof( u16 ) ) ) { return false; }
+		for( u32 i = 0; i < REPLAY_MOUSE_FIELDS; i++ )
+		{
+			if( ( mask & ( 1 << i ) ) && !read( &playState.mouse[i], sizeof( u32 ) ) ) { return false; }
+		}
+	}
+
+	playBuffer.tell = tell;
+	return true;
+}
+
+
+static void play_apply()
+{
+	Keyboard::State &keyboard = Keyboard::state();
+	memcpy( keyboard.keyCurrent, playState.keyCurrent, sizeof( keyboard.keyCurrent ) );
+	memcpy( keyboard.keyRepeat, playState.keyRepeat, sizeof( keyboard.keyRepeat ) );
+	memcpy( keyboard.inputBuffer, playState.inputBuffer, sizeof( playState.inputBuffer ) );
+	memcpy( &Mouse::state(), playState.mouse, sizeof( Mouse::State ) );
+}
+
+
+#if COMPILE_PROFILING
+static void play_profile_frame()
+{
+	// Accumulate the main thread scopes of the frame that just ended
+	using namespace CoreProfiler;
+	if( !PROFILER.capturingFrame ) { return; }
+	const int frame = ( PROFILER.frameCurrent + ProfilerManager::MAX_FRAMES - 1 ) % ProfilerManager::MAX_FRAMES;
+
+	for( int i = 0; i < PROFILER.snapshotsCount[frame]; i++ )
+	{
+		const ProfilerSnapshot &snapshot = PROFILER.snapshots[frame][i];
+		ReplayScope *scope = nullptr;
+		for( ReplayScope &other : playScopes )
+		{
+			if( other.name == snapshot.nameSnapshot || strcmp( other.name, snapshot.nameSnapshot ) == 0 )
+			{
+				scope = &other;
+				break;
+			}
+		}
+
+		if( scope == nullptr ) { scope = &playScopes.add( ReplayScope { snapshot.nameSnapshot, 0.0, 0 } ); }
+		scope->timeUS += snapshot.timeEndUS - snapshot.timeStartUS;
+		scope->count++;
+	}
+}
+#endif
+
+
+static double play_percentile( const List<double> &sorted, const u32 percentile )
+{
+	// Nearest-rank
+	const usize rank = ( sorted.count() * percentile + 99 ) / 100;
+	return sorted[rank > 0 ? rank - 1 : 0];
+}
+
+
+static void play_report()
+{
+	const u32 frames = static_cast<u32>( playFrameTimes.count() );
+	if( frames == 0 ) { Console::Log( c_yellow, "replay: '%s' contained no frames", playPath ); return; }
+
+	double timeTotal = 0.0;
+	for( const double time : playFrameTimes ) { timeTotal += time; }
+	playFrameTimes.sort();
+
+	Console::Log( c_white, "replay: '%s' %u frames | simulated %.3f s | wall %.3f s", playPath, frames,
+		playDeltaTotal, timeTotal / 1000.0 );
+	Console::Log( c_white, "  frame time: mean %.3f ms | p50 %.3f ms | p95 %.3f ms | p99 %.3f ms | max %.3f ms",
+		timeTotal / frames, play_percentile( playFrameTimes, 50 ), play_percentile( playFrameTimes, 95 ),
+		play_percentile( playFrameTimes, 99 ), playFrameTimes[frames - 1] );
+
+#if COMPILE_PROFILING
+	playScopes.sort( []( const ReplayScope &a, const ReplayScope &b ) { return a.timeUS > b.timeUS; } );
+	for( const ReplayScope &scope : playScopes )
+	{
+		Console::Log( c_white, "  %-24s %10.3f ms total | %8.3f ms per frame | %8u calls", scope.name,
+			scope.timeUS / 1000.0, scope.timeUS / 1000.0 / frames, scope.count );
+	}
+#endif
+}
+
+
+static void play_finish( const bool report )
+{
+	if( report ) { play_report(); }
+
+	playBuffer.free();
+	playFrameTimes.free();
+	PROFILING( playScopes.free() );
+	playFrame = false;
+
+	// Hand input back to the window backend
+	Keyboard::clear();
+	Mouse::clear();
+
+	if( playExit ) { playExit = false; Engine::exit(); }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool Replay::record_start( const char *path )
+{
+	if( recording() || playing() ) { return false; }
+
+	recordFile = fopen( path, "wb" );
+	if( recordFile == nullptr )
+	{
+		Console::Log( c_red, "replay: failed to open '%s' for recording", path );
+		return false;
+	}
+
+	const ReplayHeader header { REPLAY_MAGIC, REPLAY_VERSION };
+	fwrite( &header, sizeof( ReplayHeader ), 1, recordFile );
+	memset( &recordState, 0, sizeof( ReplayInput ) );
+	recordFrames = 0;
+	recordBytes = sizeof( ReplayHeader );
+
+	Console::Log( c_lime, "replay: recording input to '%s'", path );
+	return true;
+}
+
+
+bool Replay::record_stop()
+{
+	if( !recording() ) { return false; }
+
+	fclose( recordFile );
+	recordFile = nullptr;
+
+	Console::Log( c_lime, "replay: recorded %u frames (%.2f kb, %.2f bytes per frame)", recordFrames,
+		KB( recordBytes ), recordFrames > 0 ? static_cast<double>( recordBytes ) / recordFrames : 0.0 );
+	return true;
+}
+
+
+bool Replay::recording()
+{
+	return recordFile != nullptr;
+}
+
+
+bool Replay::play_start( const char *path, const bool exitOnEnd )
+{
+	if( recording() || playing() ) { return false; }
+
+	if( !playBuffer.load( path ) )
+	{
+		Console::Log( c_red, "replay: failed to load '%s'", path );
+		return false;
+	}
+
+	ReplayHeader header { 0, 0 };
+	if( playBuffer.size() >= sizeof( ReplayHeader ) ) { memcpy( &header, playBuffer.data, sizeof( ReplayHeader ) ); }
+	if( header.magic != REPLAY_MAGIC || header.version != REPLAY_VERSION )
+	{
+		Console::Log( c_red, "replay: '%s' is not a version %u input recording", path, REPLAY_VERSION );
+		playBuffer.free();
+		return false;
+	}
+	playBuffer.seek_to( sizeof( ReplayHeader ) );
+
+	snprintf( playPath, sizeof( playPath ), "%s", path );
+	memset( &playState, 0, sizeof( ReplayInput ) );
+	playExit = exitOnEnd;
+	playFrame = false;
+	playDeltaTotal = 0.0;
+	playFrameTimes.init( 1024 );
+	PROFILING( playScopes.init( 64 ) );
+
+	Keyboard::clear();
+	Mouse::clear();
+
+	Console::Log( c_lime, "replay: playing '%s'", path );
+	return true;
+}
+
+
+bool Replay::play_stop()
+{
+	if( !playing() ) { return false; }
+	playExit = false;
+	play_finish( true );
+	return true;
+}
+
+
+bool Replay::playing()
+{
+	return playBuffer.is_initialized();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+bool CoreReplay::init( int argc, char **argv )
+{
+	CMD_REPLAY_RECORD = Console::command_init( "replay record [path]",
+		"Record per-frame input & Frame::delta to a file",
+		CONSOLE_COMMAND_LAMBDA { Replay::record_start( Console::get_parameter_string( 0 ) ); } );
+
+	CMD_REPLAY_PLAY = Console::command_init( "replay play [path]",
+		"Replay a recorded input file with its recorded frame deltas & report frame times",
+		CONSOLE_COMMAND_LAMBDA { Replay::play_start( Console::get_parameter_string( 0 ) ); } );
+
+	CMD_REPLAY_STOP = Console::command_init( "replay stop",
+		"Stop the active input recording or replay",
+		CONSOLE_COMMAND_LAMBDA { if( !Replay::record_stop() ) { Replay::play_stop(); } } );
+
+	// Command Line: -input-record=<path> -input-replay=<path>
+	for( int i = 1; i < argc; i++ )
+	{
+		if( strncmp( argv[i], "-input-record=", 14 ) == 0 )
+		{
+			ErrorReturnIf( !Replay::record_start( argv[i] + 14 ), false,
+				"Replay: failed to record to '%s'", argv[i] + 14 );
+		}
+		else if( strncmp( argv[i], "-input-replay=", 14 ) == 0 )
+		{
+			ErrorReturnIf( !Replay::play_start( argv[i] + 14, true ), false,
+				"Replay: failed to play '%s'", argv[i] + 14 );
+		}
+	}
+
+	return true;
+}
+
+
+bool CoreReplay::free()
+{
+	Replay::record_stop();
+	if( Replay::playing() ) { playExit = false; play_finish( false ); }
+
+	Console::command_free( CMD_REPLAY_RECORD );
+	Console::command_free( CMD_REPLAY_PLAY );
+	Console::command_free( CMD_REPLAY_STOP );
+	return true;
+}
+
+
+bool CoreReplay::frame_start( Delta &delta )
+{
+	if( !Replay::playing() ) { return false; }
+
+	if( playBuffer.bytes_remaining() == 0 ) { play_finish( true ); return false; }
+	if( !play_read_frame() )
+	{
+		Console::Log( c_red, "replay: '%s' is truncated (frame %u)", playPath,
+			static_cast<u32>( playFrameTimes.count() ) );
+		play_finish( true );
+		return false;
+	}
+
+	playFrame = true;
+	playFrameTimeStart = Time::value();
+	playDeltaTotal += playState.delta;
+	delta = playState.delta;
+	return true;
+}
+
+
+void CoreReplay::frame_input()
+{
+	if( playFrame ) { play_apply(); return; }
+	if( recordFile != nullptr ) { record_frame(); }
+}
+
+
+void CoreReplay::frame_end()
+{
+	if( !playFrame ) { return; }
+	playFrame = false;
+
+	playFrameTimes.add( ( Time::value() - playFrameTimeStart ) * 1000.0 );
+	PROFILING( play_profile_frame() );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
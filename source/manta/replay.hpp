@@ -0,0 +1,55 @@
+#pragma once
+
+#include <core/types.hpp>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Input record & replay
+//
+// Recording captures Frame::delta and the Keyboard/Mouse state of every frame (after the window backend has polled
+// its events) to a binary file. Frames are delta-coded against the previous frame: a flags byte, followed by the
+// delta (if it changed), the keys that toggled, the repeated keys, text input, and the Mouse::State fields that
+// changed -- an idle frame costs one byte.
+//
+// Replay substitutes the recorded input for the window backend's and runs each frame with its recorded delta
+// (Frame::start_fixed) without frame regulation, so repeated runs simulate identical sessions and their frame times
+// can be compared across builds. When the recording ends, replay reports frame-time percentiles and (with
+// COMPILE_PROFILING) per-scope profiler totals.
+//
+// Command Line: -input-record=<path> -input-replay=<path> (exits once the replay completes)
+// Console: "replay record [path]", "replay play [path]", "replay stop"
+
+#define REPLAY_MAGIC ( 0x4C50524D ) // 'MRPL'
+#define REPLAY_VERSION ( 1 )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace CoreReplay
+{
+	extern bool init( int argc, char **argv );
+	extern bool free();
+
+	// Main loop hooks:
+	//   frame_start() -- before Frame::start(); returns true (and the recorded delta) if replay drives this frame
+	//   frame_input() -- after Window::update(); records or substitutes the Keyboard/Mouse state
+	//   frame_end() -- after the profiler frame ends
+	extern bool frame_start( Delta &delta );
+	extern void frame_input();
+	extern void frame_end();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Replay
+{
+	extern bool record_start( const char *path );
+	extern bool record_stop();
+	extern bool recording();
+
+	// 'exitOnEnd': calls Engine::exit() after the replay report
+	extern bool play_start( const char *path, bool exitOnEnd = false );
+	extern bool play_stop();
+	extern bool playing();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
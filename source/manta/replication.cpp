@@ -0,0 +1,796 @@
+#include <manta/replication.hpp>
+
+#include <core/debug.hpp>
+#include <core/math.hpp>
+#include <core/memory.hpp>
+
+#include <manta/objects.hpp>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Packet layout (bit-packed):
+//   u32 tick | u32 baseline (0: full snapshot) | { 1 | key delta | op | ... } * N | 0
+//
+// Objects are keyed by their server (bucketID, index), delta-coded against the previous entry so that runs of
+// neighbouring objects cost a few bits each. Updates carry a variable mask followed by the masked variables only.
+
+enum_type( ReplicationOp, u32 )
+{
+	ReplicationOp_Update,
+	ReplicationOp_Create,
+	ReplicationOp_Destroy,
+	REPLICATIONOP_COUNT,
+};
+
+#define REPLICATION_OP_BITS ( 2 )
+
+#define REPLICATION_STAGED_ALIVE ( 1U << 16 )
+#define REPLICATION_STAGED_REASSIGNED ( 1U << 31 )
+
+
+static u32 replication_mask_all( const u32 fields )
+{
+	return fields >= 32 ? U32_MAX : ( 1U << fields ) - 1;
+}
+
+
+static void replication_write_key( BitWriter &bits, u32 &key, const u16 bucketID, const u16 index )
+{
+	const u32 entryKey = ( static_cast<u32>( bucketID ) << 16 ) | index;
+	bits.write( 1, 1 );
+	bits.write_varint( Replication::zigzag( static_cast<i32>( entryKey - key ) ) );
+	key = entryKey;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// ObjectContext -> ReplicationServer/ReplicationClient (see: ObjectContext::event_network_send/receive)
+// ObjectContext is kept at 32 bytes, so attachments live here rather than on the context
+
+static ReplicationServer *replicationServers[REPLICATION_CONTEXTS_MAX];
+static ReplicationClient *replicationClients[REPLICATION_CONTEXTS_MAX];
+
+
+template <typename T> static void replication_attach( T **slots, T *replication )
+{
+	for( u32 i = 0; i < REPLICATION_CONTEXTS_MAX; i++ )
+	{
+		if( slots[i] != nullptr ) { continue; }
+		slots[i] = replication;
+		return;
+	}
+	Error( "Replication: exceeded REPLICATION_CONTEXTS_MAX (%d)", REPLICATION_CONTEXTS_MAX );
+}
+
+
+template <typename T> static void replication_detach( T **slots, T *replication )
+{
+	for( u32 i = 0; i < REPLICATION_CONTEXTS_MAX; i++ )
+	{
+		if( slots[i] == replication ) { slots[i] = nullptr; }
+	}
+}
+
+
+template <typename T> static T *replication_find( T **slots, const ObjectContext *context )
+{
+	for( u32 i = 0; i < REPLICATION_CONTEXTS_MAX; i++ )
+	{
+		if( slots[i] != nullptr && slots[i]->context == context ) { return slots[i]; }
+	}
+	return nullptr;
+}
+
+
+bool ObjectContext::event_network_send( Buffer &buffer )
+{
+	ReplicationServer *server = replication_find( replicationServers, this );
+	if( server == nullptr || server->network == nullptr ) { return false; }
+	server->sample();
+	return server->send( *server->network, buffer );
+}
+
+
+bool ObjectContext::event_network_receive( Buffer &buffer )
+{
+	ReplicationClient *client = replication_find( replicationClients, this );
+	if( client == nullptr ) { return false; }
+	if( !client->receive( buffer ) ) { return false; }
+	if( client->network != nullptr ) { client->acknowledge( *client->network ); }
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ReplicationServer::init( ObjectContext &context, NetworkServerUDP *network )
+{
+	this->context = &context;
+	this->network = network;
+	tick = 0U;
+	replication_attach( replicationServers, this );
+
+	buckets.init( 1, memory_heap( MemoryTag_Network ) );
+	for( u32 i = 0; i < REPLICATION_HISTORY; i++ )
+	{
+		history[i].init( 1, memory_heap( MemoryTag_Network ) );
+		historyTick[i] = 0U;
+	}
+}
+
+
+void ReplicationServer::free()
+{
+	if( buckets.is_initialized() )
+	{
+		for( Bucket &bucket : buckets ) { bucket_free( bucket ); }
+		buckets.free();
+	}
+
+	for( u32 i = 0; i < REPLICATION_HISTORY; i++ )
+	{
+		if( history[i].is_initialized() ) { history[i].free(); }
+	}
+
+	replication_detach( replicationServers, this );
+	context = nullptr;
+	network = nullptr;
+}
+
+
+void ReplicationServer::bucket_init( Bucket &bucket, const u16 type )
+{
+	const CoreObjects::TypeReplication &replication = CoreObjects::TYPE_REPLICATION[type];
+	Assert( replication.fields > 0 );
+
+	Allocator *allocator = memory_heap( MemoryTag_Network );
+	bucket.type = type;
+	bucket.capacity = CoreObjects::TYPE_BUCKET_CAPACITY[type];
+	bucket.slots = reinterpret_cast<Slot *>( memory_alloc( allocator, bucket.capacity * sizeof( Slot ) ) );
+	bucket.states = reinterpret_cast<byte *>( memory_alloc( allocator, bucket.capacity * replication.stateSize ) );
+	bucket.ticks = reinterpret_cast<u32 *>( memory_alloc( allocator,
+		bucket.capacity * replication.fields * sizeof( u32 ) ) );
+	memory_set( bucket.slots, 0, bucket.capacity * sizeof( Slot ) );
+}
+
+
+void ReplicationServer::bucket_free( Bucket &bucket )
+{
+	Allocator *allocator = memory_heap( MemoryTag_Network );
+	const CoreObjects::TypeReplication &replication = CoreObjects::TYPE_REPLICATION[bucket.type];
+	if( bucket.slots != nullptr )
+	{
+		memory_free( allocator, bucket.slots, bucket.capacity * sizeof( Slot ) );
+		bucket.slots = nullptr;
+	}
+	if( bucket.states != nullptr )
+	{
+		memory_free( allocator, bucket.states, bucket.capacity * replication.stateSize );
+		bucket.states = nullptr;
+	}
+	if( bucket.ticks != nullptr )
+	{
+		memory_free( allocator, bucket.ticks, bucket.capacity * replication.fields * sizeof( u32 ) );
+		bucket.ticks = nullptr;
+	}
+	bucket.type = 0;
+	bucket.capacity = 0;
+}
+
+
+u32 ReplicationServer::sample()
+{
+	Assert( context != nullptr && context->is_initialized() );
+
+	tick++;
+	List<Change> &changes = history[tick % REPLICATION_HISTORY];
+	historyTick[tick % REPLICATION_HISTORY] = tick;
+	changes.clear();
+
+	// Mirror the ObjectContext bucket layout
+	const u16 bucketCount = context->current;
+	while( buckets.size() < bucketCount ) { buckets.add( Bucket { } ); }
+
+	for( u16 bucketID = 0; bucketID < bucketCount; bucketID++ )
+	{
+		const ObjectContext::ObjectBucket &objectBucket = context->buckets[bucketID];
+		const CoreObjects::TypeReplication &replication = CoreObjects::TYPE_REPLICATION[objectBucket.type];
+		if( replication.fields == 0 || objectBucket.data == nullptr ) { continue; }
+
+		// Bucket was reassigned to another type (stale slots are destroyed below)
+		Bucket &bucket = buckets[bucketID];
+		if( UNLIKELY( bucket.type != objectBucket.type ) )
+		{
+			for( u16 index = 0; index < bucket.capacity; index++ )
+			{
+				const Slot &slot = bucket.slots[index];
+				if( slot.alive ) { changes.add( Change { bucketID, index, slot.generation, true } ); }
+			}
+			bucket_free( bucket );
+			bucket_init( bucket, objectBucket.type );
+		}
+
+		const u16 objectSize = CoreObjects::TYPE_SIZE[bucket.type];
+		for( u16 index = objectBucket.bottom; index < objectBucket.top; index++ )
+		{
+			byte *const object = objectBucket.data + index * objectSize;
+			const ObjectInstance &instance = reinterpret_cast<const CoreObjects::DEFAULT_t *>( object )->id;
+			if( !instance.alive ) { continue; }
+
+			Slot &slot = bucket.slots[index];
+			void *const state = bucket.states + index * replication.stateSize;
+			u32 *const ticks = bucket.ticks + index * replication.fields;
+
+			// Created
+			if( UNLIKELY( !slot.alive || slot.generation != instance.generation ) )
+			{
+				if( slot.alive ) { changes.add( Change { bucketID, index, slot.generation, true } ); }
+				memory_set( state, 0, replication.stateSize );
+				replication.sample( object, state );
+				for( u32 field = 0; field < replication.fields; field++ ) { ticks[field] = tick; }
+
+				slot.generation = instance.generation;
+				slot.alive = true;
+				slot.tickCreated = tick;
+				slot.tickChanged = tick;
+				slot.tickSeen = tick;
+				changes.add( Change { bucketID, index, slot.generation, false } );
+				continue;
+			}
+
+			// Changed
+			slot.tickSeen = tick;
+			u32 mask = replication.sample( object, state );
+			if( LIKELY( mask == 0U ) ) { continue; }
+			for( ; mask != 0U; mask &= mask - 1 ) { ticks[simd_ctz64( mask )] = tick; }
+			slot.tickChanged = tick;
+			changes.add( Change { bucketID, index, slot.generation, false } );
+		}
+	}
+
+	// Destroyed (replicated objects that were not sampled this tick)
+	for( u16 bucketID = 0; bucketID < buckets.size(); bucketID++ )
+	{
+		Bucket &bucket = buckets[bucketID];
+		for( u16 index = 0; index < bucket.capacity; index++ )
+		{
+			Slot &slot = bucket.slots[index];
+			if( !slot.alive || slot.tickSeen == tick ) { continue; }
+			slot.alive = false;
+			changes.add( Change { bucketID, index, slot.generation, true } );
+		}
+	}
+
+	return static_cast<u32>( changes.size() );
+}
+
+
+void ReplicationServer::write_object( BitWriter &bits, u32 &key, const u16 bucketID, const u16 index,
+	const u32 baseline ) const
+{
+	const Bucket &bucket = buckets[bucketID];
+	const Slot &slot = bucket.slots[index];
+	const CoreObjects::TypeReplication &replication = CoreObjects::TYPE_REPLICATION[bucket.type];
+	const void *const state = bucket.states + index * replication.stateSize;
+	replication_write_key( bits, key, bucketID, index );
+
+	// Create: type, generation, and every variable
+	if( slot.tickCreated > baseline )
+	{
+		bits.write( ReplicationOp_Create, REPLICATION_OP_BITS );
+		bits.write_varint( bucket.type );
+		bits.write( slot.generation, 16 );
+		replication.write( bits, state, replication_mask_all( replication.fields ) );
+		return;
+	}
+
+	// Update: variables changed after the baseline
+	const u32 *const ticks = bucket.ticks + index * replication.fields;
+	u32 mask = 0U;
+	for( u32 field = 0; field < replication.fields; field++ ) { mask |= ( ticks[field] > baseline ) << field; }
+	bits.write( ReplicationOp_Update, REPLICATION_OP_BITS );
+	bits.write( mask, replication.fields );
+	replication.write( bits, state, mask );
+}
+
+
+void ReplicationServer::write( Buffer &buffer, u32 baseline ) const
+{
+	// Baselines outside of the change history (or none at all) receive a full snapshot
+	const i32 age = static_cast<i32>( tick - baseline );
+	if( age <= 0 || age >= REPLICATION_HISTORY ) { baseline = 0U; }
+
+	BitWriter bits;
+	bits.begin( buffer );
+	bits.write( tick, 32 );
+	bits.write( baseline, 32 );
+	u32 key = 0U;
+
+	if( baseline == 0U )
+	{
+		// Full snapshot
+		for( u16 bucketID = 0; bucketID < buckets.size(); bucketID++ )
+		{
+			const Bucket &bucket = buckets[bucketID];
+			for( u16 index = 0; index < bucket.capacity; index++ )
+			{
+				if( !bucket.slots[index].alive ) { continue; }
+				write_object( bits, key, bucketID, index, baseline );
+			}
+		}
+	}
+	else
+	{
+		// Delta: walk the changes recorded after the baseline
+		for( u32 t = baseline + 1; t != tick + 1; t++ )
+		{
+			Assert( historyTick[t % REPLICATION_HISTORY] == t );
+			for( const Change &change : history[t % REPLICATION_HISTORY] )
+			{
+				if( change.destroyed )
+				{
+					replication_write_key( bits, key, change.bucketID, change.index );
+					bits.write( ReplicationOp_Destroy, REPLICATION_OP_BITS );
+					bits.write( change.generation, 16 );
+					continue;
+				}
+
+				// Objects are written once, from the tick they last changed on
+				const Slot &slot = buckets[change.bucketID].slots[change.index];
+				if( !slot.alive || slot.generation != change.generation || slot.tickChanged != t ) { continue; }
+				write_object( bits, key, change.bucketID, change.index, baseline );
+			}
+		}
+	}
+
+	bits.write( 0, 1 );
+	bits.end();
+}
+
+
+u32 ReplicationServer::fragment_count( const Buffer &buffer )
+{
+	const usize size = buffer.size();
+	return static_cast<u32>( ( size + REPLICATION_FRAGMENT_PAYLOAD_BYTES - 1 ) / REPLICATION_FRAGMENT_PAYLOAD_BYTES );
+}
+
+
+usize ReplicationServer::fragment( const Buffer &buffer, const u32 index, void *datagram )
+{
+	const u32 count = fragment_count( buffer );
+	Assert( index < count && count <= REPLICATION_FRAGMENTS_MAX );
+
+	// Snapshots begin with their tick (see: write)
+	ReplicationFragmentHeader header;
+	memory_copy( &header.tick, buffer.data, sizeof( u32 ) );
+	header.index = static_cast<u16>( index );
+	header.count = static_cast<u16>( count );
+
+	const usize offset = index * REPLICATION_FRAGMENT_PAYLOAD_BYTES;
+	const usize size = min( static_cast<usize>( REPLICATION_FRAGMENT_PAYLOAD_BYTES ), buffer.size() - offset );
+	byte *bytes = reinterpret_cast<byte *>( datagram );
+	memory_copy( bytes, &header, sizeof( header ) );
+	memory_copy( bytes + sizeof( header ), buffer.data + offset, size );
+	return sizeof( header ) + size;
+}
+
+
+static bool replication_send_fragments( NetworkServerUDP &server, NetworkConnectionHandle handle,
+	const Buffer &buffer )
+{
+	const u32 count = ReplicationServer::fragment_count( buffer );
+	ErrorReturnIf( count > REPLICATION_FRAGMENTS_MAX, false,
+		"Replication: snapshot exceeds REPLICATION_FRAGMENTS_MAX (%llu bytes)", buffer.size() );
+
+	byte datagram[REPLICATION_DATAGRAM_BYTES];
+	bool success = true;
+	for( u32 i = 0; i < count; i++ )
+	{
+		const usize size = ReplicationServer::fragment( buffer, i, datagram );
+		if( !server.send_to( handle, datagram, size ) ) { success = false; }
+	}
+	return success;
+}
+
+
+bool ReplicationServer::send_to( NetworkServerUDP &server, NetworkConnectionHandle handle, Buffer &buffer ) const
+{
+	buffer.clear();
+	write( buffer, server.connection_baseline( handle ) );
+	return replication_send_fragments( server, handle, buffer );
+}
+
+
+bool ReplicationServer::send( NetworkServerUDP &server, Buffer &buffer ) const
+{
+	bool success = true;
+	for( u32 i = 0; i < server.connectionsCapacity; i++ )
+	{
+		const NetworkConnectionUDP &connection = server.connections[i];
+		if( connection.handle == NetworkConnectionHandle_Null ) { continue; }
+		buffer.clear();
+		write( buffer, connection.baseline );
+		if( !replication_send_fragments( server, connection.handle, buffer ) ) { success = false; }
+	}
+	return success;
+}
+
+
+bool ReplicationServer::receive( NetworkServerUDP &server, const NetworkConnectionHandle handle, Buffer &datagram )
+{
+	u32 acknowledged = 0U;
+	if( !datagram.read<u32>( acknowledged ) ) { return false; }
+
+	// A client can't have applied a tick that was never sent
+	if( acknowledged == 0U || static_cast<i32>( acknowledged - tick ) > 0 ) { return false; }
+	server.connection_acknowledge( handle, acknowledged );
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ReplicationClient::init( ObjectContext &context, NetworkClientUDP *network )
+{
+	this->context = &context;
+	this->network = network;
+	tick = 0U;
+	buckets.init( 1, memory_heap( MemoryTag_Network ) );
+
+	// Validation scratch
+	stagedSlots.init( 1024, 0U, memory_heap( MemoryTag_Network ) );
+	stagedBuckets.init( 64, 0U, memory_heap( MemoryTag_Network ) );
+	stagedObjectSize = 0LLU;
+	for( u16 type = 0; type < CoreObjects::TYPE_COUNT; type++ )
+	{
+		if( CoreObjects::TYPE_REPLICATION[type].fields == 0 ) { continue; }
+		stagedObjectSize = max( stagedObjectSize, static_cast<usize>( CoreObjects::TYPE_SIZE[type] ) );
+	}
+	stagedObject = reinterpret_cast<byte *>( memory_alloc( memory_heap( MemoryTag_Network ), stagedObjectSize ) );
+	memory_set( stagedObject, 0, stagedObjectSize );
+
+	assembly = nullptr;
+	assemblyCapacity = 0LLU;
+	assemblySize = 0LLU;
+	assemblyTick = 0U;
+	assemblyCount = 0U;
+	assemblyReceived = 0U;
+	replication_attach( replicationClients, this );
+}
+
+
+void ReplicationClient::free()
+{
+	if( buckets.is_initialized() )
+	{
+		for( Bucket &bucket : buckets ) { bucket_free( bucket ); }
+		buckets.free();
+	}
+
+	if( assembly != nullptr )
+	{
+		memory_free( memory_heap( MemoryTag_Network ), assembly, assemblyCapacity );
+		assembly = nullptr;
+		assemblyCapacity = 0LLU;
+	}
+
+	if( stagedSlots.is_initialized() ) { stagedSlots.free(); }
+	if( stagedBuckets.is_initialized() ) { stagedBuckets.free(); }
+	if( stagedObject != nullptr )
+	{
+		memory_free( memory_heap( MemoryTag_Network ), stagedObject, stagedObjectSize );
+		stagedObject = nullptr;
+		stagedObjectSize = 0LLU;
+	}
+
+	replication_detach( replicationClients, this );
+	context = nullptr;
+	network = nullptr;
+}
+
+
+void ReplicationClient::bucket_init( Bucket &bucket, const u16 type )
+{
+	bucket.type = type;
+	bucket.capacity = CoreObjects::TYPE_BUCKET_CAPACITY[type];
+	bucket.slots = reinterpret_cast<Slot *>( memory_alloc( memory_heap( MemoryTag_Network ),
+		bucket.capacity * sizeof( Slot ) ) );
+	memory_set( bucket.slots, 0, bucket.capacity * sizeof( Slot ) );
+}
+
+
+void ReplicationClient::bucket_free( Bucket &bucket )
+{
+	if( bucket.slots == nullptr ) { return; }
+
+	for( u16 index = 0; index < bucket.capacity; index++ )
+	{
+		Slot &slot = bucket.slots[index];
+		if( slot.alive && context != nullptr ) { context->destroy( slot.instance ); }
+	}
+
+	memory_free( memory_heap( MemoryTag_Network ), bucket.slots, bucket.capacity * sizeof( Slot ) );
+	bucket.slots = nullptr;
+	bucket.type = 0;
+	bucket.capacity = 0;
+}
+
+
+bool ReplicationClient::read( Buffer &buffer )
+{
+	usize bytesRead = 0LLU;
+	if( !apply( buffer.tell_ptr(), buffer.bytes_remaining(), bytesRead ) ) { return false; }
+	buffer.tell += bytesRead;
+	return true;
+}
+
+
+bool ReplicationClient::receive( Buffer &datagram )
+{
+	ReplicationFragmentHeader header;
+	if( datagram.bytes_remaining() < sizeof( header ) ) { return false; }
+	memory_copy( &header, datagram.tell_ptr(), sizeof( header ) );
+	const byte *payload = datagram.tell_ptr() + sizeof( header );
+	const usize payloadSize = datagram.bytes_remaining() - sizeof( header );
+	datagram.tell += datagram.bytes_remaining();
+
+	if( header.count == 0 || header.count > REPLICATION_FRAGMENTS_MAX || header.index >= header.count ) { return false; }
+	if( payloadSize > REPLICATION_FRAGMENT_PAYLOAD_BYTES ) { return false; }
+	if( header.index + 1 < header.count && payloadSize != REPLICATION_FRAGMENT_PAYLOAD_BYTES ) { return false; }
+
+	// Stale, or part of a snapshot already applied
+	if( static_cast<i32>( header.tick - tick ) <= 0 ) { return false; }
+
+	// A newer snapshot supersedes the one being assembled (its missing fragments will never arrive)
+	if( header.tick != assemblyTick || assemblyCount == 0U )
+	{
+		if( assemblyCount != 0U && static_cast<i32>( header.tick - assemblyTick ) < 0 ) { return false; }
+		assemblyTick = header.tick;
+		assemblyCount = header.count;
+		assemblyReceived = 0U;
+		assemblySize = 0LLU;
+		memory_set( assemblyMask, 0, sizeof( assemblyMask ) );
+
+		const usize capacity = header.count * REPLICATION_FRAGMENT_PAYLOAD_BYTES;
+		if( capacity > assemblyCapacity )
+		{
+			assembly = reinterpret_cast<byte *>( memory_realloc( memory_heap( MemoryTag_Network ), assembly,
+				assemblyCapacity, capacity ) );
+			assemblyCapacity = capacity;
+		}
+	}
+	if( header.count != assemblyCount ) { return false; }
+
+	// Duplicate
+	u64 &mask = assemblyMask[header.index / 64];
+	const u64 bit = 1LLU << ( header.index % 64 );
+	if( mask & bit ) { return false; }
+	mask |= bit;
+
+	memory_copy( assembly + header.index * REPLICATION_FRAGMENT_PAYLOAD_BYTES, payload, payloadSize );
+	if( header.index + 1 == header.count ) { assemblySize = header.index * REPLICATION_FRAGMENT_PAYLOAD_BYTES + payloadSize; }
+	if( ++assemblyReceived < assemblyCount ) { return false; }
+
+	assemblyCount = 0U;
+	usize bytesRead = 0LLU;
+	return apply( assembly, assemblySize, bytesRead );
+}
+
+
+bool ReplicationClient::acknowledge( NetworkClientUDP &network ) const
+{
+	return network.send( &tick, sizeof( tick ) );
+}
+
+
+bool ReplicationClient::validate( const void *data, const usize size )
+{
+	// Parse the whole packet against a staged copy of the slot state (REPLICATED variables are read into
+	// 'stagedObject'), so apply() never meets a malformed entry after it started mutating the context
+	stagedSlots.clear();
+	stagedBuckets.clear();
+
+	BitReader bits;
+	bits.begin( data, size );
+	const u32 packetTick = bits.read( 32 );
+	const u32 baseline = bits.read( 32 );
+	if( !bits.valid() ) { return false; }
+
+	// Stale packet, or a delta against a baseline we never acknowledged
+	if( static_cast<i32>( packetTick - tick ) <= 0 ) { return false; }
+	if( baseline != 0U && static_cast<i32>( baseline - tick ) > 0 ) { return false; }
+
+	u32 key = 0U;
+	while( bits.read( 1 ) == 1 )
+	{
+		key += static_cast<u32>( Replication::unzigzag( bits.read_varint() ) );
+		const u16 bucketID = static_cast<u16>( key >> 16 );
+		const u16 index = static_cast<u16>( key & 0xFFFF );
+		const ReplicationOp op = bits.read( REPLICATION_OP_BITS );
+		if( !bits.valid() || key == U32_MAX ) { return false; }
+
+		// Bucket type (U32_MAX: no slots) and slot state as apply() would see them at this entry
+		const Bucket *bucket = bucketID < buckets.size() && buckets[bucketID].slots != nullptr ?
+			&buckets[bucketID] : nullptr;
+		const bool staged = stagedBuckets.contains( bucketID );
+		const u32 stagedType = staged ? stagedBuckets.get( bucketID ) : 0U;
+		const bool reassigned = staged && ( stagedType & REPLICATION_STAGED_REASSIGNED );
+		const u32 type = staged ? ( stagedType & ~REPLICATION_STAGED_REASSIGNED ) :
+			( bucket != nullptr ? bucket->type : U32_MAX );
+
+		u32 state = 0U;
+		if( stagedSlots.contains( key ) ) { state = stagedSlots.get( key ); }
+		else if( !reassigned && bucket != nullptr && index < bucket->capacity && bucket->slots[index].alive )
+		{
+			state = REPLICATION_STAGED_ALIVE | bucket->slots[index].generation;
+		}
+
+		switch( op )
+		{
+			case ReplicationOp_Create:
+			{
+				const u32 typeCreated = bits.read_varint();
+				const u16 generation = static_cast<u16>( bits.read( 16 ) );
+				if( !bits.valid() || typeCreated >= CoreObjects::TYPE_COUNT ) { return false; }
+				const CoreObjects::TypeReplication &replication = CoreObjects::TYPE_REPLICATION[typeCreated];
+				if( replication.fields == 0 ) { return false; }
+				if( index >= CoreObjects::TYPE_BUCKET_CAPACITY[typeCreated] ) { return false; }
+
+				// apply() reassigns the bucket (destroying its objects) -- servers write every object of a bucket
+				// with its current type, so a packet never uses one bucket as two types
+				if( typeCreated != type )
+				{
+					if( staged ) { return false; }
+					stagedBuckets.set( bucketID, typeCreated | REPLICATION_STAGED_REASSIGNED );
+				}
+				else if( !staged )
+				{
+					stagedBuckets.set( bucketID, typeCreated );
+				}
+
+				stagedSlots.set( key, REPLICATION_STAGED_ALIVE | generation );
+				if( !replication.read( bits, stagedObject, replication_mask_all( replication.fields ) ) )
+				{
+					return false;
+				}
+			}
+			break;
+
+			case ReplicationOp_Update:
+			{
+				if( type == U32_MAX || ( state & REPLICATION_STAGED_ALIVE ) == 0U ) { return false; }
+				if( !staged ) { stagedBuckets.set( bucketID, type ); }
+
+				const CoreObjects::TypeReplication &replication = CoreObjects::TYPE_REPLICATION[type];
+				const u32 mask = bits.read( replication.fields );
+				if( !replication.read( bits, stagedObject, mask ) ) { return false; }
+			}
+			break;
+
+			case ReplicationOp_Destroy:
+			{
+				const u16 generation = static_cast<u16>( bits.read( 16 ) );
+				if( ( state & REPLICATION_STAGED_ALIVE ) == 0U || ( state & 0xFFFF ) != generation ) { continue; }
+				stagedSlots.set( key, 0U );
+			}
+			break;
+
+			default: { return false; }
+		}
+	}
+
+	return bits.valid();
+}
+
+
+bool ReplicationClient::apply( const void *data, const usize size, usize &bytesRead )
+{
+	Assert( context != nullptr && context->is_initialized() );
+	if( !validate( data, size ) ) { return false; }
+
+	BitReader bits;
+	bits.begin( data, size );
+	const u32 packetTick = bits.read( 32 );
+	const u32 baseline = bits.read( 32 );
+	if( !bits.valid() ) { return false; }
+
+	// Stale packet, or a delta against a baseline we never acknowledged
+	if( static_cast<i32>( packetTick - tick ) <= 0 ) { return false; }
+	if( baseline != 0U && static_cast<i32>( baseline - tick ) > 0 ) { return false; }
+
+	u32 key = 0U;
+	while( bits.read( 1 ) == 1 )
+	{
+		key += static_cast<u32>( Replication::unzigzag( bits.read_varint() ) );
+		const u16 bucketID = static_cast<u16>( key >> 16 );
+		const u16 index = static_cast<u16>( key & 0xFFFF );
+		const ReplicationOp op = bits.read( REPLICATION_OP_BITS );
+		if( !bits.valid() ) { return false; }
+
+		while( buckets.size() <= bucketID ) { buckets.add( Bucket { } ); }
+		Bucket &bucket = buckets[bucketID];
+
+		switch( op )
+		{
+			case ReplicationOp_Create:
+			{
+				const u32 type = bits.read_varint();
+				const u16 generation = static_cast<u16>( bits.read( 16 ) );
+				if( !bits.valid() || type >= CoreObjects::TYPE_COUNT ) { return false; }
+				const CoreObjects::TypeReplication &replication = CoreObjects::TYPE_REPLICATION[type];
+				if( replication.fields == 0 ) { return false; }
+
+				if( bucket.type != type || bucket.slots == nullptr )
+				{
+					bucket_free( bucket );
+					bucket_init( bucket, static_cast<u16>( type ) );
+				}
+				if( index >= bucket.capacity ) { return false; }
+				Slot &slot = bucket.slots[index];
+
+				// Replace a previous occupant we missed the destruction of
+				if( slot.alive && slot.generation != generation ) { context->destroy( slot.instance ); slot.alive = false; }
+
+				if( !slot.alive )
+				{
+					slot.instance = context->create( static_cast<Object>( type ) );
+					if( !slot.instance ) { return false; }
+					slot.generation = generation;
+					slot.alive = true;
+				}
+
+				slot.tickSeen = packetTick;
+				byte *object = context->get_object_pointer( slot.instance );
+				if( !replication.read( bits, object, replication_mask_all( replication.fields ) ) ) { return false; }
+			}
+			break;
+
+			case ReplicationOp_Update:
+			{
+				if( bucket.slots == nullptr || index >= bucket.capacity ) { return false; }
+				Slot &slot = bucket.slots[index];
+				if( !slot.alive ) { return false; }
+
+				const CoreObjects::TypeReplication &replication = CoreObjects::TYPE_REPLICATION[bucket.type];
+				const u32 mask = bits.read( replication.fields );
+				slot.tickSeen = packetTick;
+				byte *object = context->get_object_pointer( slot.instance );
+				if( !replication.read( bits, object, mask ) ) { return false; }
+			}
+			break;
+
+			case ReplicationOp_Destroy:
+			{
+				const u16 generation = static_cast<u16>( bits.read( 16 ) );
+				if( bucket.slots == nullptr || index >= bucket.capacity ) { continue; }
+				Slot &slot = bucket.slots[index];
+				if( !slot.alive || slot.generation != generation ) { continue; }
+				context->destroy( slot.instance );
+				slot.alive = false;
+			}
+			break;
+
+			default: { return false; }
+		}
+	}
+	if( !bits.valid() ) { return false; }
+
+	// Full snapshots list every live object -- anything else was destroyed
+	if( baseline == 0U )
+	{
+		for( Bucket &bucket : buckets )
+		{
+			for( u16 index = 0; index < bucket.capacity; index++ )
+			{
+				Slot &slot = bucket.slots[index];
+				if( !slot.alive || slot.tickSeen == packetTick ) { continue; }
+				context->destroy( slot.instance );
+				slot.alive = false;
+			}
+		}
+	}
+
+	bytesRead = bits.bytes_read();
+	tick = packetTick;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -0,0 +1,361 @@
+#pragma once
+
+#include <core/types.hpp>
+#include <core/debug.hpp>
+#include <core/list.hpp>
+#include <core/hashmap.hpp>
+#include <core/buffer.hpp>
+
+#include <manta/network.hpp>
+#include <manta/objects.system.hpp>
+
+#include <vendor/string.hpp>
+#include <vendor/simd.hpp>
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Delta replication of NETWORKED objects
+//
+// REPLICATED variables in .object files generate per-variable snapshot, compare, and bit-packing functions
+// (see: CoreObjects::TYPE_REPLICATION). ReplicationServer::sample() diffs replicated objects against their
+// snapshots once per network tick and records the tick each variable last changed. Snapshots are then encoded
+// relative to each client's acknowledged tick (its baseline, kept on NetworkServerUDP), so bandwidth and
+// encoding cost scale with what changed since that baseline rather than with world size.
+//
+// Clients acknowledge ReplicationClient::tick after a successful read() with ReplicationClient::acknowledge(); the
+// server passes acknowledgements to ReplicationServer::receive(), which advances that connection's baseline on
+// NetworkServerUDP. Packets are validated in full before any object is created, destroyed, or written, so a
+// truncated or malformed packet leaves the client context untouched.
+//
+// Snapshots are split into datagrams of at most REPLICATION_DATAGRAM_BYTES on send and reassembled by
+// ReplicationClient::receive(). A snapshot with a lost fragment is never applied or acknowledged, so the server
+// keeps encoding against the older baseline (and falls back to a full snapshot after REPLICATION_HISTORY ticks).
+//
+// A context with a ReplicationServer or ReplicationClient attached replicates through its network events:
+// ObjectContext::event_network_send() samples and sends, event_network_receive() reassembles, applies, and (with
+// a NetworkClientUDP attached) acknowledges. Acknowledgements arrive on the server without an ObjectContext
+// event, so the NetworkServerUDP receive callback must pass them to ReplicationServer::receive().
+//
+// Replication memory is accounted to MemoryTag_Network.
+
+#define REPLICATION_FIELDS_MAX ( 32 ) // field masks are u32
+#define REPLICATION_HISTORY ( 64 ) // ticks of change history kept -- older baselines receive full snapshots
+#define REPLICATION_CONTEXTS_MAX ( 8 ) // ObjectContexts with a ReplicationServer/ReplicationClient attached
+
+#define REPLICATION_DATAGRAM_BYTES ( 1200 ) // fits the minimum IPv6 MTU (1280) with IP/UDP/network headers
+#define REPLICATION_FRAGMENTS_MAX ( 1024 ) // largest snapshot: ~1.2 mb
+
+struct ReplicationFragmentHeader
+{
+	u32 tick;
+	u16 index;
+	u16 count;
+};
+static_assert( sizeof( ReplicationFragmentHeader ) == 8, "Size mismatch!" );
+
+#define REPLICATION_FRAGMENT_PAYLOAD_BYTES ( REPLICATION_DATAGRAM_BYTES - sizeof( ReplicationFragmentHeader ) )
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class BitWriter
+{
+public:
+	void begin( Buffer &buffer )
+	{
+		this->buffer = &buffer;
+		scratch = 0LLU;
+		scratchBits = 0;
+		bitsWritten = 0LLU;
+	}
+
+	void end()
+	{
+		// Flush remaining bits (rounded up to a whole byte)
+		for( ; scratchBits > 0; scratchBits = scratchBits > 8 ? scratchBits - 8 : 0 )
+		{
+			buffer->write<u8>( static_cast<u8>( scratch ) );
+			scratch >>= 8;
+		}
+	}
+
+	void write( const u32 value, const u32 bits )
+	{
+		Assert( bits <= 32 );
+		scratch |= ( static_cast<u64>( value ) & ( ( 1LLU << bits ) - 1 ) ) << scratchBits;
+		scratchBits += bits;
+		bitsWritten += bits;
+
+		if( scratchBits >= 32 )
+		{
+			buffer->write<u32>( static_cast<u32>( scratch ) );
+			scratch >>= 32;
+			scratchBits -= 32;
+		}
+	}
+
+	void write_varint( const u32 value, const u32 prefixBits = 6 )
+	{
+		// Significant bit count, followed by the value without its (implicit) leading 1
+		const u32 length = value == 0 ? 0 : 64 - simd_clz64( value );
+		write( length, prefixBits );
+		if( length > 1 ) { write( value, length - 1 ); }
+	}
+
+	usize bits_written() const { return bitsWritten; }
+
+private:
+	Buffer *buffer = nullptr;
+	u64 scratch = 0LLU;
+	u32 scratchBits = 0;
+	usize bitsWritten = 0LLU;
+};
+
+
+class BitReader
+{
+public:
+	void begin( const void *data, const usize size )
+	{
+		this->data = reinterpret_cast<const byte *>( data );
+		this->size = size;
+		tell = 0LLU;
+		scratch = 0LLU;
+		scratchBits = 0;
+		overflow = false;
+	}
+
+	u32 read( const u32 bits )
+	{
+		Assert( bits <= 32 );
+		if( scratchBits < bits )
+		{
+			if( LIKELY( tell + 4 <= size ) )
+			{
+				u32 word; memcpy( &word, data + tell, 4 );
+				scratch |= static_cast<u64>( word ) << scratchBits;
+				scratchBits += 32;
+				tell += 4;
+			}
+			else
+			{
+				for( ; scratchBits < bits && tell < size; scratchBits += 8 )
+				{
+					scratch |= static_cast<u64>( data[tell++] ) << scratchBits;
+				}
+				if( UNLIKELY( scratchBits < bits ) ) { overflow = true; return 0U; }
+			}
+		}
+
+		const u32 value = static_cast<u32>( scratch & ( ( 1LLU << bits ) - 1 ) );
+		scratch >>= bits;
+		scratchBits -= bits;
+		return value;
+	}
+
+	u32 read_varint( const u32 prefixBits = 6 )
+	{
+		const u32 length = read( prefixBits );
+		if( length <= 1 ) { return length; }
+		if( UNLIKELY( length > 32 ) ) { overflow = true; return 0U; }
+		return ( 1U << ( length - 1 ) ) | read( length - 1 );
+	}
+
+	bool valid() const { return !overflow; }
+	usize bytes_read() const { return tell - scratchBits / 8; }
+
+private:
+	const byte *data = nullptr;
+	usize size = 0LLU;
+	usize tell = 0LLU;
+	u64 scratch = 0LLU;
+	u32 scratchBits = 0;
+	bool overflow = false;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+namespace Replication
+{
+	// Snapshot compare (bitwise, so NaNs don't register as changed every sample)
+	template <typename T> inline bool sample( T &state, const T &value )
+	{
+		if( memcmp( &state, &value, sizeof( T ) ) == 0 ) { return false; }
+		state = value;
+		return true;
+	}
+
+	inline u32 zigzag( const i32 value ) { return ( static_cast<u32>( value ) << 1 ) ^ static_cast<u32>( value >> 31 ); }
+	inline i32 unzigzag( const u32 value ) { return static_cast<i32>( value >> 1 ) ^ -static_cast<i32>( value & 1 ); }
+
+	// Default: raw bits (float, double, structs, enums, ...)
+	template <typename T> inline void write( BitWriter &bits, const T &value )
+	{
+		const byte *bytes = reinterpret_cast<const byte *>( &value );
+		usize i = 0;
+		for( ; i + 4 <= sizeof( T ); i += 4 ) { u32 word; memcpy( &word, bytes + i, 4 ); bits.write( word, 32 ); }
+		for( ; i < sizeof( T ); i++ ) { bits.write( bytes[i], 8 ); }
+	}
+
+	template <typename T> inline void read( BitReader &bits, T &value )
+	{
+		byte *bytes = reinterpret_cast<byte *>( &value );
+		usize i = 0;
+		for( ; i + 4 <= sizeof( T ); i += 4 ) { const u32 word = bits.read( 32 ); memcpy( bytes + i, &word, 4 ); }
+		for( ; i < sizeof( T ); i++ ) { bytes[i] = static_cast<byte>( bits.read( 8 ) ); }
+	}
+
+	// bool: 1 bit
+	inline void write( BitWriter &bits, const bool &value ) { bits.write( value ? 1U : 0U, 1 ); }
+	inline void read( BitReader &bits, bool &value ) { value = bits.read( 1 ) != 0; }
+
+	// Integers: significant bits only (signed values are zigzag encoded)
+	inline void write( BitWriter &bits, const u8 &value ) { bits.write_varint( value, 4 ); }
+	inline void read( BitReader &bits, u8 &value ) { value = static_cast<u8>( bits.read_varint( 4 ) ); }
+	inline void write( BitWriter &bits, const u16 &value ) { bits.write_varint( value, 5 ); }
+	inline void read( BitReader &bits, u16 &value ) { value = static_cast<u16>( bits.read_varint( 5 ) ); }
+	inline void write( BitWriter &bits, const u32 &value ) { bits.write_varint( value, 6 ); }
+	inline void read( BitReader &bits, u32 &value ) { value = bits.read_varint( 6 ); }
+
+	inline void write( BitWriter &bits, const i8 &value ) { bits.write_varint( zigzag( value ), 4 ); }
+	inline void read( BitReader &bits, i8 &value ) { value = static_cast<i8>( unzigzag( bits.read_varint( 4 ) ) ); }
+	inline void write( BitWriter &bits, const i16 &value ) { bits.write_varint( zigzag( value ), 5 ); }
+	inline void read( BitReader &bits, i16 &value ) { value = static_cast<i16>( unzigzag( bits.read_varint( 5 ) ) ); }
+	inline void write( BitWriter &bits, const i32 &value ) { bits.write_varint( zigzag( value ), 6 ); }
+	inline void read( BitReader &bits, i32 &value ) { value = unzigzag( bits.read_varint( 6 ) ); }
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+class ReplicationServer
+{
+public:
+	// 'network': connections sent to by ObjectContext::event_network_send() (optional)
+	void init( ObjectContext &context, NetworkServerUDP *network = nullptr );
+	void free();
+
+	// Advance the tick and record every REPLICATED variable that changed since the previous sample
+	u32 sample();
+
+	// Encode everything that changed after 'baseline' (0: full snapshot)
+	void write( Buffer &buffer, u32 baseline ) const;
+
+	// Encode & send relative to each connection's acknowledged baseline (see: NetworkServerUDP)
+	bool send_to( NetworkServerUDP &server, NetworkConnectionHandle handle, Buffer &buffer ) const;
+	bool send( NetworkServerUDP &server, Buffer &buffer ) const;
+
+	// Advance a connection's baseline from a ReplicationClient::acknowledge() datagram (positioned after the
+	// network header). Returns false for malformed acknowledgements or ticks that were never sent
+	bool receive( NetworkServerUDP &server, NetworkConnectionHandle handle, Buffer &datagram );
+
+	// Datagrams of an encoded snapshot: header + at most REPLICATION_FRAGMENT_PAYLOAD_BYTES of payload each
+	// ('datagram' must hold REPLICATION_DATAGRAM_BYTES, returns the datagram size)
+	static u32 fragment_count( const Buffer &buffer );
+	static usize fragment( const Buffer &buffer, u32 index, void *datagram );
+
+private:
+	struct Slot
+	{
+		u16 generation; // ObjectInstance generation of the sampled object
+		u16 alive;
+		u32 tickCreated; // tick the object was first sampled
+		u32 tickChanged; // tick any REPLICATED variable last changed
+		u32 tickSeen; // tick the object was last sampled alive
+	};
+
+	struct Bucket // mirrors an ObjectContext::ObjectBucket
+	{
+		u16 type = 0;
+		u16 capacity = 0;
+		Slot *slots = nullptr;
+		byte *states = nullptr; // OBJECT_REPLICATION<T>::State per slot
+		u32 *ticks = nullptr; // change tick per REPLICATED variable per slot
+	};
+
+	struct Change
+	{
+		u16 bucketID;
+		u16 index;
+		u16 generation;
+		u16 destroyed;
+	};
+
+	void bucket_init( Bucket &bucket, u16 type );
+	void bucket_free( Bucket &bucket );
+	void write_object( BitWriter &bits, u32 &key, u16 bucketID, u16 index, u32 baseline ) const;
+
+public:
+	ObjectContext *context = nullptr;
+	NetworkServerUDP *network = nullptr;
+	u32 tick = 0U;
+
+private:
+	List<Bucket> buckets;
+	List<Change> history[REPLICATION_HISTORY];
+	u32 historyTick[REPLICATION_HISTORY];
+};
+
+
+class ReplicationClient
+{
+public:
+	// 'network': acknowledgements sent by ObjectContext::event_network_receive() (optional)
+	void init( ObjectContext &context, NetworkClientUDP *network = nullptr );
+	void free();
+
+	// Apply a ReplicationServer snapshot (returns false for stale or malformed packets)
+	bool read( Buffer &buffer );
+
+	// Reassemble a datagram from ReplicationServer::send() (positioned after the network header). Returns true
+	// once the last fragment of a snapshot arrived and the snapshot was applied. A fragment of a newer tick
+	// discards an incomplete older snapshot
+	bool receive( Buffer &datagram );
+
+	// Send 'tick' to the server (see: ReplicationServer::receive)
+	bool acknowledge( NetworkClientUDP &network ) const;
+
+private:
+	struct Slot
+	{
+		ObjectInstance instance; // local object
+		u16 generation; // server ObjectInstance generation
+		u16 alive;
+		u32 tickSeen;
+	};
+
+	struct Bucket // mirrors a server ObjectContext::ObjectBucket
+	{
+		u16 type = 0;
+		u16 capacity = 0;
+		Slot *slots = nullptr;
+	};
+
+	void bucket_init( Bucket &bucket, u16 type );
+	void bucket_free( Bucket &bucket );
+	bool validate( const void *data, usize size );
+	bool apply( const void *data, usize size, usize &bytesRead );
+
+public:
+	ObjectContext *context = nullptr;
+	NetworkClientUDP *network = nullptr;
+	u32 tick = 0U; // last applied server tick (acknowledge this back to the server)
+
+private:
+	List<Bucket> buckets;
+
+	// Validation (see: validate)
+	HashMap<u32, u32> stagedSlots; // slot key -> REPLICATION_STAGED_ALIVE | generation (0: dead)
+	HashMap<u32, u32> stagedBuckets; // bucketID -> type in use by the packet (| REPLICATION_STAGED_REASSIGNED)
+	byte *stagedObject = nullptr; // REPLICATED variables are read here (sized for the largest replicated type)
+	usize stagedObjectSize = 0LLU;
+
+	// Fragment reassembly (see: receive)
+	byte *assembly = nullptr;
+	usize assemblyCapacity = 0LLU;
+	usize assemblySize = 0LLU; // known once the last fragment arrived
+	u32 assemblyTick = 0U;
+	u32 assemblyCount = 0U;
+	u32 assemblyReceived = 0U;
+	u64 assemblyMask[REPLICATION_FRAGMENTS_MAX / 64];
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
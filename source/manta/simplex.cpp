@@ -1,8 +1,11 @@
 #include <manta/simplex.hpp>
 
 #include <core/types.hpp>
+#include <core/debug.hpp>
 #include <core/math.hpp>
 
+#include <vendor/simd.hpp>
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #define F2 0.366025403f
@@ -22,6 +25,19 @@ static inline int wrap_int( int x, int period )
 	return ( x < 0 ) ? x + period : x;
 }
 
+static inline int hash_seeded( u32 seed, int x, int y )
+{
+	u32 h = seed;
+	h = h * 0x45d9f3b + x;
+	h = h * 0x45d9f3b + y;
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+	return h & 0x3F;
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void Simplex::seed( u64 seed )
@@ -296,17 +312,355 @@ float Simplex::sample_fbm_unorm( float x, float y, float f, float a, float l, fl
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Batched grid sampling
+//
+// The lanes replay the scalar functions operation for operation (same operand order, no fused multiply-adds), so
+// results are bit-identical. Corner gradients are selected with masks & sign flips rather than table lookups, and the
+// hash is plain 32-bit integer math; only the permutation table (fast) and tiled wrapping fall back to per-lane
+// scalar lookups.
+
+#if SIMD_SSE2 || SIMD_NEON
+#define SIMPLEX_LANES ( 4 )
+
+#if SIMD_SSE2
+	using f32x4 = __m128;
+	using i32x4 = __m128i;
+
+	static inline f32x4 f32x4_set( float v ) { return _mm_set1_ps( v ); }
+	static inline void f32x4_store( float *p, f32x4 v ) { _mm_storeu_ps( p, v ); }
+	static inline f32x4 f32x4_add( f32x4 a, f32x4 b ) { return _mm_add_ps( a, b ); }
+	static inline f32x4 f32x4_sub( f32x4 a, f32x4 b ) { return _mm_sub_ps( a, b ); }
+	static inline f32x4 f32x4_mul( f32x4 a, f32x4 b ) { return _mm_mul_ps( a, b ); }
+	static inline f32x4 f32x4_xor( f32x4 a, i32x4 bits ) { return _mm_xor_ps( a, _mm_castsi128_ps( bits ) ); }
+	static inline i32x4 f32x4_lt( f32x4 a, f32x4 b ) { return _mm_castps_si128( _mm_cmplt_ps( a, b ) ); }
+	static inline i32x4 f32x4_gt( f32x4 a, f32x4 b ) { return _mm_castps_si128( _mm_cmpgt_ps( a, b ) ); }
+	static inline f32x4 f32x4_select( i32x4 mask, f32x4 a, f32x4 b )
+	{
+		const __m128 m = _mm_castsi128_ps( mask );
+		return _mm_or_ps( _mm_and_ps( m, a ), _mm_andnot_ps( m, b ) );
+	}
+	static inline f32x4 f32x4_from_i32( i32x4 v ) { return _mm_cvtepi32_ps( v ); }
+	static inline i32x4 f32x4_truncate( f32x4 v ) { return _mm_cvttps_epi32( v ); }
+
+	static inline i32x4 i32x4_set( int v ) { return _mm_set1_epi32( v ); }
+	static inline i32x4 i32x4_set( int a, int b, int c, int d ) { return _mm_setr_epi32( a, b, c, d ); }
+	static inline i32x4 i32x4_load( const int *p ) { return _mm_loadu_si128( reinterpret_cast<const __m128i *>( p ) ); }
+	static inline void i32x4_store( int *p, i32x4 v ) { _mm_storeu_si128( reinterpret_cast<__m128i *>( p ), v ); }
+	static inline i32x4 i32x4_add( i32x4 a, i32x4 b ) { return _mm_add_epi32( a, b ); }
+	static inline i32x4 i32x4_and( i32x4 a, i32x4 b ) { return _mm_and_si128( a, b ); }
+	static inline i32x4 i32x4_xor( i32x4 a, i32x4 b ) { return _mm_xor_si128( a, b ); }
+	static inline i32x4 i32x4_gt( i32x4 a, i32x4 b ) { return _mm_cmpgt_epi32( a, b ); }
+	template <int N> static inline i32x4 i32x4_shl( i32x4 v ) { return _mm_slli_epi32( v, N ); }
+	template <int N> static inline i32x4 i32x4_shr( i32x4 v ) { return _mm_srli_epi32( v, N ); }
+	static inline i32x4 i32x4_mul( i32x4 a, i32x4 b )
+	{
+		// Low 32 bits of each product (SSE2 has no pmulld)
+		const __m128i even = _mm_mul_epu32( a, b );
+		const __m128i odd = _mm_mul_epu32( _mm_srli_epi64( a, 32 ), _mm_srli_epi64( b, 32 ) );
+		return _mm_unpacklo_epi32( _mm_shuffle_epi32( even, _MM_SHUFFLE( 0, 0, 2, 0 ) ),
+			_mm_shuffle_epi32( odd, _MM_SHUFFLE( 0, 0, 2, 0 ) ) );
+	}
+#elif SIMD_NEON
+	using f32x4 = float32x4_t;
+	using i32x4 = int32x4_t;
+
+	static inline f32x4 f32x4_set( float v ) { return vdupq_n_f32( v ); }
+	static inline void f32x4_store( float *p, f32x4 v ) { vst1q_f32( p, v ); }
+	static inline f32x4 f32x4_add( f32x4 a, f32x4 b ) { return vaddq_f32( a, b ); }
+	static inline f32x4 f32x4_sub( f32x4 a, f32x4 b ) { return vsubq_f32( a, b ); }
+	static inline f32x4 f32x4_mul( f32x4 a, f32x4 b ) { return vmulq_f32( a, b ); }
+	static inline f32x4 f32x4_xor( f32x4 a, i32x4 bits )
+	{
+		return vreinterpretq_f32_s32( veorq_s32( vreinterpretq_s32_f32( a ), bits ) );
+	}
+	static inline i32x4 f32x4_lt( f32x4 a, f32x4 b ) { return vreinterpretq_s32_u32( vcltq_f32( a, b ) ); }
+	static inline i32x4 f32x4_gt( f32x4 a, f32x4 b ) { return vreinterpretq_s32_u32( vcgtq_f32( a, b ) ); }
+	static inline f32x4 f32x4_select( i32x4 mask, f32x4 a, f32x4 b )
+	{
+		return vbslq_f32( vreinterpretq_u32_s32( mask ), a, b );
+	}
+	static inline f32x4 f32x4_from_i32( i32x4 v ) { return vcvtq_f32_s32( v ); }
+	static inline i32x4 f32x4_truncate( f32x4 v ) { return vcvtq_s32_f32( v ); }
+
+	static inline i32x4 i32x4_set( int v ) { return vdupq_n_s32( v ); }
+	static inline i32x4 i32x4_set( int a, int b, int c, int d )
+	{
+		const int v[4] = { a, b, c, d };
+		return vld1q_s32( v );
+	}
+	static inline i32x4 i32x4_load( const int *p ) { return vld1q_s32( p ); }
+	static inline void i32x4_store( int *p, i32x4 v ) { vst1q_s32( p, v ); }
+	static inline i32x4 i32x4_add( i32x4 a, i32x4 b ) { return vaddq_s32( a, b ); }
+	static inline i32x4 i32x4_and( i32x4 a, i32x4 b ) { return vandq_s32( a, b ); }
+	static inline i32x4 i32x4_xor( i32x4 a, i32x4 b ) { return veorq_s32( a, b ); }
+	static inline i32x4 i32x4_gt( i32x4 a, i32x4 b ) { return vreinterpretq_s32_u32( vcgtq_s32( a, b ) ); }
+	template <int N> static inline i32x4 i32x4_shl( i32x4 v ) { return vshlq_n_s32( v, N ); }
+	template <int N> static inline i32x4 i32x4_shr( i32x4 v )
+	{
+		return vreinterpretq_s32_u32( vshrq_n_u32( vreinterpretq_u32_s32( v ), N ) );
+	}
+	static inline i32x4 i32x4_mul( i32x4 a, i32x4 b ) { return vmulq_s32( a, b ); }
+#endif
+
+
+enum_type( SimplexLanesHash, int )
+{
+	SimplexLanesHash_Hash = 0, // sample()
+	SimplexLanesHash_Permutation, // sample_fast()
+	SimplexLanesHash_Tiled, // sample_tiled()
+	SIMPLEXLANESHASH_COUNT,
+};
+
+
+struct SimplexLanes
+{
+	const u8 *perm;
+	u32 seed;
+	int period;
+};
+
+
+static inline i32x4 floor_lanes( f32x4 v )
+{
+	// fast_floor(): truncate, then step down where truncation rounded up
+	const i32x4 f = f32x4_truncate( v );
+	return i32x4_add( f, f32x4_gt( f32x4_from_i32( f ), v ) );
+}
+
+
+static inline i32x4 hash_lanes( u32 seed, i32x4 x, i32x4 y )
+{
+	i32x4 h = i32x4_add( i32x4_set( static_cast<int>( seed * 0x45d9f3b ) ), x );
+	h = i32x4_add( i32x4_mul( h, i32x4_set( 0x45d9f3b ) ), y );
+	h = i32x4_xor( h, i32x4_shr<16>( h ) );
+	h = i32x4_mul( h, i32x4_set( static_cast<int>( 0x85ebca6b ) ) );
+	h = i32x4_xor( h, i32x4_shr<13>( h ) );
+	h = i32x4_mul( h, i32x4_set( static_cast<int>( 0xc2b2ae35 ) ) );
+	h = i32x4_xor( h, i32x4_shr<16>( h ) );
+	return i32x4_and( h, i32x4_set( 0x3F ) );
+}
+
+
+static inline f32x4 corner_lanes( i32x4 hash, f32x4 x, f32x4 y )
+{
+	// grad(): h < 4 picks ( u, v ) = ( x, y ), otherwise ( y, x ); bits 0 & 1 negate u & 2v
+	const i32x4 h = i32x4_and( hash, i32x4_set( 0x3F ) );
+	const i32x4 swap = i32x4_gt( h, i32x4_set( 3 ) );
+	const f32x4 u = f32x4_select( swap, y, x );
+	const f32x4 v = f32x4_select( swap, x, y );
+	const i32x4 signU = i32x4_shl<31>( h );
+	const i32x4 signV = i32x4_shl<30>( i32x4_and( h, i32x4_set( 2 ) ) );
+	const f32x4 g = f32x4_add( f32x4_xor( u, signU ), f32x4_xor( f32x4_mul( f32x4_set( 2.0f ), v ), signV ) );
+
+	const f32x4 t = f32x4_sub( f32x4_sub( f32x4_set( 0.5f ), f32x4_mul( x, x ) ), f32x4_mul( y, y ) );
+	const f32x4 t2 = f32x4_mul( t, t );
+	const f32x4 n = f32x4_mul( f32x4_mul( t2, t2 ), g );
+	return f32x4_select( f32x4_lt( t, f32x4_set( 0.0f ) ), f32x4_set( 0.0f ), n );
+}
+
+
+template <SimplexLanesHash HASH> static f32x4 sample_lanes( const SimplexLanes &lanes, f32x4 x, f32x4 y )
+{
+	const f32x4 s = f32x4_mul( f32x4_add( x, y ), f32x4_set( F2 ) );
+	const i32x4 i = floor_lanes( f32x4_add( x, s ) );
+	const i32x4 j = floor_lanes( f32x4_add( y, s ) );
+	const f32x4 t = f32x4_mul( f32x4_from_i32( i32x4_add( i, j ) ), f32x4_set( G2 ) );
+	const f32x4 x0 = f32x4_sub( x, f32x4_sub( f32x4_from_i32( i ), t ) );
+	const f32x4 y0 = f32x4_sub( y, f32x4_sub( f32x4_from_i32( j ), t ) );
+	const i32x4 i1 = i32x4_and( f32x4_gt( x0, y0 ), i32x4_set( 1 ) );
+	const i32x4 j1 = i32x4_xor( i1, i32x4_set( 1 ) );
+	const f32x4 x1 = f32x4_add( f32x4_sub( x0, f32x4_from_i32( i1 ) ), f32x4_set( G2 ) );
+	const f32x4 y1 = f32x4_add( f32x4_sub( y0, f32x4_from_i32( j1 ) ), f32x4_set( G2 ) );
+	const f32x4 x2 = f32x4_add( f32x4_sub( x0, f32x4_set( 1.0f ) ), f32x4_set( 2.0f * G2 ) );
+	const f32x4 y2 = f32x4_add( f32x4_sub( y0, f32x4_set( 1.0f ) ), f32x4_set( 2.0f * G2 ) );
+
+	// Hashed gradient indices of the three simplex corners
+	i32x4 gi0, gi1, gi2;
+	if constexpr ( HASH == SimplexLanesHash_Hash )
+	{
+		const i32x4 one = i32x4_set( 1 );
+		gi0 = hash_lanes( lanes.seed, i, j );
+		gi1 = hash_lanes( lanes.seed, i32x4_add( i, i1 ), i32x4_add( j, j1 ) );
+		gi2 = hash_lanes( lanes.seed, i32x4_add( i, one ), i32x4_add( j, one ) );
+	}
+	else
+	{
+		alignas( 16 ) int li[SIMPLEX_LANES], lj[SIMPLEX_LANES], li1[SIMPLEX_LANES];
+		alignas( 16 ) int g0[SIMPLEX_LANES], g1[SIMPLEX_LANES], g2[SIMPLEX_LANES];
+		i32x4_store( li, i );
+		i32x4_store( lj, j );
+		i32x4_store( li1, i1 );
+
+		for( int lane = 0; lane < SIMPLEX_LANES; lane++ )
+		{
+			const int ii = li[lane];
+			const int jj = lj[lane];
+			const int ii1 = li1[lane];
+			const int jj1 = !ii1;
+
+			if constexpr ( HASH == SimplexLanesHash_Permutation )
+			{
+				const u8 *perm = lanes.perm;
+				g0[lane] = perm[static_cast<u8>( ii       + perm[static_cast<u8>( jj )] )];
+				g1[lane] = perm[static_cast<u8>( ii + ii1 + perm[static_cast<u8>( jj + jj1 )] )];
+				g2[lane] = perm[static_cast<u8>( ii + 1   + perm[static_cast<u8>( jj + 1 )] )];
+			}
+			else
+			{
+				const int period = lanes.period;
+				g0[lane] = hash_seeded( lanes.seed, wrap_int( ii, period ), wrap_int( jj, period ) );
+				g1[lane] = hash_seeded( lanes.seed, wrap_int( ii + ii1, period ), wrap_int( jj + jj1, period ) );
+				g2[lane] = hash_seeded( lanes.seed, wrap_int( ii + 1, period ), wrap_int( jj + 1, period ) );
+			}
+		}
+
+		gi0 = i32x4_load( g0 );
+		gi1 = i32x4_load( g1 );
+		gi2 = i32x4_load( g2 );
+	}
+
+	const f32x4 n0 = corner_lanes( gi0, x0, y0 );
+	const f32x4 n1 = corner_lanes( gi1, x1, y1 );
+	const f32x4 n2 = corner_lanes( gi2, x2, y2 );
+	return f32x4_mul( f32x4_set( 45.23065f ), f32x4_add( f32x4_add( n0, n1 ), n2 ) );
+}
+
+
+template <SimplexLanesHash HASH> static void sample_grid_row_lanes( const SimplexLanes &lanes,
+	const SimplexGrid &grid, float *output, float y, int columns )
+{
+	const f32x4 x = f32x4_set( grid.x );
+	const f32x4 step = f32x4_set( grid.step );
+	const f32x4 py = f32x4_set( y );
+	const i32x4 lane = i32x4_set( 0, 1, 2, 3 );
+
+	for( int column = 0; column < columns; column += SIMPLEX_LANES )
+	{
+		const f32x4 c = f32x4_from_i32( i32x4_add( i32x4_set( column ), lane ) );
+		const f32x4 px = f32x4_add( x, f32x4_mul( c, step ) );
+
+		f32x4 value;
+		if( grid.octaves == 0 )
+		{
+			value = sample_lanes<HASH>( lanes, px, py );
+		}
+		else
+		{
+			value = f32x4_set( 0.0f );
+			float f = grid.frequency;
+			float a = grid.amplitude;
+			for( int o = 0; o < grid.octaves; o++ )
+			{
+				const f32x4 ff = f32x4_set( f );
+				const f32x4 n = sample_lanes<HASH>( lanes, f32x4_mul( px, ff ), f32x4_mul( py, ff ) );
+				value = f32x4_add( value, f32x4_mul( f32x4_set( a ), n ) );
+				f *= grid.lacunarity;
+				a *= grid.persistence;
+			}
+		}
+
+		if( grid.unorm ) { value = f32x4_add( f32x4_mul( value, f32x4_set( 0.5f ) ), f32x4_set( 0.5f ) ); }
+		f32x4_store( &output[column], value );
+	}
+}
+#endif
+
+
+float Simplex::sample_grid_point( const SimplexGrid &grid, float x, float y ) const
+{
+	if( grid.octaves > 0 )
+	{
+		const float f = grid.frequency;
+		const float a = grid.amplitude;
+		const float l = grid.lacunarity;
+		const float p = grid.persistence;
+		const int o = grid.octaves;
+		if( grid.fast )
+		{
+			return grid.unorm ? sample_fbm_unorm_fast( x, y, f, a, l, p, o ) : sample_fbm_fast( x, y, f, a, l, p, o );
+		}
+		return grid.unorm ? sample_fbm_unorm( x, y, f, a, l, p, o ) : sample_fbm( x, y, f, a, l, p, o );
+	}
+
+	const float value = grid.period > 0 ? sample_tiled( x, y, grid.period ) :
+		( grid.fast ? sample_fast( x, y ) : sample( x, y ) );
+	return grid.unorm ? value * 0.5f + 0.5f : value;
+}
+
+
+void Simplex::sample_grid( const SimplexGrid &grid ) const
+{
+	sample_grid_rows( grid, 0, grid.height );
+}
+
+
+void Simplex::sample_grid_rows( const SimplexGrid &grid, int rowFirst, int rowEnd ) const
+{
+	Assert( grid.output != nullptr );
+	Assert( grid.width >= 0 && grid.height >= 0 );
+	Assert( rowFirst >= 0 && rowFirst <= rowEnd && rowEnd <= grid.height );
+	Assert( grid.period <= 0 || ( grid.octaves == 0 && !grid.fast ) );
+	const usize stride = grid.stride == 0 ? static_cast<usize>( grid.width ) : grid.stride;
+
+#if SIMD_SSE2 || SIMD_NEON
+	const SimplexLanes lanes { perm, static_cast<u32>( s ), grid.period };
+	const int columns = grid.width & ~( SIMPLEX_LANES - 1 );
+#else
+	const int columns = 0;
+#endif
+
+	for( int row = rowFirst; row < rowEnd; row++ )
+	{
+		float *output = &grid.output[row * stride];
+		const float y = grid.y + static_cast<float>( row ) * grid.step;
+
+	#if SIMD_SSE2 || SIMD_NEON
+		if( grid.period > 0 )
+		{
+			sample_grid_row_lanes<SimplexLanesHash_Tiled>( lanes, grid, output, y, columns );
+		}
+		else if( grid.fast )
+		{
+			sample_grid_row_lanes<SimplexLanesHash_Permutation>( lanes, grid, output, y, columns );
+		}
+		else
+		{
+			sample_grid_row_lanes<SimplexLanesHash_Hash>( lanes, grid, output, y, columns );
+		}
+	#endif
+
+		// Remainder columns
+		for( int column = columns; column < grid.width; column++ )
+		{
+			output[column] = sample_grid_point( grid, grid.x + static_cast<float>( column ) * grid.step, y );
+		}
+	}
+}
+
+
+void Simplex::sample_grid_scalar( const SimplexGrid &grid ) const
+{
+	Assert( grid.output != nullptr );
+	Assert( grid.width >= 0 && grid.height >= 0 );
+	Assert( grid.period <= 0 || ( grid.octaves == 0 && !grid.fast ) );
+	const usize stride = grid.stride == 0 ? static_cast<usize>( grid.width ) : grid.stride;
+
+	for( int row = 0; row < grid.height; row++ )
+	{
+		float *output = &grid.output[row * stride];
+		const float y = grid.y + static_cast<float>( row ) * grid.step;
+		for( int column = 0; column < grid.width; column++ )
+		{
+			output[column] = sample_grid_point( grid, grid.x + static_cast<float>( column ) * grid.step, y );
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 int Simplex::hash( int x, int y ) const
 {
-	u32 h = static_cast<u32>( s );
-	h = h * 0x45d9f3b + x;
-	h = h * 0x45d9f3b + y;
-	h ^= h >> 16;
-	h *= 0x85ebca6b;
-	h ^= h >> 13;
-	h *= 0xc2b2ae35;
-	h ^= h >> 16;
-	return h & 0x3F;
+	return hash_seeded( static_cast<u32>( s ), x, y );
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -36,9 +36,9 @@ constexpr float ANIMATION_SPEED = 1.0;
 constexpr u16 ANIMATION_KEYFRAMES = 8;
 
 
-float Animation::get_value( Timeline timeline ) const
+static float animation_sample( const u32 animation, const float time, const Timeline timeline, const bool degrees )
 {
-	const AnimationEntry &animationEntry = animationEntries[index];
+	const AnimationEntry &animationEntry = animationEntries[animation];
 	if( animationEntry.keyframeCount[timeline] == 0 ) { return 0.0f; }
 
 	const int keyframeCurrent = static_cast<int>( time * animationEntry.keyframeCount[timeline] );
@@ -53,28 +53,20 @@ float Animation::get_value( Timeline timeline ) const
 	const float b = frameNext.time - frameCurrent.time + ( frameNext.time < frameCurrent.time ) * 1.0f;
 	const float progress = a / b;
 
-	return lerp( frameCurrent.value, frameNext.value, progress );
+	return degrees ? lerp_degrees( frameCurrent.value, frameNext.value, progress ) :
+		lerp( frameCurrent.value, frameNext.value, progress );
 }
 
 
-float Animation::get_rotation( Timeline timeline ) const
+float Animation::get_value( Timeline timeline ) const
 {
-	const AnimationEntry &animationEntry = animationEntries[index];
-	if( animationEntry.keyframeCount[timeline] == 0 ) { return 0.0f; }
-
-	const int keyframeCurr = static_cast<int>( time * animationEntry.keyframeCount[timeline] );
-	const u32 indexCurr = animationEntry.keyframeFirst[timeline] + keyframeCurr;
-	const BinKeyframe &frameCurr = binKeyframes[indexCurr];
-
-	const int keyframeNext = ( ( keyframeCurr + 1 ) % animationEntry.keyframeCount[timeline] );
-	const u32 indexNext = animationEntry.keyframeFirst[timeline] + keyframeNext;
-	const BinKeyframe &frameNext = binKeyframes[indexNext];
+	return animation_sample( index, time, timeline, false );
+}
 
-	const float a = time - frameCurr.time + ( time < frameCurr.time ) * 1.0f;
-	const float b = frameNext.time - frameCurr.time + ( frameNext.time < frameCurr.time ) * 1.0f;
-	const float progress = a / b;
 
-	return lerp_degrees( frameCurr.value, frameNext.value, progress );
+float Animation::get_rotation( Timeline timeline ) const
+{
+	return animation_sample( index, time, timeline, true );
 }
 
 
@@ -308,6 +300,7 @@ void Bone::update( const BoneEntry &boneEntry, Delta delta )
 		if( animations[i].index == U32_MAX ) { continue; }
 
 		animation.update( delta );
+		if( animation.index == U32_MAX ) { continue; } // Finished (non-looping)
 
 		const float weight = animation.weight.get_value();
 		const float rotation = animation.get_rotation( Timeline_Rotation );
@@ -526,4 +519,355 @@ void Skeleton2D::draw( Delta delta, float x, float y, Color color, float depth )
 	}
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void Skeleton2DBatch::init()
+{
+	skeletons.init();
+	poseCache.init( 64, U32_MAX );
+	dirty = true;
+}
+
+
+void Skeleton2DBatch::free()
+{
+	if( arena != nullptr ) { memory_free( arena ); arena = nullptr; }
+	poseCache.free();
+	skeletons.free();
+	boneCount = 0;
+	chunkCount = 0;
+	poseCount = 0;
+	animationCount = 0;
+}
+
+
+void Skeleton2DBatch::add( Skeleton2D &skeleton )
+{
+	MemoryAssert( skeleton.bones != nullptr );
+	skeletons.add( &skeleton );
+	dirty = true;
+}
+
+
+bool Skeleton2DBatch::remove( Skeleton2D &skeleton )
+{
+	for( usize i = 0; i < skeletons.count(); i++ )
+	{
+		if( skeletons[i] != &skeleton ) { continue; }
+		skeletons.remove_swap( i );
+		dirty = true;
+		return true;
+	}
+
+	return false;
+}
+
+
+void Skeleton2DBatch::layout()
+{
+	// Count
+	boneCount = 0;
+	for( Skeleton2D *skeleton : skeletons ) { boneCount += skeletonEntries[skeleton->type].boneCount; }
+	chunkCount = static_cast<u32>( ( skeletons.count() + SKELETON_BATCH_CHUNK - 1 ) / SKELETON_BATCH_CHUNK );
+
+	// Arena
+	const usize poseCapacity = static_cast<usize>( boneCount ) * BONE_ANIMATION_COUNT;
+	const usize size = ( chunkCount + 1 ) * sizeof( u32 ) +
+		boneCount * ( sizeof( Bone * ) + 2 * sizeof( u32 ) + 15 * sizeof( float ) + sizeof( Color ) ) +
+		poseCapacity * ( sizeof( u32 ) + sizeof( float ) ) +
+		poseCapacity * ( sizeof( u32 ) + 9 * sizeof( float ) ) + 32 * 8; // + alignment
+	if( arena != nullptr ) { memory_free( arena ); }
+	arena = memory_alloc( size );
+
+	byte *cursor = reinterpret_cast<byte *>( arena );
+	auto carve = [&cursor]( auto *&array, const usize count )
+	{
+		cursor = reinterpret_cast<byte *>( ( reinterpret_cast<usize>( cursor ) + 7 ) & ~static_cast<usize>( 7 ) );
+		array = reinterpret_cast<decltype( array )>( cursor );
+		cursor += count * sizeof( *array );
+	};
+	carve( bones, boneCount );
+	carve( restX, boneCount ); carve( restY, boneCount );
+	carve( restScaleX, boneCount ); carve( restScaleY, boneCount );
+	carve( restRotation, boneCount ); carve( restCos, boneCount ); carve( restSin, boneCount );
+	carve( length, boneCount );
+	carve( worldX, boneCount ); carve( worldY, boneCount );
+	carve( worldScaleX, boneCount ); carve( worldScaleY, boneCount );
+	carve( worldRotation, boneCount ); carve( worldCos, boneCount ); carve( worldSin, boneCount );
+	carve( animationWeight, poseCapacity );
+	carve( poseTime, poseCapacity );
+	carve( poseRotX, poseCapacity ); carve( poseRotY, poseCapacity );
+	carve( poseX, poseCapacity ); carve( poseY, poseCapacity );
+	carve( poseScaleX, poseCapacity ); carve( poseScaleY, poseCapacity );
+	carve( poseShearX, poseCapacity ); carve( poseShearY, poseCapacity );
+	carve( worldColor, boneCount );
+	carve( parent, boneCount );
+	carve( order, boneCount );
+	carve( chunkBoneFirst, chunkCount + 1 );
+	carve( animationPose, poseCapacity );
+	carve( poseAnimation, poseCapacity );
+	Assert( cursor <= reinterpret_cast<byte *>( arena ) + size );
+
+	// Bones: chunk-major, then depth-major (so every parent is composed before its children)
+	auto bone_depth = []( const SkeletonEntry &skeletonEntry, u32 bone )
+	{
+		u32 depth = 0;
+		for( u32 p = boneEntries[skeletonEntry.boneFirst + bone].parent; p != U32_MAX;
+			p = boneEntries[skeletonEntry.boneFirst + p].parent ) { depth++; }
+		return depth;
+	};
+
+	u32 next = 0;
+	for( u32 chunk = 0; chunk < chunkCount; chunk++ )
+	{
+		chunkBoneFirst[chunk] = next;
+		const usize skeletonFirst = chunk * SKELETON_BATCH_CHUNK;
+		const usize skeletonLast = min( skeletonFirst + SKELETON_BATCH_CHUNK, skeletons.count() );
+
+		u32 depthMax = 0;
+		for( usize s = skeletonFirst; s < skeletonLast; s++ )
+		{
+			const SkeletonEntry &skeletonEntry = skeletonEntries[skeletons[s]->type];
+			for( u32 i = 0; i < skeletonEntry.boneCount; i++ )
+			{
+				depthMax = max( depthMax, bone_depth( skeletonEntry, i ) );
+			}
+		}
+
+		for( u32 depth = 0; depth <= depthMax; depth++ )
+		{
+			u32 skeletonFlat = chunkBoneFirst[chunk];
+			for( usize s = skeletonFirst; s < skeletonLast; s++ )
+			{
+				Skeleton2D &skeleton = *skeletons[s];
+				const SkeletonEntry &skeletonEntry = skeletonEntries[skeleton.type];
+
+				for( u32 i = 0; i < skeletonEntry.boneCount; i++ )
+				{
+					if( bone_depth( skeletonEntry, i ) != depth ) { continue; }
+					const BoneEntry &boneEntry = boneEntries[skeletonEntry.boneFirst + i];
+
+					order[skeletonFlat + i] = next;
+					bones[next] = &skeleton.bones[i];
+					parent[next] = boneEntry.parent == U32_MAX ? U32_MAX : order[skeletonFlat + boneEntry.parent];
+					restX[next] = boneEntry.x;
+					restY[next] = boneEntry.y;
+					restScaleX[next] = boneEntry.scaleX;
+					restScaleY[next] = boneEntry.scaleY;
+					restRotation[next] = boneEntry.rotation;
+					restCos[next] = cosf( boneEntry.rotation * DEG2RAD_F );
+					restSin[next] = sinf( boneEntry.rotation * DEG2RAD_F );
+					length[next] = skeleton.bones[i].length;
+					next++;
+				}
+
+				skeletonFlat += skeletonEntry.boneCount;
+			}
+		}
+	}
+	chunkBoneFirst[chunkCount] = next;
+	Assert( next == boneCount );
+
+	dirty = false;
+}
+
+
+void Skeleton2DBatch::update_begin( Delta delta )
+{
+	if( dirty ) { layout(); }
+
+	// Advance animation clocks & assign every active bone animation a (shared) pose
+	poseCache.clear();
+	poseCount = 0;
+	animationCount = 0;
+	u64 keyPrevious[BONE_ANIMATION_COUNT]; // Bones of a skeleton usually play in lockstep: skip repeated lookups
+	u32 posePrevious[BONE_ANIMATION_COUNT];
+	for( u8 i = 0; i < BONE_ANIMATION_COUNT; i++ ) { keyPrevious[i] = U64_MAX; posePrevious[i] = U32_MAX; }
+	for( u32 k = 0; k < boneCount; k++ )
+	{
+		const u32 b = order[k];
+		Bone &bone = *bones[b];
+		for( u8 i = 0; i < BONE_ANIMATION_COUNT; i++ )
+		{
+			const u32 slot = b * BONE_ANIMATION_COUNT + i;
+			Animation &animation = bone.animations[i];
+			if( animation.index != U32_MAX ) { animation.update( delta ); }
+			if( animation.index == U32_MAX ) { animationPose[slot] = U32_MAX; continue; }
+
+			u32 timeBits;
+			memory_copy( &timeBits, &animation.time, sizeof( u32 ) );
+			const u64 key = ( static_cast<u64>( animation.index ) << 32 ) | timeBits;
+			if( key != keyPrevious[i] )
+			{
+				u32 &pose = poseCache.get( key );
+				if( pose == U32_MAX )
+				{
+					pose = poseCount++;
+					poseAnimation[pose] = animation.index;
+					poseTime[pose] = animation.time;
+				}
+				keyPrevious[i] = key;
+				posePrevious[i] = pose;
+			}
+
+			animationPose[slot] = posePrevious[i];
+			animationWeight[slot] = animation.weight.get_value();
+			animationCount++;
+		}
+	}
+}
+
+
+u32 Skeleton2DBatch::sample_chunk_count() const
+{
+	return ( poseCount + SKELETON_BATCH_SAMPLE_CHUNK - 1 ) / SKELETON_BATCH_SAMPLE_CHUNK;
+}
+
+
+void Skeleton2DBatch::sample_chunk( const u32 chunk )
+{
+	const u32 first = chunk * SKELETON_BATCH_SAMPLE_CHUNK;
+	const u32 last = min( first + SKELETON_BATCH_SAMPLE_CHUNK, poseCount );
+
+	for( u32 pose = first; pose < last; pose++ )
+	{
+		// Animation::get_rotation() & Animation::get_value() for every timeline
+		const u32 animation = poseAnimation[pose];
+		const float time = poseTime[pose];
+		const float rotation = animation_sample( animation, time, Timeline_Rotation, true );
+		poseRotX[pose] = cosf( rotation * DEG2RAD_F );
+		poseRotY[pose] = sinf( rotation * DEG2RAD_F );
+		poseX[pose] = animation_sample( animation, time, Timeline_TranslationX, false );
+		poseY[pose] = animation_sample( animation, time, Timeline_TranslationY, false );
+		poseScaleX[pose] = animation_sample( animation, time, Timeline_ScaleX, false );
+		poseScaleY[pose] = animation_sample( animation, time, Timeline_ScaleY, false );
+		poseShearX[pose] = animation_sample( animation, time, Timeline_ShearX, false );
+		poseShearY[pose] = animation_sample( animation, time, Timeline_ShearY, false );
+	}
+}
+
+
+u32 Skeleton2DBatch::pose_chunk_count() const
+{
+	return chunkCount;
+}
+
+
+void Skeleton2DBatch::pose_chunk( const u32 chunk )
+{
+	Assert( chunk < chunkCount );
+
+	// Matches Bone::update(), with parent transforms read from the SoA buffers
+	for( u32 b = chunkBoneFirst[chunk]; b < chunkBoneFirst[chunk + 1]; b++ )
+	{
+		Bone &bone = *bones[b];
+
+		// Blend Animations
+		float animRotation = 0.0f;
+		float animRotX = 0.0f;
+		float animRotY = 0.0f;
+		float animX = 0.0f;
+		float animY = 0.0f;
+		float animScaleX = 1.0f;
+		float animScaleY = 1.0f;
+		float animShearX = 1.0f;
+		float animShearY = 1.0f;
+		float animWeight = 0.0f;
+
+		for( u32 slot = b * BONE_ANIMATION_COUNT; slot < ( b + 1 ) * BONE_ANIMATION_COUNT; slot++ )
+		{
+			const u32 pose = animationPose[slot];
+			if( pose == U32_MAX ) { continue; }
+
+			const float weight = animationWeight[slot];
+			animRotX += weight * poseRotX[pose];
+			animRotY += weight * poseRotY[pose];
+			animX += weight * poseX[pose];
+			animY += weight * poseY[pose];
+			animScaleX += weight * poseScaleX[pose];
+			animScaleY += weight * poseScaleY[pose];
+			animShearX += weight * poseShearX[pose];
+			animShearY += weight * poseShearY[pose];
+			animWeight += weight;
+		}
+
+		if( animWeight > 0.0f )
+		{
+			const float magnitude = sqrt( animRotX * animRotX + animRotY * animRotY );
+			animRotX /= magnitude;
+			animRotY /= magnitude;
+			animRotation = atan2f( animRotX, animRotY ) * RAD2DEG_F;
+			animX /= animWeight;
+			animY /= animWeight;
+			animScaleX /= animWeight;
+			animScaleY /= animWeight;
+			animShearX /= animWeight;
+			animShearY /= animWeight;
+		}
+
+		// Parent
+		const u32 p = parent[b];
+		const bool hasParent = ( p != U32_MAX );
+		const float parentX = hasParent ? worldX[p] : 0.0f;
+		const float parentY = hasParent ? worldY[p] : 0.0f;
+		const float parentLength = hasParent ? length[p] : 0.0f;
+		const float parentScaleX = hasParent ? worldScaleX[p] : 1.0f;
+		const float parentScaleY = hasParent ? worldScaleY[p] : 1.0f;
+		const float parentRotation = hasParent ? worldRotation[p] : 0.0f;
+		const float cosParent = hasParent ? worldCos[p] : 1.0f;
+		const float sinParent = hasParent ? worldSin[p] : 0.0f;
+		const Color parentColor = hasParent ? worldColor[p] : c_white;
+
+		// Scale
+		const float scaleX = bone.customScaleX * restScaleX[b] * animScaleX * parentScaleX;
+		const float scaleY = bone.customScaleY * restScaleY[b] * animScaleY * parentScaleY;
+
+		// Translation
+		const float localX = restX[b] + animX;
+		const float localY = restY[b] + animY;
+		const float x = ( parentX + parentLength * parentScaleX * cosParent ) +
+			( localX * scaleX * cosParent - localY * scaleX * sinParent );
+		const float y = ( parentY + parentLength * parentScaleY * sinParent ) +
+			( localX * scaleY * sinParent + localY * scaleY * cosParent );
+
+		// Rotation (its cos & sin are composed from unit vectors rather than recomputed)
+		const float rotation = bone.customRotation + restRotation[b] + animRotation + parentRotation;
+		const float customCos = bone.customRotation == 0.0f ? 1.0f : cosf( bone.customRotation * DEG2RAD_F );
+		const float customSin = bone.customRotation == 0.0f ? 0.0f : sinf( bone.customRotation * DEG2RAD_F );
+		const float animCos = animWeight > 0.0f ? animRotY : 1.0f;
+		const float animSin = animWeight > 0.0f ? animRotX : 0.0f;
+		const float localCos = customCos * restCos[b] - customSin * restSin[b];
+		const float localSin = customSin * restCos[b] + customCos * restSin[b];
+		const float animatedCos = localCos * animCos - localSin * animSin;
+		const float animatedSin = localSin * animCos + localCos * animSin;
+
+		// Color
+		const Color color = bone.color * bone.customColor * parentColor;
+
+		worldX[b] = x;
+		worldY[b] = y;
+		worldScaleX[b] = scaleX;
+		worldScaleY[b] = scaleY;
+		worldRotation[b] = rotation;
+		worldCos[b] = animatedCos * cosParent - animatedSin * sinParent;
+		worldSin[b] = animatedSin * cosParent + animatedCos * sinParent;
+		worldColor[b] = color;
+
+		bone.x = x;
+		bone.y = y;
+		bone.scaleX = scaleX;
+		bone.scaleY = scaleY;
+		bone.rotation = rotation;
+		bone.color = color;
+	}
+}
+
+
+void Skeleton2DBatch::update( Delta delta )
+{
+	update_begin( delta );
+	for( u32 chunk = 0; chunk < sample_chunk_count(); chunk++ ) { sample_chunk( chunk ); }
+	for( u32 chunk = 0; chunk < pose_chunk_count(); chunk++ ) { pose_chunk( chunk ); }
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
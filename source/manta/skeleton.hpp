@@ -3,6 +3,8 @@
 #include <core/types.hpp>
 #include <core/debug.hpp>
 #include <core/color.hpp>
+#include <core/list.hpp>
+#include <core/flathashmap.hpp>
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
@@ -173,6 +175,7 @@ public:
 
 private:
 	friend class Bone;
+	friend class Skeleton2DBatch;
 	u32 index = U32_MAX;
 	bool loop = false;
 	bool unused = false;
@@ -240,6 +243,7 @@ public:
 
 private:
 	friend class Skeleton2D;
+	friend class Skeleton2DBatch;
 	friend class Attachment;
 
 	class Skeleton2D *skeleton = nullptr;
@@ -297,3 +301,91 @@ public:
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Batched Skeleton2D::update() for many skeletons
+//
+// Every distinct (animation, time) pair is sampled once per update -- all timelines in one pass -- into SoA pose
+// buffers that are shared by every bone & skeleton playing it. Bones of all skeletons are laid out in chunks of
+// SKELETON_BATCH_CHUNK skeletons, depth-major within a chunk (parents always precede their children), and their
+// world transforms are composed from SoA parent data rather than through Skeleton2D::bones.
+//
+// update() runs everything on the calling thread. To use worker threads, call update_begin() on one thread, then
+// sample_chunk() for every index in [0, sample_chunk_count()), and once those have all completed, pose_chunk() for
+// every index in [0, pose_chunk_count()). Chunks of the same stage may run concurrently on any threads.
+//
+// Skeletons must not move in memory while they are in a batch.
+
+#define SKELETON_BATCH_CHUNK ( 64 ) // Skeletons per pose_chunk()
+#define SKELETON_BATCH_SAMPLE_CHUNK ( 256 ) // Poses per sample_chunk()
+
+class Skeleton2DBatch
+{
+public:
+	void init();
+	void free();
+
+	void add( Skeleton2D &skeleton );
+	bool remove( Skeleton2D &skeleton );
+	usize count() const { return skeletons.count(); }
+
+	void update( Delta delta );
+
+	void update_begin( Delta delta );
+	u32 sample_chunk_count() const;
+	void sample_chunk( u32 chunk );
+	u32 pose_chunk_count() const;
+	void pose_chunk( u32 chunk );
+
+	u32 pose_count() const { return poseCount; } // Poses sampled by the last update
+	u32 animation_count() const { return animationCount; } // Bone animations they were shared by
+
+private:
+	void layout();
+
+	List<Skeleton2D *> skeletons;
+	FlatHashMap<u64, u32> poseCache; // (animation, time) -> pose
+	bool dirty = true;
+
+	// Bones: chunk-major, then depth-major
+	void *arena = nullptr;
+	u32 boneCount = 0;
+	u32 chunkCount = 0;
+	u32 *chunkBoneFirst = nullptr; // [chunkCount + 1]
+	Bone **bones = nullptr;
+	u32 *parent = nullptr; // U32_MAX: root
+	u32 *order = nullptr; // Skeleton order (skeleton-major, then bone) -> b
+	float *restX = nullptr;
+	float *restY = nullptr;
+	float *restScaleX = nullptr;
+	float *restScaleY = nullptr;
+	float *restRotation = nullptr;
+	float *restCos = nullptr;
+	float *restSin = nullptr;
+	float *length = nullptr;
+	float *worldX = nullptr;
+	float *worldY = nullptr;
+	float *worldScaleX = nullptr;
+	float *worldScaleY = nullptr;
+	float *worldRotation = nullptr;
+	float *worldCos = nullptr;
+	float *worldSin = nullptr;
+	Color *worldColor = nullptr;
+	u32 *animationPose = nullptr; // [boneCount * BONE_ANIMATION_COUNT] (U32_MAX: inactive)
+	float *animationWeight = nullptr;
+
+	// Poses: at most one per bone animation
+	u32 poseCount = 0;
+	u32 animationCount = 0;
+	u32 *poseAnimation = nullptr;
+	float *poseTime = nullptr;
+	float *poseRotX = nullptr; // cos( rotation )
+	float *poseRotY = nullptr; // sin( rotation )
+	float *poseX = nullptr;
+	float *poseY = nullptr;
+	float *poseScaleX = nullptr;
+	float *poseScaleY = nullptr;
+	float *poseShearX = nullptr;
+	float *poseShearY = nullptr;
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -9,7 +9,13 @@
 
 	#include <vendor/stdio.hpp>
 	#include <vendor/string.hpp>
+
+	#include <core/debug.hpp>
+	#include <core/math.hpp>
+	#include <core/memory.hpp>
+
 	#include <manta/thread.hpp>
+	#include <manta/time.hpp>
 	#include <manta/console.hpp>
 #endif
 
@@ -33,6 +39,278 @@ static THREAD_FUNCTION( terminal_poll )
 }
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Print() Writer
+//
+// Bounded lock-free MPSC queue with per-slot sequence numbers. A producer claims a run of consecutive slots with a
+// single CAS, so a long message is never interleaved with another thread's output. The writer thread drains the
+// queue into a batch buffer and issues one fwrite + fflush per batch (and per batch to the binary log file)
+
+#define LOG_SLOTS ( 4096 ) // Power of two
+#define LOG_SLOT_TEXT ( 240 )
+#define LOG_BATCH_SIZE ( 64 * 1024 )
+#define LOG_FLUSH_TIMEOUT_MS ( 1000 )
+
+static_assert( ( LOG_SLOTS & ( LOG_SLOTS - 1 ) ) == 0, "LOG_SLOTS must be a power of two" );
+
+struct LogSlot
+{
+	Atomic_U32 sequence; // == position: free, == position + 1: published
+	u16 length;
+	i8 color;
+	u8 flags;
+	u64 timeUS;
+	char text[LOG_SLOT_TEXT];
+};
+static_assert( sizeof( LogSlot ) == 256, "LogSlot size changed" );
+
+static LogSlot *logSlots = nullptr;
+static Atomic_U32 logEnqueue;
+static Atomic_U32 logWritten; // Position the writer has written (and flushed) up to
+static Atomic_U32 logWriterSleeping;
+static Atomic_U32 logWriterExit;
+static Atomic_U32 logWriterAlive;
+static Semaphore logWriterWake;
+
+static Atomic_U64 logMessages;
+static Atomic_U64 logBatches;
+static Atomic_U64 logStalls;
+
+static Mutex logFileMutex;
+static FILE *logFile = nullptr;
+
+// Writer thread only
+static u32 logDequeue = 0;
+static char logBatchTerminal[LOG_BATCH_SIZE];
+static byte logBatchFile[LOG_BATCH_SIZE];
+
+
+static void log_writer_wake()
+{
+	// NOTE: Both sides exchange() 'logWriterSleeping', so either the writer observes the published slot or the
+	// producer observes the writer going to sleep
+	if( logWriterSleeping.exchange( 0 ) == 1 ) { logWriterWake.post(); }
+}
+
+
+static void log_sink( int color, bool newline, const char *string, int length )
+{
+	const u32 slots = length <= LOG_SLOT_TEXT ? 1 : static_cast<u32>( ( length + LOG_SLOT_TEXT - 1 ) / LOG_SLOT_TEXT );
+	Assert( slots <= LOG_SLOTS );
+	const u64 timeUS = static_cast<u64>( Time::value() * 1000000.0 );
+
+	// Claim slots [position, position + slots): the queue frees slots in order, so the last slot being free
+	// implies the entire run is free
+	bool stalled = false;
+	u32 position = logEnqueue.load();
+	for( ;; )
+	{
+		const u32 last = position + slots - 1;
+		const i32 difference = static_cast<i32>( logSlots[last & ( LOG_SLOTS - 1 )].sequence.load() - last );
+
+		if( difference == 0 )
+		{
+			if( logEnqueue.compare_exchange_strong( position, position + slots ) ) { break; }
+			continue; // 'position' reloaded by the failed exchange
+		}
+
+		if( difference < 0 )
+		{
+			// Queue full: wait on the writer
+			stalled = true;
+			log_writer_wake();
+			Thread::yield();
+		}
+
+		position = logEnqueue.load();
+	}
+
+	// Publish
+	for( u32 i = 0; i < slots; i++ )
+	{
+		LogSlot &slot = logSlots[( position + i ) & ( LOG_SLOTS - 1 )];
+		const int offset = static_cast<int>( i ) * LOG_SLOT_TEXT;
+		const int size = min( length - offset, LOG_SLOT_TEXT );
+		const bool complete = ( i + 1 == slots );
+
+		memory_copy( slot.text, string + offset, static_cast<usize>( size ) );
+		slot.length = static_cast<u16>( size );
+		slot.color = static_cast<i8>( color );
+		slot.flags = complete ? ( newline ? TerminalLogFlag_Newline : 0 ) : TerminalLogFlag_Continued;
+		slot.timeUS = timeUS;
+		slot.sequence.store( position + i + 1 );
+	}
+
+	logMessages.increment();
+	if( stalled ) { logStalls.increment(); }
+	log_writer_wake();
+}
+
+
+static void log_flush()
+{
+	const u32 target = logEnqueue.load();
+	log_writer_wake();
+	Thread::wait_until( [target]() { return static_cast<i32>( logWritten.load() - target ) >= 0; },
+		LOG_FLUSH_TIMEOUT_MS );
+}
+
+
+static void log_writer_write( usize &lengthTerminal, usize &lengthFile )
+{
+	if( lengthTerminal > 0 )
+	{
+		fwrite( logBatchTerminal, 1, lengthTerminal, stdout );
+		fflush( stdout );
+		lengthTerminal = 0;
+	}
+
+	if( lengthFile > 0 )
+	{
+		if( logFile != nullptr )
+		{
+			fwrite( logBatchFile, 1, lengthFile, logFile );
+			fflush( logFile ); // Keep the file intact should the process crash
+		}
+		lengthFile = 0;
+	}
+}
+
+
+static THREAD_FUNCTION( log_writer )
+{
+	// Worst case bytes per slot: color escape + text + reset escape + newline / record header + text
+	constexpr usize SLOT_TERMINAL_MAX = LOG_SLOT_TEXT + 16;
+	constexpr usize SLOT_FILE_MAX = LOG_SLOT_TEXT + 12;
+	bool continued = false;
+
+	for( ;; )
+	{
+		usize lengthTerminal = 0;
+		usize lengthFile = 0;
+		u32 drained = 0;
+
+		logFileMutex.lock();
+		for( ;; )
+		{
+			LogSlot &slot = logSlots[logDequeue & ( LOG_SLOTS - 1 )];
+			if( slot.sequence.load() != logDequeue + 1 ) { break; }
+
+			if( lengthTerminal + SLOT_TERMINAL_MAX > LOG_BATCH_SIZE || lengthFile + SLOT_FILE_MAX > LOG_BATCH_SIZE )
+			{
+				log_writer_write( lengthTerminal, lengthFile );
+			}
+
+			// Terminal
+			char *terminal = logBatchTerminal + lengthTerminal;
+			const bool colored = slot.color >= 0;
+			const bool complete = ( slot.flags & TerminalLogFlag_Continued ) == 0;
+			int escape = 0;
+			if( colored && !continued ) { escape += snprintf( terminal, 16, "\x1b[%dm", slot.color ); }
+			memory_copy( terminal + escape, slot.text, slot.length );
+			lengthTerminal += static_cast<usize>( escape ) + slot.length;
+			if( colored && complete )
+			{
+				lengthTerminal += static_cast<usize>( snprintf( logBatchTerminal + lengthTerminal, 8, "\x1b[%dm",
+					PrintColor_Default ) );
+			}
+			if( slot.flags & TerminalLogFlag_Newline ) { logBatchTerminal[lengthTerminal++] = '\n'; }
+			continued = !complete;
+
+			// Binary log file
+			if( logFile != nullptr )
+			{
+				byte *record = logBatchFile + lengthFile;
+				memory_copy( record + 0, &slot.timeUS, sizeof( u64 ) );
+				memory_copy( record + 8, &slot.length, sizeof( u16 ) );
+				memory_copy( record + 10, &slot.color, sizeof( i8 ) );
+				memory_copy( record + 11, &slot.flags, sizeof( u8 ) );
+				memory_copy( record + 12, slot.text, slot.length );
+				lengthFile += 12 + slot.length;
+			}
+
+			slot.sequence.store( logDequeue + LOG_SLOTS );
+			logDequeue++;
+			drained++;
+		}
+		log_writer_write( lengthTerminal, lengthFile );
+		logFileMutex.unlock();
+
+		if( drained > 0 )
+		{
+			logWritten.store( logDequeue );
+			logBatches.increment();
+			continue;
+		}
+
+		// Queue is empty
+		if( logWriterExit.load() != 0 ) { break; }
+		logWriterSleeping.exchange( 1 );
+		if( logSlots[logDequeue & ( LOG_SLOTS - 1 )].sequence.load() == logDequeue + 1 )
+		{
+			logWriterSleeping.exchange( 0 );
+			continue;
+		}
+		logWriterWake.wait();
+	}
+
+	logWriterAlive.decrement();
+	return 0;
+}
+
+
+static bool log_writer_init()
+{
+	logSlots = reinterpret_cast<LogSlot *>( memory_alloc( memory_heap( MemoryTag_Console ),
+		LOG_SLOTS * sizeof( LogSlot ) ) );
+	for( u32 i = 0; i < LOG_SLOTS; i++ ) { logSlots[i].sequence.init( i ); }
+
+	logEnqueue.init( 0 );
+	logWritten.init( 0 );
+	logWriterSleeping.init( 0 );
+	logWriterExit.init( 0 );
+	logWriterAlive.init( 1 );
+	logMessages.init( 0 );
+	logBatches.init( 0 );
+	logStalls.init( 0 );
+	logDequeue = 0;
+	logWriterWake.init( 0 );
+	logFileMutex.init();
+
+	// Without a thread backend, Print() stays synchronous
+	void *thread = Thread::create( log_writer );
+	if( thread == nullptr )
+	{
+		logWriterAlive.init( 0 );
+		return true;
+	}
+	Thread::free( thread );
+
+	Debug::print_redirect( log_sink, log_flush );
+	return true;
+}
+
+
+static bool log_writer_free()
+{
+	if( logSlots == nullptr ) { return true; }
+
+	// Restore synchronous printing, then let the writer drain what is left and exit
+	if( Debug::print_redirect_sink() == log_sink ) { Debug::print_redirect( nullptr, nullptr ); }
+	logWriterExit.store( 1 );
+	logWriterWake.post();
+	Thread::wait_until( []() { return logWriterAlive.load() == 0; }, LOG_FLUSH_TIMEOUT_MS );
+
+	Terminal::log_file_close();
+	logFileMutex.free();
+	logWriterWake.free();
+	memory_free( memory_heap( MemoryTag_Console ), logSlots, LOG_SLOTS * sizeof( LogSlot ) );
+	logSlots = nullptr;
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 bool CoreTerminal::init()
 {
 #if OS_WINDOWS && COMPILE_TERMINAL
@@ -57,7 +335,7 @@ bool CoreTerminal::init()
 	inputQueue.init();
 	Thread::create( terminal_poll );
 
-	return true;
+	return log_writer_init();
 }
 
 
@@ -65,7 +343,7 @@ bool CoreTerminal::free()
 {
 	// NOTE: 'terminal_poll' runs for the entire application duration, and the OS will free it up upon exit
 	inputQueue.free();
-	return true;
+	return log_writer_free();
 }
 
 
@@ -80,6 +358,46 @@ void CoreTerminal::update()
 }
 
 
+bool Terminal::log_file_open( const char *path )
+{
+	FILE *file = fopen( path, "wb" );
+	ErrorReturnIf( file == nullptr, false, "Terminal: failed to open log file '%s'", path );
+
+	const u32 version = 1;
+	fwrite( "MLOG", 1, 4, file );
+	fwrite( &version, sizeof( u32 ), 1, file );
+	fflush( file );
+
+	// Output already queued is written to the previous file (if any)
+	Debug::print_flush();
+	logFileMutex.lock();
+	if( logFile != nullptr ) { fclose( logFile ); }
+	logFile = file;
+	logFileMutex.unlock();
+	return true;
+}
+
+
+void Terminal::log_file_close()
+{
+	Debug::print_flush();
+	logFileMutex.lock();
+	if( logFile != nullptr ) { fclose( logFile ); }
+	logFile = nullptr;
+	logFileMutex.unlock();
+}
+
+
+TerminalLogStats Terminal::log_stats()
+{
+	TerminalLogStats stats;
+	stats.messages = logMessages.load();
+	stats.batches = logBatches.load();
+	stats.stalls = logStalls.load();
+	return stats;
+}
+
+
 void Terminal::get_dimensions( int &columns, int &rows )
 {
 #if OS_WINDOWS
@@ -157,12 +475,16 @@ void Terminal::cursor_show()
 
 void Terminal::write( const char *text )
 {
+	// Stay ordered with queued Print() output
+	const Debug::PrintSinkFunction sink = Debug::print_redirect_sink();
+	if( sink != nullptr ) { sink( -1, false, text, static_cast<int>( strlen( text ) ) ); return; }
 	fputs( text, stdout );
 }
 
 
 void Terminal::flush()
 {
+	Debug::print_flush();
 	fflush( stdout );
 }
 
@@ -172,6 +494,10 @@ bool CoreTerminal::init() { return true; }
 bool CoreTerminal::free() { return true; }
 void CoreTerminal::update() { }
 
+bool Terminal::log_file_open( const char *path ) { return false; }
+void Terminal::log_file_close() { }
+TerminalLogStats Terminal::log_stats() { return TerminalLogStats { }; }
+
 void Terminal::get_dimensions( int &columns, int &rows ) { columns = 0; rows = 0; }
 void Terminal::clear() { }
 void Terminal::clear_line() { }
@@ -2,6 +2,8 @@
 
 #include <config.hpp>
 
+#include <core/types.hpp>
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 #ifdef COMPILE_TERMINAL
@@ -12,6 +14,14 @@
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+enum_type( TerminalLogFlag, u8 )
+{
+	TerminalLogFlag_Newline = ( 1 << 0 ),
+	TerminalLogFlag_Continued = ( 1 << 1 ), // Message continues in the next record
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 namespace CoreTerminal
 {
 	bool init();
@@ -21,8 +31,28 @@ namespace CoreTerminal
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+struct TerminalLogStats
+{
+	u64 messages = 0; // Queued Print() calls
+	u64 batches = 0; // Writer thread wake-ups that wrote output
+	u64 stalls = 0; // Print() calls that had to wait on a full queue
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 namespace Terminal
 {
+	// Print() output is queued to a background writer thread (see: Debug::print_redirect), so callers never block
+	// on terminal I/O. The writer can also append every message to a binary log file:
+	//
+	//     header: "MLOG" u32 version
+	//     record: u64 microseconds, u16 length, i8 color (-1: none), u8 flags (TerminalLogFlag), char[length]
+	//
+	// Messages longer than a queue slot are split across consecutive records (TerminalLogFlag_Continued)
+	bool log_file_open( const char *path );
+	void log_file_close();
+	TerminalLogStats log_stats();
+
 	void get_dimensions( int &columns, int &rows );
 
 	void clear();
@@ -439,12 +439,12 @@ void Text::string( String &string )
 };
 
 
-String Text::substr( usize start, usize end )
+String Text::substr( usize start, usize end, Allocator *allocator )
 {
 	MemoryAssert( data != nullptr );
 	Assert( start < end );
 	Assert( end <= current );
-	String string;
+	String string { allocator };
 
 	// Encode TextChars to output sting
 	char buffer[5];
@@ -490,12 +490,8 @@ static void draw_glyph( float x, float y, float xOffset, float yOffset,
 	const u16 u2 = ( glyph.u + glyph.width ) * uvScale;
 	const u16 v2 = ( glyph.v + glyph.height ) * uvScale;
 
-	// TODO: Implement this properly...
-	if( UNLIKELY( Gfx::quad_batch_can_break() ) ||
-		UNLIKELY( CoreGfx::state.boundTexture[0] != CoreFonts::glyphAtlasTexture.resource ) )
-	{
-		CoreFonts::update();
-	}
+	// Newly packed glyphs must be uploaded before the batch flushes
+	if( UNLIKELY( Gfx::quad_batch_can_break() ) ) { CoreFonts::update(); }
 
 	Gfx::quad_batch_write( glyphX1, glyphY1, glyphX2, glyphY2, u1, v1, u2, v2, color, &CoreFonts::glyphAtlasTexture, 0.0f );
 }
@@ -904,6 +900,7 @@ int_v2 Text::draw( float x, float y, Alpha alpha )
 		if( line.next == USIZE_MAX ) { break; }
 	}
 
+	CoreFonts::update();
 	return dimensions;
 }
 
@@ -1518,7 +1515,8 @@ void TextEditor::event_copy_clipboard()
 	if( !highlighting() ) { return; }
 
 	// Copy selection to clipboard
-	String selection = text.substr( caret_get_start(), caret_get_end() );
+	MemoryScratchScope scratch;
+	String selection = text.substr( caret_get_start(), caret_get_end(), scratch );
 	Window::set_clipboard( selection );
 }
 
@@ -1544,7 +1542,8 @@ void TextEditor::event_copy_selection()
 	if( start != startPrevious || end != endPrevious )
 	{
 		// Copy selection to clipboard
-		String selection = text.substr( caret_get_start(), caret_get_end() );
+		MemoryScratchScope scratch;
+		String selection = text.substr( caret_get_start(), caret_get_end(), scratch );
 		Window::set_selection( selection );
 		startPrevious = start;
 		endPrevious = end;
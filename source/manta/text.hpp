@@ -143,7 +143,7 @@ public:
 	TextChar &char_at( usize index );
 	const TextChar &char_at( usize index ) const;
 	void string( class String &string );
-	String substr( usize start, usize end );
+	String substr( usize start, usize end, Allocator *allocator = nullptr );
 	void cstr( char *buffer, usize size );
 
 	void draw_selection( float x, float y, usize begin, usize end, const Alpha alpha = { } );
@@ -193,6 +193,26 @@ void Atomic_U32::store( u32 value )
 }
 
 
+u32 Atomic_U32::load_relaxed() const
+{
+#if defined( ATOMIC_MSVC )
+	return v;
+#elif defined( ATOMIC_GCC_CLANG )
+	return __atomic_load_n( &v, __ATOMIC_RELAXED );
+#endif
+}
+
+
+void Atomic_U32::store_relaxed( u32 value )
+{
+#if defined( ATOMIC_MSVC )
+	v = value;
+#elif defined( ATOMIC_GCC_CLANG )
+	__atomic_store_n( &v, value, __ATOMIC_RELAXED );
+#endif
+}
+
+
 u32 Atomic_U32::fetch_add( u32 value )
 {
 #if defined( ATOMIC_MSVC )
@@ -291,6 +311,26 @@ void Atomic_U64::store( u64 value )
 }
 
 
+u64 Atomic_U64::load_relaxed() const
+{
+#if defined( ATOMIC_MSVC )
+	return v;
+#elif defined( ATOMIC_GCC_CLANG )
+	return __atomic_load_n( &v, __ATOMIC_RELAXED );
+#endif
+}
+
+
+void Atomic_U64::store_relaxed( u64 value )
+{
+#if defined( ATOMIC_MSVC )
+	v = static_cast<long long>( value ); // Aligned 64-bit stores are atomic on x64
+#elif defined( ATOMIC_GCC_CLANG )
+	__atomic_store_n( &v, value, __ATOMIC_RELAXED );
+#endif
+}
+
+
 u64 Atomic_U64::fetch_add( u64 value )
 {
 #if defined( ATOMIC_MSVC )
@@ -367,4 +407,43 @@ bool Atomic_U64::compare_exchange_strong( u64 &expected, u64 desired )
 #endif
 }
 
-///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void atomic_fence()
+{
+#if defined( ATOMIC_MSVC )
+	volatile long barrier = 0;
+	_InterlockedOr( &barrier, 0 ); // Locked instructions are full barriers on x86/x64
+#elif defined( ATOMIC_GCC_CLANG )
+	__atomic_thread_fence( __ATOMIC_SEQ_CST );
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void EventCount::init()
+{
+	mutex.init();
+	condition.init();
+	waiters.init( 0U );
+}
+
+
+void EventCount::free()
+{
+	condition.free();
+	mutex.free();
+}
+
+
+void EventCount::notify_all()
+{
+	atomic_fence(); // Pairs with wait_until()
+	if( waiters.load() == 0U ) { return; }
+
+	mutex.lock();
+	condition.wake_all();
+	mutex.unlock();
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
@@ -167,6 +167,7 @@ struct Condition
 	void init();
 	void free();
 	void sleep( Mutex &mutex );
+	bool sleep( Mutex &mutex, u32 timeoutMS ); // false on timeout
 	void wake();
 	void wake_all();
 };
@@ -196,6 +197,8 @@ struct Atomic_U32
 	void init( u32 value = 0 ) { v = value; }
 	u32 load() const;
 	void store( u32 value );
+	u32 load_relaxed() const;
+	void store_relaxed( u32 value );
 	u32 fetch_add( u32 value );
 	u32 fetch_sub( u32 value );
 	u32 fetch_or( u32 value );
@@ -214,6 +217,8 @@ struct Atomic_U64
 	void init( u64 value = 0 ) { v = value; }
 	u64 load() const;
 	void store( u64 value);
+	u64 load_relaxed() const;
+	void store_relaxed( u64 value );
 	u64 fetch_add( u64 value );
 	u64 fetch_sub( u64 value );
 	u64 fetch_or( u64 value );
@@ -230,6 +235,10 @@ struct Atomic_U64
 #endif
 };
 
+
+// Full (sequentially consistent) memory fence
+extern void atomic_fence();
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 struct Semaphore
@@ -248,6 +257,52 @@ struct Semaphore
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Blocking wait on lock-free state (an 'event count'): waiters spin briefly, then sleep on a Condition until
+// notify_all(). Notifying is a fence & a load while nobody is waiting, so it is cheap to call on every state change
+struct EventCount
+{
+	Mutex mutex;
+	Condition condition;
+	Atomic_U32 waiters;
+
+	void init();
+	void free();
+	void notify_all();
+
+	// Returns false if 'predicate' still fails after 'timeoutMS' (< 0: wait forever)
+	template <typename F> bool wait_until( F predicate, int timeoutMS = -1 )
+	{
+		constexpr int SPIN_ITERATIONS = 2000;
+		for( int i = 0; i < SPIN_ITERATIONS; i++ )
+		{
+			if( predicate() ) { return true; }
+			Thread::pause();
+		}
+
+		Timer timer;
+		bool satisfied = true;
+
+		mutex.lock();
+		waiters.increment();
+		atomic_fence(); // Pairs with notify_all(): either we see the new state, or the notifier sees us waiting
+
+		while( !predicate() )
+		{
+			if( timeoutMS < 0 ) { condition.sleep( mutex ); continue; }
+
+			const double remainingMS = timeoutMS - timer.ms();
+			if( remainingMS <= 0.0 ) { satisfied = false; break; }
+			condition.sleep( mutex, static_cast<u32>( remainingMS ) + 1 );
+		}
+
+		waiters.decrement();
+		mutex.unlock();
+		return satisfied;
+	}
+};
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 template <typename T> struct ConcurrentQueue
 {
 public:
@@ -345,6 +400,14 @@ enum_type( WriteMode, u32 )
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Single-producer / single-consumer writer over up to MAX_RESOURCE_COUNT resources. T must provide:
+//   bool init( usize capacity ), bool free(), void write_begin(), void write_end(),
+//   void write( const void *data, usize size, usize offset ),
+//   void *map( usize offset, usize size ) -- only if reserve() is used on an unbuffered writer
+//
+// The producer writes (write_begin/write/reserve/write_end), calls commit(), and hands the CommitResult to the
+// consumer, which calls release( commitID ) once it is done with the data. Commits are published to the consumer
+// with one release-store, either per commit() or once per commit_batch_begin()/commit_batch_end() pair
 template <typename T> class ThreadedWriterSPSC
 {
 public:
@@ -370,6 +433,7 @@ public:
 		u64 commitID = 0LLU;
 	};
 
+	// Written by the producer with relaxed stores, made visible to the consumer by 'commitsPublished'
 	struct CommitTracking
 	{
 		Atomic_U64 commitID;
@@ -381,8 +445,6 @@ public:
 	bool init( T *resources, int resourceCount, usize resourceCapacity, WriteMode writeMode,
 		bool bufferedWrites = true )
 	{
-		constexpr usize s = sizeof( ResourceState );
-
 		Assert( !initialized );
 		Assert( resourceCount > 0 && resourceCount <= MAX_RESOURCE_COUNT );
 		Assert( resourceCapacity > 0 );
@@ -408,6 +470,7 @@ public:
 			resourceStates[i].offset.init( 0LLU );
 			resourceStates[i].isWritten.init( 0U );
 			resourceStates[i].numCommitsInFlight.init( 0U );
+			pendingCommits[i] = 0U;
 		}
 
 		for( int i = 0; i < MAX_COMMIT_TRACKING; i++ )
@@ -423,7 +486,12 @@ public:
 			Assert( scratchBuffer != nullptr );
 		}
 
-		globalCommitCounter.init( 0LLU );
+		globalCommitCounter = 0LLU;
+		commitsTracked = 0LLU;
+		commitsPublished.init( 0LLU );
+		pendingResources = 0U;
+		batchOpen = false;
+		resourceReleased.init();
 
 		initialized = true;
 		return true;
@@ -433,26 +501,14 @@ public:
 	{
 		Assert( initialized );
 
-	#if COMPILE_DEBUG
-		const bool success = Thread::wait_until( [&]()
+		stall_until( [&]()
 			{
 				for( int i = 0; i < resourceCount; i++ )
 				{
 					if( resourceStates[i].numCommitsInFlight.load() > 0U ) { return false; }
 				}
 				return true;
-			}, STALL_TIMEOUT_MS );
-		ErrorIf( !success, "ThreadedWriter: free() timeout -- resources still in flight" );
-	#else
-		Thread::wait_until( [&]()
-			{
-				for( int i = 0; i < resourceCount; i++ )
-				{
-					if( resourceStates[i].numCommitsInFlight.load() > 0U ) { return false; }
-				}
-				return true;
-			} );
-	#endif
+			}, "free()" );
 
 		if( scratchBuffer != nullptr )
 		{
@@ -466,6 +522,8 @@ public:
 			if( !succeeded ) { Warning( "ThreadedWriter: failed to free resource %d", i ); }
 		}
 
+		resourceReleased.free();
+
 		initialized = false;
 		return true;
 	}
@@ -494,20 +552,11 @@ public:
 			{
 				if( !stall ) { return false; }
 
-			#if COMPILE_DEBUG
-				const bool success = Thread::wait_until( [&]()
-					{
-						resourceIndexCurrent = find_available_resource();
-						return resourceIndexCurrent >= 0;
-					}, STALL_TIMEOUT_MS );
-				ErrorIf( !success, "ThreadedWriter: write_begin() timeout -- no available resources" );
-			#else
-				Thread::wait_until( [&]()
+				stall_until( [&]()
 					{
 						resourceIndexCurrent = find_available_resource();
 						return resourceIndexCurrent >= 0;
-					} );
-			#endif
+					}, "write_begin()" );
 			}
 
 			// OVERWRITE resets scratch buffer
@@ -525,7 +574,7 @@ public:
 			if( writeMode == WriteMode_OVERWRITE )
 			{
 				writeStartOffset = 0LLU;
-				resourceStates[resourceIndexCurrent].offset.store( 0LLU );
+				resourceStates[resourceIndexCurrent].offset.store_relaxed( 0LLU );
 			}
 			else
 			{
@@ -543,34 +592,35 @@ public:
 	{
 		Assert( initialized );
 
-		if( alignment > 1 )
-		{
-			const usize alignMask = static_cast<usize>( alignment - 1 );
-			scratchOffset = ( scratchOffset + alignMask ) & ~alignMask;
-		}
-
-		if( scratchOffset + size > resourceCapacity )
-		{
-			Error( "ThreadedWriter: write exceeds capacity! (offset=%llu, size=%llu, capacity=%llu)",
-				scratchOffset, size, resourceCapacity );
-			return false;
-		}
+		usize offset;
+		if( !reserve_offset( size, alignment, offset ) ) { return false; }
 
 		if( writeBuffered )
 		{
-			byte *destination = static_cast<byte *>( scratchBuffer ) + scratchOffset;
+			byte *destination = static_cast<byte *>( scratchBuffer ) + offset;
 			memory_copy( destination, data, size );
 		}
 		else
 		{
-			const usize offset = writeStartOffset + scratchOffset;
-			resourceStates[resourceIndexCurrent].resource->write( data, size, offset );
+			resourceStates[resourceIndexCurrent].resource->write( data, size, writeStartOffset + offset );
 		}
 
-		scratchOffset += size;
 		return true;
 	}
 
+	// Zero-copy write: returns 'size' bytes for the producer to fill in place (nullptr if it does not fit).
+	// Unbuffered writers hand out the mapped resource itself (valid until write_end()), buffered writers hand out
+	// scratch memory (valid until commit())
+	void *reserve( usize size, int alignment = 1 )
+	{
+		Assert( initialized );
+
+		usize offset;
+		if( !reserve_offset( size, alignment, offset ) ) { return nullptr; }
+
+		if( writeBuffered ) { return static_cast<byte *>( scratchBuffer ) + offset; }
+		return resourceStates[resourceIndexCurrent].resource->map( writeStartOffset + offset, size );
+	}
 
 	bool write_end()
 	{
@@ -583,7 +633,7 @@ public:
 		else
 		{
 			resourceStates[resourceIndexCurrent].resource->write_end();
-			resourceStates[resourceIndexCurrent].offset.store( writeMode == WriteMode_RING ?
+			resourceStates[resourceIndexCurrent].offset.store_relaxed( writeMode == WriteMode_RING ?
 				writeStartOffset + scratchOffset : 0LLU );
 		}
 
@@ -596,6 +646,7 @@ public:
 
 		CommitResult result;
 		const usize commitSize = scratchOffset;
+		usize commitOffset = writeStartOffset;
 
 		if( writeBuffered )
 		{
@@ -618,26 +669,13 @@ public:
 
 					if( index < 0 )
 					{
-						if( !stall )
-						{
-							return result;
-						}
-
-						// Stall until a resource becomes available
-					#if COMPILE_DEBUG
-						const bool success = Thread::wait_until( [&]()
+						if( !stall ) { return result; }
+
+						stall_until( [&]()
 							{
-								index = find_next_available_resource(resourceIndexTarget);
+								index = find_next_available_resource( resourceIndexTarget );
 								return index >= 0;
-							}, STALL_TIMEOUT_MS );
-						ErrorIf( !success, "ThreadedWriter: RING commit() timeout -- no available resources" );
-					#else
-						Thread::wait_until( [&]()
-						{
-							index = find_next_available_resource(resourceIndexTarget);
-							return index >= 0;
-						} );
-					#endif
+							}, "RING commit()" );
 					}
 
 					resourceIndexTarget = index;
@@ -647,6 +685,9 @@ public:
 				}
 			}
 
+			// Pin the resource before uploading so release() cannot recycle it underneath us
+			hold_resource( resourceIndexTarget );
+
 			if( commitSize > 0LLU )
 			{
 				T *resource = resourceStates[resourceIndexTarget].resource;
@@ -655,28 +696,19 @@ public:
 				resource->write_end();
 			}
 
-			resourceStates[resourceIndexTarget].offset.store( writeMode == WriteMode_RING ?
+			resourceStates[resourceIndexTarget].offset.store_relaxed( writeMode == WriteMode_RING ?
 				writeOffset + commitSize : 0LLU );
 			resourceIndexCurrent = resourceIndexTarget;
-		}
-
-		resourceStates[resourceIndexCurrent].numCommitsInFlight.increment();
-
-		if( commitID == U64_MAX ) { commitID = globalCommitCounter.fetch_add( 1LLU ); }
-		track_commit( commitID, resourceIndexCurrent );
-		resourceStates[resourceIndexCurrent].isWritten.store( 1U );
-
-		usize commitOffset = 0LLU;
-		if( writeBuffered )
-		{
-			commitOffset = writeMode == WriteMode_RING ?
-				resourceStates[resourceIndexCurrent].offset.load() - commitSize : 0LLU;
+			commitOffset = writeOffset;
 		}
 		else
 		{
-			commitOffset = writeStartOffset;
+			hold_resource( resourceIndexCurrent );
 		}
 
+		if( commitID == U64_MAX ) { commitID = globalCommitCounter++; }
+		track_commit( commitID, resourceIndexCurrent );
+
 		result.resource = resourceStates[resourceIndexCurrent].resource;
 		result.offset = commitOffset;
 		result.size = commitSize;
@@ -686,11 +718,33 @@ public:
 
 		if( writeBuffered ) { scratchOffset = 0LLU; }
 
+		// Outside of a batch, every commit is published on its own
+		if( !batchOpen ) { publish(); }
+
 		return result;
 	}
 
+	// Commits made until commit_batch_end() are published together (CommitResults of the batch must not be
+	// handed to the consumer before then). Stalling inside a batch publishes the commits made so far
+	void commit_batch_begin()
+	{
+		Assert( initialized );
+		Assert( !batchOpen );
+		batchOpen = true;
+	}
+
+	void commit_batch_end()
+	{
+		Assert( batchOpen );
+		batchOpen = false;
+		publish();
+	}
+
 	void release( u64 commitID )
 	{
+		// Acquire: pairs with publish() (tracking slots are written with relaxed stores)
+		if( commitsPublished.load() == 0LLU ) { return; }
+
 		const int index = find_commit_resource( commitID );
 		if( index < 0 ) { return; }
 
@@ -701,6 +755,8 @@ public:
 			return;
 		}
 
+		untrack_commit( commitID );
+
 		// Clear in-flight flag when no more commits are using this resource
 		if( ( numCommitsInFlight - 1LLU ) == 0LLU )
 		{
@@ -709,12 +765,76 @@ public:
 				resourceStates[index].offset.store( 0LLU );
 				resourceStates[index].isWritten.store( 0U );
 			}
-		}
 
-		untrack_commit( commitID );
+			resourceReleased.notify_all();
+		}
 	}
 
 private:
+	bool reserve_offset( usize size, int alignment, usize &offset )
+	{
+		if( alignment > 1 )
+		{
+			const usize alignMask = static_cast<usize>( alignment - 1 );
+			scratchOffset = ( scratchOffset + alignMask ) & ~alignMask;
+		}
+
+		// Unbuffered RING writes continue from the resource's current offset
+		const usize capacity = writeBuffered ? resourceCapacity : resourceCapacity - writeStartOffset;
+		if( scratchOffset + size > capacity )
+		{
+			Error( "ThreadedWriter: write exceeds capacity! (offset=%llu, size=%llu, capacity=%llu)",
+				scratchOffset, size, capacity );
+			return false;
+		}
+
+		offset = scratchOffset;
+		scratchOffset += size;
+		return true;
+	}
+
+	void hold_resource( int resourceIndex )
+	{
+		// The first commit on a resource since the last publish() pins it (numCommitsInFlight > 0) immediately,
+		// the remaining commits are added in publish()
+		if( pendingCommits[resourceIndex]++ == 0U )
+		{
+			resourceStates[resourceIndex].numCommitsInFlight.increment();
+			resourceStates[resourceIndex].isWritten.store_relaxed( 1U );
+			pendingResources |= ( 1U << resourceIndex );
+		}
+	}
+
+	void publish()
+	{
+		u32 mask = pendingResources;
+		for( int index = 0; mask != 0U; index++, mask >>= 1 )
+		{
+			if( ( mask & 1U ) == 0U ) { continue; }
+			const u32 pending = pendingCommits[index];
+			if( pending > 1U ) { resourceStates[index].numCommitsInFlight.fetch_add( pending - 1U ); }
+			pendingCommits[index] = 0U;
+		}
+		pendingResources = 0U;
+
+		// Single release-store: every commit tracked since the last publish() becomes visible to release()
+		commitsPublished.store( commitsTracked );
+	}
+
+	template <typename F> bool stall_until( F condition, const char *caller )
+	{
+		// Commits of an open batch are made visible first, otherwise the consumer could never release them
+		publish();
+
+	#if COMPILE_DEBUG
+		const bool success = resourceReleased.wait_until( condition, STALL_TIMEOUT_MS );
+		ErrorIf( !success, "ThreadedWriter: %s timeout -- resources still in flight", caller );
+		return success;
+	#else
+		return resourceReleased.wait_until( condition );
+	#endif
+	}
+
 	void track_commit( u64 commitID, int resourceIndex )
 	{
 		const int slot = static_cast<int>( commitID % MAX_COMMIT_TRACKING );
@@ -723,12 +843,13 @@ private:
 		{
 			const int idx = ( slot + i ) % MAX_COMMIT_TRACKING;
 
-			u32 expected = 0U;
+			// Acquire: pairs with untrack_commit()
 			if( commitTracking[idx].valid.load() == 0U )
 			{
-				commitTracking[idx].commitID.store( commitID );
-				commitTracking[idx].resourceIndex.store( static_cast<u32>( resourceIndex ) );
-				commitTracking[idx].valid.store( 1U );
+				commitTracking[idx].commitID.store_relaxed( commitID );
+				commitTracking[idx].resourceIndex.store_relaxed( static_cast<u32>( resourceIndex ) );
+				commitTracking[idx].valid.store_relaxed( 1U );
+				commitsTracked++;
 				return;
 			}
 		}
@@ -745,10 +866,10 @@ private:
 		{
 			const int idx = ( slot + i ) % MAX_COMMIT_TRACKING;
 
-			if( commitTracking[idx].valid.load() == 1U &&
-				commitTracking[idx].commitID.load() == commitID )
+			if( commitTracking[idx].valid.load_relaxed() == 1U &&
+				commitTracking[idx].commitID.load_relaxed() == commitID )
 			{
-				return static_cast<int>( commitTracking[idx].resourceIndex.load() );
+				return static_cast<int>( commitTracking[idx].resourceIndex.load_relaxed() );
 			}
 		}
 
@@ -763,8 +884,8 @@ private:
 		{
 			const int idx = ( slot + i ) % MAX_COMMIT_TRACKING;
 
-			if( commitTracking[idx].valid.load() == 1U &&
-				commitTracking[idx].commitID.load() == commitID )
+			if( commitTracking[idx].valid.load_relaxed() == 1U &&
+				commitTracking[idx].commitID.load_relaxed() == commitID )
 			{
 				commitTracking[idx].valid.store( 0U );
 				return;
@@ -797,6 +918,8 @@ private:
 private:
 	ResourceState resourceStates[MAX_RESOURCE_COUNT];
 	CommitTracking commitTracking[MAX_COMMIT_TRACKING];
+	alignas( 64 ) Atomic_U64 commitsPublished; // Producer -> consumer (count of tracked commits)
+	EventCount resourceReleased; // Consumer -> producer (a resource's numCommitsInFlight reached 0)
 
 	usize resourceCapacity = 0LLU;
 	int resourceCount = 0;
@@ -810,7 +933,12 @@ private:
 	WriteMode writeMode = WriteMode_PERSISTENT;
 	bool writeBuffered = true;
 
-	Atomic_U64 globalCommitCounter;
+	// Producer only
+	u32 pendingCommits[MAX_RESOURCE_COUNT] = { }; // Commits since the last publish(), per resource
+	u32 pendingResources = 0U; // Bitmask of resources with pendingCommits > 0
+	u64 globalCommitCounter = 0LLU;
+	u64 commitsTracked = 0LLU;
+	bool batchOpen = false;
 
 	bool initialized = false;
 };
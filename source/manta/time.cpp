@@ -72,13 +72,8 @@ namespace Frame
 		while( Time::value() < Frame::timeEnd + remaining );
 	}
 
-	void start()
+	static void advance()
 	{
-		// Time
-		const double timePrevious = timeStart;
-		timeStart = Time::value();
-		delta = ( timeStart - timePrevious );
-
 		// Reset ticks
 		tickSecond = false;
 		tickFrame = false;
@@ -112,11 +107,34 @@ namespace Frame
 		}
 	}
 
+	void start()
+	{
+		// Time
+		const double timePrevious = timeStart;
+		timeStart = Time::value();
+		delta = ( timeStart - timePrevious );
+		advance();
+	}
+
+	void start_fixed( const Delta fixedDelta )
+	{
+		// Fixed timestep: Frame::delta is the tick interval rather than the measured time
+		timeStart = Time::value();
+		delta = fixedDelta;
+		advance();
+	}
+
 	void end()
 	{
 		timeEnd = Time::value();
 		regulate();
 	}
+
+	void end_fixed()
+	{
+		// NOTE: No regulation -- the caller is responsible for scheduling the next tick
+		timeEnd = Time::value();
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
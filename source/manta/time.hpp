@@ -124,6 +124,9 @@ namespace Frame
 
 	extern void start();
 	extern void end();
+
+	extern void start_fixed( Delta fixedDelta );
+	extern void end_fixed();
 }
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file
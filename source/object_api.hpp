@@ -87,6 +87,10 @@
 	// Usage: GLOBAL void kill_all_rabbits() { ... }
 	#define GLOBAL
 
+	// Delta-replicated member data (requires NETWORKED( true ), see: manta/replication.hpp)
+	// Usage: PUBLIC REPLICATED float x;
+	#define REPLICATED
+
 	// Friend access specifier for protected/private members
 	// Usage: FRIEND( struct/class/function )
 	#define FRIEND( friend )
@@ -44,4 +44,80 @@ vertex_input VertexPositionNormalTangentUV
 	float2 uv packed_as( UNORM16 );
 };
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Packed vertex formats (smaller vertex buffers -- decode in the vertex shader with the helpers below):
+//     position: UNORM16 within the mesh bounds (Assets::MeshEntry x1, y1, z1 -> x2, y2, z2), w: tangent handedness
+//     normal, tangent: octahedral SNORM16
+//     uv: FLOAT16
+//
+// Packed meshes are opt-in ("format" in *.model files). Shaders that draw them declare a uniform buffer for the
+// bounds, e.g.:
+//
+//     uniform_buffer( 1 ) UniformsMesh
+//     {
+//         float3 boundsMin;
+//         float3 boundsMax;
+//     };
+//
+// and the runtime fills it per mesh with Assets::mesh_bounds_upload( GfxUniformBuffer::UniformsMesh, mesh )
+
+vertex_input VertexPositionPacked
+{
+	float4 position packed_as( UNORM16 );
+};
+
+
+vertex_input VertexPositionUVPacked
+{
+	float4 position packed_as( UNORM16 );
+	float2 uv packed_as( FLOAT16 );
+};
+
+
+vertex_input VertexPositionNormalPacked
+{
+	float4 position packed_as( UNORM16 );
+	float2 normal packed_as( SNORM16 );
+};
+
+
+vertex_input VertexPositionNormalUVPacked
+{
+	float4 position packed_as( UNORM16 );
+	float2 normal packed_as( SNORM16 );
+	float2 uv packed_as( FLOAT16 );
+};
+
+
+vertex_input VertexPositionNormalTangentUVPacked
+{
+	float4 position packed_as( UNORM16 );
+	float2 normal packed_as( SNORM16 );
+	float2 tangent packed_as( SNORM16 );
+	float2 uv packed_as( FLOAT16 );
+};
+
+
+float3 vertex_unpack_position( float4 position, float3 boundsMin, float3 boundsMax )
+{
+	return boundsMin + position.xyz * ( boundsMax - boundsMin );
+}
+
+
+float3 vertex_unpack_octahedral( float2 packed )
+{
+	float3 direction = float3( packed.x, packed.y, 1.0 - abs( packed.x ) - abs( packed.y ) );
+	float fold = saturate( -direction.z );
+	direction.x = direction.x + fold * ( 1.0 - 2.0 * step( 0.0, direction.x ) );
+	direction.y = direction.y + fold * ( 1.0 - 2.0 * step( 0.0, direction.y ) );
+	return normalize( direction );
+}
+
+
+float4 vertex_unpack_tangent( float2 tangent, float4 position )
+{
+	return float4( vertex_unpack_octahedral( tangent ), position.w * 2.0 - 1.0 );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
\ No newline at end of file